@@ -17,12 +17,50 @@
 
 #include <boost/format.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 using namespace std;
 
 #define ALMOST_ZERO 0.00001
 
+namespace
+{
+  //header of the binary lookup files.  The magic string is bumped whenever the layout changes.
+  struct BinaryLookupHeader
+  {
+    char magic[8];
+    float rmin, rmax, zmin, zmax;
+    int nr, nphi, nz;
+    int rmin_roi, rmax_roi, zmin_roi, zmax_roi;
+    int hasGreen; //1 if built from the rossegger greens functions, 0 for free space.
+    float green_shift; //z offset the greens functions were queried with.  only meaningful if hasGreen.
+  };
+  const char binaryLookupMagic[8]={'A','F','S','P','H','I','0','2'};
+
+  //one sample point of a distortion map, and the distortions drifted from it, per side
+  struct DistortionMapSample
+  {
+    int ir, ip, iz;
+    float partR, partP, partZ; //position in the histogram
+    TVector3 inpart; //position the drift starts from, which is nudged inward at the edges
+    TVector3 diffdistort[2];
+    TVector3 distort[2];
+  };
+
+  bool hasBinarySuffix(const char* filename){
+    const char* suffix=".bin";
+    size_t n=strlen(filename);
+    return n>=strlen(suffix) && strcmp(filename+n-strlen(suffix),suffix)==0;
+  }
+}
+
 AnnularFieldSim::AnnularFieldSim(float in_innerRadius, float in_outerRadius, float in_outerZ,
 				 int r, int roi_r0, int roi_r1, int /*in_rLowSpacing*/, int /*in_rHighSize*/,
 				 int phi, int roi_phi0, int roi_phi1, int /*in_phiLowSpacing*/, int /*in_phiHighSize*/,
@@ -557,6 +595,17 @@ TVector3 AnnularFieldSim::fieldIntegral(float zdest,TVector3 start, MultiArray<T
   return dir*fieldInt;
 }
 
+void AnnularFieldSim::load_rossegger(double epsilon){
+  green=new Rossegger(rmin,rmax,zmax,epsilon);
+  //the lookups evaluate the greens functions between cell centers, so tabulate the radial terms there:
+  std::vector<double> radii(nr);
+  for (int ir=0;ir<nr;ir++){
+    radii[ir]=GetCellCenter(ir,0,0).Perp();
+  }
+  green->PrecalcRadialTables(radii);
+  return;
+}
+
 TVector3 AnnularFieldSim::GetCellCenter(int r, int phi, int z){
   //returns the midpoint of the cell (halfway between each edge, not weighted center)
   
@@ -1271,6 +1320,26 @@ void AnnularFieldSim::populate_fieldmap(){
   printf("total elements = %llu\n",totalelements*nr*nphi*nz);
 
 
+  if (lookupCase==PhiSlice || (lookupCase==Full3D && truncation_length<1)){
+    //sum over the flat lookup and the charge, splitting the roi cells across threads:
+    if (!flat_lookup->valid) build_flat_lookup();
+    printf("populate_fieldmap: summing flat arrays with %d thread(s)\n",nthreads);
+    RunInThreads(nr_roi*nphi_roi*nz_roi,[this,percent](int first, int last){
+	for (int i=first;i<last;i++){
+	  int ir=i/(nphi_roi*nz_roi)+rmin_roi;
+	  int iphi=(i/nz_roi)%nphi_roi+phimin_roi;
+	  int iz=i%nz_roi+zmin_roi;
+	  TVector3 localF=sum_flat_field_at(ir,iphi,iz)+Eexternal->Get(ir-rmin_roi,iphi-phimin_roi,iz-zmin_roi);
+	  if(first==0 && percent>0 && !(i%percent)) {printf("populate_fieldmap %d%% (first thread):  ",(int)(debug_npercent*i/percent));
+	    printf("sum_field_at (ir=%d,iphi=%d,iz=%d) gives (%E,%E,%E)\n",
+		   ir,iphi,iz,localF.X(),localF.Y(),localF.Z());
+	  }
+	  Efield->Set(ir-rmin_roi,iphi-phimin_roi,iz-zmin_roi,localF);//sets in roi coordinates.
+	}
+      });
+    return;
+  }
+
   int el=0;
 
   
@@ -1299,6 +1368,7 @@ void  AnnularFieldSim::populate_lookup(){
   //remember the 'f' part of Epartial uses relative indices.
   //  TVector3 (*f)[fx][fy][fz][ox][oy][oz]=field_;
   //printf("populating lookup for (%dx%dx%d)x(%dx%dx%d) grid\n",fx,fy,fz,ox,oy,oz);
+  flat_lookup->valid=false;
   
   if (lookupCase==Full3D){
     printf("lookupCase==Full3D\n");
@@ -1328,37 +1398,31 @@ void  AnnularFieldSim::populate_full3d_lookup(){
   printf("populating full lookup table for (%dx%dx%d)x(%dx%dx%d) grid\n",
 	 (rmax_roi-rmin_roi),(phimax_roi-phimin_roi),(zmax_roi-zmin_roi),nr,nphi,nz);
   unsigned long long totalelements=(rmax_roi-rmin_roi)*(phimax_roi-phimin_roi)*(zmax_roi-zmin_roi)*nr*nphi*nz;
-  unsigned long long percent=totalelements/100*debug_npercent;
   printf("total elements = %llu\n",totalelements);
-  TVector3 at(1,0,0);
-  TVector3 from(1,0,0);
-  TVector3 zero(0,0,0);
 
-  int el=0;
-  for (int ifr=rmin_roi;ifr<rmax_roi;ifr++){
-    for (int ifphi=phimin_roi;ifphi<phimax_roi;ifphi++){
-      for (int ifz=zmin_roi;ifz<zmax_roi;ifz++){
-	at=GetCellCenter(ifr, ifphi, ifz);
+  //each target f-bin fills its own part of the table, so the targets are split across threads:
+  RunInThreads(nr_roi*nphi_roi*nz_roi,[this](int first, int last){
+      TVector3 zero(0,0,0);
+      const int percent=std::max(1,(last-first)/100*debug_npercent);
+      for (int i=first;i<last;i++){
+	int ifr=i/(nphi_roi*nz_roi)+rmin_roi;
+	int ifphi=(i/nz_roi)%nphi_roi+phimin_roi;
+	int ifz=i%nz_roi+zmin_roi;
+	if (first==0 && !(i%percent)) printf("populate_full3d_lookup %d%% (first thread)\n",(int)(debug_npercent*i/percent));
+	TVector3 at=GetCellCenter(ifr, ifphi, ifz);
 	for (int ior=0;ior<nr;ior++){
 	  for (int iophi=0;iophi<nphi;iophi++){
 	    for (int ioz=0;ioz<nz;ioz++){
-	      el++;
-	      if(!(el%percent)) printf("populate_full3d_lookup %d%%\n",(int)(debug_npercent*el/percent));
-	      from=GetCellCenter(ior, iophi, ioz);
-
-	      //*f[ifx][ify][ifz][iox][ioy][ioz]=cacl_unit_field(at,from);
-	      //printf("calc_unit_field...\n");
 	      if (ifr==ior && ifphi==iophi && ifz==ioz){
 		Epartial->Set(ifr-rmin_roi,ifphi-phimin_roi,ifz-zmin_roi,ior,iophi,ioz,zero);
 	      } else{
-	      Epartial->Set(ifr-rmin_roi,ifphi-phimin_roi,ifz-zmin_roi,ior,iophi,ioz,calc_unit_field(at,from));
+		Epartial->Set(ifr-rmin_roi,ifphi-phimin_roi,ifz-zmin_roi,ior,iophi,ioz,calc_unit_field(at,GetCellCenter(ior, iophi, ioz)));
 	      }
 	    }
 	  }
 	}
       }
-    }
-  }
+    });
   return;
 
 }
@@ -1514,62 +1578,57 @@ void AnnularFieldSim::populate_highres_lookup(){
 
 void AnnularFieldSim::populate_lowres_lookup(){
 
-  TVector3 at(1,0,0);
-  TVector3 from(1,0,0);
-  TVector3 zero(0,0,0);
-  int fr_low,fr_high,fphi_low,fphi_high,fz_low,fz_high;//edges of the outer l-bin
-  int r_low,r_high,phi_low,phi_high,z_low,z_high;//edges of the inner l-bin
-
   //todo:  add in handling if roi_low is wrap-around in phi
-  for (int ifr=rmin_roi_low;ifr<rmax_roi_low;ifr++){
-    fr_low=ifr*r_spacing;
-    fr_high=fr_low+r_spacing-1;
-    if (fr_high>=nr) fr_high=nr-1;	
-    for (int ifphi=phimin_roi_low;ifphi<phimax_roi_low;ifphi++){
-      fphi_low=ifphi*phi_spacing;
-      fphi_high=fphi_low+phi_spacing-1;
-      if (fphi_high>=nphi) fphi_high=nphi-1; //if our phi l-bins aren't evenly spaced, we need to catch that here.
-      for (int ifz=zmin_roi_low;ifz<zmax_roi_low;ifz++){
+  //each target l-bin fills its own part of the table, so the targets are split across threads:
+  RunInThreads(nr_roi_low*nphi_roi_low*nz_roi_low,[this](int first, int last){
+      TVector3 at(1,0,0);
+      TVector3 from(1,0,0);
+      TVector3 zero(0,0,0);
+      int fr_low,fr_high,fphi_low,fphi_high,fz_low,fz_high;//edges of the outer l-bin
+      int r_low,r_high,phi_low,phi_high,z_low,z_high;//edges of the inner l-bin
+      for (int i=first;i<last;i++){
+	int ifr=i/(nphi_roi_low*nz_roi_low)+rmin_roi_low;
+	int ifphi=(i/nz_roi_low)%nphi_roi_low+phimin_roi_low;
+	int ifz=i%nz_roi_low+zmin_roi_low;
+
+	fr_low=ifr*r_spacing;
+	fr_high=fr_low+r_spacing-1;
+	if (fr_high>=nr) fr_high=nr-1;	
+	fphi_low=ifphi*phi_spacing;
+	fphi_high=fphi_low+phi_spacing-1;
+	if (fphi_high>=nphi) fphi_high=nphi-1; //if our phi l-bins aren't evenly spaced, we need to catch that here.
 	fz_low=ifz*z_spacing;
 	fz_high=fz_low+z_spacing-1;
 	if (fz_high>=nz) fz_high=nz-1;
 	at=GetGroupCellCenter(fr_low,fr_high,fphi_low,fphi_high,fz_low,fz_high);
-	//printf("ifr=%d, rlow=%d,rhigh=%d,r_spacing=%d\n",ifr,r_low,r_high,r_spacing);
-	//if(debugFlag())	  printf("%d: AnnularFieldSim::populate_lowres_lookup icell=(%d,%d,%d)\n",__LINE__,ifr,ifphi,ifz);
+	int ir_rel=ifr-rmin_roi_low;
+	int iphi_rel=ifphi-phimin_roi_low;
+	int iz_rel=ifz-zmin_roi_low;
 		
 	for (int ior=0;ior<nr_low;ior++){
 	  r_low=ior*r_spacing;
 	  r_high=r_low+r_spacing-1;
-	  int ir_rel=ifr-rmin_roi_low;
-
 	  if (r_high>=nr) r_high=nr-1;
 	  for (int iophi=0;iophi<nphi_low;iophi++){
 	    phi_low=iophi*phi_spacing;
 	    phi_high=phi_low+phi_spacing-1;
 	    if (phi_high>=nphi) phi_high=nphi-1;
-	    int iphi_rel=ifphi-phimin_roi_low;
 	    for (int ioz=0;ioz<nz_low;ioz++){
 	      z_low=ioz*z_spacing;
 	      z_high=z_low+z_spacing-1;
 	      if (z_high>=nz) z_high=nz-1;
-	      int iz_rel=ifz-zmin_roi_low;
 	      from=GetGroupCellCenter(r_low,r_high,phi_low,phi_high,z_low,z_high);
 
-		if (ifr==ior && ifphi==iophi && ifz==ioz){
-		  Epartial_lowres->Set(ir_rel,iphi_rel,iz_rel,ior,iophi,ioz,zero);
-		}else{ //for extra carefulness, only calc the field if it's not self-to-self.
-		  Epartial_lowres->Set(ir_rel,iphi_rel,iz_rel,ior,iophi,ioz,calc_unit_field(at,from));
-		}
-	      
-	      //*f[ifx][ify][ifz][iox][ioy][ioz]=cacl_unit_field(at,from);
-	      //printf("calc_unit_field...\n");
-	      //this calc's okay.
+	      if (ifr==ior && ifphi==iophi && ifz==ioz){
+		Epartial_lowres->Set(ir_rel,iphi_rel,iz_rel,ior,iophi,ioz,zero);
+	      }else{ //for extra carefulness, only calc the field if it's not self-to-self.
+		Epartial_lowres->Set(ir_rel,iphi_rel,iz_rel,ior,iophi,ioz,calc_unit_field(at,from));
+	      }
 	    }
 	  }
 	}
       }
-    }
-  }
+    });
   return;
 
 }
@@ -1578,61 +1637,67 @@ void  AnnularFieldSim::populate_phislice_lookup(){
   //with 'f' being the position the field is being measured at, and 'o' being the position of the charge generating the field.
   //remember the 'f' part of Epartial uses relative indices.
   //  TVector3 (*f)[fx][fy][fz][ox][oy][oz]=field_;
-  printf("populating phislice  lookup for (%dx%dx%d)x(%dx%dx%d) grid\n",nr_roi,1,nz_roi,nr,nphi,nz);
+  printf("populating phislice  lookup for (%dx%dx%d)x(%dx%dx%d) grid with %d thread(s)\n",nr_roi,1,nz_roi,nr,nphi,nz,nthreads);
   unsigned long long totalelements=nr*nphi*nz*nr_roi*1*nz_roi;
-  unsigned long long percent=totalelements/100*debug_npercent;
   printf("total elements = %llu\n",totalelements);
-  TVector3 at(1,0,0);
-  TVector3 from(1,0,0);
-  TVector3 zero(0,0,0);
-
-  int el=0;
-  for (int ifr=rmin_roi;ifr<rmax_roi;ifr++){
-    for (int ifz=zmin_roi;ifz<zmax_roi;ifz++){
-      at=GetCellCenter(ifr, 0, ifz);
-      for (int ior=0;ior<nr;ior++){
-	for (int iophi=0;iophi<nphi;iophi++){
-	  for (int ioz=0;ioz<nz;ioz++){
-	    el++;
-	    from=GetCellCenter(ior, iophi, ioz);
-	    //*f[ifx][ify][ifz][iox][ioy][ioz]=cacl_unit_field(at,from);
-	    //printf("calc_unit_field...\n");
-	    if (ifr==ior && 0==iophi && ifz==ioz){
-		if(!(el%percent)) {printf("populate_phislice_lookup %d%%:  ",(int)(debug_npercent*el/percent));
-		  printf("self-to-self is zero (ir=%d,iphi=%d,iz=%d) to (or=%d,ophi=0,oz=%d) gives (%E,%E,%E)\n",
-		  	 ior,iophi,ioz,ifr,ifz,zero.X(),zero.Y(),zero.Z());
-		}
-	      Epartial_phislice->Set(ifr-rmin_roi,0,ifz-zmin_roi,ior,iophi,ioz,zero);
-	    } else{
-	      TVector3 unitf=calc_unit_field(at,from);
-	      if (1){
-		if(!(el%percent)) {printf("populate_phislice_lookup %d%%:  ",(int)(debug_npercent*el/percent));
-		  printf("calc_unit_field (ir=%d,iphi=%d,iz=%d) to (or=%d,ophi=0,oz=%d) gives (%E,%E,%E)\n",
-		  	 ior,iophi,ioz,ifr,ifz,unitf.X(),unitf.Y(),unitf.Z());
-		}
-	      }
 
-	      Epartial_phislice->Set(ifr-rmin_roi,0,ifz-zmin_roi,ior,iophi,ioz,unitf);//the origin phi is relative to zero anyway.
+  //each target f-bin in the slice fills its own part of the table, so the targets are split across threads:
+  RunInThreads(nr_roi*nz_roi,[this](int first, int last){
+      TVector3 at(1,0,0);
+      TVector3 from(1,0,0);
+      TVector3 zero(0,0,0);
+      const int percent=std::max(1,(last-first)/100*debug_npercent);
+      for (int i=first;i<last;i++){
+	int ifr=i/nz_roi+rmin_roi;
+	int ifz=i%nz_roi+zmin_roi;
+	at=GetCellCenter(ifr, 0, ifz);
+	for (int ior=0;ior<nr;ior++){
+	  for (int iophi=0;iophi<nphi;iophi++){
+	    for (int ioz=0;ioz<nz;ioz++){
+	      from=GetCellCenter(ior, iophi, ioz);
+	      if (ifr==ior && 0==iophi && ifz==ioz){
+		Epartial_phislice->Set(ifr-rmin_roi,0,ifz-zmin_roi,ior,iophi,ioz,zero);
+	      } else{
+		Epartial_phislice->Set(ifr-rmin_roi,0,ifz-zmin_roi,ior,iophi,ioz,calc_unit_field(at,from));//the origin phi is relative to zero anyway.
 	      }
 	    }
 	  }
 	}
+	if(first==0 && !(i%percent)) {printf("populate_phislice_lookup %d%% (first thread):  ",(int)(debug_npercent*i/percent));
+	  TVector3 unitf=Epartial_phislice->Get(ifr-rmin_roi,0,ifz-zmin_roi,nr-1,nphi-1,nz-1);
+	  printf("calc_unit_field (ir=%d,iphi=%d,iz=%d) to (or=%d,ophi=0,oz=%d) gives (%E,%E,%E)\n",
+		 nr-1,nphi-1,nz-1,ifr,ifz,unitf.X(),unitf.Y(),unitf.Z());
+	}
       }
-    }
+    });
   return;
 
 }
 
 void  AnnularFieldSim::load_phislice_lookup(const char* sourcefile){
+  if (hasBinarySuffix(sourcefile)){
+    if (!load_phislice_lookup_binary(sourcefile)){
+      printf("could not load binary phislice lookup from %s.  Exiting.\n",sourcefile);
+      exit(1);
+    }
+    return;
+  }
   printf("loading phislice  lookup for (%dx%dx%d)x(%dx%dx%d) grid from %s\n",nr_roi,1,nz_roi,nr,nphi,nz,sourcefile);
   unsigned long long totalelements=nr*nphi*nz*nr_roi*1*nz_roi;
   unsigned long long percent=totalelements/100*debug_npercent;
   printf("total elements = %llu\n",totalelements);
 
   TFile *input=TFile::Open(sourcefile,"READ");
+  if (!input || input->IsZombie()){
+    printf("could not open phislice lookup file %s.  Exiting.\n",sourcefile);
+    exit(1);
+  }
 
   TTree *tInfo=(TTree*)(input->Get("info"));
-  if (!tInfo) assert(1==3);
+  if (!tInfo){
+    printf("%s has no 'info' tree, so is not a phislice lookup.  Exiting.\n",sourcefile);
+    exit(1);
+  }
 
   float file_rmin,file_rmax,file_zmin,file_zmax;
   int file_rmin_roi, file_rmax_roi,file_zmin_roi,file_zmax_roi;
@@ -1668,14 +1733,15 @@ void  AnnularFieldSim::load_phislice_lookup(const char* sourcefile){
       file_rmin_roi!=rmin_roi || file_rmax_roi!=rmax_roi ||
       file_zmin_roi!=zmin_roi || file_zmax_roi!=zmax_roi ||
       file_nr!=nr || file_np!=nphi || file_nz!=nz){
-    printf("file parameters do not match fieldsim parameters:\n");
-
-
-    assert(1==4);
+    printf("file parameters do not match fieldsim parameters.  Exiting.\n");
+    exit(1);
   }
 
   TTree *tLookup=(TTree*)(input->Get("phislice"));
-  if (!tLookup) assert(1==5);
+  if (!tLookup){
+    printf("%s has no 'phislice' tree.  Exiting.\n",sourcefile);
+    exit(1);
+  }
    int ior,ifr,iophi,ioz,ifz;
    TVector3 *unitf=0; 
    tLookup->SetBranchAddress("ir_source",&ior);
@@ -1703,12 +1769,17 @@ void  AnnularFieldSim::load_phislice_lookup(const char* sourcefile){
    }
 
   input->Close();
+  flat_lookup->valid=false;
   return;
 }
 
   
 
 void  AnnularFieldSim::save_phislice_lookup(const char* destfile){
+  if (hasBinarySuffix(destfile)){
+    save_phislice_lookup_binary(destfile);
+    return;
+  }
   printf("saving phislice  lookup for (%dx%dx%d)x(%dx%dx%d) grid to %s\n",nr_roi,1,nz_roi,nr,nphi,nz,destfile);
   unsigned long long totalelements=nr*nphi*nz*nr_roi*1*nz_roi;
   unsigned long long percent=totalelements/100*debug_npercent;
@@ -1775,6 +1846,151 @@ void  AnnularFieldSim::save_phislice_lookup(const char* destfile){
 
 
 
+bool  AnnularFieldSim::load_phislice_lookup_binary(const char* sourcefile){
+  //compact binary version of load_phislice_lookup:  a geometry header followed by the raw lookup as floats, in the native (not legacy-signed) units.
+  printf("loading binary phislice lookup for (%dx%dx%d)x(%dx%dx%d) grid from %s\n",nr_roi,1,nz_roi,nr,nphi,nz,sourcefile);
+  std::ifstream input(sourcefile,std::ios::binary);
+  if (!input){
+    printf("could not open %s\n",sourcefile);
+    return false;
+  }
+
+  BinaryLookupHeader header;
+  input.read(reinterpret_cast<char*>(&header),sizeof(header));
+  if (!input || memcmp(header.magic,binaryLookupMagic,sizeof(binaryLookupMagic))!=0){
+    printf("%s is not a binary phislice lookup, or has an outdated format\n",sourcefile);
+    return false;
+  }
+  if (header.rmin!=rmin || header.rmax!=rmax ||
+      header.zmin!=zmin || header.zmax!=zmax ||
+      header.rmin_roi!=rmin_roi || header.rmax_roi!=rmax_roi ||
+      header.zmin_roi!=zmin_roi || header.zmax_roi!=zmax_roi ||
+      header.nr!=nr || header.nphi!=nphi || header.nz!=nz){
+    printf("file parameters do not match fieldsim parameters\n");
+    return false;
+  }
+  const int hasGreen=(green!=nullptr);
+  if (header.hasGreen!=hasGreen || (hasGreen && header.green_shift!=green_shift)){
+    printf("lookup was built with %s greens functions (shift %f), but fieldsim uses %s (shift %f)\n",
+	   header.hasGreen?"rossegger":"free-space",header.green_shift,hasGreen?"rossegger":"free-space",green_shift);
+    return false;
+  }
+
+  const int length=Epartial_phislice->Length();
+  std::vector<float> buffer(3*length);
+  input.read(reinterpret_cast<char*>(buffer.data()),buffer.size()*sizeof(float));
+  if (!input){
+    printf("%s is truncated\n",sourcefile);
+    return false;
+  }
+  for (int i=0;i<length;i++){
+    Epartial_phislice->GetFlat(i)->SetXYZ(buffer[3*i],buffer[3*i+1],buffer[3*i+2]);
+  }
+  flat_lookup->valid=false;
+  return true;
+}
+
+void  AnnularFieldSim::save_phislice_lookup_binary(const char* destfile){
+  printf("saving binary phislice lookup for (%dx%dx%d)x(%dx%dx%d) grid to %s\n",nr_roi,1,nz_roi,nr,nphi,nz,destfile);
+  BinaryLookupHeader header;
+  memcpy(header.magic,binaryLookupMagic,sizeof(binaryLookupMagic));
+  header.rmin=rmin; header.rmax=rmax; header.zmin=zmin; header.zmax=zmax;
+  header.nr=nr; header.nphi=nphi; header.nz=nz;
+  header.rmin_roi=rmin_roi; header.rmax_roi=rmax_roi; header.zmin_roi=zmin_roi; header.zmax_roi=zmax_roi;
+  header.hasGreen=(green!=nullptr);
+  header.green_shift=header.hasGreen?green_shift:0;
+
+  const int length=Epartial_phislice->Length();
+  std::vector<float> buffer(3*length);
+  for (int i=0;i<length;i++){
+    const TVector3 *f=Epartial_phislice->GetFlat(i);
+    buffer[3*i]=f->X();
+    buffer[3*i+1]=f->Y();
+    buffer[3*i+2]=f->Z();
+  }
+
+  std::ofstream output(destfile,std::ios::binary);
+  output.write(reinterpret_cast<const char*>(&header),sizeof(header));
+  output.write(reinterpret_cast<const char*>(buffer.data()),buffer.size()*sizeof(float));
+  if (!output) printf("error writing %s\n",destfile);
+  return;
+}
+
+std::string AnnularFieldSim::GetPhisliceLookupCacheName(const std::string &dir){
+  //the name encodes everything that load_phislice_lookup_binary checks, so a cached file is only picked up for a matching grid and greens function.
+  const std::string greenTag=green?(boost::format("ross_shift%.3f")%green_shift).str():"free";
+  return dir+"/"+(boost::format("phislice_lookup_r%.3f-%.3f_z%.3f-%.3f_n%dx%dx%d_roi_r%d-%d_z%d-%d_%s.bin")
+		  %rmin %rmax %zmin %zmax %nr %nphi %nz %rmin_roi %rmax_roi %zmin_roi %zmax_roi %greenTag).str();
+}
+
+void AnnularFieldSim::build_flat_lookup(){
+  //copy the PhiSlice or Full3D lookup into contiguous float arrays, one per component, so the summation streams through memory.
+  //self-to-self terms are zeroed here, so the summation doesn't have to skip them.
+  MultiArray<TVector3> *source=(lookupCase==PhiSlice)?Epartial_phislice:Epartial;
+  const int length=source->Length();
+  printf("building flat lookup with %d elements\n",length);
+  for (int c=0;c<3;c++) flat_lookup->e[c].resize(length);
+  for (int i=0;i<length;i++){
+    const TVector3 *f=source->GetFlat(i);
+    flat_lookup->e[0][i]=f->X();
+    flat_lookup->e[1][i]=f->Y();
+    flat_lookup->e[2][i]=f->Z();
+  }
+
+  const int nsource=nr*nphi*nz;
+  for (int ir=rmin_roi;ir<rmax_roi;ir++){
+    for (int iphi=phimin_roi;iphi<phimax_roi;iphi++){
+      for (int iz=zmin_roi;iz<zmax_roi;iz++){
+	long long self;
+	if (lookupCase==PhiSlice){
+	  if (iphi!=phimin_roi) continue; //the slice is independent of phi.
+	  self=(long long)((ir-rmin_roi)*nz_roi+(iz-zmin_roi))*nsource+(ir*nphi+0)*nz+iz;
+	} else {
+	  self=(long long)(((ir-rmin_roi)*nphi_roi+(iphi-phimin_roi))*nz_roi+(iz-zmin_roi))*nsource+(ir*nphi+iphi)*nz+iz;
+	}
+	for (int c=0;c<3;c++) flat_lookup->e[c][self]=0;
+      }
+    }
+  }
+  flat_lookup->valid=true;
+  return;
+}
+
+void AnnularFieldSim::RunInThreads(int n, const std::function<void(int,int)> &func){
+  const int nt=std::max(1,std::min(nthreads,n));
+  if (nt==1){
+    func(0,n);
+    return;
+  }
+  std::vector<std::thread> threads;
+  const int chunk=(n+nt-1)/nt;
+  for (int first=0;first<n;first+=chunk){
+    threads.emplace_back(func,first,std::min(n,first+chunk));
+  }
+  for (auto &thread:threads) thread.join();
+  return;
+}
+
+void AnnularFieldSim::RunDistortionSamples(const char* name, int n, const std::function<void(int)> &func){
+  //progress is counted over all threads, so the reports come in order no matter which thread finishes a sample.
+  const int percent=std::max(1,n/100*debug_npercent);
+  std::atomic<int> done(0);
+  const auto start=std::chrono::steady_clock::now();
+  RunInThreads(n,[&](int first, int last){
+      for (int i=first;i<last;i++){
+	func(i);
+	const int ndone=++done;
+	if (!(ndone%percent)){
+	  const double elapsed=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+	  printf("%s %d%%:  %d of %d samples in %.1fs, about %.1fs remaining\n",name,(int)(100LL*ndone/n),ndone,n,elapsed,elapsed*(n-ndone)/ndone);
+	}
+      }
+    });
+  const double elapsed=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+  printf("%s:  %d samples in %.1fs using %d threads (%.3fms per sample)\n",name,n,elapsed,std::max(1,std::min(nthreads,n)),n>0?1000*elapsed/n:0);
+  return;
+}
+
 void AnnularFieldSim::setFlatFields(float B, float E){
   //these only cover the roi, but since we address them flat, we don't need to know that here.
   printf("AnnularFieldSim::setFlatFields(B=%f Tesla,E=%f V/cm)\n",B,E);
@@ -2165,6 +2381,61 @@ TVector3 AnnularFieldSim::sum_phislice_field_at(int r,int phi, int z){
   return sum;
 }
 	    
+TVector3 AnnularFieldSim::sum_flat_field_at(int r,int phi, int z){
+  //same as sum_phislice_field_at and sum_full3d_field_at, but reading the flat float lookup (self-to-self terms already zeroed) and the charge in place.
+  //each z row is summed into nlane independent partial sums, which the compiler vectorizes without reordering any single sum.
+  //the partial sums are kept in double like the TVector3 sums they replace.
+  const int nsource=nr*nphi*nz;
+  const double *qflat=q->GetFlat(0);
+  const long long offset=(lookupCase==PhiSlice)
+    ?(long long)((r-rmin_roi)*nz_roi+(z-zmin_roi))*nsource
+    :(long long)(((r-rmin_roi)*nphi_roi+(phi-phimin_roi))*nz_roi+(z-zmin_roi))*nsource;
+  const float *lx=flat_lookup->e[0].data()+offset;
+  const float *ly=flat_lookup->e[1].data()+offset;
+  const float *lz=flat_lookup->e[2].data()+offset;
+
+  const int nlane=8;
+  double sumx[nlane]={0}, sumy[nlane]={0}, sumz[nlane]={0};
+  for (int ir=0;ir<nr;ir++){
+    for (int iphi=0;iphi<nphi;iphi++){
+      int lrow=(ir*nphi+iphi)*nz;
+      if (lookupCase==PhiSlice){
+	//the slice holds the field from sources at phi relative to the target.
+	int phirel=iphi-phi;
+	if (phirel<0) phirel+=nphi;
+	lrow=(ir*nphi+phirel)*nz;
+      }
+      const float *rx=lx+lrow, *ry=ly+lrow, *rz=lz+lrow;
+      const double *qrow=qflat+(ir*nphi+iphi)*nz;
+      int iz=0;
+      for (;iz+nlane<=nz;iz+=nlane){
+	for (int l=0;l<nlane;l++){
+	  sumx[l]+=rx[iz+l]*qrow[iz+l];
+	  sumy[l]+=ry[iz+l]*qrow[iz+l];
+	  sumz[l]+=rz[iz+l]*qrow[iz+l];
+	}
+      }
+      for (;iz<nz;iz++){
+	sumx[0]+=rx[iz]*qrow[iz];
+	sumy[0]+=ry[iz]*qrow[iz];
+	sumz[0]+=rz[iz]*qrow[iz];
+      }
+    }
+  }
+  TVector3 field(0,0,0);
+  for (int l=0;l<nlane;l++){
+    field+=TVector3(sumx[l],sumy[l],sumz[l]);
+  }
+
+  if (lookupCase==PhiSlice){
+    //every term has to be rotated by the same angle, so rotate the sum once:
+    TVector3 pos=GetRoiCellCenter(r-rmin_roi,phi-phimin_roi,z-zmin_roi);
+    TVector3 slicepos=GetRoiCellCenter(r-rmin_roi,0,z-zmin_roi);     
+    field.RotateZ(pos.Phi()-slicepos.Phi());
+  }
+  return field;
+}
+	    
 TVector3 AnnularFieldSim::swimToInAnalyticSteps(float zdest,TVector3 start,int steps=1, int *goodToStep=0){
   //assume coordinates are given in native units (cm=1 unless that changed!).
   double zdist=(zdest-start.Z())*cm;
@@ -2621,7 +2892,6 @@ void AnnularFieldSim::GenerateSeparateDistortionMaps(const char* filebase, int r
   
   TVector3 inpart,outpart;
   TVector3 diffdistort,distort;
-  int validToStep;
 
 
   //TTree version:
@@ -2644,13 +2914,9 @@ void AnnularFieldSim::GenerateSeparateDistortionMaps(const char* filebase, int r
 
   printf("generating separated distortion map with (%dx%dx%d) grid \n",nrh,nph,nzh);
   unsigned long long totalelements=nrh*nph*nzh;
-  unsigned long long percent=totalelements/100*debug_npercent;
   printf("total elements = %llu\n",totalelements);
 
 
-  int el=0;
-
-
 
   
   //we want to loop over the entire region to be mapped, but we also need to include
@@ -2660,6 +2926,9 @@ void AnnularFieldSim::GenerateSeparateDistortionMaps(const char* filebase, int r
   // normal.
 
   //note that we apply the adjustment to the particle position (inpart) and not the plotted position (partR etc)
+  //the positions are built serially, so they are bit-for-bit the same as when the drift was done in this loop:
+  std::vector<DistortionMapSample> samples;
+  samples.reserve(totalelements);
   inpart.SetXYZ(1,0,0);
   for (ir=0;ir<nrh;ir++){
     partR=(ir+0.5)*deltar+rih;
@@ -2684,17 +2953,45 @@ void AnnularFieldSim::GenerateSeparateDistortionMaps(const char* filebase, int r
 	  inpart.SetZ(partZ);
 	}
 	partZ+=0.5*deltaz; //move to center of histogram bin.
+	DistortionMapSample sample;
+	sample.ir=ir; sample.ip=ip; sample.iz=iz;
+	sample.partR=partR; sample.partP=partP; sample.partZ=partZ;
+	sample.inpart=inpart;
+	samples.push_back(sample);
+      }
+    }
+  }
+
+  //the drifts only read the fields, so the samples are independent and can be spread across threads:
+  RunDistortionSamples("generating separated distortions",samples.size(),[&](int i){
+      DistortionMapSample &sample=samples[i];
+      int validToStep;
+      for (int side=0;side<nSides;side++){
+	if (side==0){
+	  sample.diffdistort[side]=GetTotalDistortion(sample.inpart.Z()+deltaz,sample.inpart,nSteps,true, &validToStep);
+	  sample.distort[side]=GetTotalDistortion(z_readout,sample.inpart,nSteps,true, &validToStep);
+	} else{
+	  //if we have more than one side,
+	  //flip z coords and do the twin instead:
+	  TVector3 twinpart=sample.inpart;
+	  twinpart.SetZ(-1*twinpart.Z());//position to seek in sim
+	  sample.diffdistort[side]=twin->GetTotalDistortion(twinpart.Z()-deltaz,twinpart,nSteps,true, &validToStep);
+	  sample.distort[side]=twin->GetTotalDistortion(-z_readout,twinpart,nSteps,true, &validToStep);
+	}
+      }
+    });
+
+  //histograms are filled serially, in the original order, so the maps do not depend on the number of threads:
+  for (const DistortionMapSample &sample:samples){
+    ir=sample.ir; ip=sample.ip; iz=sample.iz;
+    partR=sample.partR; partP=sample.partP; partZ=sample.partZ;
+    inpart=sample.inpart;
 	for (int side=0;side<nSides;side++){
-	  if (side==0){
-	    diffdistort=GetTotalDistortion(inpart.Z()+deltaz,inpart,nSteps,true, &validToStep);
-	    distort=GetTotalDistortion(z_readout,inpart,nSteps,true, &validToStep);
-	  } else{
-	    //if we have more than one side,
-	    //flip z coords and do the twin instead:
+	  diffdistort=sample.diffdistort[side];
+	  distort=sample.distort[side];
+	  if (side==1){
 	    partZ*=-1;//position to place in histogram
 	    inpart.SetZ(-1*inpart.Z());//position to seek in sim
-	    diffdistort=twin->GetTotalDistortion(inpart.Z()-deltaz,inpart,nSteps,true, &validToStep);
-	    distort=twin->GetTotalDistortion(-z_readout,inpart,nSteps,true, &validToStep);
 	  }
 
 	  diffdistort.RotateZ(-inpart.Phi());//rotate so that distortion components are wrt the x axis
@@ -2720,7 +3017,6 @@ void AnnularFieldSim::GenerateSeparateDistortionMaps(const char* filebase, int r
 	    hSeparatedMapComponent[side][c]->Fill(partP,partR,partZ,distComp[c]);
 	  }
 	
-
 	  //recursive integral distortion:
 	  //get others working first!
 
@@ -2786,15 +3082,8 @@ void AnnularFieldSim::GenerateSeparateDistortionMaps(const char* filebase, int r
 
 	}
 
-	if(!(el%percent)) {printf("generating distortions %d%%:  ",(int)(debug_npercent*(el/percent)));
-	  printf("distortion at (ir=%d,ip=%d,iz=%d) is (%E,%E,%E)\n",
-		 ir,ip,iz,distortR,distortP,distortZ);
-	}
-	el++;
 	
 	}
-      }
-    }
   }
 
   TCanvas *canvas=new TCanvas("cdistort","distortion integrals",1200,800);
@@ -3098,7 +3387,6 @@ void AnnularFieldSim::GenerateDistortionMaps(const char* filebase, int r_subsamp
   
   TVector3 inpart,outpart;
   TVector3 distort;
-  int validToStep;
 
 
   //TTree version:
@@ -3121,13 +3409,9 @@ void AnnularFieldSim::GenerateDistortionMaps(const char* filebase, int r_subsamp
 
   printf("generating distortion map with (%dx%dx%d) grid \n",nrh,nph,nzh);
   unsigned long long totalelements=nrh*nph*nzh;
-  unsigned long long percent=totalelements/100*debug_npercent;
   printf("total elements = %llu\n",totalelements);
 
 
-  int el=0;
-
-
 
   
   //we want to loop over the entire region to be mapped, but we also need to include
@@ -3137,6 +3421,9 @@ void AnnularFieldSim::GenerateDistortionMaps(const char* filebase, int r_subsamp
   // normal.
 
   //note that we apply the adjustment to the particle position (inpart) and not the plotted position (partR etc)
+  //the positions are built serially, so they are bit-for-bit the same as when the drift was done in this loop:
+  std::vector<DistortionMapSample> samples;
+  samples.reserve(totalelements);
   inpart.SetXYZ(1,0,0);
   for (ir=0;ir<nrh;ir++){
     partR=(ir+0.5)*deltar+rih;
@@ -3161,16 +3448,45 @@ void AnnularFieldSim::GenerateDistortionMaps(const char* filebase, int r_subsamp
 	  inpart.SetZ(partZ);
 	}
 	partZ+=0.5*deltaz; //move to center of histogram bin.
+	DistortionMapSample sample;
+	sample.ir=ir; sample.ip=ip; sample.iz=iz;
+	sample.partR=partR; sample.partP=partP; sample.partZ=partZ;
+	sample.inpart=inpart;
+	samples.push_back(sample);
+      }
+    }
+  }
+
+  //the drifts only read the fields, so the samples are independent and can be spread across threads:
+  RunDistortionSamples("generating distortions",samples.size(),[&](int i){
+      DistortionMapSample &sample=samples[i];
+      const TVector3 &start=sample.inpart;
+      int validToStep;
+      //differential distortion:
+      if (hasTwin && start.Z()<0){
+	sample.diffdistort[0]=twin->GetTotalDistortion(start.Z(),start+stepzvec,nSteps,true, &validToStep);//step across the cell in the opposite direction, starting at the high side and going to the low side..
+      } else{
+	sample.diffdistort[0]=GetTotalDistortion(start.Z()+deltaz,start,nSteps,true, &validToStep);
+      }
+      //integral distortion:
+      if (hasTwin && makeUnifiedMap && start.Z()<0){		  
+	sample.distort[0]=twin->GetTotalDistortion(-z_readout,start+stepzvec,nSteps,true, &validToStep);
+      } else{
+	sample.distort[0]=GetTotalDistortion(z_readout,start,nSteps,true, &validToStep);
+      }
+    });
+
+  //histograms are filled serially, in the original order, so the maps do not depend on the number of threads:
+  for (const DistortionMapSample &sample:samples){
+    ir=sample.ir; ip=sample.ip; iz=sample.iz;
+    partR=sample.partR; partP=sample.partP; partZ=sample.partZ;
+    inpart=sample.inpart;
 
 	//printf("iz=%d, zcoord=%2.2f, bin=%d\n",iz,partZ,  hIntDist[0][0]->GetYaxis()->FindBin(partZ));
 
 	//differential distortion:
 	//be careful with the math of a distortion.  The R distortion is NOT the perp() component of outpart-inpart -- that's the transverse magnitude of the distortion!
-	if (hasTwin && inpart.Z()<0){
-	  distort=twin->GetTotalDistortion(inpart.Z(),inpart+stepzvec,nSteps,true, &validToStep);//step across the cell in the opposite direction, starting at the high side and going to the low side..
-	} else{
-	  distort=GetTotalDistortion(inpart.Z()+deltaz,inpart,nSteps,true, &validToStep);
-	}
+	distort=sample.diffdistort[0];
 	distort.RotateZ(-inpart.Phi());//rotate so that that is on the x axis
 	diffdistP=distort.Y();//the phi component is now the y component.
 	diffdistR=distort.X();//and the r component is the x component
@@ -3181,11 +3497,7 @@ void AnnularFieldSim::GenerateDistortionMaps(const char* filebase, int r_subsamp
 	dTree->Fill();
 
 	//integral distortion:
-	if (hasTwin && makeUnifiedMap && inpart.Z()<0){		  
-	distort=twin->GetTotalDistortion(-z_readout,inpart+stepzvec,nSteps,true, &validToStep);
-	} else{
-	distort=GetTotalDistortion(z_readout,inpart,nSteps,true, &validToStep);
-	}
+	distort=sample.distort[0];
 	distortX=distort.X();
 	distortY=distort.Y();
 	distort.RotateZ(-inpart.Phi());//rotate so that that is on the x axis
@@ -3258,14 +3570,7 @@ void AnnularFieldSim::GenerateDistortionMaps(const char* filebase, int r_subsamp
 
 	}
 
-	if(!(el%percent)) {printf("generating distortions %d%%:  ",(int)(debug_npercent*(el/percent)));
-	  printf("distortion at (ir=%d,ip=%d,iz=%d) is (%E,%E,%E)\n",
-		 ir,ip,iz,distortR,distortP,distortZ);
-	}
-	el++;
 	
-      }
-    }
   }
 
 
@@ -6,7 +6,10 @@
 #include <cmath>       // for NAN, abs
 #include <cstdio>      // for printf
 #include <cstdlib>     // for malloc
+#include <functional>   // for function
+#include <memory>       // for shared_ptr
 #include <string>       // for string
+#include <vector>       // for vector
 
 #include <cassert>
 
@@ -158,6 +161,16 @@ double langevin_T2 = NAN; //gas tensor drift terms.
   MultiArray<double> *q_lowres; //space charge in each l-bin. = sums over sets of f-bins.
 
   
+  //multithreading and flat (contiguous float) copy of the lookup used by the field summation:
+  //
+  int nthreads=1; //number of threads used to build the lookups and sum the fields.
+  struct FlatLookup{
+    bool valid=false; //whether the arrays match the current Epartial or Epartial_phislice content.
+    std::vector<float> e[3]; //x, y and z components of the PhiSlice or Full3D lookup, self-to-self terms zeroed, indexed [target][ir][iphi][iz]
+  };
+  std::shared_ptr<FlatLookup> flat_lookup=std::make_shared<FlatLookup>(); //shared with the sims borrowing our phislice lookup, so it is built once.
+
+  
   
 
 
@@ -189,6 +202,7 @@ debug_printActionEveryN=0; return;};
     } return false;};
   void SetDistortionScaleRPZ(float a, float b, float c){debug_distortionScale.SetXYZ(a,b,c); return;};
   void SetTruncationDistance(int x){truncation_length=x; return;}
+  void SetNumberOfThreads(int n){nthreads=(n<1)?1:n; return;}
 
   //getters for internal states:
   const char* GetLookupString();
@@ -234,9 +248,9 @@ debug_printActionEveryN=0; return;};
 
   void loadField(MultiArray<TVector3> **field, TTree *source, float *rptr, float *phiptr, float *zptr, float *frptr,  float *fphiptr,  float *fzptr, float fieldunit, int zsign);
   
-  void load_rossegger(double epsilon=1E-4){green=new Rossegger(rmin,rmax,zmax,epsilon); return;};
+  void load_rossegger(double epsilon=1E-4);
   void borrow_rossegger(Rossegger *ross, float zshift){green=ross; green_shift=zshift; return;};//get an already-existing rossegger table instead of loading it ourselves.
-  void borrow_epartial_from(AnnularFieldSim *sim, float zshift){Epartial_phislice=sim->Epartial_phislice; green_shift=zshift; return;};//get an already-existing rossegger table instead of loading it ourselves.
+  void borrow_epartial_from(AnnularFieldSim *sim, float zshift){Epartial_phislice=sim->Epartial_phislice; flat_lookup=sim->flat_lookup; green_shift=zshift; return;};//get an already-existing rossegger table instead of loading it ourselves.
   void set_twin(AnnularFieldSim * sim){twin=sim; hasTwin=true; return;};//define a twin to handle the negative-z drifting.  If asked to drift something out of range in z, if the twin flag is set we will ask the twin to do the drifting.  Note that the twin does not get linked back in to this side.  It is only the follower.
 
   
@@ -263,8 +277,12 @@ debug_printActionEveryN=0; return;};
   void  populate_lowres_lookup();
   void  populate_phislice_lookup();
 
-  void  load_phislice_lookup(const char* sourcefile);
-  void  save_phislice_lookup(const char* destfile);
+  void  load_phislice_lookup(const char* sourcefile); //files ending in '.bin' are read with the binary format below
+  void  save_phislice_lookup(const char* destfile); //files ending in '.bin' are written with the binary format below
+  bool  load_phislice_lookup_binary(const char* sourcefile); //returns false if the file is missing or its geometry does not match ours
+  void  save_phislice_lookup_binary(const char* destfile);
+  std::string GetPhisliceLookupCacheName(const std::string &dir="."); //binary lookup filename keyed by the grid geometry
+  void  build_flat_lookup();
 
   
   TVector3 sum_field_at(int r,int phi, int z);
@@ -272,6 +290,7 @@ debug_printActionEveryN=0; return;};
   TVector3 sum_local_field_at(int r,int phi, int z);
   TVector3 sum_nonlocal_field_at(int r,int phi, int z);
   TVector3 sum_phislice_field_at(int r, int phi, int z);
+  TVector3 sum_flat_field_at(int r, int phi, int z); //PhiSlice and Full3D summation over the flat lookup and the charge.  Thread-safe.
   TVector3 swimToInAnalyticSteps(float zdest,TVector3 start,int steps, int *goodToStep);
   TVector3 swimToInSteps(float zdest,TVector3 start, int steps, bool interpolate, int *goodToStep);
   TVector3 swimTo(float zdest,TVector3 start, bool interpolate=true, bool useAnalytic=false);
@@ -284,6 +303,9 @@ debug_printActionEveryN=0; return;};
   BoundsCase GetPhiIndexAndCheckBounds(float pos, int *phi);
   BoundsCase GetZindexAndCheckBounds(float pos, int *z);
 
+  void RunInThreads(int n, const std::function<void(int,int)> &func); //splits [0,n) into nthreads contiguous ranges and calls func(first,last) on each in its own thread.
+  void RunDistortionSamples(const char* name, int n, const std::function<void(int)> &func); //calls func(i) for each of n distortion map samples via RunInThreads, printing progress and timing.
+
   void UpdateOmegaTau(){omegatau_nominal=-Bnominal*vdrift/abs(Enominal);return;}; //various constants to match internal representation to the familiar formula.  Adding in these factors suggests I should switch to a unitful calculation throughout...
 
 
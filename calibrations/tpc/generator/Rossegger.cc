@@ -10,8 +10,10 @@
 #include <cassert>                                     // for assert
 #include <cmath>
 #include <cstdlib>                                     // for exit, abs
+#include <cstring>
 #include <iostream>
 #include <fstream>
+#include <mutex>
 #include <sstream>
 #include <string>
 
@@ -25,6 +27,22 @@ extern"C"{
 #include "TH2D.h"
 #include "TH3.h"
 
+namespace
+{
+  //dlia_ and dkia_ keep their state in fortran common blocks, which are shared by every Rossegger instance:
+  std::mutex fortran_mutex;
+
+  //header of the binary table files.  The magic string is bumped whenever the layout changes.
+  struct TableHeader
+  {
+    char magic[8];
+    int orders;
+    int nradii;
+    double a, b, L, epsilon;
+  };
+  const char tableMagic[8]={'R','O','S','S','T','A','B','1'};
+}
+
 using namespace std;
 using namespace TMath;
 //using namespace boost::math::special_functions
@@ -299,6 +317,48 @@ void Rossegger::PrecalcDerivedConstants(){ //Routine used to fill the arrays of
   return;
 }
 
+void Rossegger::PrecalcRadialTables(const std::vector<double> &radii){
+  //these depend on the geometry, the zeroes, and the radii we will be asked about.
+  std::vector<double> sorted(radii);
+  std::sort(sorted.begin(),sorted.end());
+  sorted.erase(std::unique(sorted.begin(),sorted.end()),sorted.end());
+  const int nradii=sorted.size();
+  const int size=nradii*NumberOfOrders*NumberOfOrders;
+  printf("Precalcing %d radial table entries for %d radii\n",6*size,nradii);
+
+  //clear the old tables first, so that the functions below evaluate rather than look up:
+  tableRadii.clear();
+  std::vector<double> rmn(size),rmn1(size),rmn2(size),rprime_a(size),rprime_b(size),rnk(size);
+  for (int ir=0;ir<nradii;ir++){
+    const double r=sorted[ir];
+    for (int i=0;i<NumberOfOrders;i++){
+      for (int j=0;j<NumberOfOrders;j++){
+	const int index=TableIndex(ir,i,j);
+	rmn[index]=Rmn(i,j,r);
+	rmn1[index]=Rmn1(i,j,r);
+	rmn2[index]=Rmn2(i,j,r);
+	rprime_a[index]=RPrime(i,j,a,r);
+	rprime_b[index]=RPrime(i,j,b,r);
+	rnk[index]=Rnk(i,j,r);
+      }
+    }
+  }
+  tRmn.swap(rmn);
+  tRmn1.swap(rmn1);
+  tRmn2.swap(rmn2);
+  tRPrime_a.swap(rprime_a);
+  tRPrime_b.swap(rprime_b);
+  tRnk.swap(rnk);
+  tableRadii.swap(sorted);
+  return;
+}
+
+int Rossegger::FindRadiusIndex(double r) const{
+  if (tableRadii.empty()) return -1;
+  auto it=std::lower_bound(tableRadii.begin(),tableRadii.end(),r-tableTolerance);
+  if (it==tableRadii.end() || *it>r+tableTolerance) return -1;
+  return it-tableRadii.begin();
+}
 
  double Rossegger::Limu(double mu, double x){
    //defined in Rossegger eqn 5.44, also a canonical 'satisfactory companion' to Kimu.
@@ -313,6 +373,7 @@ void Rossegger::PrecalcDerivedConstants(){ //Routine used to fill the arrays of
   int IERRO=0;
 
   double X=x;
+  std::lock_guard<std::mutex> lock(fortran_mutex);
   dlia_( &IFAC, &X, &A, &DLI, &DERR, &IERRO);
   return DLI;
  }
@@ -325,6 +386,7 @@ void Rossegger::PrecalcDerivedConstants(){ //Routine used to fill the arrays of
   int IERRO=0;
 
   double X=x;
+  std::lock_guard<std::mutex> lock(fortran_mutex);
   dkia_( &IFAC, &X, &A, &DKI, &DERR, &IERRO);
   return DKI;
  }
@@ -350,6 +412,9 @@ double Rossegger::Rmn(int m, int n, double r){
       return 0;
     }
 
+  int ir=FindRadiusIndex(r);
+  if (ir>=0) return tRmn[TableIndex(ir,m,n)];
+
   //  Calculate the function using C-libraries from boost
   //  Rossegger Equation 5.11:
   //         Rmn(r) = Ym(Beta_mn a)*Jm(Beta_mn r) - Jm(Beta_mn a)*Ym(Beta_mn r)
@@ -397,6 +462,9 @@ double Rossegger::Rmn1(int m, int n, double r)
       return 0;
     }
 
+  int ir=FindRadiusIndex(r);
+  if (ir>=0) return tRmn1[TableIndex(ir,m,n)];
+
   //  Calculate using the TMath functions from root.
   //  Rossegger Equation 5.32
   //         Rmn1(r) = Km(BetaN a)Im(BetaN r) - Im(BetaN a) Km(BetaN r)
@@ -442,6 +510,9 @@ double Rossegger::Rmn2(int m, int n, double r)
       return 0;
     }
 
+  int ir=FindRadiusIndex(r);
+  if (ir>=0) return tRmn2[TableIndex(ir,m,n)];
+
   //  Calculate using the TMath functions from root.
   //  Rossegger Equation 5.33
   //         Rmn2(r) = Km(BetaN b)Im(BetaN r) - Im(BetaN b) Km(BetaN r)
@@ -488,6 +559,11 @@ double Rossegger::RPrime(int m, int n, double ref, double r)
       return 0;
     }
 
+  //the field only ever needs the derivative with respect to the inner or outer radius:
+  int ir=FindRadiusIndex(r);
+  if (ir>=0 && ref==a) return tRPrime_a[TableIndex(ir,m,n)];
+  if (ir>=0 && ref==b) return tRPrime_b[TableIndex(ir,m,n)];
+
   double R=0;
   //  Calculate using the TMath functions from root.
   //  Rossegger Equation 5.65
@@ -571,6 +647,10 @@ double Rossegger::Rnk(int n, int k, double r)
       cout << "Invalid arguments Rnk("<<n<<","<<k<<","<<r<<")" << endl;;
       return 0;
     }
+
+  int ir=FindRadiusIndex(r);
+  if (ir>=0) return tRnk[TableIndex(ir,n,k)];
+
    //  Rossegger Equation 5.45
   //       Rnk(r) = Limu_nk (BetaN a) Kimu_nk (BetaN r) - Kimu_nk(BetaN a) Limu_nk (BetaN r)
 
@@ -990,6 +1070,79 @@ void  Rossegger::SaveZeroes(const char* destfile){
   return;
 }
 
+void  Rossegger::SaveTables(const char* destfile){
+  printf("saving rossegger zeroes and %d-radius tables to %s\n",(int)tableRadii.size(),destfile);
+  TableHeader header;
+  memcpy(header.magic,tableMagic,sizeof(tableMagic));
+  header.orders=NumberOfOrders;
+  header.nradii=tableRadii.size();
+  header.a=a; header.b=b; header.L=L; header.epsilon=epsilon;
+
+  const int nzeroes=NumberOfOrders*NumberOfOrders;
+  std::ofstream output(destfile,std::ios::binary);
+  output.write(reinterpret_cast<const char*>(&header),sizeof(header));
+  output.write(reinterpret_cast<const char*>(&Betamn[0][0]),nzeroes*sizeof(double));
+  output.write(reinterpret_cast<const char*>(&N2mn[0][0]),nzeroes*sizeof(double));
+  output.write(reinterpret_cast<const char*>(&Munk[0][0]),nzeroes*sizeof(double));
+  output.write(reinterpret_cast<const char*>(&N2nk[0][0]),nzeroes*sizeof(double));
+  output.write(reinterpret_cast<const char*>(tableRadii.data()),tableRadii.size()*sizeof(double));
+  for (const std::vector<double> *table:{&tRmn,&tRmn1,&tRmn2,&tRPrime_a,&tRPrime_b,&tRnk}){
+    output.write(reinterpret_cast<const char*>(table->data()),table->size()*sizeof(double));
+  }
+  if (!output) printf("error writing %s\n",destfile);
+  return;
+}
+
+bool  Rossegger::LoadTables(const char* sourcefile){
+  std::ifstream input(sourcefile,std::ios::binary);
+  if (!input){
+    printf("could not open %s\n",sourcefile);
+    return false;
+  }
+  TableHeader header;
+  input.read(reinterpret_cast<char*>(&header),sizeof(header));
+  if (!input || memcmp(header.magic,tableMagic,sizeof(tableMagic))!=0){
+    printf("%s is not a rossegger table file, or has an outdated format\n",sourcefile);
+    return false;
+  }
+  if (header.orders!=NumberOfOrders || header.a!=a || header.b!=b || header.L!=L){
+    printf("%s was made for orders=%d a=%f b=%f L=%f, not orders=%d a=%f b=%f L=%f\n",sourcefile,
+	   header.orders,header.a,header.b,header.L,NumberOfOrders,a,b,L);
+    return false;
+  }
+  printf("reading rossegger zeroes and %d-radius tables from %s\n",header.nradii,sourcefile);
+
+  //read everything before touching our own state, so a truncated file leaves us unchanged:
+  const int nzeroes=NumberOfOrders*NumberOfOrders;
+  const int size=header.nradii*nzeroes;
+  std::vector<double> zeroes(4*nzeroes);
+  std::vector<double> radii(header.nradii);
+  std::vector<double> tables(6*size);
+  input.read(reinterpret_cast<char*>(zeroes.data()),zeroes.size()*sizeof(double));
+  input.read(reinterpret_cast<char*>(radii.data()),radii.size()*sizeof(double));
+  input.read(reinterpret_cast<char*>(tables.data()),tables.size()*sizeof(double));
+  if (!input){
+    printf("%s is truncated\n",sourcefile);
+    return false;
+  }
+
+  epsilon=header.epsilon;
+  memcpy(&Betamn[0][0],zeroes.data(),nzeroes*sizeof(double));
+  memcpy(&N2mn[0][0],zeroes.data()+nzeroes,nzeroes*sizeof(double));
+  memcpy(&Munk[0][0],zeroes.data()+2*nzeroes,nzeroes*sizeof(double));
+  memcpy(&N2nk[0][0],zeroes.data()+3*nzeroes,nzeroes*sizeof(double));
+  PrecalcDerivedConstants();
+
+  tRmn.assign(tables.begin(),tables.begin()+size);
+  tRmn1.assign(tables.begin()+size,tables.begin()+2*size);
+  tRmn2.assign(tables.begin()+2*size,tables.begin()+3*size);
+  tRPrime_a.assign(tables.begin()+3*size,tables.begin()+4*size);
+  tRPrime_b.assign(tables.begin()+4*size,tables.begin()+5*size);
+  tRnk.assign(tables.begin()+5*size,tables.end());
+  tableRadii.swap(radii);
+  return true;
+}
+
 void  Rossegger::LoadZeroes(const char* destfile){
   TFile *f=TFile::Open(destfile,"READ");
   printf("reading rossegger zeroes from %s\n",destfile);
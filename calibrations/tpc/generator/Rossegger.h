@@ -22,6 +22,7 @@
 #include <cstdio>
 #include <string>
 #include <map>
+#include <vector>
 
 class TH2;
 class TH3;
@@ -52,6 +53,14 @@ class Rossegger
   double Er  (double r, double phi, double z, double r1, double phi1, double z1);
   double Ephi(double r, double phi, double z, double r1, double phi1, double z1);
 
+  //tabulation of the radial functions at a fixed set of radii, typically the cell centers of a field grid.
+  //once tabulated, Rmn, Rmn1, Rmn2, RPrime (at a and b) and Rnk at those radii, and hence Er, Ephi and Ez, are table lookups.
+  //other radii are still evaluated directly.  Evaluation is thread-safe either way, but only lookups run concurrently.
+  void PrecalcRadialTables(const std::vector<double> &radii);
+  bool HasRadialTables() const {return !tableRadii.empty();}
+  void SaveTables(const char* destfile); //binary file with the zeroes, their norms, and the radial tables
+  bool LoadTables(const char* sourcefile); //returns false if the file is missing or was made for a different geometry
+
   //alternate versions that don't use precalc constants.
    double Rmn_ (int m, int n, double r);  //Rmn function from Rossegger
    //Rmn_for_zeroes doesn't have a way to speed it up with precalcs.
@@ -115,6 +124,18 @@ class Rossegger
   double sinh_Betamn_L[NumberOfOrders][NumberOfOrders]; //sinh(Betamn[m][n]*L)  as in Rossegger 5.64
   double sinh_pi_Munk[NumberOfOrders][NumberOfOrders]; //sinh(pi*Munk[n][k]) as in Rossegger 5.66
 
+  //radial tables, indexed by TableIndex(radius index, m or n, n or k):
+  int FindRadiusIndex(double r) const; //-1 if r is not one of the tabulated radii
+  int TableIndex(int ir, int i, int j) const {return (ir*NumberOfOrders+i)*NumberOfOrders+j;}
+  double tableTolerance = 1E-6; //how close r needs to be to a tabulated radius to use it, to allow for rounding in the caller.
+  std::vector<double> tableRadii; //sorted
+  std::vector<double> tRmn;  //Rmn(m,n,r)
+  std::vector<double> tRmn1; //Rmn1(m,n,r)
+  std::vector<double> tRmn2; //Rmn2(m,n,r)
+  std::vector<double> tRPrime_a; //RPrime(m,n,a,r)
+  std::vector<double> tRPrime_b; //RPrime(m,n,b,r)
+  std::vector<double> tRnk;  //Rnk(n,k,r)
+
   TH2 *Tags = nullptr;
   std::map<std::string, TH3*> Grid;
 
@@ -30,10 +30,13 @@
 #include <CLHEP/Random/RandFlat.h>
 #include <CLHEP/Vector/LorentzVector.h>
 
+#include <algorithm>  // for find
+#include <array>
 #include <cmath>
 #include <cstdlib>  // for exit
 #include <iostream>
 #include <map>  // for map
+#include <vector>
 
 namespace CLHEP
 {
@@ -205,20 +208,11 @@ void custom_vn(double /*b*/, double /*eta*/, double /*pt*/)
   v6 = 0.0015;
 }
 
-double
-AddFlowToParent(HepMC::GenEvent *event, HepMC::GenParticle *parent)
+namespace
+{
+// Set the vn values for a given particle, using the selected algorithm
+void calc_vn(double b, double eta, double pt)
 {
-  CLHEP::HepLorentzVector momentum(parent->momentum().px(),
-                                   parent->momentum().py(),
-                                   parent->momentum().pz(),
-                                   parent->momentum().e());
-  double pt = momentum.perp();
-  double eta = momentum.pseudoRapidity();
-  double phi_0 = momentum.phi();
-
-  HepMC::HeavyIon *hi = event->heavy_ion();
-  double b = hi->impact_parameter();
-
   v1 = 0, v2 = 0, v3 = 0, v4 = 0, v5 = 0, v6 = 0;
 
   //Call the appropriate function to set the vn values
@@ -234,11 +228,13 @@ AddFlowToParent(HepMC::GenEvent *event, HepMC::GenParticle *parent)
   {
     custom_vn(b, eta, pt);
   }
+}
 
-  double phishift = 0;
-
-  const gsl_root_fsolver_type *T = gsl_root_fsolver_brent;
-  gsl_root_fsolver *s = gsl_root_fsolver_alloc(T);
+// Solve for the flow shifted azimuth phi of a particle with initial azimuth phi_0,
+// using the current vn values and a Brent root finder bracketed in [-2pi, 2pi].
+// Returns false if not converged.
+bool solve_brent(gsl_root_fsolver *s, double phi_0, double &phi, double precision)
+{
   double x_lo = -2 * M_PI, x_hi = 2 * M_PI;
   float params[13];
   for (int ipar = 0; ipar < 13; ipar++)
@@ -264,7 +260,6 @@ AddFlowToParent(HepMC::GenEvent *event, HepMC::GenParticle *parent)
   params[11] = psi_n[4];
   params[12] = psi_n[5];
   int status;
-  double phi;
   do
   {
     iter++;
@@ -272,11 +267,37 @@ AddFlowToParent(HepMC::GenEvent *event, HepMC::GenParticle *parent)
     phi = gsl_root_fsolver_root(s);
     x_lo = gsl_root_fsolver_x_lower(s);
     x_hi = gsl_root_fsolver_x_upper(s);
-    status = gsl_root_test_interval(x_lo, x_hi, 0, 0.00001);
+    status = gsl_root_test_interval(x_lo, x_hi, 0, precision);
   } while (status == GSL_CONTINUE && iter < 1000);
+
+  return iter < 1000;
+}
+}  // namespace
+
+double
+AddFlowToParent(HepMC::GenEvent *event, HepMC::GenParticle *parent, double precision)
+{
+  CLHEP::HepLorentzVector momentum(parent->momentum().px(),
+                                   parent->momentum().py(),
+                                   parent->momentum().pz(),
+                                   parent->momentum().e());
+  double pt = momentum.perp();
+  double eta = momentum.pseudoRapidity();
+  double phi_0 = momentum.phi();
+
+  HepMC::HeavyIon *hi = event->heavy_ion();
+  double b = hi->impact_parameter();
+
+  calc_vn(b, eta, pt);
+
+  double phishift = 0;
+
+  gsl_root_fsolver *s = gsl_root_fsolver_alloc(gsl_root_fsolver_brent);
+  double phi;
+  const bool found = solve_brent(s, phi_0, phi, precision);
   gsl_root_fsolver_free(s);
 
-  if (iter >= 1000)
+  if (!found)
     return 0;
 
   phishift = phi - phi_0;
@@ -290,11 +311,206 @@ AddFlowToParent(HepMC::GenEvent *event, HepMC::GenParticle *parent)
   return phishift;
 }
 
+namespace
+{
+// Preallocated state for the batched solver. Per-particle quantities are
+// stored as arrays indexed by particle, so that the solver loops vectorize,
+// and are reused from one event to the next
+struct BatchState
+{
+  std::vector<HepMC::GenParticle *> particles;
+  std::vector<double> phi_0;
+  std::vector<double> phi;
+  std::array<std::vector<double>, 6> vn;
+
+  // 0: active, 1: converged, 2: needs the Brent fallback
+  std::vector<unsigned char> status;
+
+  // Brent solver, allocated once, for particles where the iteration fails
+  gsl_root_fsolver *fallback = nullptr;
+
+  // descendant vertices to visit, and already visited
+  std::vector<HepMC::GenVertex *> stack;
+  std::vector<HepMC::GenVertex *> visited;
+
+  ~BatchState()
+  {
+    if (fallback) gsl_root_fsolver_free(fallback);
+  }
+};
+
+BatchState batch;
+
+// Solve all particles stored in batch together with a Halley iteration,
+// starting from the unshifted azimuth. The harmonics are obtained from a
+// single sin/cos per particle and iteration, using
+//   sin(n(x-psi_n)) = sin(nx)cos(n psi_n) - cos(nx)sin(n psi_n)
+// and the Chebyshev recursion for sin(nx), cos(nx).
+// Particles for which the iteration does not converge, or the flow modulated
+// CDF is not monotonic, are flagged for the Brent fallback
+void solve_batch(double precision)
+{
+  static constexpr int max_iterations = 20;
+
+  const size_t n = batch.particles.size();
+  double cos_npsi[6], sin_npsi[6];
+  for (int k = 0; k < 6; k++)
+  {
+    cos_npsi[k] = cos((k + 1) * psi_n[k]);
+    sin_npsi[k] = sin((k + 1) * psi_n[k]);
+  }
+
+  const double *phi_0 = batch.phi_0.data();
+  double *phi = batch.phi.data();
+  unsigned char *status = batch.status.data();
+  const double *vn[6];
+  for (int k = 0; k < 6; k++)
+  {
+    vn[k] = batch.vn[k].data();
+  }
+
+  for (size_t i = 0; i < n; i++)
+  {
+    phi[i] = phi_0[i];
+    status[i] = 0;
+  }
+
+  size_t nactive = n;
+  for (int iter = 0; iter < max_iterations && nactive > 0; iter++)
+  {
+    nactive = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+      if (status[i]) continue;
+
+      const double x = phi[i];
+      const double sin_x = sin(x);
+      const double cos_x = cos(x);
+
+      double f = x - phi_0[i];
+      double df = 1;
+      double d2f = 0;
+      double sin_kx = sin_x;
+      double cos_kx = cos_x;
+      for (int k = 0; k < 6; k++)
+      {
+        const double sin_k = sin_kx * cos_npsi[k] - cos_kx * sin_npsi[k];
+        const double cos_k = cos_kx * cos_npsi[k] + sin_kx * sin_npsi[k];
+        f += 2 * vn[k][i] * sin_k / (k + 1);
+        df += 2 * vn[k][i] * cos_k;
+        d2f -= 2 * (k + 1) * vn[k][i] * sin_k;
+
+        const double sin_next = sin_kx * cos_x + cos_kx * sin_x;
+        cos_kx = cos_kx * cos_x - sin_kx * sin_x;
+        sin_kx = sin_next;
+      }
+
+      const double denominator = 2 * df * df - f * d2f;
+      if (df <= 0 || denominator <= 0)
+      {
+        status[i] = 2;
+        continue;
+      }
+
+      const double dx = 2 * f * df / denominator;
+      phi[i] = x - dx;
+      if (fabs(dx) < precision)
+      {
+        status[i] = 1;
+      }
+      else if (fabs(phi[i]) > 2 * M_PI)
+      {
+        status[i] = 2;
+      }
+      else
+      {
+        ++nactive;
+      }
+    }
+  }
+
+  // Brent fallback for remaining particles, using the same bracket as the reference implementation
+  for (size_t i = 0; i < n; i++)
+  {
+    if (status[i] == 1) continue;
+    if (!batch.fallback) batch.fallback = gsl_root_fsolver_alloc(gsl_root_fsolver_brent);
+
+    v1 = vn[0][i], v2 = vn[1][i], v3 = vn[2][i], v4 = vn[3][i], v5 = vn[4][i], v6 = vn[5][i];
+    if (!solve_brent(batch.fallback, phi_0[i], phi[i], precision))
+    {
+      // no shift, as in AddFlowToParent
+      phi[i] = phi_0[i];
+    }
+  }
+}
+
+// Rotate a particle and the branch of its descendant vertices and particles by phishift.
+// The branch is walked with an explicit stack, and vertices reached through
+// several particles are only rotated once
+void RotateWithDescendants(HepMC::GenParticle *parent, double phishift)
+{
+  if (fabs(phishift) <= 1e-7)
+  {
+    return;
+  }
+
+  const double cos_shift = cos(phishift);
+  const double sin_shift = sin(phishift);
+  auto rotate_momentum = [cos_shift, sin_shift](HepMC::GenParticle *particle) {
+    const HepMC::FourVector &momentum = particle->momentum();
+    particle->set_momentum(HepMC::FourVector(cos_shift * momentum.px() - sin_shift * momentum.py(),
+                                             sin_shift * momentum.px() + cos_shift * momentum.py(),
+                                             momentum.pz(), momentum.e()));
+  };
+
+  rotate_momentum(parent);
+
+  HepMC::GenVertex *endvtx = parent->end_vertex();
+  if (!endvtx)
+  {
+    return;
+  }
+
+  batch.stack.clear();
+  batch.visited.clear();
+  batch.stack.push_back(endvtx);
+  batch.visited.push_back(endvtx);
+  while (!batch.stack.empty())
+  {
+    HepMC::GenVertex *descvtx = batch.stack.back();
+    batch.stack.pop_back();
+
+    const HepMC::FourVector &position = descvtx->position();
+    descvtx->set_position(HepMC::FourVector(cos_shift * position.x() - sin_shift * position.y(),
+                                            sin_shift * position.x() + cos_shift * position.y(),
+                                            position.z(), position.t()));
+
+    for (HepMC::GenVertex::particles_out_const_iterator descpartit = descvtx->particles_out_const_begin();
+         descpartit != descvtx->particles_out_const_end();
+         ++descpartit)
+    {
+      HepMC::GenParticle *descpart = (*descpartit);
+      rotate_momentum(descpart);
+
+      // decay trees are small, a linear search is cheaper than a set
+      HepMC::GenVertex *nextvtx = descpart->end_vertex();
+      if (nextvtx && std::find(batch.visited.begin(), batch.visited.end(), nextvtx) == batch.visited.end())
+      {
+        batch.visited.push_back(nextvtx);
+        batch.stack.push_back(nextvtx);
+      }
+    }
+  }
+}
+}  // namespace
+
 int flowAfterburner(HepMC::GenEvent *event,
                     CLHEP::HepRandomEngine *engine,
                     std::string algorithmName,
                     float mineta, float maxeta,
-                    float minpt, float maxpt)
+                    float minpt, float maxpt,
+                    double precision,
+                    flowAfterburnerSolver solver)
 {
   algorithm = algorithms[algorithmName];
   HepMC::HeavyIon *hi = event->heavy_ion();
@@ -319,6 +535,14 @@ int flowAfterburner(HepMC::GenEvent *event,
 
   HepMC::GenVertex *mainvtx = event->barcode_to_vertex(-1);
 
+  // reset batch, keeping the allocated memory
+  batch.particles.clear();
+  batch.phi_0.clear();
+  for (auto &vn : batch.vn)
+  {
+    vn.clear();
+  }
+
   // Loop over all children of this vertex
   HepMC::GenVertexParticleRange r(*mainvtx, HepMC::children);
 
@@ -350,9 +574,36 @@ int flowAfterburner(HepMC::GenEvent *event,
       continue;
     }
 
-    // Add flow to particles from main vertex
-    double phishift = AddFlowToParent(event, parent);
-    MoveDescendantsToParent(parent, phishift);
+    if (solver == gsl_solver)
+    {
+      // Add flow to particles from main vertex
+      double phishift = AddFlowToParent(event, parent, precision);
+      MoveDescendantsToParent(parent, phishift);
+      continue;
+    }
+
+    // store particle for the batched solver
+    const double b = hi->impact_parameter();
+    calc_vn(b, momentum.pseudoRapidity(), momentum.perp());
+    batch.particles.push_back(parent);
+    batch.phi_0.push_back(momentum.phi());
+    batch.vn[0].push_back(v1);
+    batch.vn[1].push_back(v2);
+    batch.vn[2].push_back(v3);
+    batch.vn[3].push_back(v4);
+    batch.vn[4].push_back(v5);
+    batch.vn[5].push_back(v6);
+  }
+
+  if (solver == batched_solver)
+  {
+    batch.phi.resize(batch.particles.size());
+    batch.status.resize(batch.particles.size());
+    solve_batch(precision);
+    for (size_t i = 0; i < batch.particles.size(); i++)
+    {
+      RotateWithDescendants(batch.particles[i], batch.phi[i] - batch.phi_0[i]);
+    }
   }
 
   return 0;
@@ -19,10 +19,25 @@ enum flowAfterburnerAlgorithm
   custom_algorithm
 };
 
+//! root finder used to solve for the flow shifted azimuth
+enum flowAfterburnerSolver
+{
+  //! one GSL Brent solver per particle (reference implementation)
+  gsl_solver,
+
+  //! all particles of the event solved together with a Halley iteration, Brent fallback if not converged (opt-in)
+  batched_solver
+};
+
+//! default precision on the shifted azimuth (rad)
+static constexpr double flowAfterburnerDefaultPrecision = 1e-5;
+
 int flowAfterburner(HepMC::GenEvent *inEvent,
                     CLHEP::HepRandomEngine *engine,
                     std::string algorithmName,
                     float mineta, float maxeta,
-                    float minpt, float maxpt);
+                    float minpt, float maxpt,
+                    double precision = flowAfterburnerDefaultPrecision,
+                    flowAfterburnerSolver solver = gsl_solver);
 
 #endif
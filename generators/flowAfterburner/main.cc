@@ -67,6 +67,10 @@ int main()
 
   std::string algorithmName = pt.get("FLOWAFTERBURNER.ALGORITHM", "MINBIAS");
 
+  double precision = pt.get("FLOWAFTERBURNER.PRECISION", flowAfterburnerDefaultPrecision);
+  std::string solverName = pt.get("FLOWAFTERBURNER.SOLVER", "GSL");
+  flowAfterburnerSolver solver = (solverName == "BATCHED") ? batched_solver : gsl_solver;
+
   // Open input file.
   HepMC::IO_GenEvent ascii_in(input.c_str(), std::ios::in);
   HepMC::IO_GenEvent ascii_out(output.c_str(), std::ios::out);
@@ -74,7 +78,7 @@ int main()
 
   while (ascii_in >> evt)
   {
-    flowAfterburner(evt, engine, algorithmName, mineta, maxeta, minpt, maxpt);
+    flowAfterburner(evt, engine, algorithmName, mineta, maxeta, minpt, maxpt, precision, solver);
 
     ascii_out << evt;
     delete evt;
@@ -1,6 +1,8 @@
 //
 // Inspired by code from ATLAS.  Thanks!
 //
+#include "flowAfterburner.h"
+
 #include <HepMC/GenEvent.h>
 #include <HepMC/GenParticle.h>
 #include <HepMC/GenRanges.h>
@@ -11,6 +13,8 @@
 #include <HepMC/IteratorRange.h>
 #include <HepMC/SimpleVector.h>
 
+#include <CLHEP/Random/MTwistEngine.h>
+
 // this is an ugly hack, the gcc optimizer has a bug which
 // triggers the uninitialized variable warning which
 // stops compilation because of our -Werror
@@ -52,6 +56,11 @@ int main()
 
   std::string input = proptree.get("TEST.INPUT", "test.dat");
 
+  // regression test of the batched solver against the GSL one
+  std::string algorithmName = proptree.get("TEST.ALGORITHM", "MINBIAS");
+  double precision = proptree.get("TEST.PRECISION", flowAfterburnerDefaultPrecision);
+  double max_deviation = 0;
+
   // Try to open input file.
   std::ifstream istr(input.c_str());
   if (!istr)
@@ -86,6 +95,24 @@ int main()
     HepMC::GenVertex *primary_vtx = evt->barcode_to_vertex(-1);
     double phi0 = hi->event_plane_angle();
 
+    // apply the afterburner on copies of the event, with identical random sequences,
+    // and compare the particle azimuths
+    {
+      HepMC::GenEvent gsl_evt(*evt);
+      HepMC::GenEvent batched_evt(*evt);
+      CLHEP::MTwistEngine gsl_engine(evt->event_number());
+      CLHEP::MTwistEngine batched_engine(evt->event_number());
+      flowAfterburner(&gsl_evt, &gsl_engine, algorithmName, -5, 5, 0, 100, precision, gsl_solver);
+      flowAfterburner(&batched_evt, &batched_engine, algorithmName, -5, 5, 0, 100, precision, batched_solver);
+      for (HepMC::GenEvent::particle_const_iterator it = gsl_evt.particles_begin(); it != gsl_evt.particles_end(); ++it)
+      {
+        HepMC::GenParticle *batched = batched_evt.barcode_to_particle((*it)->barcode());
+        double dphi = batched->momentum().phi() - (*it)->momentum().phi();
+        dphi = atan2(sin(dphi), cos(dphi));
+        max_deviation = std::max(max_deviation, fabs(dphi));
+      }
+    }
+
     HepMC::GenVertexParticleRange r(*primary_vtx, HepMC::children);
     for (HepMC::GenVertex::particle_iterator it = r.begin(); it != r.end(); it++)
     {
@@ -129,5 +156,13 @@ int main()
     std::cout << pt << ", " << val << ", " << err << std::endl;
   }
 
+  std::cout << "batched vs gsl solver, max azimuth deviation: " << max_deviation
+            << ", precision: " << precision << std::endl;
+  if (max_deviation > 2 * precision)
+  {
+    std::cout << __PRETTY_FUNCTION__ << ": batched solver does not match the gsl solver" << std::endl;
+    return 1;
+  }
+
   return 0;
 }
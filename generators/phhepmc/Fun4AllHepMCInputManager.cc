@@ -1,5 +1,6 @@
 #include "Fun4AllHepMCInputManager.h"
 
+#include "HepMCParallelReader.h"
 #include "PHHepMCGenEvent.h"
 #include "PHHepMCGenEventMap.h"
 
@@ -19,11 +20,7 @@
 #include <phool/recoConsts.h>
 
 #include <HepMC/GenEvent.h>
-#include <HepMC/GenParticle.h>  // for GenParticle
-#include <HepMC/GenVertex.h>    // for GenVertex
 #include <HepMC/IO_GenEvent.h>
-#include <HepMC/SimpleVector.h>  // for FourVector
-#include <HepMC/Units.h>         // for CM, GEV
 
 #include <TDirectory.h>
 #include <TPRegexp.h>
@@ -34,16 +31,12 @@
 #include <boost/iostreams/filter/bzip2.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
 
-#include <cmath>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <map>  // for _Rb_tree_it...
-#include <sstream>
 #include <vector>  // for vector
 
-static const double toMM = 1.e-12;
-
 Fun4AllHepMCInputManager::Fun4AllHepMCInputManager(const std::string &name, const std::string &nodename, const std::string &topnodename)
   : Fun4AllInputManager(name, nodename, topnodename)
   , topNodeName(topnodename)
@@ -103,7 +96,12 @@ int Fun4AllHepMCInputManager::fileopen(const std::string &filenam)
     std::cout << Name() << ": opening file " << fname << std::endl;
   }
 
-  if (m_ReadOscarFlag)
+  if (m_ParallelReadThreads > 0)
+  {
+    m_ParallelReader.reset(new HepMCParallelReader(fname, m_ReadOscarFlag ? HepMCParallelReader::kOscar : HepMCParallelReader::kHepMC, m_ParallelReadThreads, m_ParallelReadQueueSize));
+    m_ParallelReader->Verbosity(Verbosity());
+  }
+  else if (m_ReadOscarFlag)
   {
     theOscarFile.open(fname);
   }
@@ -188,19 +186,12 @@ int Fun4AllHepMCInputManager::run(const int /*nevents*/)
     }
     else
     {
-      if (m_ReadOscarFlag)
-      {
-        evt = ConvertFromOscar();
-      }
-      else
-      {
-        evt = ascii_in->read_next_event();
-      }
+      evt = ReadNextEvent();
     }
 
     if (!evt)
     {
-      if (Verbosity() > 1)
+      if (Verbosity() > 1 && ascii_in)
       {
         std::cout << "Fun4AllHepMCInputManager::run::" << Name()
                   << ": error type: " << ascii_in->error_type()
@@ -254,7 +245,11 @@ int Fun4AllHepMCInputManager::fileclose()
     std::cout << Name() << ": fileclose: No Input file open" << std::endl;
     return -1;
   }
-  if (m_ReadOscarFlag)
+  if (m_ParallelReader)
+  {
+    m_ParallelReader.reset();
+  }
+  else if (m_ReadOscarFlag)
   {
     theOscarFile.close();
   }
@@ -326,12 +321,15 @@ int Fun4AllHepMCInputManager::PushBackEvents(const int i)
   int errorflag = 0;
   while (nevents > 0 && !errorflag)
   {
-    evt = ascii_in->read_next_event();
+    evt = ReadNextEvent();
     if (!evt)
     {
       std::cout << "Error after skipping " << i - nevents << std::endl;
-      std::cout << "error type: " << ascii_in->error_type()
-                << ", rdstate: " << ascii_in->rdstate() << std::endl;
+      if (ascii_in)
+      {
+        std::cout << "error type: " << ascii_in->error_type()
+                  << ", rdstate: " << ascii_in->rdstate() << std::endl;
+      }
       errorflag = -1;
       fileclose();
     }
@@ -358,64 +356,13 @@ Fun4AllHepMCInputManager::ConvertFromOscar()
   }
 
   delete evt;
-  //use PHENIX unit
-  evt = new HepMC::GenEvent(HepMC::Units::GEV, HepMC::Units::CM);
 
   if (Verbosity() > 1) std::cout << "Reading Oscar Event " << events_total << std::endl;
-  //Grab New Event From Oscar
-  std::string theLine;
-  std::vector<std::vector<double> > theEventVec;
-  std::vector<HepMC::FourVector> theVtxVec;
-  while (getline(theOscarFile, theLine))
-  {
-    if (theLine.compare(0, 1, "#") == 0) continue;
-    std::vector<double> theInfo;  //format: N,pid,px,py,pz,E,mass,xvtx,yvtx,zvtx,?
-    double number = NAN;
-    for (std::istringstream numbers_iss(theLine); numbers_iss >> number;)
-    {
-      theInfo.push_back(number);
-    }
-
-    if (theInfo.size() == 2 && theInfo[0] == 0 && theInfo[1] == 0)
-    {
-      break;
-    }
-    else if (theInfo.size() == 2 && theInfo[0] == 0 && theInfo[1] > 0)
-    {
-      continue;
-    }
-    else
-    {
-      theEventVec.push_back(theInfo);
-      HepMC::FourVector vert(theInfo[8] * toMM, theInfo[9] * toMM, theInfo[10] * toMM, theInfo[11]);
-      theVtxVec.push_back(vert);
-    }
-
-  }  //while(getline)
+  evt = HepMCParallelReader::read_oscar_event(theOscarFile);
 
   //Set Event Number
   evt->set_event_number(events_total);
 
-  //Loop Over One Event, Fill HepMC
-  for (unsigned int i = 0; i < theEventVec.size(); i++)
-  {
-    //int N = (int)theEventVec[i][0];
-    int pid = (int) theEventVec[i][1];
-    double px = theEventVec[i][3];
-    double py = theEventVec[i][4];
-    double pz = theEventVec[i][5];
-    double E = theEventVec[i][6];
-    double m = theEventVec[i][7];
-    int status = 1;  //oscar only writes final state particles
-
-    HepMC::GenVertex *v = new HepMC::GenVertex(theVtxVec[i]);
-    evt->add_vertex(v);
-
-    HepMC::GenParticle *p = new HepMC::GenParticle(HepMC::FourVector(px, py, pz, E), pid, status);
-    p->setGeneratedMass(m);
-    p->suggest_barcode(i + 1);
-    v->add_particle_out(p);
-  }
   if (Verbosity() > 3)
   {
     evt->print();
@@ -423,6 +370,24 @@ Fun4AllHepMCInputManager::ConvertFromOscar()
   return evt;
 }
 
+HepMC::GenEvent *Fun4AllHepMCInputManager::ReadNextEvent()
+{
+  if (m_ParallelReader)
+  {
+    HepMC::GenEvent *newevt = m_ParallelReader->read_next_event();
+    if (newevt && m_ReadOscarFlag)
+    {
+      newevt->set_event_number(events_total);
+    }
+    return newevt;
+  }
+  if (m_ReadOscarFlag)
+  {
+    return ConvertFromOscar();
+  }
+  return ascii_in->read_next_event();
+}
+
 int Fun4AllHepMCInputManager::ResetEvent()
 {
   m_MyEvent.clear();
@@ -9,10 +9,12 @@
 #include <boost/iostreams/filtering_streambuf.hpp>
 
 #include <fstream>
+#include <memory>
 #include <string>
 #include <utility>  // for swap
 #include <vector>
 
+class HepMCParallelReader;
 class PHCompositeNode;
 class SyncObject;
 
@@ -34,6 +36,14 @@ class Fun4AllHepMCInputManager : public Fun4AllInputManager, public PHHepMCGenHe
   int ResetEvent() override;
   void ReadOscar(const int i) { m_ReadOscarFlag = i; }
   int ReadOscar() const { return m_ReadOscarFlag; }
+
+  //! decompress and parse input files with background threads. nthreads is the number of parser threads, 0 (default) reads sequentially
+  /*! queue_size is the maximum number of events read ahead. Applies to files opened afterwards */
+  void ParallelRead(const unsigned int nthreads, const unsigned int queue_size = 100)
+  {
+    m_ParallelReadThreads = nthreads;
+    m_ParallelReadQueueSize = queue_size;
+  }
   void Print(const std::string &what = "ALL") const override;
   int PushBackEvents(const int i) override;
 
@@ -48,6 +58,9 @@ class Fun4AllHepMCInputManager : public Fun4AllInputManager, public PHHepMCGenHe
   int MyCurrentEvent(const unsigned int index = 0) const;
 
  protected:
+  //! next event from the current file, from either the HepMC or Oscar reader. Caller takes ownership
+  HepMC::GenEvent *ReadNextEvent();
+
   HepMC::GenEvent *evt = nullptr;
 
   int events_total = 0;
@@ -56,6 +69,9 @@ class Fun4AllHepMCInputManager : public Fun4AllInputManager, public PHHepMCGenHe
 
   HepMC::IO_GenEvent *ascii_in = nullptr;
 
+  //! threaded reader, used instead of ascii_in or the Oscar file, if enabled
+  std::unique_ptr<HepMCParallelReader> m_ParallelReader;
+
   std::string m_HepMCTmpFile;
 
  private:
@@ -67,6 +83,9 @@ class Fun4AllHepMCInputManager : public Fun4AllInputManager, public PHHepMCGenHe
 
   int m_ReadOscarFlag = 0;
 
+  unsigned int m_ParallelReadThreads = 0;
+  unsigned int m_ParallelReadQueueSize = 100;
+
   std::vector<int> m_MyEvent;
 
   boost::iostreams::filtering_streambuf<boost::iostreams::input> zinbuffer;
@@ -43,6 +43,8 @@ HepMCFlowAfterBurner::HepMCFlowAfterBurner(const std::string &name)
   , maxeta(4)
   , minpt(0.)
   , maxpt(100.)
+  , precision(flowAfterburnerDefaultPrecision)
+  , use_gsl_solver(true)
   , seedset(0)
   , seed(0)
   , randomSeed(11793)
@@ -83,9 +85,11 @@ int HepMCFlowAfterBurner::process_event(PHCompositeNode *topNode)
       cout << "calling flowAfterburner with algorithm "
            << algorithmName << ", mineta " << mineta
            << ", maxeta: " << maxeta << ", minpt: " << minpt
-           << ", maxpt: " << maxpt << endl;
+           << ", maxpt: " << maxpt << ", precision: " << precision
+           << (use_gsl_solver ? ", gsl solver" : ", batched solver") << endl;
     }
-    flowAfterburner(evt, engine, algorithmName, mineta, maxeta, minpt, maxpt);
+    flowAfterburner(evt, engine, algorithmName, mineta, maxeta, minpt, maxpt,
+                    precision, use_gsl_solver ? gsl_solver : batched_solver);
   }
   return Fun4AllReturnCodes::EVENT_OK;
 }
@@ -131,6 +135,7 @@ void HepMCFlowAfterBurner::Print(const string &/*what*/) const
   cout << "algorithm: " << algorithmName << endl;
   cout << "mineta: " << mineta << ", maxeta: " << maxeta << endl;
   cout << "minpt: " << minpt << ", maxpt: " << maxpt << endl;
+  cout << "precision: " << precision << ", solver: " << (use_gsl_solver ? "gsl" : "batched") << endl;
   cout << "Implemented algorithms: MINBIAS (default), MINBIAS_V2_ONLY, CUSTOM"
        << endl;
   return;
@@ -41,6 +41,18 @@ class HepMCFlowAfterBurner : public SubsysReco
   }
   void setSeed(const long il);
 
+  //! precision on the flow shifted azimuth (rad)
+  void setPrecision(const double d)
+  {
+    precision = d;
+  }
+
+  //! use the per particle GSL Brent solver (default), false selects the batched one
+  void setUseGslSolver(const bool b)
+  {
+    use_gsl_solver = b;
+  }
+
   void SaveRandomState(const std::string &savefile = "HepMCFlowAfterBurner.ransave");
   void RestoreRandomState(const std::string &savefile = "HepMCFlowAfterBurner.ransave");
 
@@ -54,6 +66,9 @@ class HepMCFlowAfterBurner : public SubsysReco
   float minpt;
   float maxpt;
 
+  double precision;
+  bool use_gsl_solver;
+
   int seedset;
   long seed;
   long randomSeed;
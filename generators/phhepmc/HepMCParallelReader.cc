@@ -0,0 +1,337 @@
+#include "HepMCParallelReader.h"
+
+#include <HepMC/GenEvent.h>
+#include <HepMC/GenParticle.h>   // for GenParticle
+#include <HepMC/GenVertex.h>     // for GenVertex
+#include <HepMC/IO_GenEvent.h>
+#include <HepMC/SimpleVector.h>  // for FourVector
+#include <HepMC/Units.h>         // for CM, GEV
+
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_streambuf.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  const double toMM = 1.e-12;
+
+  //! true if string ends with given extension
+  bool has_extension(const std::string &filename, const std::string &extension)
+  {
+    return filename.size() >= extension.size() && filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+  }
+
+  //! true if line is the Oscar end of event line, "0 0"
+  bool is_oscar_end_of_event(const std::string &line)
+  {
+    std::vector<double> values;
+    double number = NAN;
+    for (std::istringstream numbers_iss(line); numbers_iss >> number;)
+    {
+      values.push_back(number);
+    }
+    return values.size() == 2 && values[0] == 0 && values[1] == 0;
+  }
+
+  //! true if line has non whitespace characters
+  bool is_blank(const std::string &text)
+  {
+    return text.find_first_not_of(" \t\r\n") == std::string::npos;
+  }
+}  // namespace
+
+//_____________________________________________________________________________
+HepMCParallelReader::HepMCParallelReader(const std::string &filename, Format format, unsigned int nthreads, unsigned int queue_size)
+  : m_FileName(filename)
+  , m_Format(format)
+  , m_QueueSize(std::max(queue_size, 1u))
+{
+  // check that the file can be opened, before starting threads
+  if (!std::ifstream(m_FileName).good())
+  {
+    std::cout << "HepMCParallelReader::HepMCParallelReader - cannot open " << m_FileName << std::endl;
+    return;
+  }
+
+  m_IsOpen = true;
+  m_ReaderThread = std::thread(&HepMCParallelReader::read_file, this);
+  for (unsigned int i = 0; i < std::max(nthreads, 1u); ++i)
+  {
+    m_ParserThreads.emplace_back(&HepMCParallelReader::parse_chunks, this);
+  }
+}
+
+//_____________________________________________________________________________
+HepMCParallelReader::~HepMCParallelReader()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stop = true;
+  }
+  m_ChunkAvailable.notify_all();
+  m_EventAvailable.notify_all();
+  m_RoomAvailable.notify_all();
+
+  if (m_ReaderThread.joinable())
+  {
+    m_ReaderThread.join();
+  }
+  for (auto &thread : m_ParserThreads)
+  {
+    thread.join();
+  }
+
+  for (auto &pair : m_Events)
+  {
+    delete pair.second;
+  }
+}
+
+//_____________________________________________________________________________
+HepMC::GenEvent *HepMCParallelReader::read_next_event()
+{
+  if (!m_IsOpen)
+  {
+    return nullptr;
+  }
+
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_EventAvailable.wait(lock, [this] { return m_Events.find(m_NextIndex) != m_Events.end() || (m_ReadDone && m_NextIndex >= m_NChunks); });
+
+  auto iter = m_Events.find(m_NextIndex);
+  if (iter == m_Events.end())
+  {
+    // end of file
+    return nullptr;
+  }
+
+  HepMC::GenEvent *evt = iter->second;
+  m_Events.erase(iter);
+  ++m_NextIndex;
+  lock.unlock();
+  m_RoomAvailable.notify_one();
+  return evt;
+}
+
+//_____________________________________________________________________________
+HepMC::GenEvent *HepMCParallelReader::read_oscar_event(std::istream &in)
+{
+  //use PHENIX unit
+  HepMC::GenEvent *evt = new HepMC::GenEvent(HepMC::Units::GEV, HepMC::Units::CM);
+
+  //Grab New Event From Oscar
+  std::string theLine;
+  std::vector<std::vector<double> > theEventVec;
+  std::vector<HepMC::FourVector> theVtxVec;
+  while (getline(in, theLine))
+  {
+    if (theLine.compare(0, 1, "#") == 0) continue;
+    std::vector<double> theInfo;  //format: N,pid,px,py,pz,E,mass,xvtx,yvtx,zvtx,?
+    double number = NAN;
+    for (std::istringstream numbers_iss(theLine); numbers_iss >> number;)
+    {
+      theInfo.push_back(number);
+    }
+
+    if (theInfo.size() == 2 && theInfo[0] == 0 && theInfo[1] == 0)
+    {
+      break;
+    }
+    else if (theInfo.size() == 2 && theInfo[0] == 0 && theInfo[1] > 0)
+    {
+      continue;
+    }
+    else
+    {
+      theEventVec.push_back(theInfo);
+      HepMC::FourVector vert(theInfo[8] * toMM, theInfo[9] * toMM, theInfo[10] * toMM, theInfo[11]);
+      theVtxVec.push_back(vert);
+    }
+
+  }  //while(getline)
+
+  //Loop Over One Event, Fill HepMC
+  for (unsigned int i = 0; i < theEventVec.size(); i++)
+  {
+    //int N = (int)theEventVec[i][0];
+    int pid = (int) theEventVec[i][1];
+    double px = theEventVec[i][3];
+    double py = theEventVec[i][4];
+    double pz = theEventVec[i][5];
+    double E = theEventVec[i][6];
+    double m = theEventVec[i][7];
+    int status = 1;  //oscar only writes final state particles
+
+    HepMC::GenVertex *v = new HepMC::GenVertex(theVtxVec[i]);
+    evt->add_vertex(v);
+
+    HepMC::GenParticle *p = new HepMC::GenParticle(HepMC::FourVector(px, py, pz, E), pid, status);
+    p->setGeneratedMass(m);
+    p->suggest_barcode(i + 1);
+    v->add_particle_out(p);
+  }
+  return evt;
+}
+
+//_____________________________________________________________________________
+void HepMCParallelReader::read_file()
+{
+  // open file, with on the fly decompression if needed
+  std::ifstream filestream(m_FileName, std::ios::in | std::ios::binary);
+  boost::iostreams::filtering_streambuf<boost::iostreams::input> zinbuffer;
+  if (has_extension(m_FileName, ".bz2"))
+  {
+    zinbuffer.push(boost::iostreams::bzip2_decompressor());
+  }
+  else if (has_extension(m_FileName, ".gz"))
+  {
+    zinbuffer.push(boost::iostreams::gzip_decompressor());
+  }
+  zinbuffer.push(filestream);
+  std::istream in(&zinbuffer);
+
+  // split at event boundaries
+  std::string header;
+  std::string chunk;
+  bool in_event = false;
+  bool header_done = false;
+  std::string line;
+  while (std::getline(in, line))
+  {
+    if (m_Format == kOscar)
+    {
+      chunk += line;
+      chunk += '\n';
+      if (is_oscar_end_of_event(line))
+      {
+        if (!push_chunk(std::move(chunk))) return;
+        chunk.clear();
+      }
+      continue;
+    }
+
+    // HepMC events start with an 'E' line and end at the next event or at the next HepMC keyword (end of listing)
+    const bool start_of_event = line.compare(0, 2, "E ") == 0;
+    const bool keyword = line.compare(0, 7, "HepMC::") == 0;
+    if (in_event && (start_of_event || keyword))
+    {
+      if (!push_chunk(std::move(chunk))) return;
+      chunk.clear();
+      in_event = false;
+    }
+
+    if (start_of_event)
+    {
+      if (!header_done)
+      {
+        // header is written once, before any chunk is handed to the parser threads
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Header = header;
+        header_done = true;
+      }
+      in_event = true;
+    }
+
+    if (in_event)
+    {
+      chunk += line;
+      chunk += '\n';
+    }
+    else if (!header_done)
+    {
+      header += line;
+      header += '\n';
+    }
+  }
+
+  // last event
+  if ((m_Format == kOscar && !is_blank(chunk)) || (m_Format == kHepMC && in_event))
+  {
+    push_chunk(std::move(chunk));
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_ReadDone = true;
+    if (m_Verbosity > 0)
+    {
+      std::cout << "HepMCParallelReader::read_file - " << m_FileName << " done, events: " << m_NChunks << std::endl;
+    }
+  }
+  m_ChunkAvailable.notify_all();
+  m_EventAvailable.notify_all();
+}
+
+//_____________________________________________________________________________
+bool HepMCParallelReader::push_chunk(std::string &&text)
+{
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_RoomAvailable.wait(lock, [this] { return m_Stop || m_NChunks - m_NextIndex < m_QueueSize; });
+    if (m_Stop)
+    {
+      return false;
+    }
+    Chunk chunk;
+    chunk.index = m_NChunks++;
+    chunk.text = std::move(text);
+    m_Chunks.push(std::move(chunk));
+  }
+  m_ChunkAvailable.notify_one();
+  return true;
+}
+
+//_____________________________________________________________________________
+void HepMCParallelReader::parse_chunks()
+{
+  while (true)
+  {
+    Chunk chunk;
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_ChunkAvailable.wait(lock, [this] { return m_Stop || !m_Chunks.empty() || m_ReadDone; });
+      if (m_Stop || m_Chunks.empty())
+      {
+        return;
+      }
+      chunk = std::move(m_Chunks.front());
+      m_Chunks.pop();
+    }
+
+    HepMC::GenEvent *evt = parse(chunk);
+
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Events[chunk.index] = evt;
+    }
+    m_EventAvailable.notify_all();
+  }
+}
+
+//_____________________________________________________________________________
+HepMC::GenEvent *HepMCParallelReader::parse(const Chunk &chunk) const
+{
+  if (m_Format == kOscar)
+  {
+    std::istringstream in(chunk.text);
+    return read_oscar_event(in);
+  }
+
+  // each chunk is parsed with its own stream and IO_GenEvent, using the file header
+  std::istringstream in(m_Header + chunk.text + "HepMC::IO_GenEvent-END_EVENT_LISTING\n");
+  HepMC::IO_GenEvent ascii_in(in);
+  HepMC::GenEvent *evt = ascii_in.read_next_event();
+  if (!evt && m_Verbosity > 0)
+  {
+    std::cout << "HepMCParallelReader::parse - failed to parse event " << chunk.index << std::endl;
+  }
+  return evt;
+}
@@ -0,0 +1,119 @@
+#ifndef PHHEPMC_HEPMCPARALLELREADER_H
+#define PHHEPMC_HEPMCPARALLELREADER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace HepMC
+{
+  class GenEvent;
+}  // namespace HepMC
+
+/*!
+ * reads HepMC (IO_GenEvent) or Oscar ascii files with background threads.
+ * A reader thread decompresses the file (.gz and .bz2 are recognized from the extension)
+ * and splits it at event boundaries. Events are then parsed concurrently by a pool of parser threads,
+ * and handed back in file order by read_next_event.
+ * The number of events read ahead, either waiting to be parsed or parsed and waiting to be consumed,
+ * is bounded by the queue size.
+ */
+class HepMCParallelReader
+{
+ public:
+  //! input format
+  enum Format
+  {
+    kHepMC,
+    kOscar
+  };
+
+  //! constructor. Opens the file and starts the threads
+  HepMCParallelReader(const std::string &filename, Format format = kHepMC, unsigned int nthreads = 2, unsigned int queue_size = 100);
+
+  //! destructor. Stops the threads and deletes events not consumed
+  ~HepMCParallelReader();
+
+  //! true if file could be opened
+  bool is_open() const { return m_IsOpen; }
+
+  //! next event, in file order. Caller takes ownership. Returns nullptr at end of file or on parsing error
+  HepMC::GenEvent *read_next_event();
+
+  //! parse one Oscar event from stream, up to and including the "0 0" end of event line
+  static HepMC::GenEvent *read_oscar_event(std::istream &);
+
+  //! verbosity
+  void Verbosity(const int verbosity) { m_Verbosity = verbosity; }
+
+ private:
+  //! event text, as found in the file
+  struct Chunk
+  {
+    uint64_t index = 0;
+    std::string text;
+  };
+
+  //! reader thread: decompress and split into chunks
+  void read_file();
+
+  //! parser thread: parse chunks into events
+  void parse_chunks();
+
+  //! push chunk to parser queue, waiting for room if needed. Returns false if stopped
+  bool push_chunk(std::string &&text);
+
+  //! parse one chunk
+  HepMC::GenEvent *parse(const Chunk &) const;
+
+  std::string m_FileName;
+  Format m_Format = kHepMC;
+  unsigned int m_QueueSize = 100;
+  int m_Verbosity = 0;
+  bool m_IsOpen = false;
+
+  //! file header (HepMC version and start of listing), prepended to each chunk before parsing
+  std::string m_Header;
+
+  std::thread m_ReaderThread;
+  std::vector<std::thread> m_ParserThreads;
+
+  //!@name shared state, protected by m_Mutex
+  //@{
+  std::mutex m_Mutex;
+
+  //! notified when chunks are available, or reading is done
+  std::condition_variable m_ChunkAvailable;
+
+  //! notified when events are parsed
+  std::condition_variable m_EventAvailable;
+
+  //! notified when events are consumed
+  std::condition_variable m_RoomAvailable;
+
+  std::queue<Chunk> m_Chunks;
+
+  //! parsed events, waiting to be consumed, by chunk index
+  std::map<uint64_t, HepMC::GenEvent *> m_Events;
+
+  //! number of chunks produced by the reader thread
+  uint64_t m_NChunks = 0;
+
+  //! index of next chunk to be consumed
+  uint64_t m_NextIndex = 0;
+
+  //! true when the reader thread is done
+  bool m_ReadDone = false;
+
+  //! true when stopping
+  bool m_Stop = false;
+  //@}
+};
+
+#endif
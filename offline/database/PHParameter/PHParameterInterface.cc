@@ -84,6 +84,12 @@ PHParameterInterface::get_double_param(const std::string &name) const
   return m_Params->get_double_param(name);
 }
 
+PHParameters::DoubleHandle
+PHParameterInterface::get_double_handle(const std::string &name)
+{
+  return m_Params->get_double_handle(name);
+}
+
 void PHParameterInterface::set_int_param(const std::string &name, const int ival)
 {
   if (m_DefaultIntParMap.find(name) == m_DefaultIntParMap.end())
@@ -104,6 +110,12 @@ int PHParameterInterface::get_int_param(const std::string &name) const
   return m_Params->get_int_param(name);
 }
 
+PHParameters::IntHandle
+PHParameterInterface::get_int_handle(const std::string &name)
+{
+  return m_Params->get_int_handle(name);
+}
+
 void PHParameterInterface::set_string_param(const std::string &name, const std::string &sval)
 {
   if (m_DefaultStringParMap.find(name) == m_DefaultStringParMap.end())
@@ -127,6 +139,9 @@ PHParameterInterface::get_string_param(const std::string &name) const
 
 void PHParameterInterface::UpdateParametersWithMacro()
 {
+  // called in every InitRun, the parameters may have been frozen in the previous run
+  const bool frozen = m_Params->IsFrozen();
+  m_Params->Unfreeze();
   for (std::map<const std::string, double>::const_iterator iter = m_DoubleParMap.begin(); iter != m_DoubleParMap.end(); ++iter)
   {
     m_Params->set_double_param(iter->first, iter->second);
@@ -139,6 +154,10 @@ void PHParameterInterface::UpdateParametersWithMacro()
   {
     m_Params->set_string_param(iter->first, iter->second);
   }
+  if (frozen)
+  {
+    m_Params->Freeze();
+  }
   return;
 }
 
@@ -3,11 +3,12 @@
 #ifndef PHPARAMETER_PHPARAMETERINTERFACE_H
 #define PHPARAMETER_PHPARAMETERINTERFACE_H
 
+#include "PHParameters.h"
+
 #include <map>
 #include <string>
 
 class PHCompositeNode;
-class PHParameters;
 
 class PHParameterInterface
 {
@@ -30,6 +31,10 @@ class PHParameterInterface
   void set_string_param(const std::string &name, const std::string &sval);
   std::string get_string_param(const std::string &name) const;
 
+  // handle access for per hit loops, resolve the handles in InitRun
+  double get_double_param(const PHParameters::DoubleHandle handle) const { return m_Params->get_double_param(handle); }
+  int get_int_param(const PHParameters::IntHandle handle) const { return m_Params->get_int_param(handle); }
+
   void UpdateParametersWithMacro();
   void SaveToNodeTree(PHCompositeNode *runNode, const std::string &nodename);
   void PutOnParNode(PHCompositeNode *parNode, const std::string &nodename);
@@ -40,6 +45,11 @@ class PHParameterInterface
   void set_default_string_param(const std::string &name, const std::string &sval);
   void InitializeParameters();
 
+  PHParameters::DoubleHandle get_double_handle(const std::string &name);
+  PHParameters::IntHandle get_int_handle(const std::string &name);
+  // make the parameters read only once they are final (after UpdateParametersWithMacro)
+  void FreezeParameters() { m_Params->Freeze(); }
+
  private:
   PHParameters *m_Params = nullptr;
   std::map<const std::string, double> m_DoubleParMap;
@@ -49,11 +49,18 @@ PHParameters::~PHParameters()
 
 void PHParameters::set_int_param(const std::string &name, const int ival)
 {
+  CheckSetAllowed("integer", name);
   m_IntParMap[name] = ival;
+  std::map<const std::string, unsigned int>::const_iterator slotiter = m_IntSlotIndex.find(name);
+  if (slotiter != m_IntSlotIndex.end())
+  {
+    m_IntSlots[slotiter->second] = ival;
+  }
 }
 
 int PHParameters::get_int_param(const std::string &name) const
 {
+  CheckStringLookup("integer", name);
   if (m_IntParMap.find(name) != m_IntParMap.end())
   {
     return m_IntParMap.find(name)->second;
@@ -91,12 +98,19 @@ void PHParameters::printint() const
 
 void PHParameters::set_double_param(const std::string &name, const double dval)
 {
+  CheckSetAllowed("double", name);
   m_DoubleParMap[name] = dval;
+  std::map<const std::string, unsigned int>::const_iterator slotiter = m_DoubleSlotIndex.find(name);
+  if (slotiter != m_DoubleSlotIndex.end())
+  {
+    m_DoubleSlots[slotiter->second] = dval;
+  }
 }
 
 double
 PHParameters::get_double_param(const std::string &name) const
 {
+  CheckStringLookup("double", name);
   if (m_DoubleParMap.find(name) != m_DoubleParMap.end())
   {
     return m_DoubleParMap.find(name)->second;
@@ -122,6 +136,88 @@ bool PHParameters::exist_double_param(const std::string &name) const
   return false;
 }
 
+PHParameters::DoubleHandle
+PHParameters::get_double_handle(const std::string &name)
+{
+  if (m_Frozen)
+  {
+    std::cout << PHWHERE << " cannot resolve handle for double parameter " << name
+              << " of " << m_Detector << ", parameters are frozen" << std::endl;
+    gSystem->Exit(1);
+    exit(1);
+  }
+  DoubleHandle handle;
+  std::map<const std::string, unsigned int>::const_iterator slotiter = m_DoubleSlotIndex.find(name);
+  if (slotiter != m_DoubleSlotIndex.end())
+  {
+    handle.slot = slotiter->second;
+    return handle;
+  }
+  handle.slot = m_DoubleSlots.size();
+  // get_double_param exits if the parameter does not exist
+  m_DoubleSlots.push_back(get_double_param(name));
+  m_DoubleSlotIndex[name] = handle.slot;
+  return handle;
+}
+
+PHParameters::IntHandle
+PHParameters::get_int_handle(const std::string &name)
+{
+  if (m_Frozen)
+  {
+    std::cout << PHWHERE << " cannot resolve handle for integer parameter " << name
+              << " of " << m_Detector << ", parameters are frozen" << std::endl;
+    gSystem->Exit(1);
+    exit(1);
+  }
+  IntHandle handle;
+  std::map<const std::string, unsigned int>::const_iterator slotiter = m_IntSlotIndex.find(name);
+  if (slotiter != m_IntSlotIndex.end())
+  {
+    handle.slot = slotiter->second;
+    return handle;
+  }
+  handle.slot = m_IntSlots.size();
+  // get_int_param exits if the parameter does not exist
+  m_IntSlots.push_back(get_int_param(name));
+  m_IntSlotIndex[name] = handle.slot;
+  return handle;
+}
+
+void PHParameters::CheckSetAllowed(const std::string &type, const std::string &name) const
+{
+  if (!m_Frozen)
+  {
+    return;
+  }
+  std::cout << PHWHERE << " cannot set " << type << " parameter " << name
+            << " of " << m_Detector << ", parameters are frozen" << std::endl;
+  std::cout << "Here is the stacktrace: " << std::endl;
+  std::cout << boost::stacktrace::stacktrace();
+  std::cout << std::endl
+            << "DO NOT PANIC - this is not a segfault" << std::endl;
+  std::cout << "Check the stacktrace for the guilty party (typically #2)" << std::endl;
+  gSystem->Exit(1);
+  exit(1);
+}
+
+void PHParameters::CheckStringLookup(const std::string &type, const std::string &name) const
+{
+  if (!m_Frozen || !m_StringLookupCheck)
+  {
+    return;
+  }
+  // only the first lookup is printed, also with several threads
+  if (m_StringLookupCount++ == 0)
+  {
+    std::cout << PHWHERE << " lookup of " << type << " parameter " << name
+              << " of " << m_Detector << " by name while frozen, use a handle" << std::endl;
+    std::cout << "Here is the stacktrace: " << std::endl;
+    std::cout << boost::stacktrace::stacktrace();
+    std::cout << std::endl;
+  }
+}
+
 void PHParameters::Print(Option_t */*option*/) const
 {
   std::cout << "Parameters for " << m_Detector << std::endl;
@@ -179,12 +275,14 @@ void PHParameters::printdouble() const
 
 void PHParameters::set_string_param(const std::string &name, const std::string &str)
 {
+  CheckSetAllowed("string", name);
   m_StringParMap[name] = str;
 }
 
 std::string
 PHParameters::get_string_param(const std::string &name) const
 {
+  CheckStringLookup("string", name);
   if (m_StringParMap.find(name) != m_StringParMap.end())
   {
     return m_StringParMap.find(name)->second;
@@ -230,7 +328,7 @@ void PHParameters::FillFrom(const PdbParameterMap *saveparams)
   for (std::map<const std::string, double>::const_iterator iter = begin_end_d.first;
        iter != begin_end_d.second; ++iter)
   {
-    m_DoubleParMap[iter->first] = iter->second;
+    set_double_param(iter->first, iter->second);
   }
   std::pair<std::map<const std::string, int>::const_iterator,
             std::map<const std::string, int>::const_iterator>
@@ -238,7 +336,7 @@ void PHParameters::FillFrom(const PdbParameterMap *saveparams)
   for (std::map<const std::string, int>::const_iterator iter = begin_end_i.first;
        iter != begin_end_i.second; ++iter)
   {
-    m_IntParMap[iter->first] = iter->second;
+    set_int_param(iter->first, iter->second);
   }
   std::pair<std::map<const std::string, std::string>::const_iterator,
             std::map<const std::string, std::string>::const_iterator>
@@ -246,7 +344,7 @@ void PHParameters::FillFrom(const PdbParameterMap *saveparams)
   for (std::map<const std::string, std::string>::const_iterator iter = begin_end_s.first;
        iter != begin_end_s.second; ++iter)
   {
-    m_StringParMap[iter->first] = iter->second;
+    set_string_param(iter->first, iter->second);
   }
 
   return;
@@ -267,7 +365,7 @@ void PHParameters::FillFrom(const PdbParameterMapContainer *saveparamcontainer,
   for (std::map<const std::string, double>::const_iterator iter = begin_end_d.first;
        iter != begin_end_d.second; ++iter)
   {
-    m_DoubleParMap[iter->first] = iter->second;
+    set_double_param(iter->first, iter->second);
   }
   std::pair<std::map<const std::string, int>::const_iterator,
             std::map<const std::string, int>::const_iterator>
@@ -275,7 +373,7 @@ void PHParameters::FillFrom(const PdbParameterMapContainer *saveparamcontainer,
   for (std::map<const std::string, int>::const_iterator iter = begin_end_i.first;
        iter != begin_end_i.second; ++iter)
   {
-    m_IntParMap[iter->first] = iter->second;
+    set_int_param(iter->first, iter->second);
   }
   std::pair<std::map<const std::string, std::string>::const_iterator,
             std::map<const std::string, std::string>::const_iterator>
@@ -283,7 +381,7 @@ void PHParameters::FillFrom(const PdbParameterMapContainer *saveparamcontainer,
   for (std::map<const std::string, std::string>::const_iterator iter = begin_end_s.first;
        iter != begin_end_s.second; ++iter)
   {
-    m_StringParMap[iter->first] = iter->second;
+    set_string_param(iter->first, iter->second);
   }
 
   return;
@@ -296,19 +394,19 @@ void PHParameters::FillFrom(const PHParameters *saveparams)
   for (dMap::const_iterator iter = saveparams->m_DoubleParMap.begin();
        iter != saveparams->m_DoubleParMap.end(); ++iter)
   {
-    m_DoubleParMap[iter->first] = iter->second;
+    set_double_param(iter->first, iter->second);
   }
 
   for (iMap::const_iterator iter = saveparams->m_IntParMap.begin();
        iter != saveparams->m_IntParMap.end(); ++iter)
   {
-    m_IntParMap[iter->first] = iter->second;
+    set_int_param(iter->first, iter->second);
   }
 
   for (strMap::const_iterator iter = saveparams->m_StringParMap.begin();
        iter != saveparams->m_StringParMap.end(); ++iter)
   {
-    m_StringParMap[iter->first] = iter->second;
+    set_string_param(iter->first, iter->second);
   }
   return;
 }
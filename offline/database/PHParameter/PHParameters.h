@@ -5,10 +5,12 @@
 
 #include <phool/PHObject.h>
 
+#include <atomic>
 #include <cstddef>
 #include <map>
 #include <string>
 #include <utility>
+#include <vector>
 
 class PdbParameterMap;
 class PdbParameterMapContainer;
@@ -20,6 +22,21 @@ class PHCompositeNode;
 class PHParameters : public PHObject
 {
  public:
+  //! handle to a double parameter, resolved once by name with get_double_handle.
+  //! Reading through a handle is an index into a flat array, no string lookup
+  struct DoubleHandle
+  {
+    unsigned int slot = ~0U;
+    bool valid() const { return slot != ~0U; }
+  };
+
+  //! handle to an int parameter, see DoubleHandle
+  struct IntHandle
+  {
+    unsigned int slot = ~0U;
+    bool valid() const { return slot != ~0U; }
+  };
+
   typedef std::map<const std::string, double> dMap;
   typedef dMap::const_iterator dIter;
   typedef std::map<const std::string, int> iMap;
@@ -50,6 +67,31 @@ class PHParameters : public PHObject
   bool exist_double_param(const std::string &name) const;
   std::pair<std::map<const std::string, double>::const_iterator, std::map<const std::string, double>::const_iterator> get_all_double_params() { return std::make_pair(m_DoubleParMap.begin(), m_DoubleParMap.end()); }
 
+  //!@name parameter handles
+  //! resolve the name once (in InitRun), then read with the handle in process_event.
+  //! Handles stay valid when the parameter is set again, they cannot be
+  //! resolved once the parameters are frozen
+  //@{
+  DoubleHandle get_double_handle(const std::string &name);
+  double get_double_param(const DoubleHandle handle) const { return m_DoubleSlots[handle.slot]; }
+  IntHandle get_int_handle(const std::string &name);
+  int get_int_param(const IntHandle handle) const { return m_IntSlots[handle.slot]; }
+  //@}
+
+  //!@name frozen mode
+  //! frozen parameters are read only, setting them is a fatal error.
+  //! Reading frozen parameters (also by name) is safe from several threads
+  //@{
+  void Freeze() { m_Frozen = true; }
+  void Unfreeze() { m_Frozen = false; }
+  bool IsFrozen() const { return m_Frozen; }
+  //@}
+
+  //! debug check: report lookups by name while frozen, which should be replaced by handles.
+  //! The first lookup is printed with a stacktrace, all of them are counted
+  void set_string_lookup_check(const bool b) { m_StringLookupCheck = b; }
+  unsigned int get_string_lookup_count() const { return m_StringLookupCount; }
+
   void set_string_param(const std::string &name, const std::string &str);
   std::string get_string_param(const std::string &name) const;
   bool exist_string_param(const std::string &name) const;
@@ -91,11 +133,24 @@ class PHParameters : public PHObject
 
  private:
   unsigned int ConvertStringToUint(const std::string &str) const;
+  void CheckSetAllowed(const std::string &type, const std::string &name) const;
+  void CheckStringLookup(const std::string &type, const std::string &name) const;
   std::string m_Detector;
   dMap m_DoubleParMap;
   iMap m_IntParMap;
   strMap m_StringParMap;
 
+  // flat copies of the parameters which have a handle, kept in sync by the setters
+  std::vector<double> m_DoubleSlots;
+  std::vector<int> m_IntSlots;
+  std::map<const std::string, unsigned int> m_DoubleSlotIndex;
+  std::map<const std::string, unsigned int> m_IntSlotIndex;
+
+  bool m_Frozen = false;
+  bool m_StringLookupCheck = false;
+  // debug counter, frozen parameters are read by name from several threads
+  mutable std::atomic<unsigned int> m_StringLookupCount{0};
+
   //No Class Def since this class is not intended to be persistent
 };
 
@@ -0,0 +1,297 @@
+#include "PdbBankCache.h"
+
+#include "PdbCalBank.h"
+
+#include <phool/phool.h>
+
+#include <TBuffer.h>
+#include <TBufferFile.h>
+#include <TDirectory.h>
+#include <TFile.h>
+#include <TMD5.h>
+#include <TObject.h>
+#include <TSystem.h>
+
+#include <cstdio>  // for rename
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+PdbBankCache *PdbBankCache::mySpecificCopy = nullptr;
+
+int PdbBankCache::Register(const std::string &cachedir)
+{
+  if (mySpecificCopy)
+  {
+    return -1;
+  }
+  if (!__instance)
+  {
+    std::cout << PHWHERE << " No bank manager registered, cannot cache its banks" << std::endl;
+    return -1;
+  }
+  mySpecificCopy = new PdbBankCache(__instance, cachedir);
+  __instance = mySpecificCopy;
+  return 0;
+}
+
+int PdbBankCache::RegisterFromEnv()
+{
+  const char *cachedir = getenv("PDBCAL_CACHE_DIR");
+  if (!cachedir || std::string(cachedir).empty())
+  {
+    return -1;
+  }
+  if (Register(cachedir))
+  {
+    return -1;
+  }
+  const char *maxinserttime = getenv("PDBCAL_CACHE_MAXINSERTTIME");
+  if (maxinserttime && !std::string(maxinserttime).empty())
+  {
+    mySpecificCopy->SetMaxInsertTime(PHTimeStamp(static_cast<time_t>(atol(maxinserttime))));
+  }
+  else
+  {
+    std::cout << "PdbBankCache: PDBCAL_CACHE_MAXINSERTTIME is not set, banks are not cached until a max insert time is set" << std::endl;
+  }
+  return 0;
+}
+
+PdbBankCache::PdbBankCache(PdbBankManager *backend, const std::string &cachedir)
+  : m_Backend(backend)
+  , m_CacheDir(cachedir)
+{
+  // recursive mkdir does nothing if the directories exist already
+  gSystem->mkdir((m_CacheDir + "/keys").c_str(), true);
+  gSystem->mkdir((m_CacheDir + "/banks").c_str(), true);
+  std::cout << "PdbBankCache: caching calibration banks in " << m_CacheDir << std::endl;
+}
+
+PdbBankCache::~PdbBankCache()
+{
+  mySpecificCopy = nullptr;
+}
+
+void PdbBankCache::SetMaxInsertTime(const PHTimeStamp &tMax)
+{
+  m_MaxInsertTime = tMax;
+  m_MaxInsertTimeSet = true;
+  m_Backend->SetMaxInsertTime(tMax);
+}
+
+bool PdbBankCache::isActive() const
+{
+  // banks can still be committed with an insert time before a max insert time in the future
+  return m_MaxInsertTimeSet && m_MaxInsertTime <= PHTimeStamp();
+}
+
+PdbCalBank *
+PdbBankCache::fetchBank(const std::string &className, PdbBankID bankID, const std::string &bankName, const int runNumber)
+{
+  if (!isActive())
+  {
+    return m_Backend->fetchBank(className, bankID, bankName, runNumber);
+  }
+  std::ostringstream search;
+  search << "r" << runNumber;
+  const std::string key = makeKey(bankName, bankID, search.str());
+  PdbCalBank *bank = readBank(key);
+  if (bank)
+  {
+    return bank;
+  }
+  bank = m_Backend->fetchBank(className, bankID, bankName, runNumber);
+  if (bank)
+  {
+    writeBank(key, bank);
+  }
+  return bank;
+}
+
+PdbCalBank *
+PdbBankCache::fetchBank(const std::string &className, PdbBankID bankID, const std::string &bankName, const PHTimeStamp &searchTime)
+{
+  if (!isActive())
+  {
+    return m_Backend->fetchBank(className, bankID, bankName, searchTime);
+  }
+  std::ostringstream search;
+  search << "t" << searchTime.getTics();
+  const std::string key = makeKey(bankName, bankID, search.str());
+  PdbCalBank *bank = readBank(key);
+  if (bank)
+  {
+    return bank;
+  }
+  bank = m_Backend->fetchBank(className, bankID, bankName, searchTime);
+  if (bank)
+  {
+    writeBank(key, bank);
+  }
+  return bank;
+}
+
+int PdbBankCache::Prefetch(const std::string &className, PdbBankID bankID, const std::string &bankName, const std::vector<int> &runs)
+{
+  if (!isActive())
+  {
+    std::cout << PHWHERE << " no max insert time in the past is set, nothing is cached" << std::endl;
+    return runs.size();
+  }
+  int nmissing = 0;
+  for (int run : runs)
+  {
+    PdbCalBank *bank = fetchBank(className, bankID, bankName, run);
+    if (!bank)
+    {
+      std::cout << "PdbBankCache::Prefetch - no " << bankName << " bank for run " << run << std::endl;
+      nmissing++;
+      continue;
+    }
+    delete bank;
+  }
+  return nmissing;
+}
+
+void PdbBankCache::Print() const
+{
+  std::cout << "PdbBankCache: " << m_CacheDir;
+  if (m_MaxInsertTimeSet)
+  {
+    std::cout << ", max insert time " << m_MaxInsertTime.getTics();
+  }
+  std::cout << (isActive() ? "" : " (inactive, no max insert time in the past)") << std::endl;
+  std::cout << "hits: " << m_Hits << ", misses: " << m_Misses
+            << ", banks stored: " << m_Stored << ", unreadable entries: " << m_Errors << std::endl;
+}
+
+std::string
+PdbBankCache::makeKey(const std::string &bankName, PdbBankID bankID, const std::string &search) const
+{
+  std::ostringstream key;
+  key << bankName << "-" << bankID.getInternalValue() << "-" << search
+      << "-" << m_MaxInsertTime.getTics();
+  return key.str();
+}
+
+PdbCalBank *
+PdbBankCache::readBank(const std::string &key)
+{
+  std::ifstream keyfile(m_CacheDir + "/keys/" + key);
+  if (!keyfile)
+  {
+    m_Misses++;
+    if (m_Verbosity > 0)
+    {
+      std::cout << "PdbBankCache: miss for " << key << std::endl;
+    }
+    return nullptr;
+  }
+  std::string md5;
+  keyfile >> md5;
+  const std::string bankfile = m_CacheDir + "/banks/" + md5 + ".root";
+  PdbCalBank *bank = nullptr;
+  // AccessPathName returns true if the file does NOT exist
+  if (!md5.empty() && !gSystem->AccessPathName(bankfile.c_str()))
+  {
+    // do not change the current directory of the caller (e.g. an open histogram file)
+    TDirectory::TContext context;
+    TFile *f = TFile::Open(bankfile.c_str());
+    if (f && !f->IsZombie())
+    {
+      TObject *obj = f->Get("bank");
+      bank = dynamic_cast<PdbCalBank *>(obj);
+      if (!bank)
+      {
+        delete obj;
+      }
+    }
+    delete f;
+  }
+  if (!bank)
+  {
+    std::cout << PHWHERE << " unreadable cache entry " << key << " (" << bankfile
+              << "), fetching from database" << std::endl;
+    m_Errors++;
+    m_Misses++;
+    return nullptr;
+  }
+  m_Hits++;
+  if (m_Verbosity > 0)
+  {
+    std::cout << "PdbBankCache: hit for " << key << " in " << bankfile << std::endl;
+  }
+  return bank;
+}
+
+void PdbBankCache::writeBank(const std::string &key, PdbCalBank *bank)
+{
+  // the bank is stored under the md5 of its streamed content
+  TBufferFile buffer(TBuffer::kWrite);
+  buffer.WriteObject(bank);
+  TMD5 md5;
+  md5.Update(reinterpret_cast<const UChar_t *>(buffer.Buffer()), buffer.Length());
+  md5.Final();
+  const std::string hash = md5.AsString();
+
+  const std::string bankfile = m_CacheDir + "/banks/" + hash + ".root";
+  if (gSystem->AccessPathName(bankfile.c_str()))
+  {
+    std::ostringstream tmpfile;
+    tmpfile << bankfile << "." << gSystem->HostName() << "." << gSystem->GetPid() << ".tmp";
+    TDirectory::TContext context;
+    TFile *f = TFile::Open(tmpfile.str().c_str(), "RECREATE");
+    if (!f || f->IsZombie())
+    {
+      std::cout << PHWHERE << " cannot write " << tmpfile.str() << ", bank not cached" << std::endl;
+      delete f;
+      return;
+    }
+    f->WriteTObject(bank, "bank");
+    delete f;
+    if (rename(tmpfile.str().c_str(), bankfile.c_str()) != 0)
+    {
+      std::cout << PHWHERE << " cannot rename " << tmpfile.str() << " to " << bankfile
+                << ", bank not cached" << std::endl;
+      gSystem->Unlink(tmpfile.str().c_str());
+      return;
+    }
+    m_Stored++;
+  }
+  if (!writeFile(m_CacheDir + "/keys/" + key, hash + "\n"))
+  {
+    std::cout << PHWHERE << " cannot write cache key " << key << std::endl;
+    return;
+  }
+  if (m_Verbosity > 0)
+  {
+    std::cout << "PdbBankCache: stored " << key << " as " << bankfile << std::endl;
+  }
+}
+
+bool PdbBankCache::writeFile(const std::string &path, const std::string &content) const
+{
+  std::ostringstream tmpfile;
+  tmpfile << path << "." << gSystem->HostName() << "." << gSystem->GetPid() << ".tmp";
+  {
+    std::ofstream out(tmpfile.str());
+    if (!out)
+    {
+      return false;
+    }
+    out << content;
+    if (!out)
+    {
+      gSystem->Unlink(tmpfile.str().c_str());
+      return false;
+    }
+  }
+  if (rename(tmpfile.str().c_str(), path.c_str()) != 0)
+  {
+    gSystem->Unlink(tmpfile.str().c_str());
+    return false;
+  }
+  return true;
+}
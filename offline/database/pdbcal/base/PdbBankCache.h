@@ -0,0 +1,161 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef PDBCAL_BASE_PDBBANKCACHE_H
+#define PDBCAL_BASE_PDBBANKCACHE_H
+
+#include "PdbBankID.h"
+#include "PdbBankManager.h"
+
+#include <phool/PHTimeStamp.h>
+
+#include <ctime>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+class PdbApplication;
+class PdbCalBank;
+class PdbCalBankIterator;
+
+/*!
+ * \brief local file cache in front of a bank manager
+ *
+ * PdbBankCache replaces PdbBankManager::instance() and forwards everything
+ * to the bank manager which was registered before (the backend), except
+ * fetchBank. Fetched banks are stored in a cache directory, keyed by bank
+ * name, bank id, run number or search time and the max insert time.
+ * The banks themselves are stored once per content (md5 of the streamed bank),
+ * so identical banks found for different runs share one file:
+ *
+ *   cachedir/keys/<bankname>-<bankid>-r<run>-<maxinserttime>  (contains the md5)
+ *   cachedir/keys/<bankname>-<bankid>-t<tics>-<maxinserttime>
+ *   cachedir/banks/<md5>.root
+ *
+ * Files are written under a temporary name and renamed, so many jobs can
+ * share (and fill) the same cache directory.
+ *
+ * The cache is only used once a max insert time in the past is set
+ * (SetMaxInsertTime, or PDBCAL_CACHE_MAXINSERTTIME in unix time). Banks
+ * committed later have a later insert time and are ignored by the backend
+ * too, so a cached answer stays the one the backend would give and entries
+ * never have to expire. Until then, and while the max insert time is in the
+ * future, all fetches go to the backend.
+ *
+ * The cache is put in place by PgPostInstantiator if PDBCAL_CACHE_DIR is set,
+ * or by calling Register() after the backend is registered.
+ */
+class PdbBankCache : public PdbBankManager
+{
+ public:
+  //! put the cache in front of the current bank manager. Returns -1 if there is none
+  //! or the cache is already registered
+  static int Register(const std::string &cachedir);
+
+  //! Register with $PDBCAL_CACHE_DIR, does nothing if it is not set.
+  //! The max insert time is set from $PDBCAL_CACHE_MAXINSERTTIME if it is set
+  static int RegisterFromEnv();
+
+  //! the cache, nullptr if not registered
+  static PdbBankCache *instance() { return mySpecificCopy; }
+
+  ~PdbBankCache() override;
+
+  PdbCalBankIterator *getIterator() override { return m_Backend->getIterator(); }
+
+  PdbCalBank *createBank(const std::string &className, PdbBankID bankID, const std::string &description, PHTimeStamp &tStart, PHTimeStamp &tStop, const std::string &bankName) override
+  {
+    return m_Backend->createBank(className, bankID, description, tStart, tStop, bankName);
+  }
+
+  PdbCalBank *createBank(const int runNumber, const std::string &className, PdbBankID bankID, const std::string &description, const std::string &bankName, const time_t duration = 60) override
+  {
+    return m_Backend->createBank(runNumber, className, bankID, description, bankName, duration);
+  }
+
+  PdbCalBank *createBank(const int beginRunNumber, const int endRunNumber, const std::string &className, PdbBankID bankID, const std::string &description, const std::string &bankName) override
+  {
+    return m_Backend->createBank(beginRunNumber, endRunNumber, className, bankID, description, bankName);
+  }
+
+  //! cached fetch by run number, the run to time lookup is skipped on a hit
+  PdbCalBank *fetchBank(const std::string &className, PdbBankID bankID, const std::string &bankName, const int runNumber) override;
+
+  //! cached fetch by time stamp
+  PdbCalBank *fetchBank(const std::string &className, PdbBankID bankID, const std::string &bankName, const PHTimeStamp &searchTime) override;
+
+  PdbCalBank *fetchClosestBank(const std::string &className, PdbBankID bankID, const std::string &bankName, const int runNumber) override
+  {
+    return m_Backend->fetchClosestBank(className, bankID, bankName, runNumber);
+  }
+
+  PdbCalBank *fetchClosestBank(const std::string &className, PdbBankID bankID, const std::string &bankName, PHTimeStamp &searchTime) override
+  {
+    return m_Backend->fetchClosestBank(className, bankID, bankName, searchTime);
+  }
+
+  PdbApplication *getApplication() override { return m_Backend->getApplication(); }
+
+  void fillCalibObject(PdbCalBank *bank, const std::string &className, PHTimeStamp &tSearch) override
+  {
+    m_Backend->fillCalibObject(bank, className, tSearch);
+  }
+
+  void GetUsedBankRids(std::map<std::string, std::set<int> > &usedbanks) const override { m_Backend->GetUsedBankRids(usedbanks); }
+  void ClearUsedBankRids() override { m_Backend->ClearUsedBankRids(); }
+  void SetMaxInsertTime(const PHTimeStamp &tMax) override;
+
+  //! true if fetches are served from the cache, i.e. the max insert time is set and in the past
+  bool isActive() const;
+
+  //! fetch the bank for each run into the cache, returns the number of runs without bank (all of them if the cache is not active)
+  int Prefetch(const std::string &className, PdbBankID bankID, const std::string &bankName, const std::vector<int> &runs);
+
+  //! the manager behind the cache
+  PdbBankManager *getBackend() { return m_Backend; }
+
+  const std::string &getCacheDir() const { return m_CacheDir; }
+
+  //!@name statistics
+  //@{
+  unsigned int getHits() const { return m_Hits; }
+  unsigned int getMisses() const { return m_Misses; }
+  //! banks written to the cache (a miss whose content is already cached is not written again)
+  unsigned int getStored() const { return m_Stored; }
+  //! unreadable cache entries, they count as misses
+  unsigned int getErrors() const { return m_Errors; }
+  void Print() const;
+  //@}
+
+  void Verbosity(const int i) { m_Verbosity = i; }
+  int Verbosity() const { return m_Verbosity; }
+
+ protected:
+  PdbBankCache(PdbBankManager *backend, const std::string &cachedir);
+
+ private:
+  //! cache lookup, nullptr on miss
+  PdbCalBank *readBank(const std::string &key);
+
+  //! store a bank fetched from the backend
+  void writeBank(const std::string &key, PdbCalBank *bank);
+
+  //! write content to path, through a temporary file
+  bool writeFile(const std::string &path, const std::string &content) const;
+
+  std::string makeKey(const std::string &bankName, PdbBankID bankID, const std::string &search) const;
+
+  static PdbBankCache *mySpecificCopy;
+
+  PdbBankManager *m_Backend = nullptr;
+  std::string m_CacheDir;
+  PHTimeStamp m_MaxInsertTime;
+  bool m_MaxInsertTimeSet = false;
+  int m_Verbosity = 0;
+  unsigned int m_Hits = 0;
+  unsigned int m_Misses = 0;
+  unsigned int m_Stored = 0;
+  unsigned int m_Errors = 0;
+};
+
+#endif /* PDBCAL_BASE_PDBBANKCACHE_H */
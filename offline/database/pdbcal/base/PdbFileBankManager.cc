@@ -0,0 +1,205 @@
+#include "PdbFileBankManager.h"
+
+#include "PdbApplication.h"
+#include "PdbCalBank.h"
+#include "RunToTime.h"
+
+#include <phool/phool.h>
+
+#include <TDirectory.h>
+#include <TFile.h>
+#include <TObject.h>
+#include <TSystem.h>
+
+#include <iostream>
+#include <sstream>
+
+PdbFileBankManager *PdbFileBankManager::mySpecificCopy = nullptr;
+
+int PdbFileBankManager::Register(const std::string &dir)
+{
+  if (__instance)
+  {
+    return -1;
+  }
+  mySpecificCopy = new PdbFileBankManager(dir);
+  __instance = mySpecificCopy;
+  return 0;
+}
+
+PdbFileBankManager::PdbFileBankManager(const std::string &dir)
+  : m_Dir(dir)
+{
+  m_MaxInsertTime.setToFarFuture();
+}
+
+PdbFileBankManager::~PdbFileBankManager()
+{
+  mySpecificCopy = nullptr;
+}
+
+int PdbFileBankManager::WriteBank(const std::string &dir, PdbCalBank *bank, const std::string &bankName, PdbBankID bankID,
+                                  const PHTimeStamp &tStart, const PHTimeStamp &tStop, const PHTimeStamp &tInsert)
+{
+  std::ostringstream fname;
+  fname << dir << "/" << bankName << "-" << bankID.getInternalValue()
+        << "-" << tStart.getTics() << "-" << tStop.getTics() << "-" << tInsert.getTics()
+        << ".root";
+  TDirectory::TContext context;
+  TFile *f = TFile::Open(fname.str().c_str(), "RECREATE");
+  if (!f || f->IsZombie())
+  {
+    std::cout << PHWHERE << " cannot open " << fname.str() << std::endl;
+    delete f;
+    return -1;
+  }
+  f->WriteTObject(bank, "bank");
+  delete f;
+  return 0;
+}
+
+PdbCalBank *
+PdbFileBankManager::fetchBank(const std::string &className, PdbBankID bankID, const std::string &bankName, const int runNumber)
+{
+  std::map<int, PHTimeStamp>::const_iterator iter = m_RunBeginTime.find(runNumber);
+  if (iter != m_RunBeginTime.end())
+  {
+    return fetchBank(className, bankID, bankName, iter->second);
+  }
+  RunToTime *runTime = RunToTime::instance();
+  if (!runTime)
+  {
+    std::cout << PHWHERE << " no begin time for run " << runNumber << std::endl;
+    m_FetchCount++;
+    return nullptr;
+  }
+  PHTimeStamp *runBeginTime = runTime->getBeginTime(runNumber);
+  if (!runBeginTime)
+  {
+    m_FetchCount++;
+    return nullptr;
+  }
+  PHTimeStamp searchTime = *runBeginTime;
+  delete runBeginTime;
+  return fetchBank(className, bankID, bankName, searchTime);
+}
+
+PdbCalBank *
+PdbFileBankManager::fetchBank(const std::string & /*className*/, PdbBankID bankID, const std::string &bankName, const PHTimeStamp &searchTime)
+{
+  m_FetchCount++;
+  std::ostringstream prefix;
+  prefix << bankName << "-" << bankID.getInternalValue() << "-";
+  const time_t search = searchTime.getTics();
+  const time_t maxinsert = m_MaxInsertTime.getTics();
+
+  std::string bestfile;
+  time_t bestinsert = 0;
+  void *dirp = gSystem->OpenDirectory(m_Dir.c_str());
+  if (!dirp)
+  {
+    std::cout << PHWHERE << " cannot open directory " << m_Dir << std::endl;
+    return nullptr;
+  }
+  while (const char *entry = gSystem->GetDirEntry(dirp))
+  {
+    const std::string fname(entry);
+    if (fname.compare(0, prefix.str().size(), prefix.str()) != 0)
+    {
+      continue;
+    }
+    // <startvaltime>-<endvaltime>-<inserttime>.root
+    std::istringstream times(fname.substr(prefix.str().size()));
+    time_t start;
+    time_t stop;
+    time_t insert;
+    char sep1;
+    char sep2;
+    std::string extension;
+    if (!(times >> start >> sep1 >> stop >> sep2 >> insert >> extension) ||
+        sep1 != '-' || sep2 != '-' || extension != ".root")
+    {
+      continue;
+    }
+    if (start > search || stop <= search || insert > maxinsert)
+    {
+      continue;
+    }
+    if (bestfile.empty() || insert > bestinsert)
+    {
+      bestfile = fname;
+      bestinsert = insert;
+    }
+  }
+  gSystem->FreeDirectory(dirp);
+
+  if (bestfile.empty())
+  {
+    std::cout << PHWHERE << "NO Bank found : " << prefix.str() << " valid at " << search
+              << " in " << m_Dir << std::endl;
+    return nullptr;
+  }
+  TDirectory::TContext context;
+  TFile *f = TFile::Open((m_Dir + "/" + bestfile).c_str());
+  PdbCalBank *bank = nullptr;
+  if (f && !f->IsZombie())
+  {
+    TObject *obj = f->Get("bank");
+    bank = dynamic_cast<PdbCalBank *>(obj);
+    if (!bank)
+    {
+      std::cout << PHWHERE << " no PdbCalBank in " << bestfile << std::endl;
+      delete obj;
+    }
+  }
+  delete f;
+  return bank;
+}
+
+PdbCalBankIterator *
+PdbFileBankManager::getIterator()
+{
+  std::cout << PHWHERE << " not implemented for the file stand-in" << std::endl;
+  return nullptr;
+}
+
+PdbCalBank *
+PdbFileBankManager::createBank(const std::string &, PdbBankID, const std::string &, PHTimeStamp &, PHTimeStamp &, const std::string &)
+{
+  std::cout << PHWHERE << " not implemented for the file stand-in, use WriteBank" << std::endl;
+  return nullptr;
+}
+
+PdbCalBank *
+PdbFileBankManager::createBank(const int, const std::string &, PdbBankID, const std::string &, const std::string &, const time_t)
+{
+  std::cout << PHWHERE << " not implemented for the file stand-in, use WriteBank" << std::endl;
+  return nullptr;
+}
+
+PdbCalBank *
+PdbFileBankManager::createBank(const int, const int, const std::string &, PdbBankID, const std::string &, const std::string &)
+{
+  std::cout << PHWHERE << " not implemented for the file stand-in, use WriteBank" << std::endl;
+  return nullptr;
+}
+
+PdbCalBank *
+PdbFileBankManager::fetchClosestBank(const std::string &, PdbBankID, const std::string &, const int)
+{
+  std::cout << PHWHERE << " not implemented for the file stand-in" << std::endl;
+  return nullptr;
+}
+
+PdbCalBank *
+PdbFileBankManager::fetchClosestBank(const std::string &, PdbBankID, const std::string &, PHTimeStamp &)
+{
+  std::cout << PHWHERE << " not implemented for the file stand-in" << std::endl;
+  return nullptr;
+}
+
+PdbApplication *
+PdbFileBankManager::getApplication()
+{
+  return PdbApplication::instance();
+}
@@ -0,0 +1,83 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef PDBCAL_BASE_PDBFILEBANKMANAGER_H
+#define PDBCAL_BASE_PDBFILEBANKMANAGER_H
+
+#include "PdbBankID.h"
+#include "PdbBankManager.h"
+
+#include <phool/PHTimeStamp.h>
+
+#include <ctime>
+#include <map>
+#include <string>
+
+class PdbApplication;
+class PdbCalBank;
+class PdbCalBankIterator;
+
+/*!
+ * \brief file based stand-in for the calibration database (read only)
+ *
+ * Banks are read from root files in one directory, named like the
+ * parameter files of PHParameters::WriteToFile
+ *
+ *   <bankname>-<bankid>-<startvaltime>-<endvaltime>-<inserttime>.root
+ *
+ * each containing a PdbCalBank under the key "bank" (see WriteBank).
+ * fetchBank selects the bank like the database does: valid at the search
+ * time, latest insert time not after the max insert time.
+ * Meant for tests of the bank users and of PdbBankCache without database.
+ */
+class PdbFileBankManager : public PdbBankManager
+{
+ public:
+  //! use the banks in dir as database. Returns -1 if a bank manager is already registered
+  static int Register(const std::string &dir);
+
+  //! the file manager, nullptr if not registered
+  static PdbFileBankManager *instance() { return mySpecificCopy; }
+
+  ~PdbFileBankManager() override;
+
+  //! write bank into dir with the given validity range and insert time
+  static int WriteBank(const std::string &dir, PdbCalBank *bank, const std::string &bankName, PdbBankID bankID,
+                       const PHTimeStamp &tStart, const PHTimeStamp &tStop, const PHTimeStamp &tInsert);
+
+  //! begin time of a run, used by the fetch by run number. RunToTime is used for runs which are not set
+  void setRunBeginTime(const int runNumber, const PHTimeStamp &beginTime) { m_RunBeginTime[runNumber] = beginTime; }
+
+  //! fetches which were done (also the unsuccessful ones)
+  unsigned int getFetchCount() const { return m_FetchCount; }
+
+  // banks cannot be created or iterated over in the stand-in
+  PdbCalBankIterator *getIterator() override;
+  PdbCalBank *createBank(const std::string &, PdbBankID, const std::string &, PHTimeStamp &, PHTimeStamp &, const std::string &) override;
+  PdbCalBank *createBank(const int, const std::string &, PdbBankID, const std::string &, const std::string &, const time_t duration = 60) override;
+  PdbCalBank *createBank(const int, const int, const std::string &, PdbBankID, const std::string &, const std::string &) override;
+
+  PdbCalBank *fetchBank(const std::string &className, PdbBankID bankID, const std::string &bankName, const int runNumber) override;
+  PdbCalBank *fetchBank(const std::string &className, PdbBankID bankID, const std::string &bankName, const PHTimeStamp &searchTime) override;
+
+  PdbCalBank *fetchClosestBank(const std::string &, PdbBankID, const std::string &, const int) override;
+  PdbCalBank *fetchClosestBank(const std::string &, PdbBankID, const std::string &, PHTimeStamp &) override;
+
+  PdbApplication *getApplication() override;
+
+  void fillCalibObject(PdbCalBank *, const std::string &, PHTimeStamp &) override {}
+
+  void SetMaxInsertTime(const PHTimeStamp &tMax) override { m_MaxInsertTime = tMax; }
+
+ protected:
+  explicit PdbFileBankManager(const std::string &dir);
+
+ private:
+  static PdbFileBankManager *mySpecificCopy;
+
+  std::string m_Dir;
+  PHTimeStamp m_MaxInsertTime;
+  std::map<int, PHTimeStamp> m_RunBeginTime;
+  unsigned int m_FetchCount = 0;
+};
+
+#endif /* PDBCAL_BASE_PDBFILEBANKMANAGER_H */
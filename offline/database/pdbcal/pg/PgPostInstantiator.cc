@@ -2,6 +2,8 @@
 #include "PgPostBankManager.h"
 #include "RunToTimePg.h"
 
+#include <pdbcalbase/PdbBankCache.h>
+
 namespace
 {
 int PgPostApp = PgPostApplication::Register();
@@ -9,6 +11,9 @@ int PgPostApp = PgPostApplication::Register();
 int PgPostBank = PgPostBankManager::Register();
 
 int PgPostrtt = RunToTimePg::Register();
+
+// local bank cache in front of the database if PDBCAL_CACHE_DIR is set
+int PgPostCache = PdbBankCache::RegisterFromEnv();
 }  // namespace
 
 //_xd __xd;
@@ -0,0 +1,106 @@
+// fills a local bank cache (see PdbBankCache) from the database before
+// jobs start, so the jobs read their calibrations from the cache only.
+//
+// usage: pdbcalPrefetch <cachedir> <max insert time> <bank class> <bank name> <bank id> <run list file>
+//        pdbcalPrefetch <cachedir> <max insert time> <bank class> <bank name> <bank id> -t <tics> [<tics> ...]
+//
+// the max insert time (unix time, not in the future) fixes the DB content which is cached.
+// The run list file contains run numbers separated by white space. The parameters
+// read by PHParameters::ReadFromDB are fetched with time stamp 10, e.g.
+//   pdbcalPrefetch /cache 1600000000 PdbParameterMapBank cemc_geoparams 0 -t 10
+// The jobs use the cache with PDBCAL_CACHE_DIR=<cachedir> and
+// PDBCAL_CACHE_MAXINSERTTIME=<max insert time>
+
+#include <pdbcalbase/PdbApplication.h>
+#include <pdbcalbase/PdbBankCache.h>
+#include <pdbcalbase/PdbBankID.h>
+#include <pdbcalbase/PdbBankManager.h>
+#include <pdbcalbase/PdbCalBank.h>
+
+#include <phool/PHTimeStamp.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  void usage()
+  {
+    std::cout << "usage: pdbcalPrefetch <cachedir> <max insert time> <bank class> <bank name> <bank id> <run list file>" << std::endl;
+    std::cout << "       pdbcalPrefetch <cachedir> <max insert time> <bank class> <bank name> <bank id> -t <tics> [<tics> ...]" << std::endl;
+  }
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+  if (argc < 7)
+  {
+    usage();
+    return 1;
+  }
+  const std::string cachedir = argv[1];
+  const PHTimeStamp maxinserttime(static_cast<time_t>(atol(argv[2])));
+  const std::string classname = argv[3];
+  const std::string bankname = argv[4];
+  const PdbBankID bankid(atoi(argv[5]));
+
+  // the cache is already registered if PDBCAL_CACHE_DIR is set
+  PdbBankCache::Register(cachedir);
+  PdbBankCache *cache = PdbBankCache::instance();
+  if (!cache)
+  {
+    std::cout << "no database connection, cannot prefetch" << std::endl;
+    return 1;
+  }
+  if (cache->getCacheDir() != cachedir)
+  {
+    std::cout << "PDBCAL_CACHE_DIR is set to " << cache->getCacheDir()
+              << ", unset it or use it as cachedir" << std::endl;
+    return 1;
+  }
+  cache->SetMaxInsertTime(maxinserttime);
+  if (!cache->isActive())
+  {
+    std::cout << "max insert time " << argv[2] << " is in the future, banks could still be added" << std::endl;
+    return 1;
+  }
+  cache->getApplication()->startRead();
+
+  int nmissing = 0;
+  if (std::string(argv[6]) == "-t")
+  {
+    for (int i = 7; i < argc; i++)
+    {
+      PHTimeStamp searchtime(atol(argv[i]));
+      PdbCalBank *bank = cache->fetchBank(classname, bankid, bankname, searchtime);
+      if (!bank)
+      {
+        std::cout << "no " << bankname << " bank for time stamp " << argv[i] << std::endl;
+        nmissing++;
+        continue;
+      }
+      delete bank;
+    }
+  }
+  else
+  {
+    std::ifstream runlist(argv[6]);
+    if (!runlist)
+    {
+      std::cout << "cannot open run list " << argv[6] << std::endl;
+      return 1;
+    }
+    std::vector<int> runs;
+    int run;
+    while (runlist >> run)
+    {
+      runs.push_back(run);
+    }
+    nmissing = cache->Prefetch(classname, bankid, bankname, runs);
+  }
+  cache->Print();
+  return (nmissing > 0) ? 1 : 0;
+}
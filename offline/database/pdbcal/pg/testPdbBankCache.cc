@@ -0,0 +1,121 @@
+// checks PdbBankCache in front of PdbFileBankManager, the file based stand-in for the database:
+// nothing is cached without a max insert time in the past, cached banks are the ones
+// the backend returns for the same max insert time, and banks committed later are not seen
+// run with make check
+
+#include "PgPostParameterBank.h"
+
+#include <pdbcalbase/PdbBankCache.h>
+#include <pdbcalbase/PdbBankID.h>
+#include <pdbcalbase/PdbBankManager.h>
+#include <pdbcalbase/PdbCalBank.h>
+#include <pdbcalbase/PdbFileBankManager.h>
+#include <pdbcalbase/PdbParameter.h>
+
+#include <phool/PHTestCheck.h>
+#include <phool/PHTimeStamp.h>
+
+#include <TSystem.h>
+
+#include <ctime>
+#include <string>
+
+namespace
+{
+  PHTestCheck check("testPdbBankCache");
+
+  const std::string kDbDir = "testPdbBankCache_db";
+  const std::string kCacheDir = "testPdbBankCache_cache";
+  const std::string kClassName = "PgPostParameterBank";
+  const std::string kBankName = "testbank";
+  const PdbBankID kBankID(3);
+  const int kRun = 12;
+  const time_t kRunBeginTime = 150;
+
+  //! bank valid from 100 to 200, with one parameter
+  void write_bank(double value, time_t inserttime)
+  {
+    PgPostParameterBank bank;
+    bank.setLength(1);
+    static_cast<PdbParameter &>(bank.getEntry(0)) = PdbParameter(value, "value");
+    PdbFileBankManager::WriteBank(kDbDir, &bank, kBankName, kBankID,
+                                  PHTimeStamp(static_cast<time_t>(100)), PHTimeStamp(static_cast<time_t>(200)), PHTimeStamp(inserttime));
+  }
+
+  //! parameter of the bank, -1 if there is none. Deletes the bank
+  double value(PdbCalBank *bank)
+  {
+    const double value = (bank && bank->getLength() == 1) ? static_cast<PdbParameter &>(bank->getEntry(0)).getParameter() : -1;
+    delete bank;
+    return value;
+  }
+
+  double fetch_run(PdbBankManager *manager)
+  {
+    return value(manager->fetchBank(kClassName, kBankID, kBankName, kRun));
+  }
+
+  double fetch_time(PdbBankManager *manager)
+  {
+    return value(manager->fetchBank(kClassName, kBankID, kBankName, PHTimeStamp(kRunBeginTime)));
+  }
+}  // namespace
+
+int main()
+{
+  gSystem->Exec(("rm -rf " + kDbDir + " " + kCacheDir).c_str());
+  gSystem->mkdir(kDbDir.c_str(), true);
+
+  write_bank(1, 1000);
+
+  PdbFileBankManager::Register(kDbDir);
+  PdbFileBankManager *db = PdbFileBankManager::instance();
+  db->setRunBeginTime(kRun, PHTimeStamp(kRunBeginTime));
+  check(PdbBankCache::Register(kCacheDir) == 0, "register cache");
+  PdbBankCache *cache = PdbBankCache::instance();
+  if (!cache)
+  {
+    return check.result();
+  }
+
+  // no max insert time, every fetch goes to the backend
+  check(!cache->isActive(), "inactive without max insert time");
+  check(fetch_run(cache) == 1 && fetch_run(cache) == 1, "fetch without max insert time");
+  check(db->getFetchCount() == 2, "backend fetched without max insert time");
+  check(cache->getStored() == 0 && cache->getHits() == 0, "nothing cached without max insert time");
+
+  // fixed max insert time, a miss then hits
+  cache->SetMaxInsertTime(PHTimeStamp(static_cast<time_t>(2000)));
+  check(cache->isActive(), "active with max insert time in the past");
+  check(fetch_run(cache) == 1, "fetch by run, miss");
+  check(fetch_run(cache) == 1, "fetch by run, hit");
+  check(fetch_time(cache) == 1, "fetch by time, miss");
+  check(fetch_time(cache) == 1, "fetch by time, hit");
+  check(db->getFetchCount() == 4, "backend fetched on misses only");
+  check(cache->getHits() == 2 && cache->getMisses() == 2, "hits and misses");
+  check(cache->getStored() == 1, "identical banks stored once");
+
+  // a bank committed later is ignored by the backend for the same max insert time, so the cache is still right
+  write_bank(2, 3000);
+  check(fetch_run(cache) == 1, "later bank not seen, hit");
+  check(fetch_run(db) == 1, "later bank not seen by the backend");
+
+  // and seen with a later max insert time
+  cache->SetMaxInsertTime(PHTimeStamp(static_cast<time_t>(4000)));
+  check(fetch_run(cache) == 2, "later bank seen with later max insert time");
+  check(cache->getStored() == 2, "later bank stored");
+
+  // banks can still be committed before a max insert time in the future, nothing is cached
+  PHTimeStamp future;
+  future += 24 * 3600;
+  cache->SetMaxInsertTime(future);
+  check(!cache->isActive(), "inactive with max insert time in the future");
+  const unsigned int fetches = db->getFetchCount();
+  const unsigned int hits = cache->getHits();
+  check(fetch_run(cache) == 2 && fetch_run(cache) == 2, "fetch with max insert time in the future");
+  check(db->getFetchCount() == fetches + 2 && cache->getHits() == hits, "backend fetched with max insert time in the future");
+
+  cache->Print();
+  gSystem->Exec(("rm -rf " + kDbDir + " " + kCacheDir).c_str());
+  return check.result();
+}
@@ -1,5 +1,7 @@
 #include "Fun4AllPrdfInputManager.h"
 
+#include "PrdfReadAheadReader.h"
+
 #include <fun4all/Fun4AllInputManager.h>  // for Fun4AllInputManager
 #include <fun4all/Fun4AllReturnCodes.h>
 #include <fun4all/Fun4AllServer.h>
@@ -23,6 +25,7 @@
 #include <Event/fileEventiterator.h>
 
 #include <cassert>
+#include <chrono>
 #include <cstdlib>
 #include <iostream>  // for operator<<, basic_ostream, endl
 #include <utility>   // for pair
@@ -37,8 +40,11 @@ Fun4AllPrdfInputManager::Fun4AllPrdfInputManager(const string &name, const strin
   , m_Event(nullptr)
   , m_SaveEvent(nullptr)
   , m_EventIterator(nullptr)
+  , m_ReadAheadReader(nullptr)
   , m_SyncObject(new SyncObjectv1())
   , m_PrdfNodeName(prdfnodename)
+  , m_ReadAheadQueueSize(0)
+  , m_ReadAheadBatchSize(10)
 {
   Fun4AllServer *se = Fun4AllServer::instance();
   m_topNode = se->topNode(TopNodeName());
@@ -87,6 +93,13 @@ int Fun4AllPrdfInputManager::fileopen(const string &filenam)
     cout << PHWHERE << Name() << ": could not open file " << fname << endl;
     return -1;
   }
+  m_CurrentFileStatistics = FileStatistics();
+  if (m_ReadAheadQueueSize > 0)
+  {
+    // the reader takes ownership of the event iterator
+    m_ReadAheadReader = new PrdfReadAheadReader(m_EventIterator, m_ReadAheadQueueSize, m_ReadAheadBatchSize);
+    m_EventIterator = nullptr;
+  }
   pair<int, int> runseg = Fun4AllUtils::GetRunSegment(fname);
   m_Segment = runseg.second;
   IsOpen(1);
@@ -133,7 +146,7 @@ readagain:
   }
   else
   {
-    m_Event = m_EventIterator->getNextEvent();
+    m_Event = GetNextEvent();
   }
   PrdfNode->setData(m_Event);
   if (!m_Event)
@@ -171,6 +184,9 @@ int Fun4AllPrdfInputManager::fileclose()
     cout << Name() << ": fileclose: No Input file open" << endl;
     return -1;
   }
+  UpdateFileStatistics();
+  delete m_ReadAheadReader;
+  m_ReadAheadReader = nullptr;
   delete m_EventIterator;
   m_EventIterator = nullptr;
   IsOpen(0);
@@ -183,6 +199,20 @@ int Fun4AllPrdfInputManager::fileclose()
 void Fun4AllPrdfInputManager::Print(const string &what) const
 {
   Fun4AllInputManager::Print(what);
+  if (what == "ALL" || what == "STATISTICS")
+  {
+    for (auto &iter : m_FileStatistics)
+    {
+      const FileStatistics &stat = iter.second;
+      cout << Name() << ": " << iter.first << ": " << stat.events << " events, "
+           << stat.bytes / 1e6 << " MB, read time " << stat.read_time << " s";
+      if (stat.read_time > 0)
+      {
+        cout << " (" << stat.bytes / 1e6 / stat.read_time << " MB/s)";
+      }
+      cout << ", processing waited " << stat.wait_time << " s" << endl;
+    }
+  }
   return;
 }
 
@@ -216,7 +246,7 @@ int Fun4AllPrdfInputManager::PushBackEvents(const int i)
          << endl;
     return -1;
   }
-  if (!m_EventIterator)
+  if (!m_EventIterator && !m_ReadAheadReader)
   {
     cout << PHWHERE << Name()
          << " no file open" << endl;
@@ -229,7 +259,7 @@ int Fun4AllPrdfInputManager::PushBackEvents(const int i)
   int errorflag = 0;
   while (nevents > 0 && !errorflag)
   {
-    m_Event = m_EventIterator->getNextEvent();
+    m_Event = GetNextEvent();
     if (!m_Event)
     {
       cout << "Error after skipping " << i - nevents
@@ -292,3 +322,47 @@ int Fun4AllPrdfInputManager::SyncIt(const SyncObject *mastersync)
   }
   return Fun4AllReturnCodes::SYNC_OK;
 }
+
+Event *Fun4AllPrdfInputManager::GetNextEvent()
+{
+  Event *evt = nullptr;
+  if (m_ReadAheadReader)
+  {
+    evt = m_ReadAheadReader->getNextEvent();
+  }
+  else
+  {
+    const auto start = chrono::steady_clock::now();
+    evt = m_EventIterator->getNextEvent();
+    const double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    m_CurrentFileStatistics.read_time += elapsed;
+    m_CurrentFileStatistics.wait_time += elapsed;
+  }
+  if (evt)
+  {
+    m_CurrentFileStatistics.events++;
+    m_CurrentFileStatistics.bytes += 4. * evt->getEvtLength();  // evtlength is in 32bit words
+  }
+  return evt;
+}
+
+void Fun4AllPrdfInputManager::UpdateFileStatistics()
+{
+  if (m_ReadAheadReader)
+  {
+    m_CurrentFileStatistics.read_time = m_ReadAheadReader->ReadTime();
+    m_CurrentFileStatistics.wait_time = m_ReadAheadReader->WaitTime();
+  }
+  FileStatistics &stat = m_FileStatistics[FileName()];
+  stat.events += m_CurrentFileStatistics.events;
+  stat.bytes += m_CurrentFileStatistics.bytes;
+  stat.read_time += m_CurrentFileStatistics.read_time;
+  stat.wait_time += m_CurrentFileStatistics.wait_time;
+  if (Verbosity() > 0)
+  {
+    cout << Name() << ": closing " << FileName() << " after " << m_CurrentFileStatistics.events << " events, "
+         << m_CurrentFileStatistics.bytes / 1e6 << " MB, read time " << m_CurrentFileStatistics.read_time
+         << " s, processing waited " << m_CurrentFileStatistics.wait_time << " s" << endl;
+  }
+  m_CurrentFileStatistics = FileStatistics();
+}
@@ -5,11 +5,13 @@
 
 #include <fun4all/Fun4AllInputManager.h>
 
+#include <map>
 #include <string>
 
 class Event;
 class Eventiterator;
 class PHCompositeNode;
+class PrdfReadAheadReader;
 class SyncObject;
 
 class Fun4AllPrdfInputManager : public Fun4AllInputManager
@@ -28,7 +30,32 @@ class Fun4AllPrdfInputManager : public Fun4AllInputManager
   int SyncIt(const SyncObject *mastersync);
   int HasSyncObject() const {return 1;}
 
+  //! read events in a background thread, with up to queue_size events read ahead, in batches of batch_size.
+  //! Applies to files opened afterwards. queue_size = 0 reads events on the processing thread (default)
+  void ReadAhead(const unsigned int queue_size, const unsigned int batch_size = 10)
+  {
+    m_ReadAheadQueueSize = queue_size;
+    m_ReadAheadBatchSize = batch_size;
+  }
+
  private:
+  //! per file reading statistics
+  struct FileStatistics
+  {
+    int events = 0;
+    double bytes = 0;
+    //! time spent reading events, on the processing or the reader thread (s)
+    double read_time = 0;
+    //! time the processing thread spent waiting for events (s)
+    double wait_time = 0;
+  };
+
+  //! next event from current file, from the read ahead queue if enabled
+  Event *GetNextEvent();
+
+  //! update and print the statistics of the current file
+  void UpdateFileStatistics();
+
   int m_Segment;
   int m_EventsTotal;
   int m_EventsThisFile;
@@ -36,8 +63,13 @@ class Fun4AllPrdfInputManager : public Fun4AllInputManager
   Event *m_Event;
   Event *m_SaveEvent;
   Eventiterator *m_EventIterator;
+  PrdfReadAheadReader *m_ReadAheadReader;
   SyncObject *m_SyncObject;
   std::string m_PrdfNodeName;
+  unsigned int m_ReadAheadQueueSize;
+  unsigned int m_ReadAheadBatchSize;
+  FileStatistics m_CurrentFileStatistics;
+  std::map<std::string, FileStatistics> m_FileStatistics;
 };
 
 #endif /* FUN4ALL_FUN4ALLPRDFINPUTMANAGER_H */
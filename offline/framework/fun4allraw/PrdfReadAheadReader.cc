@@ -0,0 +1,127 @@
+#include "PrdfReadAheadReader.h"
+
+#include <Event/Event.h>
+#include <Event/Eventiterator.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+//_____________________________________________________________________________
+PrdfReadAheadReader::PrdfReadAheadReader(Eventiterator *eventiterator, unsigned int queue_size, unsigned int batch_size)
+  : m_EventIterator(eventiterator)
+  , m_QueueSize(std::max(queue_size, 1u))
+  , m_BatchSize(std::min(std::max(batch_size, 1u), m_QueueSize))
+{
+  m_ReaderThread = std::thread(&PrdfReadAheadReader::read_events, this);
+}
+
+//_____________________________________________________________________________
+PrdfReadAheadReader::~PrdfReadAheadReader()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stop = true;
+  }
+  m_RoomAvailable.notify_all();
+  m_ReaderThread.join();
+
+  for (Event *evt : m_Batch)
+  {
+    delete evt;
+  }
+  for (Event *evt : m_Events)
+  {
+    delete evt;
+  }
+  delete m_EventIterator;
+}
+
+//_____________________________________________________________________________
+Event *PrdfReadAheadReader::getNextEvent()
+{
+  if (m_Batch.empty())
+  {
+    const auto start = std::chrono::steady_clock::now();
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_EventAvailable.wait(lock, [this] { return !m_Events.empty() || m_ReadDone; });
+      m_Batch.swap(m_Events);
+    }
+    m_RoomAvailable.notify_one();
+    m_WaitTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (m_Batch.empty())
+    {
+      // end of file
+      return nullptr;
+    }
+  }
+
+  Event *evt = m_Batch.front();
+  m_Batch.pop_front();
+  return evt;
+}
+
+//_____________________________________________________________________________
+double PrdfReadAheadReader::ReadTime() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_ReadTime;
+}
+
+//_____________________________________________________________________________
+double PrdfReadAheadReader::BytesRead() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_BytesRead;
+}
+
+//_____________________________________________________________________________
+void PrdfReadAheadReader::read_events()
+{
+  std::vector<Event *> batch;
+  batch.reserve(m_BatchSize);
+  bool done = false;
+  while (!done)
+  {
+    // read a batch without holding the lock
+    const auto start = std::chrono::steady_clock::now();
+    double bytes = 0;
+    while (batch.size() < m_BatchSize)
+    {
+      Event *evt = m_EventIterator->getNextEvent();
+      if (!evt)
+      {
+        done = true;
+        break;
+      }
+      // the event points into the buffer of the event iterator, which is
+      // overwritten by the next reads. Make it own its data before queuing it
+      evt->convert();
+      bytes += 4. * evt->getEvtLength();  // evtlength is in 32bit words
+      batch.push_back(evt);
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    {
+      // wait for room in the queue (the consumer holds at most one batch on its side)
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_RoomAvailable.wait(lock, [this, &batch] { return m_Stop || m_Events.size() + batch.size() <= m_QueueSize; });
+      m_ReadTime += elapsed;
+      m_BytesRead += bytes;
+      if (m_Stop)
+      {
+        for (Event *evt : batch)
+        {
+          delete evt;
+        }
+        return;
+      }
+      m_Events.insert(m_Events.end(), batch.begin(), batch.end());
+      m_ReadDone = done;
+    }
+    m_EventAvailable.notify_all();
+    batch.clear();
+  }
+}
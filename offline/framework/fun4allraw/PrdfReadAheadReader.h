@@ -0,0 +1,79 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef FUN4ALLRAW_PRDFREADAHEADREADER_H
+#define FUN4ALLRAW_PRDFREADAHEADREADER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+class Event;
+class Eventiterator;
+
+/*!
+ * reads events from an Eventiterator in a background thread.
+ * Events are read in batches of batch_size and queued, with at most queue_size events in the queue.
+ * The consumer takes all queued events at once, so the lock is taken at most once per batch.
+ * Events are handed back in file order by getNextEvent
+ */
+class PrdfReadAheadReader
+{
+ public:
+  //! constructor. Takes ownership of the event iterator and starts the reader thread
+  PrdfReadAheadReader(Eventiterator *eventiterator, unsigned int queue_size = 100, unsigned int batch_size = 10);
+
+  //! destructor. Stops the thread, deletes events not consumed and the event iterator
+  ~PrdfReadAheadReader();
+
+  //! next event, in file order. Caller takes ownership. Returns nullptr at end of file
+  Event *getNextEvent();
+
+  //! time spent in the reader thread reading events (s)
+  double ReadTime() const;
+
+  //! time spent by the consumer waiting for events (s)
+  double WaitTime() const { return m_WaitTime; }
+
+  //! number of bytes read
+  double BytesRead() const;
+
+ private:
+  //! reader thread
+  void read_events();
+
+  Eventiterator *m_EventIterator = nullptr;
+  unsigned int m_QueueSize = 100;
+  unsigned int m_BatchSize = 10;
+
+  std::thread m_ReaderThread;
+
+  //! events taken from the queue, not yet handed to the consumer. Only accessed by the consumer
+  std::deque<Event *> m_Batch;
+
+  double m_WaitTime = 0;
+
+  //!@name shared state, protected by m_Mutex
+  //@{
+  mutable std::mutex m_Mutex;
+
+  //! notified when events are queued, or reading is done
+  std::condition_variable m_EventAvailable;
+
+  //! notified when events are consumed
+  std::condition_variable m_RoomAvailable;
+
+  std::deque<Event *> m_Events;
+
+  double m_ReadTime = 0;
+  double m_BytesRead = 0;
+
+  //! true when the reader thread is done
+  bool m_ReadDone = false;
+
+  //! true when stopping
+  bool m_Stop = false;
+  //@}
+};
+
+#endif
@@ -0,0 +1,176 @@
+// writes a PRDF file, copies it with Fun4AllPrdfInputManager and Fun4AllFileOutStream
+// with and without read ahead, and checks that both copies are byte identical
+// run with make check
+
+#include "Fun4AllFileOutStream.h"
+#include "Fun4AllPrdfInputManager.h"
+
+#include <fun4all/Fun4AllReturnCodes.h>
+#include <fun4all/Fun4AllServer.h>
+#include <fun4all/SubsysReco.h>
+
+#include <phool/getClass.h>
+#include <phool/PHTestCheck.h>
+
+#include <Event/Event.h>
+#include <Event/EventTypes.h>
+#include <Event/fileEventiterator.h>
+#include <Event/oBuffer.h>
+#include <Event/packet.h>
+#include <Event/packetConstants.h>
+#include <Event/phenixTypes.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+  PHTestCheck check("testPrdfReadAhead");
+
+  const int kRun = 1234;
+  const int kEvents = 500;
+  const int kPacketId = 1001;
+
+  // small buffers, so that the events are spread over many buffers of the input file
+  const int kBufferLength = 16 * 1024;
+
+  // packet content of an event, of varying length
+  std::vector<PHDWORD> packet_data(int ievent)
+  {
+    std::vector<PHDWORD> data(50 + (ievent * 37) % 400);
+    for (unsigned int i = 0; i < data.size(); ++i)
+    {
+      data[i] = ievent * 100000 + i;
+    }
+    return data;
+  }
+
+  void write_input(const std::string &filename)
+  {
+    const int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRWXU | S_IROTH | S_IRGRP);
+    std::vector<PHDWORD> buffer(kBufferLength);
+    oBuffer *ob = new oBuffer(fd, buffer.data(), kBufferLength, kRun);
+    for (int ievent = 1; ievent <= kEvents; ++ievent)
+    {
+      std::vector<PHDWORD> data = packet_data(ievent);
+      ob->nextEvent(data.size() + 100, DATAEVENT, ievent);
+      ob->addUnstructPacketData(data.data(), data.size(), kPacketId, 4, IDCRAW);
+    }
+    delete ob;
+    close(fd);
+  }
+
+  //! writes the PRDF node with a Fun4AllFileOutStream
+  class PrdfCopy : public SubsysReco
+  {
+   public:
+    explicit PrdfCopy(const std::string &filerule)
+      : SubsysReco("PRDFCOPY")
+      , m_OutStream(new Fun4AllFileOutStream(filerule))
+    {
+    }
+
+    ~PrdfCopy() override { delete m_OutStream; }
+
+    int process_event(PHCompositeNode *topNode) override
+    {
+      Event *evt = findNode::getClass<Event>(topNode, "PRDF");
+      if (!evt)
+      {
+        return Fun4AllReturnCodes::ABORTRUN;
+      }
+      m_OutStream->WriteEvent(evt);
+      return Fun4AllReturnCodes::EVENT_OK;
+    }
+
+    int End(PHCompositeNode * /*topNode*/) override
+    {
+      m_OutStream->CloseOutStream();
+      return Fun4AllReturnCodes::EVENT_OK;
+    }
+
+   private:
+    // holds the output buffer, too large for the stack
+    Fun4AllFileOutStream *m_OutStream;
+  };
+
+  void copy_file(const std::string &input, const std::string &filerule, unsigned int read_ahead)
+  {
+    Fun4AllServer *se = Fun4AllServer::instance();
+    Fun4AllPrdfInputManager *in = new Fun4AllPrdfInputManager("PRDFIN");
+    in->ReadAhead(read_ahead, 7);
+    in->fileopen(input);
+    se->registerInputManager(in);
+    se->registerSubsystem(new PrdfCopy(filerule));
+    se->run();
+    se->End();
+    delete se;
+  }
+
+  std::string output_name(const std::string &filerule)
+  {
+    char name[256];
+    snprintf(name, sizeof(name), filerule.c_str(), kRun, 0);
+    return name;
+  }
+
+  std::string read_file(const std::string &filename)
+  {
+    std::ifstream in(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+}  // namespace
+
+int main()
+{
+  // standard -runnumber-segment name, the copies get the same segment
+  const std::string input = "testPrdfReadAhead_input-0000001234-0000.prdf";
+  const std::string rule_direct = "testPrdfReadAhead_direct-%010d-%04d.prdf";
+  const std::string rule_readahead = "testPrdfReadAhead_readahead-%010d-%04d.prdf";
+
+  write_input(input);
+  copy_file(input, rule_direct, 0);
+  copy_file(input, rule_readahead, 100);
+
+  // the copy without read ahead has all events, with their packet content
+  int status = 0;
+  fileEventiterator it(output_name(rule_direct).c_str(), status);
+  check(status == 0, "open copy");
+  int nevents = 0;
+  bool content_ok = true;
+  while (Event *evt = it.getNextEvent())
+  {
+    if (evt->getEvtType() == DATAEVENT)
+    {
+      ++nevents;
+      const std::vector<PHDWORD> data = packet_data(evt->getEvtSequence());
+      Packet *packet = evt->getPacket(kPacketId);
+      content_ok = content_ok && packet && packet->getLength() > 0;
+      for (unsigned int i = 0; packet && i < data.size(); ++i)
+      {
+        content_ok = content_ok && static_cast<PHDWORD>(packet->iValue(i)) == data[i];
+      }
+      delete packet;
+    }
+    delete evt;
+  }
+  check(nevents == kEvents, "number of events in the copy");
+  check(content_ok, "packet content in the copy");
+
+  const std::string direct = read_file(output_name(rule_direct));
+  const std::string readahead = read_file(output_name(rule_readahead));
+  check(!direct.empty(), "copy not empty");
+  check(direct == readahead, "copies with and without read ahead are identical");
+
+  unlink(input.c_str());
+  unlink(output_name(rule_direct).c_str());
+  unlink(output_name(rule_readahead).c_str());
+
+  return check.result();
+}
@@ -0,0 +1,41 @@
+#include "PHObjectPool.h"
+
+#include <TObject.h>
+
+#include <atomic>
+
+namespace
+{
+  std::atomic<bool> s_enabled(false);
+  std::atomic<size_t> s_reserved_bytes(0);
+}  // namespace
+
+void PHObjectPool::enable()
+{
+  s_enabled = true;
+}
+
+bool PHObjectPool::enabled()
+{
+  return s_enabled.load(std::memory_order_relaxed);
+}
+
+size_t PHObjectPool::reserved_bytes()
+{
+  return s_reserved_bytes;
+}
+
+void PHObjectPool::add_reserved_bytes(size_t bytes)
+{
+  s_reserved_bytes += bytes;
+}
+
+void *PHObjectPool::object_new(size_t size)
+{
+  return TObject::operator new(size);
+}
+
+void PHObjectPool::object_delete(void *p)
+{
+  TObject::operator delete(p);
+}
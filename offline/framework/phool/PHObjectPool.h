@@ -0,0 +1,223 @@
+#ifndef PHOOL_PHOBJECTPOOL_H
+#define PHOOL_PHOBJECTPOOL_H
+
+/*!
+ * \file PHObjectPool.h
+ * \brief recycling allocation for small objects created and deleted every event
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/*!
+ * \brief global switch and statistics for PHObjectPoolAllocator.
+ *
+ * Pooling is opt-in. Once enabled, deleted objects of pooled classes are kept in per class free lists,
+ * and handed back by the next new, so that the containers' Reset and refill do not go through malloc and free.
+ * Pooled memory is never returned to the system, so that capacity is kept across events;
+ * for the same reason pooling cannot be disabled once enabled
+ */
+class PHObjectPool
+{
+ public:
+  //! enable pooling for all classes using PHOBJECTPOOL_OPERATORS
+  static void enable();
+
+  //! true if pooling is enabled
+  static bool enabled();
+
+  //! total memory reserved by the pools (bytes)
+  static size_t reserved_bytes();
+
+  //! add to reserved memory. Used by PHObjectPoolAllocator
+  static void add_reserved_bytes(size_t);
+
+  //! TObject::operator new, for requests which are not pooled
+  static void *object_new(size_t);
+
+  //! TObject::operator delete, for requests which are not pooled
+  static void object_delete(void *);
+};
+
+/*!
+ * \brief per class free list allocator.
+ *
+ * Each thread keeps a local free list. When a local list grows beyond two batches,
+ * one batch is moved to a shared depot, from which other threads refill,
+ * so that objects created on one thread and deleted on another are recycled as well.
+ * Requests whose size differs from sizeof(T) (derived classes) are not pooled,
+ * the caller then uses the regular TObject allocation
+ */
+template <class T>
+class PHObjectPoolAllocator
+{
+ public:
+  //! slot from the pool, nullptr if the request is not pooled
+  static void *allocate(size_t size)
+  {
+    if (size != sizeof(T) || !PHObjectPool::enabled())
+    {
+      return nullptr;
+    }
+
+    Cache &cache = local_cache();
+    if (!cache.head)
+    {
+      refill(cache);
+    }
+
+    Block *block = cache.head;
+    cache.head = block->next;
+    --cache.count;
+
+    // fill like TStorage::ObjectAlloc, from which the TObject constructor sets kIsOnHeap
+    std::memset(block, object_alloc_mem_value, size);
+    return block;
+  }
+
+  //! return slot to the pool. Returns false if the request is not pooled
+  static bool deallocate(void *p, size_t size)
+  {
+    if (size != sizeof(T) || !PHObjectPool::enabled())
+    {
+      return false;
+    }
+
+    if (!p)
+    {
+      return true;
+    }
+
+    Cache &cache = local_cache();
+    Block *block = static_cast<Block *>(p);
+    block->next = cache.head;
+    cache.head = block;
+    if (++cache.count >= 2 * batch_size)
+    {
+      release(cache, batch_size);
+    }
+    return true;
+  }
+
+ private:
+  //! free slot
+  struct Block
+  {
+    Block *next;
+  };
+
+  //! byte pattern written by TStorage::ObjectAlloc (kObjectAllocMemValue)
+  static const int object_alloc_mem_value = 0x99;
+
+  //! objects per batch, and per chunk of fresh memory
+  static const size_t batch_size = 1024;
+
+  //! slot size
+  static const size_t slot_size = sizeof(T) > sizeof(Block) ? sizeof(T) : sizeof(Block);
+
+  //! list of free slots, with its length
+  using Batch = std::pair<Block *, size_t>;
+
+  //! batches shared between threads
+  struct Depot
+  {
+    std::mutex mutex;
+    std::vector<Batch> batches;
+  };
+
+  //! thread local free list. Handed to the depot when the thread exits
+  struct Cache
+  {
+    Block *head = nullptr;
+    size_t count = 0;
+
+    ~Cache()
+    {
+      if (head) release(*this, count);
+    }
+  };
+
+  static Depot &depot()
+  {
+    static Depot depot;
+    return depot;
+  }
+
+  static Cache &local_cache()
+  {
+    thread_local Cache cache;
+    return cache;
+  }
+
+  //! take a batch from the depot, or fresh memory if the depot is empty
+  static void refill(Cache &cache)
+  {
+    {
+      Depot &shared = depot();
+      std::lock_guard<std::mutex> lock(shared.mutex);
+      if (!shared.batches.empty())
+      {
+        std::tie(cache.head, cache.count) = shared.batches.back();
+        shared.batches.pop_back();
+        return;
+      }
+    }
+
+    char *chunk = static_cast<char *>(::operator new(batch_size * slot_size));
+    PHObjectPool::add_reserved_bytes(batch_size * slot_size);
+    for (size_t i = 0; i < batch_size; ++i)
+    {
+      Block *block = reinterpret_cast<Block *>(chunk + i * slot_size);
+      block->next = cache.head;
+      cache.head = block;
+    }
+    cache.count = batch_size;
+  }
+
+  //! move the first n slots of the local list to the depot
+  static void release(Cache &cache, size_t n)
+  {
+    Block *first = cache.head;
+    Block *last = first;
+    for (size_t i = 1; i < n; ++i)
+    {
+      last = last->next;
+    }
+    cache.head = last->next;
+    cache.count -= n;
+    last->next = nullptr;
+
+    Depot &shared = depot();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    shared.batches.emplace_back(first, n);
+  }
+};
+
+/*!
+ * declare pooled operator new and delete in class T, a TObject. Requests which are not pooled
+ * go to the TObject operators, so that kIsOnHeap is set as without the pool.
+ * The placement forms are declared too, since class operator new hides the global ones
+ * (they are used by the ROOT dictionaries)
+ */
+#define PHOBJECTPOOL_OPERATORS(T)                                      \
+  static void *operator new(size_t size)                               \
+  {                                                                    \
+    void *p = PHObjectPoolAllocator<T>::allocate(size);                \
+    return p ? p : PHObjectPool::object_new(size);                     \
+  }                                                                    \
+  static void operator delete(void *p, size_t size)                    \
+  {                                                                    \
+    if (!PHObjectPoolAllocator<T>::deallocate(p, size))                \
+    {                                                                  \
+      PHObjectPool::object_delete(p);                                  \
+    }                                                                  \
+  }                                                                    \
+  static void *operator new(size_t, void *p) { return p; }             \
+  static void operator delete(void *, void *) {}
+
+#endif
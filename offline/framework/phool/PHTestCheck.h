@@ -0,0 +1,55 @@
+#ifndef PHOOL_PHTESTCHECK_H
+#define PHOOL_PHTESTCHECK_H
+
+/*!
+\file   PHTestCheck.h
+\brief  failed check counter for the unit test programs run with make check
+
+    PHTestCheck check("testMyClass");
+    check(value == 1, "value");
+    return check.result();
+*/
+
+#include <iostream>
+#include <string>
+
+class PHTestCheck
+{
+ public:
+  explicit PHTestCheck(const std::string &name)
+    : m_name(name)
+  {
+  }
+
+  //! prints and counts the check if it failed. Returns ok
+  bool operator()(bool ok, const std::string &what)
+  {
+    if (!ok)
+    {
+      std::cout << m_name << " - FAILED: " << what << std::endl;
+      ++m_nfailed;
+    }
+    return ok;
+  }
+
+  //! number of failed checks so far
+  int nfailed() const { return m_nfailed; }
+
+  //! prints the summary and returns the exit code of the test program
+  int result() const
+  {
+    if (m_nfailed)
+    {
+      std::cout << m_name << " - " << m_nfailed << " checks failed" << std::endl;
+      return 1;
+    }
+    std::cout << m_name << " - all checks passed" << std::endl;
+    return 0;
+  }
+
+ private:
+  std::string m_name;
+  int m_nfailed = 0;
+};
+
+#endif
@@ -0,0 +1,114 @@
+// allocates and frees objects using PHOBJECTPOOL_OPERATORS, with the pool disabled and enabled,
+// and checks that slots are recycled and that the objects are flagged as on the heap
+// run with make check
+
+#include "PHObject.h"
+#include "PHObjectPool.h"
+#include "PHTestCheck.h"
+
+#include <set>
+#include <vector>
+
+namespace
+{
+  PHTestCheck check("testPHObjectPool");
+
+  class PooledObject : public PHObject
+  {
+   public:
+    PHOBJECTPOOL_OPERATORS(PooledObject)
+
+    double value = 0;
+  };
+
+  //! larger than PooledObject, not pooled
+  class DerivedObject : public PooledObject
+  {
+   public:
+    double other_value = 0;
+  };
+
+  bool all_on_heap(const std::vector<PooledObject *> &objects)
+  {
+    for (const PooledObject *object : objects)
+    {
+      if (!object->IsOnHeap()) return false;
+    }
+    return true;
+  }
+}  // namespace
+
+int main()
+{
+  // pool disabled, TObject allocation
+  {
+    PooledObject *object = new PooledObject;
+    check(object->IsOnHeap(), "on heap, pool disabled");
+    object->value = 1;
+    delete object;
+
+    DerivedObject *derived = new DerivedObject;
+    check(derived->IsOnHeap(), "derived on heap, pool disabled");
+    delete derived;
+
+    check(PHObjectPool::reserved_bytes() == 0, "nothing reserved while disabled");
+  }
+
+  // allocated before enabling, deleted after
+  PooledObject *early = new PooledObject;
+
+  PHObjectPool::enable();
+  check(PHObjectPool::enabled(), "enabled");
+
+  delete early;
+
+  {
+    PooledObject *object = new PooledObject;
+    check(object->IsOnHeap(), "on heap, pool enabled");
+    object->value = 2;
+    const void *slot = object;
+    delete object;
+
+    // the freed slot is handed back, and flagged again
+    PooledObject *reused = new PooledObject;
+    check(reused == slot, "slot recycled");
+    check(reused->IsOnHeap(), "recycled slot on heap");
+    check(reused->value == 0, "recycled slot constructed");
+    delete reused;
+
+    DerivedObject *derived = new DerivedObject;
+    check(derived->IsOnHeap(), "derived on heap, pool enabled");
+    delete derived;
+  }
+
+  // several batches, all slots distinct, then the same memory again
+  {
+    std::vector<PooledObject *> objects;
+    for (int i = 0; i < 5000; ++i)
+    {
+      objects.push_back(new PooledObject);
+    }
+    check(std::set<PooledObject *>(objects.begin(), objects.end()).size() == objects.size(), "distinct slots");
+    check(all_on_heap(objects), "all on heap");
+    check(PHObjectPool::reserved_bytes() > 0, "memory reserved");
+    const size_t reserved = PHObjectPool::reserved_bytes();
+
+    for (PooledObject *object : objects)
+    {
+      delete object;
+    }
+    objects.clear();
+    for (int i = 0; i < 5000; ++i)
+    {
+      objects.push_back(new PooledObject);
+    }
+    check(PHObjectPool::reserved_bytes() == reserved, "no new memory for recycled slots");
+    check(all_on_heap(objects), "all recycled on heap");
+    for (PooledObject *object : objects)
+    {
+      delete object;
+    }
+  }
+
+  return check.result();
+}
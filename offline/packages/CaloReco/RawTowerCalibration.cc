@@ -32,6 +32,19 @@
 
 using namespace std;
 
+namespace
+{
+  // parameter name suffix of the tower by tower calibration
+  string tower_param_suffix(const RawTowerDefs::keytype key)
+  {
+    if (RawTowerDefs::decode_caloid(key) == RawTowerDefs::LFHCAL)
+    {
+      return "_eta" + to_string(RawTowerDefs::decode_index1v2(key)) + "_phi" + to_string(RawTowerDefs::decode_index2v2(key)) + "_l" + to_string(RawTowerDefs::decode_index3v2(key));
+    }
+    return "_eta" + to_string(RawTowerDefs::decode_index1(key)) + "_phi" + to_string(RawTowerDefs::decode_index2(key));
+  }
+}  // namespace
+
 RawTowerCalibration::RawTowerCalibration(const std::string &name)
   : SubsysReco(name)
   , _calib_algorithm(kNo_calibration)
@@ -86,6 +99,14 @@ int RawTowerCalibration::InitRun(PHCompositeNode *topNode)
     std::cout << e.what() << std::endl;
     return Fun4AllReturnCodes::ABORTRUN;
   }
+
+  if (_calib_algorithm == kTower_by_tower_calibration)
+  {
+    // the parameters are read only from here on
+    _tower_calib_params.Unfreeze();
+    ResolveCalibrationHandles();
+    _tower_calib_params.Freeze();
+  }
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
@@ -134,52 +155,20 @@ int RawTowerCalibration::process_event(PHCompositeNode */*topNode*/)
     }
     else if (_calib_algorithm == kTower_by_tower_calibration)
     {
-      RawTowerDefs::CalorimeterId caloid = RawTowerDefs::decode_caloid(key);
-      const int eta = raw_tower->get_bineta();
-      const int phi = raw_tower->get_binphi();
+      static const TowerCalibHandles no_handles;
+      map<RawTowerDefs::keytype, TowerCalibHandles>::const_iterator handle_iter = _tower_calib_handles.find(key);
+      const TowerCalibHandles &handles = (handle_iter == _tower_calib_handles.end()) ? no_handles : handle_iter->second;
 
-      double tower_by_tower_calib = 1.;
-      if (caloid == RawTowerDefs::LFHCAL) 
+      const double tower_by_tower_calib = get_tower_param(handles.calib_const, "calib_const", key);
+
+      if (_pedestal_file == true)
       {
-        const int l   = raw_tower->get_binl();
-        const string calib_const_name("calib_const_eta" + to_string(eta) + "_phi" + to_string(phi) + "_l" + to_string(l));
-
-        tower_by_tower_calib = _tower_calib_params.get_double_param(calib_const_name);
-
-        if (_pedestal_file == true)
-        {
-          const string pedstal_name("PedCentral_ADC_eta" + to_string(eta) + "_phi" + to_string(phi)+ "_l" + to_string(l));
-          _pedstal_ADC =
-              _tower_calib_params.get_double_param(pedstal_name);
-        }
-
-        if (_GeV_ADC_file == true)
-        {
-          const string GeVperADCname("GeVperADC_eta" + to_string(eta) + "_phi" + to_string(phi)+ "_l" + to_string(l));
-          _calib_const_GeV_ADC =
-              _tower_calib_params.get_double_param(GeVperADCname);
-        }
-      } 
-      else 
+        _pedstal_ADC = get_tower_param(handles.pedestal, "PedCentral_ADC", key);
+      }
+
+      if (_GeV_ADC_file == true)
       {
-        const string calib_const_name("calib_const_eta" + to_string(eta) + "_phi" + to_string(phi));
-
-        tower_by_tower_calib = _tower_calib_params.get_double_param(calib_const_name);
-
-        if (_pedestal_file == true)
-        {
-          const string pedstal_name("PedCentral_ADC_eta" + to_string(eta) + "_phi" + to_string(phi));
-          _pedstal_ADC =
-              _tower_calib_params.get_double_param(pedstal_name);
-        }
-
-        if (_GeV_ADC_file == true)
-        {
-          const string GeVperADCname("GeVperADC_eta" + to_string(eta) + "_phi" + to_string(phi));
-          _calib_const_GeV_ADC =
-              _tower_calib_params.get_double_param(GeVperADCname);
-        }
-        
+        _calib_const_GeV_ADC = get_tower_param(handles.GeV_ADC, "GeVperADC", key);
       }
       const double raw_energy = raw_tower->get_energy();
       const double calib_energy = (raw_energy - _pedstal_ADC) * _calib_const_GeV_ADC * tower_by_tower_calib;
@@ -214,6 +203,52 @@ int RawTowerCalibration::End(PHCompositeNode */*topNode*/)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+void RawTowerCalibration::ResolveCalibrationHandles()
+{
+  _tower_calib_handles.clear();
+  RawTowerGeomContainer::ConstRange begin_end = rawtowergeom->get_tower_geometries();
+  for (RawTowerGeomContainer::ConstIterator iter = begin_end.first; iter != begin_end.second; ++iter)
+  {
+    if (_tower_type >= 0 && _tower_type != iter->second->get_tower_type())
+    {
+      continue;
+    }
+    // geometry keys are the tower keys
+    const RawTowerDefs::keytype key = iter->first;
+    const string suffix = tower_param_suffix(key);
+    TowerCalibHandles &handles = _tower_calib_handles[key];
+    // missing parameters keep an invalid handle, they are reported when the tower is calibrated
+    if (_tower_calib_params.exist_double_param("calib_const" + suffix))
+    {
+      handles.calib_const = _tower_calib_params.get_double_handle("calib_const" + suffix);
+    }
+    if (_pedestal_file && _tower_calib_params.exist_double_param("PedCentral_ADC" + suffix))
+    {
+      handles.pedestal = _tower_calib_params.get_double_handle("PedCentral_ADC" + suffix);
+    }
+    if (_GeV_ADC_file && _tower_calib_params.exist_double_param("GeVperADC" + suffix))
+    {
+      handles.GeV_ADC = _tower_calib_params.get_double_handle("GeVperADC" + suffix);
+    }
+  }
+  if (Verbosity())
+  {
+    std::cout << Name() << "::" << detector << "::" << __PRETTY_FUNCTION__
+              << " resolved calibration parameters of " << _tower_calib_handles.size()
+              << " towers" << std::endl;
+  }
+}
+
+double RawTowerCalibration::get_tower_param(const PHParameters::DoubleHandle handle, const std::string &prefix, const RawTowerDefs::keytype key) const
+{
+  if (handle.valid())
+  {
+    return _tower_calib_params.get_double_param(handle);
+  }
+  // the lookup by name reports the missing parameter
+  return _tower_calib_params.get_double_param(prefix + tower_param_suffix(key));
+}
+
 void RawTowerCalibration::CreateNodes(PHCompositeNode *topNode)
 {
   PHNodeIterator iter(topNode);
@@ -1,11 +1,14 @@
 #ifndef CALORECO_RAWTOWERCALIBRATION_H
 #define CALORECO_RAWTOWERCALIBRATION_H
 
+#include <calobase/RawTowerDefs.h>
+
 #include <fun4all/SubsysReco.h>
 
 #include <phparameter/PHParameters.h>
 
 #include <iostream>
+#include <map>
 #include <string>
 
 class PHCompositeNode;
@@ -141,6 +144,14 @@ class RawTowerCalibration : public SubsysReco
   void
   CreateNodes(PHCompositeNode *topNode);
 
+  //! resolve the tower by tower parameters of all towers in the geometry
+  void
+  ResolveCalibrationHandles();
+
+  //! calibration parameter of a tower, by handle if the parameter exists
+  double
+  get_tower_param(const PHParameters::DoubleHandle handle, const std::string &prefix, const RawTowerDefs::keytype key) const;
+
   enu_calib_algorithm _calib_algorithm;
 
   RawTowerContainer *_calib_towers;
@@ -172,6 +183,17 @@ class RawTowerCalibration : public SubsysReco
 
   //! Tower by tower calibration parameters
   PHParameters _tower_calib_params;
+
+  //! handles of the tower by tower calibration parameters of one tower
+  struct TowerCalibHandles
+  {
+    PHParameters::DoubleHandle calib_const;
+    PHParameters::DoubleHandle pedestal;
+    PHParameters::DoubleHandle GeV_ADC;
+  };
+
+  //! resolved in InitRun, so that process_event does not build parameter names
+  std::map<RawTowerDefs::keytype, TowerCalibHandles> _tower_calib_handles;
 };
 
 #endif
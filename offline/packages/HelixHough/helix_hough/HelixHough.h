@@ -196,6 +196,12 @@ class HelixHough
     void setCullInputHits( bool cih ){ cull_input_hits = cih; }
     void setIterateClustering( bool icl ){ iterate_clustering = icl; }
     
+    // widest vector unit usable on this cpu for the helicity separated xy vote : 4 (sse), 8 (avx2) or 16 (avx512)
+    static unsigned int maxVoteWidth();
+    // limit the vector width of the helicity separated xy vote, defaults to maxVoteWidth()
+    void setVoteWidth(unsigned int vw);
+    unsigned int getVoteWidth() const {return vote_width;}
+    
   protected:
     bool remove_hits;
     std::vector<unsigned int>* hit_used;
@@ -296,6 +302,7 @@ class HelixHough
     bool smooth_back;
     bool cull_input_hits;
     bool iterate_clustering;
+    unsigned int vote_width;
 };
 
 #endif
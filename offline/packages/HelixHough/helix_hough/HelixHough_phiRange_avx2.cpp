@@ -0,0 +1,55 @@
+// compiled with -mavx2 -ffp-contract=off, see Makefile.am.
+// Only include headers without inline functions of their own here, anything
+// else could end up compiled with avx2 and used on cpus without it
+#include "HelixHough_phiRange_wide.h"
+
+#include <immintrin.h>
+
+namespace {
+
+struct Avx2 {
+  typedef __m256 V;
+  typedef __m256 M;
+
+  static V load(const float* p) { return _mm256_load_ps(p); }
+  static void store(float* p, V v) { _mm256_store_ps(p, v); }
+  static V set1(float f) { return _mm256_set1_ps(f); }
+
+  static V add(V a, V b) { return _mm256_add_ps(a, b); }
+  static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+  static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+  static V div(V a, V b) { return _mm256_div_ps(a, b); }
+  static V min(V a, V b) { return _mm256_min_ps(a, b); }
+  static V max(V a, V b) { return _mm256_max_ps(a, b); }
+  static V rsqrt(V a) { return _mm256_rsqrt_ps(a); }
+
+  static M lt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OS); }
+  static M gt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GT_OS); }
+  static M le(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LE_OS); }
+  static M eq(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+  static M mask_or(M a, M b) { return _mm256_or_ps(a, b); }
+  static M mask_and(M a, M b) { return _mm256_and_ps(a, b); }
+  static V select(M m, V a, V b) { return _mm256_blendv_ps(b, a, m); }
+
+  static V sign(V a) {
+    return _mm256_and_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(0x80000000)));
+  }
+  static V bit_xor(V a, V b) { return _mm256_xor_ps(a, b); }
+  // all ones where a and b have the same sign bit
+  static M same_sign(V a, V b) {
+    __m256i i = _mm256_castps_si256(_mm256_xor_ps(a, b));
+    return _mm256_castsi256_ps(_mm256_cmpgt_epi32(i, _mm256_set1_epi32(-1)));
+  }
+};
+
+}  // namespace
+
+#include "HelixHough_phiRange_wide_kernel.h"
+
+void phiRange_avx2(const float* hit_x, const float* hit_y, float min_d,
+                   float max_d, float min_k, float max_k, float hel,
+                   float* min_phi, float* max_phi, float* phi_3, float* phi_4,
+                   bool first_k) {
+  wide_phiRange<Avx2>(hit_x, hit_y, min_d, max_d, min_k, max_k, hel, min_phi,
+                      max_phi, phi_3, phi_4, first_k);
+}
@@ -0,0 +1,74 @@
+// compiled with -mavx512f -ffp-contract=off, see Makefile.am.
+// Only include headers without inline functions of their own here, anything
+// else could end up compiled with avx512 and used on cpus without it
+#include "HelixHough_phiRange_wide.h"
+
+// some gcc versions warn about the _mm512_undefined_* initializers used
+// inside the avx512 intrinsics
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+
+namespace {
+
+struct Avx512 {
+  typedef __m512 V;
+  typedef __mmask16 M;
+
+  static V load(const float* p) { return _mm512_load_ps(p); }
+  static void store(float* p, V v) { _mm512_store_ps(p, v); }
+  static V set1(float f) { return _mm512_set1_ps(f); }
+
+  static V add(V a, V b) { return _mm512_add_ps(a, b); }
+  static V sub(V a, V b) { return _mm512_sub_ps(a, b); }
+  static V mul(V a, V b) { return _mm512_mul_ps(a, b); }
+  static V div(V a, V b) { return _mm512_div_ps(a, b); }
+  static V min(V a, V b) { return _mm512_min_ps(a, b); }
+  static V max(V a, V b) { return _mm512_max_ps(a, b); }
+  // the 256 bit rsqrt on both halves, rsqrt14 is more precise than the sse
+  // and avx2 approximation, and would change the votes
+  static V rsqrt(V a) {
+    __m512d a_pd = _mm512_castps_pd(a);
+    __m256 lo = _mm256_rsqrt_ps(_mm512_castps512_ps256(a));
+    __m256 hi = _mm256_rsqrt_ps(
+        _mm256_castpd_ps(_mm512_extractf64x4_pd(a_pd, 1)));
+    a_pd = _mm512_castps_pd(_mm512_castps256_ps512(lo));
+    a_pd = _mm512_insertf64x4(a_pd, _mm256_castps_pd(hi), 1);
+    return _mm512_castpd_ps(a_pd);
+  }
+
+  static M lt(V a, V b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OS); }
+  static M gt(V a, V b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OS); }
+  static M le(V a, V b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OS); }
+  static M eq(V a, V b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+  static M mask_or(M a, M b) { return _mm512_kor(a, b); }
+  static M mask_and(M a, M b) { return _mm512_kand(a, b); }
+  static V select(M m, V a, V b) { return _mm512_mask_blend_ps(m, b, a); }
+
+  static V sign(V a) {
+    return _mm512_castsi512_ps(_mm512_and_si512(
+        _mm512_castps_si512(a), _mm512_set1_epi32(0x80000000)));
+  }
+  static V bit_xor(V a, V b) {
+    return _mm512_castsi512_ps(
+        _mm512_xor_si512(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+  }
+  // set where a and b have the same sign bit
+  static M same_sign(V a, V b) {
+    __m512i i = _mm512_xor_si512(_mm512_castps_si512(a), _mm512_castps_si512(b));
+    return _mm512_cmpgt_epi32_mask(i, _mm512_set1_epi32(-1));
+  }
+};
+
+}  // namespace
+
+#include "HelixHough_phiRange_wide_kernel.h"
+
+void phiRange_avx512(const float* hit_x, const float* hit_y, float min_d,
+                     float max_d, float min_k, float max_k, float hel,
+                     float* min_phi, float* max_phi, float* phi_3, float* phi_4,
+                     bool first_k) {
+  wide_phiRange<Avx512>(hit_x, hit_y, min_d, max_d, min_k, max_k, hel, min_phi,
+                        max_phi, phi_3, phi_4, first_k);
+}
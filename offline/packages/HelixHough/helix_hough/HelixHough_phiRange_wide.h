@@ -0,0 +1,25 @@
+#ifndef HELIXHOUGH_PHIRANGE_WIDE_H
+#define HELIXHOUGH_PHIRANGE_WIDE_H
+
+// phi range of the helicity separated xy vote, for 8 (avx2) or 16 (avx512)
+// hits at a time. These are compiled in their own libraries with the
+// corresponding instruction set enabled, and must only be called after
+// checking the cpu at run time (see HelixHough::maxVoteWidth).
+//
+// hit_x, hit_y, min_phi, max_phi, phi_3 and phi_4 are arrays of 8 (16) floats,
+// aligned to 32 (64) bytes. phi_3 and phi_4 carry the phi of the max_k
+// corners from one k bin to the next: with first_k they are computed from
+// min_k, otherwise they are read. They are overwritten in both cases.
+// The results are identical to the sse phiRange_sse functions.
+
+void phiRange_avx2(const float* hit_x, const float* hit_y, float min_d,
+                   float max_d, float min_k, float max_k, float hel,
+                   float* min_phi, float* max_phi, float* phi_3, float* phi_4,
+                   bool first_k);
+
+void phiRange_avx512(const float* hit_x, const float* hit_y, float min_d,
+                     float max_d, float min_k, float max_k, float hel,
+                     float* min_phi, float* max_phi, float* phi_3, float* phi_4,
+                     bool first_k);
+
+#endif
@@ -0,0 +1,222 @@
+#ifndef HELIXHOUGH_PHIRANGE_WIDE_KERNEL_H
+#define HELIXHOUGH_PHIRANGE_WIDE_KERNEL_H
+
+// width independent implementation of the helicity separated phiRange_sse,
+// included by HelixHough_phiRange_avx2.cpp and HelixHough_phiRange_avx512.cpp.
+// T provides the vector type V, the mask type M and the operations below for
+// one instruction set. T is declared in an anonymous namespace in each of
+// these files, so the instantiations, compiled with avx enabled, can not be
+// picked up by the linker for the rest of the library.
+//
+// The operations are done in the same order as in HelixHough_phiRange_sse.cpp
+// and vector_math_inline.h, with the same rsqrt approximation, so that the
+// votes do not depend on the vector width. Those files must be compiled
+// without fp contraction for that reason.
+
+template <class T>
+inline typename T::V wide_rsqrt(typename T::V x) {
+  typedef typename T::V V;
+  V x0 = T::rsqrt(x);
+  return T::mul(T::set1(0.5),
+                T::mul(x0, T::sub(T::set1(3.), T::mul(x0, T::mul(x0, x)))));
+}
+
+template <class T>
+inline typename T::V wide_sqrt(typename T::V x) {
+  return T::mul(wide_rsqrt<T>(x), x);
+}
+
+template <class T>
+inline typename T::V wide_rec(typename T::V x) {
+  typename T::V a = wide_rsqrt<T>(x);
+  return T::mul(a, a);
+}
+
+template <class T>
+inline typename T::V wide_atan(typename T::V x) {
+  typedef typename T::V V;
+  typedef typename T::M M;
+
+  // extract the sign of x and make x positive
+  V x_sign = T::sign(x);
+  x = T::bit_xor(x_sign, x);
+
+  // if x > sqrt(2)+1, then set x = -1/x
+  // else if x > sqrt(2)-1, then set x = (x-1)/(x+1)
+  M gr1 = T::gt(x, T::set1(0x2.6a09e667f3bcc9080p0f));
+  M gr2 = T::gt(x, T::set1(0x6.a09e667f3bcc9080p-4f));
+  V z1 = T::div(T::set1(-1.), x);
+  V z2 = T::div(T::add(x, T::set1(-1.)), T::sub(x, T::set1(-1.)));
+  x = T::select(gr1, z1, T::select(gr2, z2, x));
+
+  // Chebyshev polynomial (in monomial form) using Horner's scheme
+  V x2 = T::mul(x, x);
+  z1 = T::add(T::mul(x2, T::set1(-0x1.ab85dd26f5264feep-4f)),
+              T::set1(0x3.1dcf607e2808c0d4p-4f));
+  z2 = T::add(T::mul(x2, z1), T::set1(-0x5.542eef19db937268p-4f));
+  z1 = T::add(T::mul(x2, z2), T::set1(0xf.fffb771eba87d370p-4f));
+  z1 = T::mul(z1, x);
+
+  // add either pi/4 or pi/2, depending on the initial value of x
+  x2 = T::select(gr1, T::set1(0x1.921fb54442d1846ap0f),
+                 T::select(gr2, T::set1(0xc.90fdaa22168c2350p-4f),
+                           T::set1(0.)));
+  x2 = T::add(x2, z1);
+
+  // recover the original sign of x
+  return T::bit_xor(x2, x_sign);
+}
+
+template <class T>
+inline typename T::V wide_atan2(typename T::V y, typename T::V x) {
+  typedef typename T::V V;
+  typedef typename T::M M;
+
+  V zero = T::set1(0.);
+  M eq0 = T::eq(x, zero);
+  V atanval = wide_atan<T>(T::div(y, x));
+  V y_sign = T::sign(y);
+  V zero_pio2 =
+      T::bit_xor(y_sign, T::select(eq0, T::set1(0x1.921fb54442d1846ap0f), zero));
+  V zero_pi = T::bit_xor(
+      y_sign,
+      T::select(T::lt(x, zero), T::set1(0x3.243f6a8885a308d4p0f), zero));
+  atanval = T::select(eq0, zero, atanval);
+  atanval = T::add(zero_pio2, atanval);
+  return T::add(zero_pi, atanval);
+}
+
+// phi in [0, 2pi)
+template <class T>
+inline typename T::V wide_phi_positive(typename T::V phi) {
+  typename T::V zero = T::set1(0.);
+  return T::add(phi, T::select(T::lt(phi, zero),
+                               T::set1(0x6.487ed5110b4611a8p0f), zero));
+}
+
+// phi at one (d, k) corner of the bin. The helicity selection is taken from
+// the first corner and reused for the others
+template <class T>
+inline typename T::V wide_corner_phi(typename T::V x, typename T::V y,
+                                     typename T::V D, typename T::V D_inv,
+                                     typename T::V d, typename T::V k,
+                                     typename T::V hit_phi,
+                                     typename T::V helicity_vec,
+                                     typename T::M& correct_helicity,
+                                     bool set_helicity) {
+  typedef typename T::V V;
+
+  V ak = T::mul(d, T::set1(2.));
+  V tmp1 = T::mul(T::mul(d, d), k);
+  ak = T::add(ak, tmp1);
+  tmp1 = T::mul(T::mul(D, D), k);
+  ak = T::add(ak, tmp1);
+  ak = T::mul(ak, D_inv);
+  ak = T::mul(ak, T::set1(0.5));
+  V hk = T::add(T::mul(d, k), T::set1(1.));
+  hk = T::mul(hk, hk);
+  hk = T::sub(hk, T::mul(ak, ak));
+  typename T::M neg = T::le(hk, T::set1(0.));
+  hk = wide_sqrt<T>(hk);
+
+  V xk1 = T::mul(ak, x);
+  tmp1 = T::mul(hk, y);
+  V xk2 = T::sub(xk1, tmp1);
+  xk1 = T::add(xk1, tmp1);
+  xk1 = T::mul(xk1, D_inv);
+  xk2 = T::mul(xk2, D_inv);
+
+  V yk1 = T::mul(ak, y);
+  tmp1 = T::mul(hk, x);
+  V yk2 = T::add(yk1, tmp1);
+  yk1 = T::sub(yk1, tmp1);
+  yk1 = T::mul(yk1, D_inv);
+  yk2 = T::mul(yk2, D_inv);
+
+  if (set_helicity == true) {
+    V crossproduct = T::sub(T::mul(x, yk1), T::mul(y, xk1));
+    correct_helicity = T::same_sign(crossproduct, helicity_vec);
+  }
+
+  V xk = T::select(correct_helicity, xk1, xk2);
+  V yk = T::select(correct_helicity, yk1, yk2);
+
+  V phi = wide_phi_positive<T>(wide_atan2<T>(yk, xk));
+  // if neg==true, phi = hit_phi
+  return T::select(neg, hit_phi, phi);
+}
+
+template <class T>
+inline void wide_phiRange(const float* hit_x, const float* hit_y, float min_d,
+                          float max_d, float min_k, float max_k, float hel,
+                          float* min_phi, float* max_phi, float* phi_3_io,
+                          float* phi_4_io, bool first_k) {
+  typedef typename T::V V;
+  typedef typename T::M M;
+
+  V helicity_vec = T::set1(hel);
+  V x = T::load(hit_x);
+  V y = T::load(hit_y);
+  V d_min = T::set1(min_d);
+  V d_max = T::set1(max_d);
+  V k_max = T::set1(max_k);
+
+  V hit_phi = wide_phi_positive<T>(wide_atan2<T>(y, x));
+
+  V D = wide_sqrt<T>(T::add(T::mul(x, x), T::mul(y, y)));
+  V D_inv = wide_rec<T>(D);
+
+  M correct_helicity;
+  V phi_1 = wide_corner_phi<T>(x, y, D, D_inv, d_min, k_max, hit_phi,
+                               helicity_vec, correct_helicity, true);
+  V phi_2 = wide_corner_phi<T>(x, y, D, D_inv, d_max, k_max, hit_phi,
+                               helicity_vec, correct_helicity, false);
+  V phi_3;
+  V phi_4;
+  if (first_k == true) {
+    V k_min = T::set1(min_k);
+    phi_3 = wide_corner_phi<T>(x, y, D, D_inv, d_min, k_min, hit_phi,
+                               helicity_vec, correct_helicity, false);
+    phi_4 = wide_corner_phi<T>(x, y, D, D_inv, d_max, k_min, hit_phi,
+                               helicity_vec, correct_helicity, false);
+  } else {
+    phi_3 = T::load(phi_3_io);
+    phi_4 = T::load(phi_4_io);
+  }
+  T::store(phi_3_io, phi_1);
+  T::store(phi_4_io, phi_2);
+
+  // check if phi overlaps the 0,2pi jump
+  V pi_over_two = T::set1(0x1.921fb54442d1846ap0f);
+  V three_pi_over_two = T::set1((float)(3. * 0x1.921fb54442d1846ap0f));
+  M low = T::mask_or(T::mask_or(T::lt(phi_1, pi_over_two),
+                                T::lt(phi_2, pi_over_two)),
+                     T::mask_or(T::lt(phi_3, pi_over_two),
+                                T::lt(phi_4, pi_over_two)));
+  M high = T::mask_or(T::mask_or(T::gt(phi_1, three_pi_over_two),
+                                 T::gt(phi_2, three_pi_over_two)),
+                      T::mask_or(T::gt(phi_3, three_pi_over_two),
+                                 T::gt(phi_4, three_pi_over_two)));
+  // if phi overlaps the jump, subtract 2*pi from all of the phi values > 3*pi/2
+  V zero = T::set1(0.);
+  V shift =
+      T::select(T::mask_and(low, high), T::set1(0x6.487ed5110b4611a8p0f), zero);
+  phi_1 = T::sub(phi_1, T::select(T::gt(phi_1, three_pi_over_two), shift, zero));
+  phi_2 = T::sub(phi_2, T::select(T::gt(phi_2, three_pi_over_two), shift, zero));
+  phi_3 = T::sub(phi_3, T::select(T::gt(phi_3, three_pi_over_two), shift, zero));
+  phi_4 = T::sub(phi_4, T::select(T::gt(phi_4, three_pi_over_two), shift, zero));
+
+  // min(a, b) is (a < b) ? a : b, as the and/andnot/xor selection in the sse
+  // version
+  V phi_min = T::min(phi_2, phi_1);
+  phi_min = T::min(phi_3, phi_min);
+  phi_min = T::min(phi_4, phi_min);
+  V phi_max = T::max(phi_2, phi_1);
+  phi_max = T::max(phi_3, phi_max);
+  phi_max = T::max(phi_4, phi_max);
+
+  T::store(min_phi, phi_min);
+  T::store(max_phi, phi_max);
+}
+
+#endif
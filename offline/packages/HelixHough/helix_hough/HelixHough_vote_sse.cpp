@@ -1,5 +1,6 @@
 #include "HelixHough.h"
 
+#include "HelixHough_phiRange_wide.h"
 #include "fastvec.h"
 #include "SimpleHit3D.h"
 #include "vector_math_inline.h"
@@ -529,6 +530,28 @@ void HelixHough::vote_z(unsigned int zoomlevel, unsigned int /*n_phi*/,
   }
 }
 
+unsigned int HelixHough::maxVoteWidth() {
+  static const unsigned int max_width =
+      __builtin_cpu_supports("avx512f") ? 16
+      : __builtin_cpu_supports("avx2")  ? 8
+                                        : 4;
+  return max_width;
+}
+
+void HelixHough::setVoteWidth(unsigned int vw) {
+  unsigned int max_width = maxVoteWidth();
+  if (vw >= 16) {
+    vote_width = 16;
+  } else if (vw >= 8) {
+    vote_width = 8;
+  } else {
+    vote_width = 4;
+  }
+  if (vote_width > max_width) {
+    vote_width = max_width;
+  }
+}
+
 void HelixHough::vote(unsigned int zoomlevel) {
   bins_vec[zoomlevel]->clear();
   fastvec vote_array;
@@ -633,7 +656,83 @@ void HelixHough::vote(unsigned int zoomlevel) {
     min_d_array[d_bin] = avg - width * bin_scale;
   }
 
-  for (unsigned int i = 0; i < hits_vec[zoomlevel]->size(); i++) {
+  // with avx2 or avx512, vote the hits in groups of 8 or 16 with the wide
+  // phiRange kernels. The remaining hits go through the sse loop below
+  unsigned int first_hit = 0;
+  if ((separate_by_helicity == true) && (vote_width > 4)) {
+    unsigned int n_wide =
+        vote_width * (hits_vec[zoomlevel]->size() / vote_width);
+    float x_w[16] __attribute__((aligned(64)));
+    float y_w[16] __attribute__((aligned(64)));
+    float min_phi_w[16] __attribute__((aligned(64)));
+    float max_phi_w[16] __attribute__((aligned(64)));
+    float phi_3_w[16] __attribute__((aligned(64)));
+    float phi_4_w[16] __attribute__((aligned(64)));
+    float dphi_w[16];
+    // fillBins takes at most 8 hits
+    vector<vector<SimpleHit3D> > wide_hits(2, eight_hits);
+    float hel = -1.;
+    if (helicity == true) {
+      hel = 1.;
+    }
+    for (unsigned int i = 0; i < n_wide; i += vote_width) {
+      for (unsigned int h = 0; h < vote_width; ++h) {
+        SimpleHit3D& hit = wide_hits[h / 8][h % 8];
+        hit = (*(hits_vec[zoomlevel]))[i + h];
+        hit.set_id(i + h);
+        x_w[h] = hit.get_x();
+        y_w[h] = hit.get_y();
+        dphi_w[h] = sqrt(((2.0*sqrt(hit.get_size(0,0))) *
+                          (2.0*sqrt(hit.get_size(0,0))) +
+                          (2.0*sqrt(hit.get_size(1,1))) *
+                          (2.0*sqrt(hit.get_size(1,1)))) /
+                         (hit.get_x() * hit.get_x() +
+                          hit.get_y() * hit.get_y()));
+      }
+      for (unsigned int d_bin = 0; d_bin < n_d; ++d_bin) {
+        for (unsigned int k_bin = 0; k_bin < n_k; ++k_bin) {
+          if (vote_width == 16) {
+            phiRange_avx512(x_w, y_w, min_d_array[d_bin], max_d_array[d_bin],
+                            min_k_array[k_bin], max_k_array[k_bin], hel,
+                            min_phi_w, max_phi_w, phi_3_w, phi_4_w,
+                            (k_bin == 0));
+          } else {
+            phiRange_avx2(x_w, y_w, min_d_array[d_bin], max_d_array[d_bin],
+                          min_k_array[k_bin], max_k_array[k_bin], hel,
+                          min_phi_w, max_phi_w, phi_3_w, phi_4_w,
+                          (k_bin == 0));
+          }
+          for (unsigned int h = 0; h < vote_width; ++h) {
+            // the sse loop below takes the phiError of the second four hits
+            // of each group of eight from the first four, do the same here so
+            // that the votes do not depend on the vector width
+            unsigned int h_err = h % 8;
+            if (h_err >= 4) {
+              h_err -= 4;
+            }
+            float dphi = dphi_w[h];
+            dphi += phiError(
+                wide_hits[h / 8][h_err], min_kappa, max_kappa,
+                min_d_array[d_bin], max_d_array[d_bin],
+                zoomranges[zoomlevel].min_z0, zoomranges[zoomlevel].max_z0,
+                zoomranges[zoomlevel].min_dzdl, zoomranges[zoomlevel].max_dzdl);
+
+            min_phi_w[h] -= dphi;
+            max_phi_w[h] += dphi;
+          }
+          for (unsigned int h = 0; h < vote_width; h += 8) {
+            fillBins(total_bins, 8, min_phi_w + h, max_phi_w + h,
+                     wide_hits[h / 8], z_bins, n_d, n_k, n_dzdl, n_z0, d_bin,
+                     k_bin, n_phi, zoomlevel, low_phi, high_phi, inv_phi_range,
+                     vote_array);
+          }
+        }
+      }
+    }
+    first_hit = n_wide;
+  }
+
+  for (unsigned int i = first_hit; i < hits_vec[zoomlevel]->size(); i++) {
     if (hit_counter < 4) {
       four_hits[hit_counter] = ((*(hits_vec[zoomlevel]))[i]);
       x_a[hit_counter] = four_hits[hit_counter].get_x();
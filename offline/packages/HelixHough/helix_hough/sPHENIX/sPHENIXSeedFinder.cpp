@@ -303,7 +303,6 @@ sPHENIXSeedFinder::sPHENIXSeedFinder(vector<vector<unsigned int> >& zoom_profile
 							material, radius, Bfield));
 			thread_trackers.back()->setThread();
 			thread_trackers.back()->setStartZoom(1);
-			thread_tracks.push_back(vector<SimpleTrack3D>());
 			thread_ranges.push_back(HelixRange());
 			thread_hits.push_back(vector<SimpleHit3D>());
 			split_output_hits.push_back(new vector<vector<SimpleHit3D> >());
@@ -1935,7 +1934,7 @@ void sPHENIXSeedFinder::initSplitting(vector<SimpleHit3D>& hits,
 
 void sPHENIXSeedFinder::findHelicesParallelOneHelicity(
   vector<SimpleHit3D>& hits, unsigned int /*min_hits*/, unsigned int /*max_hits*/,
-		vector<SimpleTrack3D>& /*tracks*/) {
+		vector<SimpleTrack3D>& tracks) {
 	unsigned int hits_per_thread = (hits.size() + 2 * nthreads) / nthreads;
 	unsigned int pos = 0;
 	while (pos < hits.size()) {
@@ -1973,7 +1972,31 @@ void sPHENIXSeedFinder::findHelicesParallelOneHelicity(
 		}
 	}
 
+	bin_tracks.assign(nbins, vector<SimpleTrack3D>());
+	bin_states.assign(nbins, vector<HelixKalmanState>());
+	thread_bin_order.clear();
+	for (unsigned int b = 0; b < nbins; ++b) {
+		if (thread_hits[b].size() != 0) {
+			thread_bin_order.push_back(b);
+		}
+	}
+	// the zoom time grows with the number of hits, start with the busiest bins
+	// so that no thread is left with a large one at the end
+	stable_sort(thread_bin_order.begin(), thread_bin_order.end(),
+			[this](unsigned int b1, unsigned int b2) {
+				return thread_hits[b1].size() > thread_hits[b2].size();
+			});
+	thread_next_bin = 0;
+
 	pins->sewStraight(&sPHENIXSeedFinder::findHelicesParallelThread, nthreads);
+
+	// collect in bin order, so that the output does not depend on the number
+	// of threads or on which thread processed which bin
+	for (unsigned int b = 0; b < nbins; ++b) {
+		tracks.insert(tracks.end(), bin_tracks[b].begin(), bin_tracks[b].end());
+		track_states.insert(track_states.end(), bin_states[b].begin(),
+				bin_states[b].end());
+	}
 }
 
 void sPHENIXSeedFinder::findHelicesParallel(vector<SimpleHit3D>& hits,
@@ -1983,7 +2006,6 @@ void sPHENIXSeedFinder::findHelicesParallel(vector<SimpleHit3D>& hits,
 	thread_max_hits = max_hits;
 
 	for (unsigned int i = 0; i < nthreads; ++i) {
-		thread_tracks[i].clear();
 		thread_trackers[i]->clear();
 		if (cluster_start_bin != 0) {
 			thread_trackers[i]->setClusterStartBin(cluster_start_bin - 1);
@@ -1994,6 +2016,8 @@ void sPHENIXSeedFinder::findHelicesParallel(vector<SimpleHit3D>& hits,
 
 	initSplitting(hits, min_hits, max_hits);
 
+	vector<SimpleTrack3D> temp_tracks;
+
 	if (separate_by_helicity == true) {
 		for (unsigned int i = 0; i < nthreads; ++i) {
 			thread_trackers[i]->setSeparateByHelicity(true);
@@ -2002,7 +2026,7 @@ void sPHENIXSeedFinder::findHelicesParallel(vector<SimpleHit3D>& hits,
 			split_output_hits[i]->clear();
 			split_input_hits[i].clear();
 		}
-		findHelicesParallelOneHelicity(hits, min_hits, max_hits, tracks);
+		findHelicesParallelOneHelicity(hits, min_hits, max_hits, temp_tracks);
 
 		for (unsigned int i = 0; i < nthreads; ++i) {
 			thread_trackers[i]->setSeparateByHelicity(true);
@@ -2011,7 +2035,7 @@ void sPHENIXSeedFinder::findHelicesParallel(vector<SimpleHit3D>& hits,
 			split_output_hits[i]->clear();
 			split_input_hits[i].clear();
 		}
-		findHelicesParallelOneHelicity(hits, min_hits, max_hits, tracks);
+		findHelicesParallelOneHelicity(hits, min_hits, max_hits, temp_tracks);
 	} else {
 		for (unsigned int i = 0; i < nthreads; ++i) {
 			thread_trackers[i]->setSeparateByHelicity(false);
@@ -2020,18 +2044,9 @@ void sPHENIXSeedFinder::findHelicesParallel(vector<SimpleHit3D>& hits,
 			split_input_hits[i].clear();
 		}
 
-		findHelicesParallelOneHelicity(hits, min_hits, max_hits, tracks);
+		findHelicesParallelOneHelicity(hits, min_hits, max_hits, temp_tracks);
 	}
 
-	vector<SimpleTrack3D> temp_tracks;
-	for (unsigned int i = 0; i < nthreads; ++i) {
-		vector<HelixKalmanState>* states =
-				&(thread_trackers[i]->getKalmanStates());
-		for (unsigned int j = 0; j < thread_tracks[i].size(); ++j) {
-			track_states.push_back((*states)[j]);
-			temp_tracks.push_back(thread_tracks[i][j]);
-		}
-	}
 	finalize(temp_tracks, tracks);
 }
 
@@ -2044,12 +2059,14 @@ void sPHENIXSeedFinder::splitHitsParallelThread(void* arg) {
 void sPHENIXSeedFinder::findHelicesParallelThread(void* arg) {
 	unsigned long int w = (*((unsigned long int*) arg));
 
-	for (unsigned int i = w; i < thread_ranges.size(); i += nthreads) {
-		if (thread_hits[i].size() == 0) {
-			continue;
-		}
+	vector<HelixKalmanState>& states = thread_trackers[w]->getKalmanStates();
+	for (unsigned int n = thread_next_bin++; n < thread_bin_order.size();
+			n = thread_next_bin++) {
+		unsigned int i = thread_bin_order[n];
+		unsigned int n_states = states.size();
 		thread_trackers[w]->setTopRange(thread_ranges[i]);
 		thread_trackers[w]->findHelices(thread_hits[i], thread_min_hits,
-				thread_max_hits, thread_tracks[w]);
+				thread_max_hits, bin_tracks[i]);
+		bin_states[i].assign(states.begin() + n_states, states.end());
 	}
 }
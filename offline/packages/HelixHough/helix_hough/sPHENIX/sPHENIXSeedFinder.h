@@ -9,6 +9,7 @@
 
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <map>
 #include <memory>
@@ -545,9 +546,15 @@ private:
 	std::vector<SeamStress::Seamstress> vss;
 	SeamStress::Pincushion<sPHENIXSeedFinder> *pins;
 	std::vector<sPHENIXSeedFinder*> thread_trackers;
-	std::vector<std::vector<SimpleTrack3D> > thread_tracks;
 	std::vector<HelixRange> thread_ranges;
 	std::vector<std::vector<SimpleHit3D> > thread_hits;
+	// tracks and kalman states found in each bin of thread_ranges
+	std::vector<std::vector<SimpleTrack3D> > bin_tracks;
+	std::vector<std::vector<HelixKalmanState> > bin_states;
+	// non empty bins of thread_ranges, largest first, handed out to the threads
+	// one at a time
+	std::vector<unsigned int> thread_bin_order;
+	std::atomic<unsigned int> thread_next_bin;
 	std::vector<std::vector<SimpleHit3D> > split_input_hits;
 	std::vector<std::vector<std::vector<SimpleHit3D> >*> split_output_hits;
 	std::vector<std::vector<HelixRange>*> split_ranges;
@@ -0,0 +1,147 @@
+// times the xy vote of HelixHough for each vector width supported by the cpu
+// (sse, avx2, avx512) on random hits, and checks that the votes agree with
+// the sse version.
+//
+// usage: helixhough_benchmark [n_hits] [n_repeat]
+
+#include "HelixHough.h"
+#include "HelixRange.h"
+#include "SimpleHit3D.h"
+
+#include <sys/time.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+class BenchmarkHough : public HelixHough {
+ public:
+  BenchmarkHough(vector<vector<unsigned int> >& zoom_profile,
+                 unsigned int minzoom, HelixRange& range)
+      : HelixHough(zoom_profile, minzoom, range) {}
+  virtual ~BenchmarkHough() {}
+
+  void findTracks(vector<SimpleHit3D>&, vector<SimpleTrack3D>&,
+                  const HelixRange&) {}
+
+  // hits to vote in the top level bins
+  void setTopHits(vector<SimpleHit3D>& hits) {
+    (*(hits_vec[0])) = hits;
+    zoomranges.assign(max_zoom + 1, top_range);
+  }
+
+  // (bin, hit) pairs of the last top level vote, ordered by bin, then hit
+  vector<pair<unsigned int, unsigned int> > topVotes() const {
+    vector<pair<unsigned int, unsigned int> > votes;
+    for (unsigned int i = 0; i < bins_vec[0]->size(); ++i) {
+      votes.push_back(make_pair((*(bins_vec[0]))[i].bin,
+                                (*(bins_vec[0]))[i].entry));
+    }
+    sort(votes.begin(), votes.end());
+    return votes;
+  }
+
+  // time spent in the xy part of the vote, which uses the vector kernels
+  double xyVoteTime() const { return xy_vote_time; }
+  void resetTimes() {
+    xy_vote_time = 0.;
+    z_vote_time = 0.;
+  }
+};
+
+static double now() {
+  timeval t;
+  gettimeofday(&t, NULL);
+  return ((double)(t.tv_sec) + (double)(t.tv_usec) / 1000000.);
+}
+
+int main(int argc, char** argv) {
+  unsigned int n_hits = 2000;
+  unsigned int n_repeat = 20;
+  if (argc > 1) {
+    n_hits = atoi(argv[1]);
+  }
+  if (argc > 2) {
+    n_repeat = atoi(argv[2]);
+  }
+
+  // random hits on 7 cylindrical layers
+  const float radii[7] = {2.3, 3.2, 3.9, 30., 40., 50., 60.};
+  mt19937 generator(12345);
+  uniform_real_distribution<float> phi_dist(0., 2. * M_PI);
+  uniform_real_distribution<float> z_dist(-10., 10.);
+  vector<SimpleHit3D> hits;
+  for (unsigned int i = 0; i < n_hits; ++i) {
+    SimpleHit3D hit;
+    float phi = phi_dist(generator);
+    hit.set_layer(i % 7);
+    hit.set_x(radii[i % 7] * cos(phi));
+    hit.set_y(radii[i % 7] * sin(phi));
+    hit.set_z(z_dist(generator));
+    hit.set_id(i);
+    for (unsigned int j = 0; j < 3; ++j) {
+      for (unsigned int k = j; k < 3; ++k) {
+        hit.set_error(j, k, 0.);
+        hit.set_size(j, k, (j == k) ? 1.0e-6 : 0.);
+      }
+    }
+    hits.push_back(hit);
+  }
+
+  vector<vector<unsigned int> > zoom_profile;
+  for (unsigned int z = 0; z < 3; ++z) {
+    vector<unsigned int> zoom(5, 0);
+    zoom[0] = 16;
+    zoom[1] = 2;
+    zoom[2] = 8;
+    zoom[3] = 4;
+    zoom[4] = 4;
+    zoom_profile.push_back(zoom);
+  }
+  HelixRange top_range(0., 2. * M_PI, -0.1, 0.1, 0., 0.03, -0.9, 0.9, -10.,
+                       10.);
+  BenchmarkHough hough(zoom_profile, 1, top_range);
+  hough.setSeparateByHelicity(true);
+  hough.setHelicity(true);
+  hough.setPrintTimings(true);
+  hough.setTopHits(hits);
+
+  cout << "hits = " << n_hits << ", repeat = " << n_repeat
+       << ", max vote width = " << HelixHough::maxVoteWidth() << endl;
+
+  vector<pair<unsigned int, unsigned int> > sse_votes;
+  double sse_xy_time = 0.;
+  bool all_equal = true;
+  for (unsigned int width = 4; width <= HelixHough::maxVoteWidth();
+       width *= 2) {
+    hough.setVoteWidth(width);
+    hough.resetTimes();
+    double t1 = now();
+    for (unsigned int r = 0; r < n_repeat; ++r) {
+      hough.vote(0);
+    }
+    double t = (now() - t1) / n_repeat;
+    double t_xy = hough.xyVoteTime() / n_repeat;
+
+    vector<pair<unsigned int, unsigned int> > votes = hough.topVotes();
+    bool equal = true;
+    if (width == 4) {
+      sse_votes = votes;
+      sse_xy_time = t_xy;
+    } else {
+      equal = (votes == sse_votes);
+    }
+    all_equal = (all_equal && equal);
+
+    cout << "vote width " << width << " : " << 1000. * t << " ms / vote, xy "
+         << 1000. * t_xy << " ms, xy speedup " << sse_xy_time / t_xy << ", "
+         << votes.size() << " votes" << (equal ? "" : ", DIFFERENT FROM SSE")
+         << endl;
+  }
+
+  return (all_equal ? 0 : 1);
+}
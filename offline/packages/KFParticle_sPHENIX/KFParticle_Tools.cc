@@ -44,6 +44,8 @@
 #include <Eigen/Core>
 #include <Eigen/Dense>
 
+#include <iterator>
+
 /// Create necessary objects
 typedef std::pair<int, float> particle_pair;
 KFParticle_particleList kfp_particleList;
@@ -105,7 +107,7 @@ KFParticle KFParticle_Tools::makeVertex(PHCompositeNode */*topNode*/)
   return kfp_vertex;
 }
 
-std::vector<KFParticle> KFParticle_Tools::makeAllPrimaryVertices(PHCompositeNode *topNode, std::string vertexMapName)
+std::vector<KFParticle> KFParticle_Tools::makeAllPrimaryVertices(PHCompositeNode *topNode, const std::string &vertexMapName)
 {
   std::string vtxMN;
   if (vertexMapName.empty())
@@ -173,7 +175,7 @@ std::vector<KFParticle> KFParticle_Tools::makeAllDaughterParticles(PHCompositeNo
   return daughterParticles;
 }
 
-int KFParticle_Tools::getTracksFromVertex(PHCompositeNode *topNode, KFParticle vertex, std::string vertexMapName)
+int KFParticle_Tools::getTracksFromVertex(PHCompositeNode *topNode, const KFParticle &vertex, const std::string &vertexMapName)
 {
   std::string vtxMN;
   if (vertexMapName.empty())
@@ -189,7 +191,7 @@ int KFParticle_Tools::getTracksFromVertex(PHCompositeNode *topNode, KFParticle v
   return associatedVertex->size_tracks();
 }
 
-/*const*/ bool KFParticle_Tools::isGoodTrack(KFParticle particle, const std::vector<KFParticle> primaryVertices)
+/*const*/ bool KFParticle_Tools::isGoodTrack(const KFParticle &particle, const std::vector<KFParticle> &primaryVertices)
 {
   bool goodTrack = false;
   
@@ -210,7 +212,7 @@ int KFParticle_Tools::getTracksFromVertex(PHCompositeNode *topNode, KFParticle v
   return goodTrack;
 }
 
-int KFParticle_Tools::calcMinIP(KFParticle track, std::vector<KFParticle> PVs,
+int KFParticle_Tools::calcMinIP(const KFParticle &track, const std::vector<KFParticle> &PVs,
                                 float& minimumIP, float& minimumIPchi2)
 {
   std::vector<float> ip, ipchi2;
@@ -226,16 +228,26 @@ int KFParticle_Tools::calcMinIP(KFParticle track, std::vector<KFParticle> PVs,
   auto minmax_ipchi2 = minmax_element(ipchi2.begin(), ipchi2.end());  //Order the IP chi2 from small to large
   minimumIPchi2 = *minmax_ipchi2.first;
 
-  return 0;
+  return std::distance(ipchi2.begin(), minmax_ipchi2.first);
 }
 
-std::vector<int> KFParticle_Tools::findAllGoodTracks(std::vector<KFParticle> daughterParticles, const std::vector<KFParticle> primaryVertices)
+std::vector<int> KFParticle_Tools::findAllGoodTracks(const std::vector<KFParticle> &daughterParticles, const std::vector<KFParticle> &primaryVertices)
 {
   std::vector<int> goodTrackIndex;
+  m_track_associated_pv.assign(daughterParticles.size(), -1);
 
   for (unsigned int i_parts = 0; i_parts < daughterParticles.size(); ++i_parts)
   {
-    if (isGoodTrack(daughterParticles[i_parts], primaryVertices)) goodTrackIndex.push_back(i_parts);
+    if (isGoodTrack(daughterParticles[i_parts], primaryVertices))
+    {
+      goodTrackIndex.push_back(i_parts);
+      if (m_use_pv_preselection)
+      {
+        float min_ip = 0;
+        float min_ipchi2 = 0;
+        m_track_associated_pv[i_parts] = calcMinIP(daughterParticles[i_parts], primaryVertices, min_ip, min_ipchi2);
+      }
+    }
   }
 
   removeDuplicates(goodTrackIndex);
@@ -243,36 +255,33 @@ std::vector<int> KFParticle_Tools::findAllGoodTracks(std::vector<KFParticle> dau
   return goodTrackIndex;
 }
 
-std::vector<std::vector<int>> KFParticle_Tools::findTwoProngs(std::vector<KFParticle> daughterParticles, std::vector<int> goodTrackIndex, int nTracks)
+std::vector<std::vector<int>> KFParticle_Tools::findTwoProngs(const std::vector<KFParticle> &daughterParticles, const std::vector<int> &goodTrackIndex, int nTracks)
 {
   std::vector<std::vector<int>> goodTracksThatMeet;
 
-  for (std::vector<int>::iterator i_it = goodTrackIndex.begin(); i_it != goodTrackIndex.end(); ++i_it)
+  for (std::vector<int>::const_iterator i_it = goodTrackIndex.begin(); i_it != goodTrackIndex.end(); ++i_it)
   {
-    for (std::vector<int>::iterator j_it = goodTrackIndex.begin(); j_it != goodTrackIndex.end(); ++j_it)
+    for (std::vector<int>::const_iterator j_it = i_it + 1; j_it != goodTrackIndex.end(); ++j_it)
     {
-      if (i_it < j_it)
+      if (daughterParticles[*i_it].GetDistanceFromParticle(daughterParticles[*j_it]) <= m_comb_DCA)
       {
-        if (daughterParticles[*i_it].GetDistanceFromParticle(daughterParticles[*j_it]) <= m_comb_DCA)
-        {
-          KFVertex twoParticleVertex;
-          twoParticleVertex += daughterParticles[*i_it];
-          twoParticleVertex += daughterParticles[*j_it];
-          float vertexchi2ndof = twoParticleVertex.GetChi2() / twoParticleVertex.GetNDF();
-          std::vector<int> combination = {*i_it, *j_it};
+        KFVertex twoParticleVertex;
+        twoParticleVertex += daughterParticles[*i_it];
+        twoParticleVertex += daughterParticles[*j_it];
+        float vertexchi2ndof = twoParticleVertex.GetChi2() / twoParticleVertex.GetNDF();
+        std::vector<int> combination = {*i_it, *j_it};
 
-          if (nTracks == 2 && vertexchi2ndof <= m_vertex_chi2ndof)
-          {
-            goodTracksThatMeet.push_back(combination);
-          }
-          else if (nTracks == 2 && vertexchi2ndof > m_vertex_chi2ndof)
-          {
-            continue;
-          }
-          else
-          {
-            goodTracksThatMeet.push_back(combination);
-          }
+        if (nTracks == 2 && vertexchi2ndof <= m_vertex_chi2ndof)
+        {
+          goodTracksThatMeet.push_back(combination);
+        }
+        else if (nTracks == 2 && vertexchi2ndof > m_vertex_chi2ndof)
+        {
+          continue;
+        }
+        else
+        {
+          goodTracksThatMeet.push_back(combination);
         }
       }
     }
@@ -281,14 +290,15 @@ std::vector<std::vector<int>> KFParticle_Tools::findTwoProngs(std::vector<KFPart
   return goodTracksThatMeet;
 }
 
-std::vector<std::vector<int>> KFParticle_Tools::findNProngs(std::vector<KFParticle> daughterParticles,
-                                                  std::vector<int> goodTrackIndex,
-                                                  std::vector<std::vector<int>> goodTracksThatMeet,
+std::vector<std::vector<int>> KFParticle_Tools::findNProngs(const std::vector<KFParticle> &daughterParticles,
+                                                  const std::vector<int> &goodTrackIndex,
+                                                  const std::vector<std::vector<int>> &goodTracksThatMeet,
                                                   int nRequiredTracks, unsigned int nProngs)
 {
   unsigned int nGoodProngs = goodTracksThatMeet.size();
+  std::vector<std::vector<int>> goodTracksThatMeetNProngs;
 
-  for (std::vector<int>::iterator i_it = goodTrackIndex.begin(); i_it != goodTrackIndex.end(); ++i_it)
+  for (std::vector<int>::const_iterator i_it = goodTrackIndex.begin(); i_it != goodTrackIndex.end(); ++i_it)
   {
     for (unsigned int i_prongs = 0; i_prongs < nGoodProngs; ++i_prongs)
     {
@@ -321,7 +331,7 @@ std::vector<std::vector<int>> KFParticle_Tools::findNProngs(std::vector<KFPartic
 
           if ((unsigned int) nRequiredTracks == nProngs && vertexchi2ndof <= m_vertex_chi2ndof)
           {
-            goodTracksThatMeet.push_back(combination);
+            goodTracksThatMeetNProngs.push_back(combination);
           }
           else if ((unsigned int) nRequiredTracks == nProngs && vertexchi2ndof > m_vertex_chi2ndof)
           {
@@ -329,26 +339,25 @@ std::vector<std::vector<int>> KFParticle_Tools::findNProngs(std::vector<KFPartic
           }
           else
           {
-            goodTracksThatMeet.push_back(combination);
+            goodTracksThatMeetNProngs.push_back(combination);
           }
         }
       }
     }
   }
 
-  goodTracksThatMeet.erase(goodTracksThatMeet.begin(), goodTracksThatMeet.begin() + nGoodProngs);
-  for (unsigned int i = 0; i < goodTracksThatMeet.size(); ++i) sort(goodTracksThatMeet[i].begin(), goodTracksThatMeet[i].end());
-  removeDuplicates(goodTracksThatMeet);
+  for (unsigned int i = 0; i < goodTracksThatMeetNProngs.size(); ++i) sort(goodTracksThatMeetNProngs[i].begin(), goodTracksThatMeetNProngs[i].end());
+  removeDuplicates(goodTracksThatMeetNProngs);
 
-  return goodTracksThatMeet;
+  return goodTracksThatMeetNProngs;
 }
 
-std::vector<std::vector<int>> KFParticle_Tools::appendTracksToIntermediates(KFParticle intermediateResonances[], std::vector<KFParticle> daughterParticles, std::vector<int> goodTrackIndex, int num_remaining_tracks)
+std::vector<std::vector<int>> KFParticle_Tools::appendTracksToIntermediates(KFParticle intermediateResonances[], const std::vector<KFParticle> &daughterParticles, const std::vector<int> &goodTrackIndex, int num_remaining_tracks)
 {
   std::vector<std::vector<int>> goodTracksThatMeet, goodTracksThatMeetIntermediates;  //, vectorOfGoodTracks;
   if (num_remaining_tracks == 1)
   {
-    for (std::vector<int>::iterator i_it = goodTrackIndex.begin(); i_it != goodTrackIndex.end(); ++i_it)
+    for (std::vector<int>::const_iterator i_it = goodTrackIndex.begin(); i_it != goodTrackIndex.end(); ++i_it)
     {
       std::vector<KFParticle> v_intermediateResonances(intermediateResonances, intermediateResonances + m_num_intermediate_states);
       std::vector<std::vector<int>> dummyTrackList;
@@ -408,7 +417,7 @@ std::vector<std::vector<int>> KFParticle_Tools::appendTracksToIntermediates(KFPa
   return goodTracksThatMeetIntermediates;
 }
 
-float KFParticle_Tools::eventDIRA(KFParticle particle, KFParticle vertex)
+float KFParticle_Tools::eventDIRA(const KFParticle &particle, const KFParticle &vertex)
 {
   TMatrixD flightVector(3, 1);
   TMatrixD momVector(3, 1);
@@ -435,7 +444,7 @@ float KFParticle_Tools::eventDIRA(KFParticle particle, KFParticle vertex)
   return f_momDotFD / (f_sizeOfMom * f_sizeOfFD); 
 }
 
-float KFParticle_Tools::flightDistanceChi2(KFParticle particle, KFParticle vertex)
+float KFParticle_Tools::flightDistanceChi2(const KFParticle &particle, const KFParticle &vertex)
 {
   TMatrixD flightVector(3, 1);
   TMatrixD flightDistanceCovariance(3, 3);
@@ -541,7 +550,7 @@ std::tuple<KFParticle, bool> KFParticle_Tools::buildMother(KFParticle vDaughters
   return std::make_tuple(mother, goodCandidate);
 }
 
-void KFParticle_Tools::constrainToVertex(KFParticle &particle, bool &goodCandidate, KFParticle &vertex)
+void KFParticle_Tools::constrainToVertex(KFParticle &particle, bool &goodCandidate, const KFParticle &vertex)
 {
   KFParticle particleCopy = particle;
   particleCopy.SetProductionVertex(vertex);
@@ -571,7 +580,7 @@ void KFParticle_Tools::constrainToVertex(KFParticle &particle, bool &goodCandida
       goodCandidate = true;
 }
 
-std::tuple<KFParticle, bool> KFParticle_Tools::getCombination(KFParticle vDaughters[], std::string daughterOrder[], KFParticle vertex, bool constrain_to_vertex, bool isIntermediate, int intermediateNumber, int nTracks, bool constrainMass, float required_vertexID)
+std::tuple<KFParticle, bool> KFParticle_Tools::getCombination(KFParticle vDaughters[], std::string daughterOrder[], const KFParticle &vertex, bool constrain_to_vertex, bool isIntermediate, int intermediateNumber, int nTracks, bool constrainMass, float required_vertexID)
 {
   KFParticle candidate;
   bool isGoodCandidate;
@@ -620,7 +629,7 @@ double KFParticle_Tools::calculateEllipsoidRadius(int posOrNeg, double sigma_ii,
   return r_ij;
 }
 
-float KFParticle_Tools::calculateEllipsoidVolume(KFParticle particle)
+float KFParticle_Tools::calculateEllipsoidVolume(const KFParticle &particle)
 {
   TMatrixD cov_matrix(3, 3);
 
@@ -637,7 +646,7 @@ float KFParticle_Tools::calculateEllipsoidVolume(KFParticle particle)
   return volume;
 }
 
-float KFParticle_Tools::calculateJT(KFParticle mother, KFParticle daughter)
+float KFParticle_Tools::calculateJT(const KFParticle &mother, const KFParticle &daughter)
 {
   Eigen::Vector3f motherP = Eigen::Vector3f(mother.GetPx(), mother.GetPy(), mother.GetPz());
   Eigen::Vector3f daughterP = Eigen::Vector3f(daughter.GetPx(), daughter.GetPy(), daughter.GetPz());
@@ -694,7 +703,7 @@ void KFParticle_Tools::removeDuplicates(std::vector<std::vector<std::string>> &v
   v.erase(end, v.end());
 }
 
-void KFParticle_Tools::identify(KFParticle particle)
+void KFParticle_Tools::identify(const KFParticle &particle)
 {
   std::cout << "Track ID: " << particle.Id() << std::endl;
   std::cout << "PDG ID: " << particle.GetPDG() << ", charge: " << (int) particle.GetQ() << ", mass: " << particle.GetMass() << " GeV" << std::endl;
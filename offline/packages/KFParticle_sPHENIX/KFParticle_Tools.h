@@ -46,52 +46,53 @@ class KFParticle_Tools : public KFParticle_particleList, protected KFParticle_MV
 
   KFParticle makeVertex(PHCompositeNode *topNode);
 
-  std::vector<KFParticle> makeAllPrimaryVertices(PHCompositeNode *topNode, std::string vertexMapName);
+  std::vector<KFParticle> makeAllPrimaryVertices(PHCompositeNode *topNode, const std::string &vertexMapName);
 
   KFParticle makeParticle(PHCompositeNode *topNode);
 
   std::vector<KFParticle> makeAllDaughterParticles(PHCompositeNode *topNode);
 
-  int getTracksFromVertex(PHCompositeNode *topNode, KFParticle vertex, std::string vertexMapName);
+  int getTracksFromVertex(PHCompositeNode *topNode, const KFParticle &vertex, const std::string &vertexMapName);
 
-  /*const*/ bool isGoodTrack(KFParticle particle, const std::vector<KFParticle> primaryVertices);
+  /*const*/ bool isGoodTrack(const KFParticle &particle, const std::vector<KFParticle> &primaryVertices);
 
-  int calcMinIP(KFParticle track, std::vector<KFParticle> PVs, float& minimumIP, float& minimumIPchi2);
+  ///Returns the index of the vertex with the smallest IP chi2
+  int calcMinIP(const KFParticle &track, const std::vector<KFParticle> &PVs, float& minimumIP, float& minimumIPchi2);
 
-  std::vector<int> findAllGoodTracks(std::vector<KFParticle> daughterParticles, std::vector<KFParticle> primaryVertices);
+  std::vector<int> findAllGoodTracks(const std::vector<KFParticle> &daughterParticles, const std::vector<KFParticle> &primaryVertices);
 
-  std::vector<std::vector<int>> findTwoProngs(std::vector<KFParticle> daughterParticles, std::vector<int> goodTrackIndex, int nTracks);
+  std::vector<std::vector<int>> findTwoProngs(const std::vector<KFParticle> &daughterParticles, const std::vector<int> &goodTrackIndex, int nTracks);
 
-  std::vector<std::vector<int>> findNProngs(std::vector<KFParticle> daughterParticles,
-                                  std::vector<int> goodTrackIndex,
-                                  std::vector<std::vector<int>> goodTracksThatMeet,
+  std::vector<std::vector<int>> findNProngs(const std::vector<KFParticle> &daughterParticles,
+                                  const std::vector<int> &goodTrackIndex,
+                                  const std::vector<std::vector<int>> &goodTracksThatMeet,
                                   int nRequiredTracks, unsigned int nProngs);
 
-  std::vector<std::vector<int>> appendTracksToIntermediates(KFParticle intermediateResonances[], std::vector<KFParticle> daughterParticles, std::vector<int> goodTrackIndex, int num_remaining_tracks);
+  std::vector<std::vector<int>> appendTracksToIntermediates(KFParticle intermediateResonances[], const std::vector<KFParticle> &daughterParticles, const std::vector<int> &goodTrackIndex, int num_remaining_tracks);
 
   ///Calculates the cosine of the angle betweent the flight direction and momentum
-  float eventDIRA(KFParticle particle, KFParticle vertex);
+  float eventDIRA(const KFParticle &particle, const KFParticle &vertex);
 
-  float flightDistanceChi2(KFParticle particle, KFParticle vertex);
+  float flightDistanceChi2(const KFParticle &particle, const KFParticle &vertex);
 
   std::tuple<KFParticle, bool> buildMother(KFParticle vDaughters[], std::string daughterOrder[], bool isIntermediate, int intermediateNumber, int nTracks, bool constrainMass, float required_vertexID);
 
-  void constrainToVertex(KFParticle &particle, bool &goodCandidate, KFParticle &vertex);
+  void constrainToVertex(KFParticle &particle, bool &goodCandidate, const KFParticle &vertex);
 
-  std::tuple<KFParticle, bool> getCombination(KFParticle vDaughters[], std::string daughterOrder[], KFParticle vertex,
+  std::tuple<KFParticle, bool> getCombination(KFParticle vDaughters[], std::string daughterOrder[], const KFParticle &vertex,
                                          bool constrain_to_vertex, bool isIntermediate, int intermediateNumber, int nTracks, bool constrainMass, float required_vertexID);
 
   std::vector<std::vector<std::string>> findUniqueDaughterCombinations(int start, int end);
 
   double calculateEllipsoidRadius(int posOrNeg, double sigma_ii, double sigma_jj, double sigma_ij);
 
-  float calculateEllipsoidVolume(KFParticle particle);
+  float calculateEllipsoidVolume(const KFParticle &particle);
 
-  float calculateJT(KFParticle mother, KFParticle daughter);
+  float calculateJT(const KFParticle &mother, const KFParticle &daughter);
 
   bool isInRange(float min, float value, float max);
 
-  void identify(KFParticle particle);
+  void identify(const KFParticle &particle);
 
  protected:
   std::string m_mother_name_Tools;
@@ -155,6 +156,12 @@ class KFParticle_Tools : public KFParticle_particleList, protected KFParticle_MV
 
   bool m_allowZeroMassTracks = false;
 
+  ///Only combine tracks associated to the same primary vertex (smallest IP chi2)
+  bool m_use_pv_preselection = false;
+
+  ///Index of the primary vertex associated to each track, filled by findAllGoodTracks when m_use_pv_preselection is set
+  std::vector<int> m_track_associated_pv;
+
   std::string m_vtx_map_node_name;
   std::string m_trk_map_node_name;
   SvtxVertexMap *m_dst_vertexmap = nullptr;
@@ -36,6 +36,7 @@
 #include <algorithm>
 #include <assert.h>
 #include <map>
+#include <thread>
 
 /// Create necessary objects
 typedef std::pair<int, float> particle_pair;
@@ -49,6 +50,7 @@ KFParticle_eventReconstruction::KFParticle_eventReconstruction()
   : m_constrain_to_vertex(true)
   , m_constrain_int_mass(false)
   , m_use_fake_pv(false)
+  , m_num_threads(1)
 {
 }
 
@@ -87,11 +89,12 @@ void KFParticle_eventReconstruction::buildBasicChain(std::vector<KFParticle>& se
                                                      const std::vector<int>& goodTrackIndexBasic,
                                                      const std::vector<KFParticle>& primaryVerticesBasic)
 {
-  std::vector<std::vector<int>> goodTracksThatMeet = findTwoProngs(daughterParticlesBasic, goodTrackIndexBasic, m_num_tracks);
-  for (int p = 3; p < m_num_tracks + 1; ++p) goodTracksThatMeet = findNProngs(daughterParticlesBasic, goodTrackIndexBasic, goodTracksThatMeet, m_num_tracks, p);
+  std::vector<std::vector<int>> goodTracksThatMeet;
+  std::vector<int> combinationPV;
+  findCombinations(daughterParticlesBasic, goodTrackIndexBasic, m_num_tracks, goodTracksThatMeet, combinationPV);
 
   getCandidateDecay(selectedMotherBasic, selectedVertexBasic, selectedDaughtersBasic, daughterParticlesBasic,
-                    goodTracksThatMeet, primaryVerticesBasic, 0, m_num_tracks, false, 0, true);
+                    goodTracksThatMeet, primaryVerticesBasic, 0, m_num_tracks, false, 0, true, combinationPV);
 }
 
 /*
@@ -119,14 +122,12 @@ void KFParticle_eventReconstruction::buildChain(std::vector<KFParticle>& selecte
   {
     std::vector<KFParticle> vertices;
 
-    std::vector<std::vector<int>> goodTracksThatMeet = findTwoProngs(daughterParticlesAdv, goodTrackIndexAdv, m_num_tracks_from_intermediate[i]);
-    for (int p = 3; p <= m_num_tracks_from_intermediate[i]; ++p) goodTracksThatMeet = findNProngs(daughterParticlesAdv,
-                                                                                                  goodTrackIndexAdv,
-                                                                                                  goodTracksThatMeet,
-                                                                                                  m_num_tracks_from_intermediate[i], p);
+    std::vector<std::vector<int>> goodTracksThatMeet;
+    std::vector<int> combinationPV;
+    findCombinations(daughterParticlesAdv, goodTrackIndexAdv, m_num_tracks_from_intermediate[i], goodTracksThatMeet, combinationPV);
 
     getCandidateDecay(potentialIntermediates[i], vertices, potentialDaughters[i], daughterParticlesAdv, 
-                      goodTracksThatMeet, primaryVerticesAdv, track_start, track_stop, true, i, m_constrain_int_mass);
+                      goodTracksThatMeet, primaryVerticesAdv, track_start, track_stop, true, i, m_constrain_int_mass, combinationPV);
 
     track_start += track_stop;
     track_stop += m_num_tracks_from_intermediate[i + 1];
@@ -278,93 +279,165 @@ void KFParticle_eventReconstruction::buildChain(std::vector<KFParticle>& selecte
   }          //Close first intermediate
 }
 
+void KFParticle_eventReconstruction::findCombinations(const std::vector<KFParticle>& daughterParticles,
+                                                      const std::vector<int>& goodTrackIndex, int nTracks,
+                                                      std::vector<std::vector<int>>& goodTracksThatMeet,
+                                                      std::vector<int>& combinationPV)
+{
+  goodTracksThatMeet.clear();
+  combinationPV.clear();
+
+  if (!m_use_pv_preselection)
+  {
+    goodTracksThatMeet = findTwoProngs(daughterParticles, goodTrackIndex, nTracks);
+    for (int p = 3; p <= nTracks; ++p) goodTracksThatMeet = findNProngs(daughterParticles, goodTrackIndex, goodTracksThatMeet, nTracks, p);
+    return;
+  }
+
+  //Bucket the good tracks by associated PV, tracks from different PVs are never combined
+  std::map<int, std::vector<int>> tracksPerPV;
+  for (int trackIndex : goodTrackIndex) tracksPerPV[m_track_associated_pv[trackIndex]].push_back(trackIndex);
+
+  for (const auto& bucket : tracksPerPV)
+  {
+    if ((int) bucket.second.size() < nTracks) continue;
+
+    std::vector<std::vector<int>> bucketTracksThatMeet = findTwoProngs(daughterParticles, bucket.second, nTracks);
+    for (int p = 3; p <= nTracks; ++p) bucketTracksThatMeet = findNProngs(daughterParticles, bucket.second, bucketTracksThatMeet, nTracks, p);
+
+    goodTracksThatMeet.insert(goodTracksThatMeet.end(), bucketTracksThatMeet.begin(), bucketTracksThatMeet.end());
+    combinationPV.resize(goodTracksThatMeet.size(), bucket.first);
+  }
+}
+
 void KFParticle_eventReconstruction::getCandidateDecay(std::vector<KFParticle>& selectedMotherCand,
                                                        std::vector<KFParticle>& selectedVertexCand,
                                                        std::vector<std::vector<KFParticle>>& selectedDaughtersCand,
-                                                       std::vector<KFParticle> daughterParticlesCand,
-                                                       std::vector<std::vector<int>> goodTracksThatMeetCand,
-                                                       std::vector<KFParticle> primaryVerticesCand,
+                                                       const std::vector<KFParticle>& daughterParticlesCand,
+                                                       const std::vector<std::vector<int>>& goodTracksThatMeetCand,
+                                                       const std::vector<KFParticle>& primaryVerticesCand,
                                                        int n_track_start, int n_track_stop,
-                                                       bool isIntermediate, int intermediateNumber, bool constrainMass)
+                                                       bool isIntermediate, int intermediateNumber, bool constrainMass,
+                                                       const std::vector<int>& combinationPV)
 {
   int nTracks = n_track_stop - n_track_start;
   std::vector<std::vector<std::string>> uniqueCombinations = findUniqueDaughterCombinations(n_track_start, n_track_stop);
-  std::vector<KFParticle> goodCandidates, goodVertex, goodDaughters[nTracks];
-  KFParticle candidate;
-  bool isGood;
   bool fixToPV = m_constrain_to_vertex && !isIntermediate;
 
   float required_unique_vertexID = 0;
   for (int i = n_track_start; i < n_track_stop; ++i) required_unique_vertexID += m_daughter_charge[i] * particleMasses_evtReco.find(m_daughter_name[i].c_str())->second.second;
 
-  for (unsigned int i_comb = 0; i_comb < goodTracksThatMeetCand.size(); ++i_comb)  //Loop over all good track combinations
-  {
-    KFParticle daughterTracks[nTracks];
+  //Best candidate of each combination, stored in place so that the output order does not depend on the number of threads
+  const unsigned int nCombinations = goodTracksThatMeetCand.size();
+  std::vector<char> hasCandidate(nCombinations, 0);
+  std::vector<KFParticle> bestMother(nCombinations);
+  std::vector<KFParticle> bestVertex(nCombinations);
+  std::vector<std::vector<KFParticle>> bestDaughters(nCombinations);
 
-    for (int i_track = 0; i_track < nTracks; ++i_track)
-    {
-      daughterTracks[i_track] = daughterParticlesCand[goodTracksThatMeetCand[i_comb][i_track]];
-    }  //Build array of the good tracks in that combination
+  //Loop over the combinations first, first + step, ... Each call has its own workspace
+  auto evaluateCombinations = [&](unsigned int first, unsigned int step)
+  {
+    std::vector<KFParticle> goodCandidates, goodVertex;
+    std::vector<std::vector<KFParticle>> goodDaughters(nTracks);
+    std::vector<KFParticle> daughterTracks(nTracks);
+    KFParticle candidate;
+    bool isGood;
 
-    for (unsigned int i_uc = 0; i_uc < uniqueCombinations.size(); ++i_uc)  //Loop over unique track PID assignments
+    for (unsigned int i_comb = first; i_comb < nCombinations; i_comb += step)  //Loop over all good track combinations
     {
-      for (unsigned int i_pv = 0; i_pv < primaryVerticesCand.size(); ++i_pv)  //Loop over all PVs in the event
+      for (int i_track = 0; i_track < nTracks; ++i_track)
       {
-        std::string* names = &uniqueCombinations[i_uc][0];
-        std::tie(candidate, isGood) = getCombination(daughterTracks, names, primaryVerticesCand[i_pv], m_constrain_to_vertex,
-                                                isIntermediate, intermediateNumber, nTracks, constrainMass, required_unique_vertexID);
+        daughterTracks[i_track] = daughterParticlesCand[goodTracksThatMeetCand[i_comb][i_track]];
+      }  //Build array of the good tracks in that combination
 
-        float min_ip = 0;
-        float min_ipchi2 = 0;
-        if (isIntermediate && isGood)
-        {
-          calcMinIP(candidate, primaryVerticesCand, min_ip, min_ipchi2);
-          if (!isInRange(m_intermediate_min_ip[intermediateNumber], min_ip, m_intermediate_max_ip[intermediateNumber])
-           || !isInRange(m_intermediate_min_ipchi2[intermediateNumber], min_ipchi2, m_intermediate_max_ipchi2[intermediateNumber]))
-              isGood = false;
-        }
+      //Only the associated PV is tested if the combination was pre-selected by PV
+      unsigned int pv_start = combinationPV.empty() ? 0 : combinationPV[i_comb];
+      unsigned int pv_stop = combinationPV.empty() ? primaryVerticesCand.size() : pv_start + 1;
 
-        if (isGood)
+      for (unsigned int i_uc = 0; i_uc < uniqueCombinations.size(); ++i_uc)  //Loop over unique track PID assignments
+      {
+        for (unsigned int i_pv = pv_start; i_pv < pv_stop; ++i_pv)  //Loop over all PVs in the event
         {
-          goodCandidates.push_back(candidate);
-          goodVertex.push_back(primaryVerticesCand[i_pv]);
-          for (int i = 0; i < nTracks; ++i)
+          std::string* names = &uniqueCombinations[i_uc][0];
+          std::tie(candidate, isGood) = getCombination(daughterTracks.data(), names, primaryVerticesCand[i_pv], m_constrain_to_vertex,
+                                                  isIntermediate, intermediateNumber, nTracks, constrainMass, required_unique_vertexID);
+
+          float min_ip = 0;
+          float min_ipchi2 = 0;
+          if (isIntermediate && isGood)
+          {
+            calcMinIP(candidate, primaryVerticesCand, min_ip, min_ipchi2);
+            if (!isInRange(m_intermediate_min_ip[intermediateNumber], min_ip, m_intermediate_max_ip[intermediateNumber])
+             || !isInRange(m_intermediate_min_ipchi2[intermediateNumber], min_ipchi2, m_intermediate_max_ipchi2[intermediateNumber]))
+                isGood = false;
+          }
+
+          if (isGood)
           {
-            KFParticle intParticle;
-            intParticle.Create(daughterTracks[i].Parameters(),
-                               daughterTracks[i].CovarianceMatrix(),
-                               (Int_t) daughterTracks[i].GetQ(),
-                               particleMasses_evtReco.find(names[i].c_str())->second.second);
-            intParticle.NDF() = daughterTracks[i].GetNDF();
-            intParticle.Chi2() = daughterTracks[i].GetChi2();
-            intParticle.SetId(daughterTracks[i].Id());
-            intParticle.SetPDG(daughterTracks[i].GetQ() * particleMasses_evtReco.find(names[i].c_str())->second.first);
-            goodDaughters[i].push_back(intParticle);
+            goodCandidates.push_back(candidate);
+            goodVertex.push_back(primaryVerticesCand[i_pv]);
+            for (int i = 0; i < nTracks; ++i)
+            {
+              KFParticle intParticle;
+              intParticle.Create(daughterTracks[i].Parameters(),
+                                 daughterTracks[i].CovarianceMatrix(),
+                                 (Int_t) daughterTracks[i].GetQ(),
+                                 particleMasses_evtReco.find(names[i].c_str())->second.second);
+              intParticle.NDF() = daughterTracks[i].GetNDF();
+              intParticle.Chi2() = daughterTracks[i].GetChi2();
+              intParticle.SetId(daughterTracks[i].Id());
+              intParticle.SetPDG(daughterTracks[i].GetQ() * particleMasses_evtReco.find(names[i].c_str())->second.first);
+              goodDaughters[i].push_back(intParticle);
+            }
           }
         }
       }
-    }
 
-    if (goodCandidates.size() != 0)
-    {
-      int bestCombinationIndex = selectBestCombination(fixToPV, isIntermediate, goodCandidates, goodVertex);
-                          
-      selectedMotherCand.push_back(goodCandidates[bestCombinationIndex]);
-      if (fixToPV) selectedVertexCand.push_back(goodVertex[bestCombinationIndex]);
-      std::vector<KFParticle> particles;
-      for (int i = 0; i < nTracks; ++i) particles.push_back(goodDaughters[i][bestCombinationIndex]);
-      selectedDaughtersCand.push_back(particles);
-
-      goodCandidates.clear();
-      goodVertex.clear();
-      for (int j = 0; j < nTracks; ++j) goodDaughters[j].clear();
+      if (goodCandidates.size() != 0)
+      {
+        int bestCombinationIndex = selectBestCombination(fixToPV, isIntermediate, goodCandidates, goodVertex);
+
+        hasCandidate[i_comb] = 1;
+        bestMother[i_comb] = goodCandidates[bestCombinationIndex];
+        bestVertex[i_comb] = goodVertex[bestCombinationIndex];
+        for (int i = 0; i < nTracks; ++i) bestDaughters[i_comb].push_back(goodDaughters[i][bestCombinationIndex]);
+
+        goodCandidates.clear();
+        goodVertex.clear();
+        for (int j = 0; j < nTracks; ++j) goodDaughters[j].clear();
+      }
     }
+  };
+
+  //Threads are only worth starting for a reasonable number of combinations each
+  const unsigned int min_combinations_per_thread = 16;
+  unsigned int nThreads = std::min(m_num_threads, nCombinations / min_combinations_per_thread);
+
+  if (nThreads <= 1)
+  {
+    evaluateCombinations(0, 1);
+  }
+  else
+  {
+    std::vector<std::thread> threads;
+    for (unsigned int i_thread = 1; i_thread < nThreads; ++i_thread) threads.emplace_back(evaluateCombinations, i_thread, nThreads);
+    evaluateCombinations(0, nThreads);
+    for (auto& thread : threads) thread.join();
+  }
+
+  for (unsigned int i_comb = 0; i_comb < nCombinations; ++i_comb)
+  {
+    if (!hasCandidate[i_comb]) continue;
+
+    selectedMotherCand.push_back(bestMother[i_comb]);
+    if (fixToPV) selectedVertexCand.push_back(bestVertex[i_comb]);
+    selectedDaughtersCand.push_back(bestDaughters[i_comb]);
   }
 }
 
 int KFParticle_eventReconstruction::selectBestCombination(bool PVconstraint, bool isAnInterMother,
-                                                           std::vector<KFParticle> possibleCandidates, 
-                                                           std::vector<KFParticle> possibleVertex) 
+                                                           const std::vector<KFParticle>& possibleCandidates,
+                                                           const std::vector<KFParticle>& possibleVertex)
 {
   KFParticle smallestMassError = possibleCandidates[0];
   int bestCombinationIndex = 0;
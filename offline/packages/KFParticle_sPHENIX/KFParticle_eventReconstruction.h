@@ -67,20 +67,39 @@ class KFParticle_eventReconstruction : public KFParticle_Tools
                   const std::vector<int>& goodTrackIndexAdv,
                   const std::vector<KFParticle>& primaryVerticesAdv);
 
-  ///Basic building block for event reconstruction and selection
+  /**
+   * Finds the combinations of nTracks good tracks which meet at a common vertex
+   *
+   * @param goodTracksThatMeet Filled with the track indices of each combination
+   * @param combinationPV Filled with the primary vertex associated to each combination if the primary vertex pre-selection is used, left empty otherwise
+   */
+  void findCombinations(const std::vector<KFParticle>& daughterParticles,
+                        const std::vector<int>& goodTrackIndex, int nTracks,
+                        std::vector<std::vector<int>>& goodTracksThatMeet,
+                        std::vector<int>& combinationPV);
+
+  /**
+   * Basic building block for event reconstruction and selection
+   *
+   * Combinations are split between m_num_threads threads. The best candidate of each combination
+   * is stored in place, so the output does not depend on the number of threads
+   *
+   * @param combinationPV Index of the primary vertex to test for each combination. All primary vertices are tested if empty
+   */
   void getCandidateDecay(std::vector<KFParticle>& selectedMotherCand,
                          std::vector<KFParticle>& selectedVertexCand,
                          std::vector<std::vector<KFParticle>>& selectedDaughtersCand,
-                         std::vector<KFParticle> daughterParticlesCand,
-                         std::vector<std::vector<int>> goodTracksThatMeetCand,
-                         std::vector<KFParticle> primaryVerticesCand,
+                         const std::vector<KFParticle>& daughterParticlesCand,
+                         const std::vector<std::vector<int>>& goodTracksThatMeetCand,
+                         const std::vector<KFParticle>& primaryVerticesCand,
                          int n_track_start, int n_track_stop,
-                         bool isIntermediate, int intermediateNumber, bool constrainMass);
+                         bool isIntermediate, int intermediateNumber, bool constrainMass,
+                         const std::vector<int>& combinationPV = std::vector<int>());
 
   ///Method to chose best candidate from a selection of common SV's
   int selectBestCombination(bool PVconstraint, bool isAnInterMother,
-                             std::vector<KFParticle> possibleCandidates, 
-                             std::vector<KFParticle> possibleVertex);
+                             const std::vector<KFParticle>& possibleCandidates,
+                             const std::vector<KFParticle>& possibleVertex);
 
   KFParticle createFakePV(); 
 
@@ -88,6 +107,7 @@ class KFParticle_eventReconstruction : public KFParticle_Tools
   bool m_constrain_to_vertex;
   bool m_constrain_int_mass;
   bool m_use_fake_pv;
+  unsigned int m_num_threads;
 
  //private:
 
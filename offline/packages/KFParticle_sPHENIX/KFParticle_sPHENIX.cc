@@ -29,6 +29,7 @@
 #include <phool/getClass.h>
 
 #include <TFile.h>
+#include <TROOT.h>
 
 typedef std::pair<int, float> particle_pair;
 
@@ -68,6 +69,9 @@ int KFParticle_sPHENIX::Init(PHCompositeNode *topNode)
 
   if (m_save_dst) createParticleNode(topNode);
 
+  //The candidate selection uses TMatrixD from several threads
+  if (m_num_threads > 1) ROOT::EnableThreadSafety();
+
   if (m_require_mva)
   {
     TMVA::Reader *reader;
@@ -160,10 +164,10 @@ int KFParticle_sPHENIX::End(PHCompositeNode */*topNode*/)
   return 0;
 }
 
-void KFParticle_sPHENIX::printParticles(KFParticle motherParticle,
-                                        KFParticle chosenVertex,
-                                        std::vector<KFParticle> daughterParticles,
-                                        std::vector<KFParticle> intermediateParticles,
+void KFParticle_sPHENIX::printParticles(const KFParticle &motherParticle,
+                                        const KFParticle &chosenVertex,
+                                        const std::vector<KFParticle> &daughterParticles,
+                                        const std::vector<KFParticle> &intermediateParticles,
                                         int numPVs, int numTracks)
 {
   std::cout << "\n---------------KFParticle candidate information---------------" << std::endl;
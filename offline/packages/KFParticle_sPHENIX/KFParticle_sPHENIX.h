@@ -57,10 +57,10 @@ class KFParticle_sPHENIX : public SubsysReco, public KFParticle_nTuple, public K
    * masses, momenta and positions for mothers, intermediates and final state tracks,
    * PV position, number of vertices and number of tracks in the event (multiplicity)
    */
-  void printParticles(KFParticle motherParticle,
-                      KFParticle chosenVertex,
-                      std::vector<KFParticle> daughterParticles,
-                      std::vector<KFParticle> intermediateParticles,
+  void printParticles(const KFParticle &motherParticle,
+                      const KFParticle &chosenVertex,
+                      const std::vector<KFParticle> &daughterParticles,
+                      const std::vector<KFParticle> &intermediateParticles,
                       int numPVs, int numTracks);
 
   int parseDecayDescriptor();
@@ -184,6 +184,12 @@ class KFParticle_sPHENIX : public SubsysReco, public KFParticle_nTuple, public K
 
   void useFakePrimaryVertex(bool use_fake) { m_use_fake_pv = use_fake; }
 
+  ///Only combine tracks associated to the same primary vertex (smallest IP chi2), and only test candidates against that vertex
+  void usePrimaryVertexPreselection(bool use_preselection) { m_use_pv_preselection = use_preselection; }
+
+  ///Number of threads used to evaluate the track combinations
+  void setNumberOfThreads(unsigned int num_threads) { m_num_threads = num_threads > 0 ? num_threads : 1; }
+
   void allowZeroMassTracks(bool allow) { m_allowZeroMassTracks = allow; }
 
   void constrainIntermediateMasses(bool constrain_int_mass) { m_constrain_int_mass = constrain_int_mass; }
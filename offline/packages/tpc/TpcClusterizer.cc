@@ -220,57 +220,19 @@ namespace
 	Surface get_tpc_surface_from_coords(TrkrDefs::hitsetkey hitsetkey,
 					    Acts::Vector3D world,
 					    ActsSurfaceMaps *surfMaps,
-					    ActsTrackingGeometry *tGeometry,
 					    TrkrDefs::subsurfkey& subsurfkey)
 	{
-	  std::map<TrkrDefs::hitsetkey, std::vector<Surface>>::iterator mapIter;
-	  mapIter = surfMaps->tpcSurfaceMap.find(hitsetkey);
-	  
-	  if(mapIter == surfMaps->tpcSurfaceMap.end())
-	    {
-	      std::cout << PHWHERE 
-			<< "Error: hitsetkey not found in clusterSurfaceMap, hitsetkey = "
-			<< hitsetkey << std::endl;
-	      return nullptr;
-	    }
-	
-	  double world_phi = atan2(world[1], world[0]);
-	  double world_z = world[2];
-	  
-	  std::vector<Surface> surf_vec = mapIter->second;
-	  unsigned int surf_index = 999;
-	  
-	  double surfStepPhi = tGeometry->tpcSurfStepPhi;
-	  double surfStepZ = tGeometry->tpcSurfStepZ;
+	  // indexed lookup of the surface containing the cluster phi and z
+	  Surface surface = surfMaps->getTpcSurface(hitsetkey, world[0], world[1], world[2], subsurfkey);
 	
-	  for(unsigned int i=0;i<surf_vec.size(); ++i)
-	    {
-	      Surface this_surf = surf_vec[i];
-	  
-	      auto vec3d = this_surf->center(tGeometry->geoContext);
-	      std::vector<double> surf_center = {vec3d(0) / 10.0, vec3d(1) / 10.0, vec3d(2) / 10.0};  // convert from mm to cm
-	      double surf_phi = atan2(surf_center[1], surf_center[0]);
-	      double surf_z = surf_center[2];
-	 
-	      if( (world_phi > surf_phi - surfStepPhi / 2.0 && world_phi < surf_phi + surfStepPhi / 2.0 ) &&
-		  (world_z > surf_z - surfStepZ / 2.0 && world_z < surf_z + surfStepZ / 2.0) )
-		{
-		  surf_index = i;	  
-		  break;
-		}
-	    }
-	  
-	  subsurfkey = surf_index;
-	
-	  if(surf_index == 999)
+	  if(!surface)
 	    {
 	      std::cout << PHWHERE 
-			<< "Error: TPC surface index not defined, skipping cluster!" 
-			<< std::endl;
-	      return nullptr;
+			<< "Error: TPC surface index not defined, skipping cluster! hitsetkey = " 
+			<< hitsetkey << std::endl;
 	    }
 	 
-	  return surf_vec[surf_index];
+	  return surface;
 	
 	}
 	
@@ -406,7 +368,6 @@ namespace
 	  Surface surface = get_tpc_surface_from_coords(tpcHitSetKey,
 							global,
 							surfMaps,
-							tGeometry,
 							subsurfkey);
 	
 	  if(!surface)
@@ -0,0 +1,177 @@
+/**
+ * \file TpcDistortionMap.cc
+ * \brief contiguous float grid for fast trilinear interpolation of TPC distortion histograms
+ */
+
+#include "TpcDistortionMap.h"
+
+#include <TAxis.h>
+#include <TH3.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+
+  //_____________________________________________________________________
+  // true if axis has fixed bins and can be interpolated
+  bool is_valid( const TAxis* axis )
+  { return axis->GetNbins() >= 2 && !axis->IsVariableBinSize(); }
+
+  //_____________________________________________________________________
+  // true if both axis match
+  bool is_same( const TAxis* first, const TAxis* second )
+  {
+    return
+      first->GetNbins() == second->GetNbins() &&
+      first->GetXmin() == second->GetXmin() &&
+      first->GetXmax() == second->GetXmax();
+  }
+
+}
+
+//_____________________________________________________________________
+bool TpcDistortionMap::load( const std::vector<const TH3*>& histograms )
+{
+  clear();
+  if( histograms.empty() ) return true;
+
+  // check histograms
+  const auto reference = histograms.front();
+  for( const auto& h:histograms )
+  {
+    if( !h )
+    {
+      std::cout << "TpcDistortionMap::load - invalid histogram" << std::endl;
+      return false;
+    }
+
+    if( !( is_valid( h->GetXaxis() ) && is_valid( h->GetYaxis() ) && is_valid( h->GetZaxis() ) ) )
+    {
+      std::cout << "TpcDistortionMap::load - histogram " << h->GetName() << " has variable or too few bins" << std::endl;
+      return false;
+    }
+
+    if( !( is_same( h->GetXaxis(), reference->GetXaxis() ) && is_same( h->GetYaxis(), reference->GetYaxis() ) && is_same( h->GetZaxis(), reference->GetZaxis() ) ) )
+    {
+      std::cout << "TpcDistortionMap::load - histogram " << h->GetName() << " binning does not match " << reference->GetName() << std::endl;
+      return false;
+    }
+  }
+
+  // setup axes
+  auto setup_axis = []( Axis& axis, const TAxis* source )
+  {
+    axis.nbins = source->GetNbins();
+    axis.origin = source->GetBinCenter(1);
+    axis.inv_width = 1./source->GetBinWidth(1);
+  };
+
+  setup_axis( m_xaxis, reference->GetXaxis() );
+  setup_axis( m_yaxis, reference->GetYaxis() );
+  setup_axis( m_zaxis, reference->GetZaxis() );
+
+  // strides
+  m_components = histograms.size();
+  m_zstride = m_components;
+  m_ystride = m_zstride*m_zaxis.nbins;
+  m_xstride = m_ystride*m_yaxis.nbins;
+
+  // copy bin content, skipping underflow and overflow bins
+  m_values.resize( m_xstride*m_xaxis.nbins );
+  for( unsigned int ic = 0; ic < m_components; ++ic )
+  {
+    const auto& h = histograms[ic];
+    for( int ix = 0; ix < m_xaxis.nbins; ++ix )
+      for( int iy = 0; iy < m_yaxis.nbins; ++iy )
+      for( int iz = 0; iz < m_zaxis.nbins; ++iz )
+    { m_values[ix*m_xstride + iy*m_ystride + iz*m_zstride + ic] = h->GetBinContent( ix+1, iy+1, iz+1 ); }
+  }
+
+  return true;
+}
+
+//_____________________________________________________________________
+void TpcDistortionMap::clear()
+{
+  m_xaxis = Axis();
+  m_yaxis = Axis();
+  m_zaxis = Axis();
+  m_components = 0;
+  m_xstride = 0;
+  m_ystride = 0;
+  m_zstride = 0;
+  m_values.clear();
+}
+
+//_____________________________________________________________________
+void TpcDistortionMap::interpolate( float x, float y, float z, float* output ) const
+{
+  const auto weights = get_weights( x, y, z );
+  for( unsigned int ic = 0; ic < m_components; ++ic )
+  { output[ic] = interpolate( weights, ic ); }
+}
+
+//_____________________________________________________________________
+float TpcDistortionMap::interpolate( unsigned int component, float x, float y, float z ) const
+{ return component < m_components ? interpolate( get_weights( x, y, z ), component ):0; }
+
+//_____________________________________________________________________
+void TpcDistortionMap::interpolate( std::size_t n, const float* x, const float* y, const float* z, float* output ) const
+{
+  for( std::size_t i = 0; i < n; ++i )
+  { interpolate( x[i], y[i], z[i], output + i*m_components ); }
+}
+
+//_____________________________________________________________________
+TpcDistortionMap::Weights TpcDistortionMap::get_weights( float x, float y, float z ) const
+{
+  Weights out;
+  if( empty() ) return out;
+
+  /*
+   * for each axis, get the lower bin index, relative to the first bin center, and the fractional distance to it.
+   * Locations outside of the interpolation range are clamped to a valid cell, and the scale is set to zero
+   * so that the result matches TH3::Interpolate, without branching
+   */
+  bool inside = true;
+  auto get_index = [&inside]( const Axis& axis, float value, float& weight )
+  {
+    const float u = std::min( std::max( (value - axis.origin)*axis.inv_width, -1.f ), float(axis.nbins) );
+    const int i = std::floor(u);
+    inside &= (i >= 0) & (i < axis.nbins-1);
+    const int iclamped = std::min( std::max( i, 0 ), axis.nbins-2 );
+    weight = u - iclamped;
+    return std::size_t(iclamped);
+  };
+
+  const auto ix = get_index( m_xaxis, x, out.wx );
+  const auto iy = get_index( m_yaxis, y, out.wy );
+  const auto iz = get_index( m_zaxis, z, out.wz );
+  out.index = ix*m_xstride + iy*m_ystride + iz*m_zstride;
+  out.scale = inside ? 1:0;
+  return out;
+}
+
+//_____________________________________________________________________
+float TpcDistortionMap::interpolate( const Weights& weights, unsigned int component ) const
+{
+  if( empty() ) return 0;
+
+  const float* v = &m_values[weights.index + component];
+
+  // interpolate along z
+  const float v00 = v[0] + weights.wz*( v[m_zstride] - v[0] );
+  const float v01 = v[m_ystride] + weights.wz*( v[m_ystride + m_zstride] - v[m_ystride] );
+  const float v10 = v[m_xstride] + weights.wz*( v[m_xstride + m_zstride] - v[m_xstride] );
+  const float v11 = v[m_xstride + m_ystride] + weights.wz*( v[m_xstride + m_ystride + m_zstride] - v[m_xstride + m_ystride] );
+
+  // interpolate along y
+  const float v0 = v00 + weights.wy*( v01 - v00 );
+  const float v1 = v10 + weights.wy*( v11 - v10 );
+
+  // interpolate along x and apply scale
+  return weights.scale*( v0 + weights.wx*( v1 - v0 ) );
+}
@@ -0,0 +1,116 @@
+#ifndef TPC_TPCDISTORTIONMAP_H
+#define TPC_TPCDISTORTIONMAP_H
+/**
+ * \file TpcDistortionMap.h
+ * \brief contiguous float grid for fast trilinear interpolation of TPC distortion histograms
+ */
+
+#include <cstddef>
+#include <vector>
+
+class TH3;
+
+/**
+ * \class TpcDistortionMap
+ * \brief converts one or several TH3 distortion histograms into a flat float grid
+ *
+ * All histograms loaded in a given map must share the same, fixed, binning.
+ * Their content is stored interleaved so that all components are obtained
+ * from a single index calculation. Interpolation follows TH3::Interpolate conventions:
+ * values are interpolated between bin centers, and zero is returned outside of the
+ * [first bin center, last bin center] range along any axis.
+ *
+ * Once loaded the map is read-only and all accessors are const and reentrant,
+ * thus safe to call concurrently from several threads.
+ */
+class TpcDistortionMap
+{
+  public:
+
+  //! constructor
+  TpcDistortionMap() = default;
+
+  //! load histograms. Returns false if binning is either variable or inconsistent between histograms
+  bool load( const std::vector<const TH3*>& );
+
+  //! clear
+  void clear();
+
+  //!@name accessors
+  //@{
+
+  //! true if no histogram is loaded
+  bool empty() const
+  { return m_components == 0; }
+
+  //! number of components
+  unsigned int components() const
+  { return m_components; }
+
+  //! interpolate all components at a given location, expressed in histogram coordinates
+  /** output must hold at least components() values */
+  void interpolate( float x, float y, float z, float* output ) const;
+
+  //! interpolate a single component at a given location, expressed in histogram coordinates
+  float interpolate( unsigned int component, float x, float y, float z ) const;
+
+  //! interpolate all components for n locations
+  /** output must hold at least n*components() values, stored point by point */
+  void interpolate( std::size_t n, const float* x, const float* y, const float* z, float* output ) const;
+
+  //@}
+
+  private:
+
+  //! interpolation weights and base index for a given location
+  struct Weights
+  {
+    std::size_t index = 0;
+    float wx = 0;
+    float wy = 0;
+    float wz = 0;
+    float scale = 0;
+  };
+
+  //! calculate interpolation weights
+  Weights get_weights( float x, float y, float z ) const;
+
+  //! interpolate single component from weights
+  float interpolate( const Weights&, unsigned int component ) const;
+
+  //! axis description
+  struct Axis
+  {
+    //! number of bins
+    int nbins = 0;
+
+    //! center of first bin
+    float origin = 0;
+
+    //! inverse bin width
+    float inv_width = 0;
+  };
+
+  //!@name axes
+  //@{
+  Axis m_xaxis;
+  Axis m_yaxis;
+  Axis m_zaxis;
+  //@}
+
+  //! number of components
+  unsigned int m_components = 0;
+
+  //!@name strides, in number of floats
+  //@{
+  std::size_t m_xstride = 0;
+  std::size_t m_ystride = 0;
+  std::size_t m_zstride = 0;
+  //@}
+
+  //! grid values, stored as [ix][iy][iz][component]
+  std::vector<float> m_values;
+
+};
+
+#endif
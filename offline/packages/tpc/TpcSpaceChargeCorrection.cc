@@ -43,6 +43,10 @@ int TpcSpaceChargeCorrection::InitRun(PHCompositeNode*)
   m_hDRint= dynamic_cast<TH3*>(m_distortion_tfile->Get("hIntDistortionR")); assert( m_hDRint );
   m_hDZint= dynamic_cast<TH3*>(m_distortion_tfile->Get("hIntDistortionZ")); assert( m_hDZint );
 
+  // convert to flat interpolation grid
+  if( !m_distortion_map.load( { m_hDPint, m_hDRint, m_hDZint } ) )
+  { std::cout << "TpcSpaceChargeCorrection::InitRun - cannot convert distortion histograms to interpolation grid, using TH3::Interpolate" << std::endl; }
+
   // coordinates
   std::cout << "TpcSpaceChargeCorrection::InitRun - coordinates: " << std::bitset<3>(m_coordinates) << std::endl;
 
@@ -108,10 +112,19 @@ void TpcSpaceChargeCorrection::transform_cluster( TrkrCluster* cluster )
   const auto z = cluster->getZ();
   const auto zmap = m_fullzrange ? z:std::abs(z);
 
+  // get all corrections at once
+  float corrections[3];
+  if( !m_distortion_map.empty() ) m_distortion_map.interpolate( phi, r, zmap, corrections );
+  else {
+    corrections[0] = m_hDPint->Interpolate( phi, r, zmap );
+    corrections[1] = m_hDRint->Interpolate( phi, r, zmap );
+    corrections[2] = m_hDZint->Interpolate( phi, r, zmap );
+  }
+
   // apply corrections
-  const auto phi_new = (m_coordinates & COORD_PHI) ? phi - m_hDPint->Interpolate(phi,r,zmap)/r : phi;
-  const auto r_new = (m_coordinates & COORD_R) ? r - m_hDRint->Interpolate(phi,r,zmap) : r;
-  const auto z_new = (m_coordinates & COORD_Z) ? z - m_hDZint->Interpolate(phi,r,zmap) : z;
+  const auto phi_new = (m_coordinates & COORD_PHI) ? phi - corrections[0]/r : phi;
+  const auto r_new = (m_coordinates & COORD_R) ? r - corrections[1] : r;
+  const auto z_new = (m_coordinates & COORD_Z) ? z - corrections[2] : z;
 
   // update cluster
   const auto x_new = r_new*std::cos( phi_new );
@@ -1,6 +1,8 @@
 #ifndef TPC_TPCSPACECHARGECORRECTION_H
 #define TPC_TPCSPACECHARGECORRECTION_H
 
+#include "TpcDistortionMap.h"
+
 #include <fun4all/SubsysReco.h>
 #include <phool/PHObject.h>
 #include <phool/PHTimer.h>
@@ -68,6 +70,9 @@ class TpcSpaceChargeCorrection : public SubsysReco
   TH3 *m_hDZint = nullptr;
   //@}
 
+  //! flat interpolation grid built from the above histograms, storing phi, r and z components. Empty if the histograms have variable bins, in which case they are interpolated directly
+  TpcDistortionMap m_distortion_map;
+
   /*! \brief
    true if the maps contain the full z range
    assume it only contains positive z otherwise
@@ -0,0 +1,95 @@
+// checks TpcDistortionMap against known grid values and TH3::Interpolate
+// run with make check
+
+#include "TpcDistortionMap.h"
+
+#include <phool/PHTestCheck.h>
+
+#include <TH3.h>
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+  PHTestCheck check("testTpcDistortionMap");
+
+  bool close(float a, float b)
+  {
+    return std::abs(a - b) < 1e-4 * (1 + std::abs(b));
+  }
+
+  // linear in the bin index, so the trilinear interpolation is exact
+  double content(int ix, int iy, int iz, double scale)
+  {
+    return scale * (100 * ix + 10 * iy + iz);
+  }
+}  // namespace
+
+int main()
+{
+  // bin centers at 0.5, 1.5, ...
+  TH3F hx("hx", "hx", 4, 0, 4, 5, 0, 5, 6, 0, 6);
+  TH3F hy("hy", "hy", 4, 0, 4, 5, 0, 5, 6, 0, 6);
+  for (int ix = 1; ix <= 4; ++ix)
+  {
+    for (int iy = 1; iy <= 5; ++iy)
+    {
+      for (int iz = 1; iz <= 6; ++iz)
+      {
+        hx.SetBinContent(ix, iy, iz, content(ix, iy, iz, 1));
+        hy.SetBinContent(ix, iy, iz, content(ix, iy, iz, -2));
+      }
+    }
+  }
+
+  TpcDistortionMap map;
+  check(map.empty(), "map empty before load");
+  check(map.interpolate(0, 1.5, 2.5, 3.5) == 0, "empty map returns zero");
+
+  check(map.load({&hx, &hy}), "load");
+  check(!map.empty() && map.components() == 2, "two components");
+
+  // bin center of bin (2,3,4)
+  check(close(map.interpolate(0, 1.5, 2.5, 3.5), content(2, 3, 4, 1)), "lookup at bin center");
+  check(close(map.interpolate(1, 1.5, 2.5, 3.5), content(2, 3, 4, -2)), "second component at bin center");
+
+  // half way between the centers of bins 1 and 2 in x
+  check(close(map.interpolate(0, 1.0, 2.5, 3.5), 0.5 * (content(1, 3, 4, 1) + content(2, 3, 4, 1))), "lookup between bin centers");
+
+  // same as TH3::Interpolate inside the range
+  const std::vector<float> xs = {0.5, 1.3, 2.71, 3.49};
+  const std::vector<float> ys = {0.5, 1.9, 4.2, 4.49};
+  const std::vector<float> zs = {0.5, 2.2, 5.05, 5.49};
+  for (unsigned int i = 0; i < xs.size(); ++i)
+  {
+    check(close(map.interpolate(0, xs[i], ys[i], zs[i]), hx.Interpolate(xs[i], ys[i], zs[i])), "same as TH3::Interpolate");
+  }
+
+  // batch interface, all components of each point
+  std::vector<float> output(2 * xs.size());
+  map.interpolate(xs.size(), xs.data(), ys.data(), zs.data(), output.data());
+  for (unsigned int i = 0; i < xs.size(); ++i)
+  {
+    check(close(output[2 * i], map.interpolate(0, xs[i], ys[i], zs[i])) &&
+              close(output[2 * i + 1], map.interpolate(1, xs[i], ys[i], zs[i])),
+          "batch interpolation");
+  }
+
+  // zero outside of [first bin center, last bin center] along any axis, like TH3::Interpolate
+  check(map.interpolate(0, 0.2, 2.5, 3.5) == 0, "below first bin center in x");
+  check(map.interpolate(0, 3.7, 2.5, 3.5) == 0, "above last bin center in x");
+  check(map.interpolate(0, 1.5, -10, 3.5) == 0, "below y range");
+  check(map.interpolate(0, 1.5, 2.5, 100) == 0, "above z range");
+  check(map.interpolate(2, 1.5, 2.5, 3.5) == 0, "invalid component");
+  float both[2] = {1, 1};
+  map.interpolate(10, 2.5, 3.5, both);
+  check(both[0] == 0 && both[1] == 0, "all components outside of the range");
+
+  // inconsistent binning is refused
+  TH3F hother("hother", "hother", 4, 0, 4, 5, 0, 5, 7, 0, 6);
+  check(!map.load({&hx, &hother}), "refuse inconsistent binning");
+  check(map.empty(), "map cleared after failed load");
+
+  return check.result();
+}
@@ -263,15 +263,8 @@ Surface PHTpcResiduals::getSiliconSurface(TrkrDefs::hitsetkey hitsetkey)
 //___________________________________________________________________________________
 Surface PHTpcResiduals::getTpcSurface(TrkrDefs::hitsetkey hitsetkey, TrkrDefs::subsurfkey surfkey)
 {
-  const auto iter = m_surfMaps->tpcSurfaceMap.find(hitsetkey);
-  if(iter != m_surfMaps->tpcSurfaceMap.end())
-  {
-    auto surfvec = iter->second;
-    return surfvec.at(surfkey);
-  }
-  
-  // If it can't be found, return nullptr to skip this cluster
-  return nullptr;
+  /// indexed lookup, returns nullptr if it can't be found, to skip this cluster
+  return m_surfMaps->getTpcSurface(hitsetkey, surfkey);
 }
 
 //___________________________________________________________________________________
@@ -12,12 +12,17 @@
 
 #include <TFile.h>
 #include <TH3.h>
+#include <TROOT.h>
 
 #include <Eigen/Core>
 #include <Eigen/Dense>
 
+#include <algorithm>
+#include <array>
 #include <memory>
 
+#include <pthread.h>
+
 namespace
 {
   // phi range
@@ -32,6 +37,156 @@ namespace
   // z range
   static constexpr float m_zmin = -105.5;
   static constexpr float m_zmax = 105.5;
+
+  /* number of coordinates must match that of the matrix container */
+  static constexpr int m_ncoord = 3;
+
+  // minimum number of entries per bin
+  static constexpr int m_min_cluster_count = 10;
+
+  //_____________________________________________________________________
+  // create empty container matching a given source grid dimensions
+  std::unique_ptr<TpcSpaceChargeMatrixContainer> create_container( const TpcSpaceChargeMatrixContainer& source )
+  {
+    std::unique_ptr<TpcSpaceChargeMatrixContainer> container( new TpcSpaceChargeMatrixContainerv1 );
+
+    // get grid dimensions from source
+    int phibins = 0;
+    int rbins = 0;
+    int zbins = 0;
+    source.get_grid_dimensions( phibins, rbins, zbins );
+
+    // assign
+    container->set_grid_dimensions( phibins, rbins, zbins );
+    return container;
+  }
+
+  //_____________________________________________________________________
+  // load container from file. Filename must be already resolved
+  std::unique_ptr<TpcSpaceChargeMatrixContainer> load_container( const std::string& filename, const std::string& objectname )
+  {
+    // open TFile
+    std::unique_ptr<TFile> inputfile( TFile::Open( filename.c_str() ) );
+    if( !inputfile )
+    {
+      std::cout << "TpcSpaceChargeMatrixInversion::load_container - could not open file " << filename << std::endl;
+      return nullptr;
+    }
+
+    // load object from input file
+    std::unique_ptr<TpcSpaceChargeMatrixContainer> source( dynamic_cast<TpcSpaceChargeMatrixContainer*>( inputfile->Get( objectname.c_str() ) ) );
+    if( !source )
+    { std::cout << "TpcSpaceChargeMatrixInversion::load_container - could not find object name " << objectname << " in file " << filename << std::endl; }
+
+    return source;
+  }
+
+  //_____________________________________________________________________
+  // data needed to accumulate matrices from a subset of files
+  struct accumulate_thread_data
+  {
+    // all files
+    const std::vector<std::string>* filenames = nullptr;
+
+    // object name
+    std::string objectname;
+
+    // first file index and stride
+    size_t first = 0;
+    size_t stride = 1;
+
+    // accumulated container
+    std::unique_ptr<TpcSpaceChargeMatrixContainer> container;
+
+    // true if all files were successfully added
+    bool success = true;
+  };
+
+  //_____________________________________________________________________
+  void* accumulate_files( void* threadarg )
+  {
+    auto data = static_cast<accumulate_thread_data*>( threadarg );
+    for( size_t i = data->first; i < data->filenames->size(); i += data->stride )
+    {
+      const auto source = load_container( data->filenames->at(i), data->objectname );
+      if( !source )
+      {
+        data->success = false;
+        continue;
+      }
+
+      if( !data->container ) data->container = create_container( *source );
+      data->success &= data->container->add( *source );
+    }
+
+    return nullptr;
+  }
+
+  //_____________________________________________________________________
+  // inversion result for a given cell
+  struct cell_result_t
+  {
+    // true if inversion was performed
+    bool valid = false;
+
+    // distortions, ordered as rphi, z, r
+    std::array<float, m_ncoord> result = {{}};
+
+    // errors, from diagonal of the inverted lhs matrix
+    std::array<float, m_ncoord> error = {{}};
+  };
+
+  //_____________________________________________________________________
+  // data needed to invert matrices for a range of cells
+  struct invert_thread_data
+  {
+    const TpcSpaceChargeMatrixContainer* container = nullptr;
+    int first = 0;
+    int last = 0;
+    std::vector<cell_result_t>* results = nullptr;
+  };
+
+  //_____________________________________________________________________
+  void* invert_cells( void* threadarg )
+  {
+    // matrix convenience definition
+    using matrix_t = Eigen::Matrix<float, m_ncoord, m_ncoord >;
+    using column_t = Eigen::Matrix<float, m_ncoord, 1 >;
+
+    auto data = static_cast<invert_thread_data*>( threadarg );
+    const auto container = data->container;
+    for( int icell = data->first; icell < data->last; ++icell )
+    {
+      if( container->get_entries(icell) < m_min_cluster_count ) continue;
+
+      // build eigen matrices from container
+      matrix_t lhs;
+      for( int i = 0; i < m_ncoord; ++i )
+        for( int j = 0; j < m_ncoord; ++j )
+      { lhs(i,j) = container->get_lhs( icell, i, j ); }
+
+      column_t rhs;
+      for( int i = 0; i < m_ncoord; ++i )
+      { rhs(i) = container->get_rhs( icell, i ); }
+
+      // calculate result using linear solving
+      const auto cov = lhs.inverse();
+      auto partialLu = lhs.partialPivLu();
+      const auto result = partialLu.solve( rhs );
+
+      // store
+      auto& cell_result = data->results->at(icell);
+      cell_result.valid = true;
+      for( int i = 0; i < m_ncoord; ++i )
+      {
+        cell_result.result[i] = result(i);
+        cell_result.error[i] = std::sqrt( cov(i,i) );
+      }
+    }
+
+    return nullptr;
+  }
+
 }
 
 //_____________________________________________________________________
@@ -50,44 +205,126 @@ bool TpcSpaceChargeMatrixInversion::add_from_file( const std::string& shortfilen
   FROG frog;
   const auto filename = frog.location( shortfilename );  
   
-  // open TFile
-  std::unique_ptr<TFile> inputfile( TFile::Open( filename ) );
-  if( !inputfile )
-  { 
-    std::cout << "TpcSpaceChargeMatrixInversion::add_from_file - could not open file " << filename << std::endl; 
-    return false;
-  }
-  
   // load object from input file
-  std::unique_ptr<TpcSpaceChargeMatrixContainer> source( dynamic_cast<TpcSpaceChargeMatrixContainer*>( inputfile->Get( objectname.c_str() ) ) );
-  if( !source )
+  const auto source = load_container( filename, objectname );
+  if( !source ) return false;
+
+  // add object
+  return add( *source );
+}
+
+//_____________________________________________________________________
+bool TpcSpaceChargeMatrixInversion::add_from_files( const std::vector<std::string>& shortfilenames, const std::string& objectname )
+{
+  // single thread
+  if( m_nthreads <= 1 )
   {
-    std::cout << "TpcSpaceChargeMatrixInversion::add_from_file - could not find object name " << objectname << " in file " << filename << std::endl; 
-    return false;
+    bool success = true;
+    for( const auto& filename:shortfilenames )
+    { success &= add_from_file( filename, objectname ); }
+    return success;
   }
-  
-  // add object 
-  return add( *source.get() );
+
+  /*
+   * get filenames from frog
+   * this is done upfront, serially, because FROG might use database queries
+   */
+  std::vector<std::string> filenames;
+  FROG frog;
+  for( const auto& filename:shortfilenames )
+  { filenames.emplace_back( frog.location( filename ) ); }
+
+  // make sure ROOT can safely open files concurrently
+  ROOT::EnableThreadSafety();
+
+  // create structure to store given thread and associated data
+  struct thread_pair_t
+  {
+    pthread_t thread;
+    bool running = false;
+    accumulate_thread_data data;
+  };
+
+  // create vector of thread pairs and reserve the right size upfront to avoid reallocation
+  const auto nthreads = std::min<size_t>( m_nthreads, filenames.size() );
+  std::vector<thread_pair_t> threads;
+  threads.reserve( nthreads );
+
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
+
+  for( size_t ithread = 0; ithread < nthreads; ++ithread )
+  {
+    // instanciate new thread pair, at the end of thread vector
+    auto& thread_pair = threads.emplace_back();
+    thread_pair.data.filenames = &filenames;
+    thread_pair.data.objectname = objectname;
+    thread_pair.data.first = ithread;
+    thread_pair.data.stride = nthreads;
+
+    const int rc = pthread_create(&thread_pair.thread, &attr, accumulate_files, (void *)&thread_pair.data);
+    if( rc )
+    {
+      // process files in current thread
+      std::cout << "TpcSpaceChargeMatrixInversion::add_from_files - unable to create thread, " << rc << std::endl;
+      accumulate_files( &thread_pair.data );
+    } else thread_pair.running = true;
+  }
+
+  pthread_attr_destroy(&attr);
+
+  // wait for completion of all threads, and add partial containers in thread order
+  bool success = true;
+  for( auto& thread_pair:threads )
+  {
+    if( thread_pair.running )
+    {
+      const int rc = pthread_join(thread_pair.thread, nullptr);
+      if( rc )
+      {
+        std::cout << "TpcSpaceChargeMatrixInversion::add_from_files - unable to join, " << rc << std::endl;
+        success = false;
+        continue;
+      }
+    }
+
+    success &= thread_pair.data.success;
+    if( thread_pair.data.container )
+    { success &= add( *thread_pair.data.container ); }
+  }
+
+  return success;
 }
 
 //_____________________________________________________________________
-bool TpcSpaceChargeMatrixInversion::add( const TpcSpaceChargeMatrixContainer& source )
+bool TpcSpaceChargeMatrixInversion::save_matrix_container( const std::string& filename, const std::string& objectname ) const
 {
-  // check internal container, create if necessary
   if( !m_matrix_container )
   {
-    m_matrix_container.reset( new TpcSpaceChargeMatrixContainerv1 );
-
-    // get grid dimensions from source
-    int phibins = 0;
-    int rbins = 0;
-    int zbins = 0;
-    source.get_grid_dimensions( phibins, rbins, zbins );
+    std::cout << "TpcSpaceChargeMatrixInversion::save_matrix_container - no matrix to save" << std::endl;
+    return false;
+  }
 
-    // assign
-    m_matrix_container->set_grid_dimensions( phibins, rbins, zbins );
+  std::unique_ptr<TFile> outputfile( TFile::Open( filename.c_str(), "RECREATE" ) );
+  if( !outputfile )
+  {
+    std::cout << "TpcSpaceChargeMatrixInversion::save_matrix_container - could not open file " << filename << std::endl;
+    return false;
   }
 
+  outputfile->cd();
+  m_matrix_container->Write( objectname.c_str() );
+  outputfile->Close();
+  return true;
+}
+
+//_____________________________________________________________________
+bool TpcSpaceChargeMatrixInversion::add( const TpcSpaceChargeMatrixContainer& source )
+{
+  // check internal container, create if necessary
+  if( !m_matrix_container ) m_matrix_container = create_container( source );
+
   // add content
   return m_matrix_container->add( source );
 }
@@ -116,13 +353,58 @@ void TpcSpaceChargeMatrixInversion::calculate_distortions()
     h->GetZaxis()->SetTitle( "z (cm)" );
   }
 
-  // matrix convenience definition
-  /* number of coordinates must match that of the matrix container */
-  static constexpr int ncoord = 3;
-  using matrix_t = Eigen::Matrix<float, ncoord, ncoord >;
-  using column_t = Eigen::Matrix<float, ncoord, 1 >;
+  // invert matrices for all cells, in parallel
+  const int ncells = m_matrix_container->get_grid_size();
+  std::vector<cell_result_t> results( ncells );
+  {
+    // create structure to store given thread and associated data
+    struct thread_pair_t
+    {
+      pthread_t thread;
+      bool running = false;
+      invert_thread_data data;
+    };
+
+    const int nthreads = std::max( 1, std::min<int>( m_nthreads, ncells ) );
+    std::vector<thread_pair_t> threads;
+    threads.reserve( nthreads );
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
+
+    // split cells in contiguous ranges
+    const int cells_per_thread = (ncells + nthreads - 1)/nthreads;
+    for( int ithread = 0; ithread < nthreads; ++ithread )
+    {
+      auto& thread_pair = threads.emplace_back();
+      thread_pair.data.container = m_matrix_container.get();
+      thread_pair.data.first = ithread*cells_per_thread;
+      thread_pair.data.last = std::min( ncells, (ithread+1)*cells_per_thread );
+      thread_pair.data.results = &results;
+
+      const int rc = pthread_create(&thread_pair.thread, &attr, invert_cells, (void *)&thread_pair.data);
+      if( rc )
+      {
+        // process cells in current thread
+        std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortions - unable to create thread, " << rc << std::endl;
+        invert_cells( &thread_pair.data );
+      } else thread_pair.running = true;
+    }
+
+    pthread_attr_destroy(&attr);
 
-  // loop over bins
+    // wait for completion of all threads
+    for( const auto& thread_pair:threads )
+    {
+      if( !thread_pair.running ) continue;
+      const int rc = pthread_join(thread_pair.thread, nullptr);
+      if( rc )
+      { std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortions - unable to join, " << rc << std::endl; }
+    }
+  }
+
+  // loop over bins and fill histograms
   for( int iphi = 0; iphi < phibins; ++iphi )
     for( int ir = 0; ir < rbins; ++ir )
     for( int iz = 0; iz < zbins; ++iz )
@@ -130,53 +412,37 @@ void TpcSpaceChargeMatrixInversion::calculate_distortions()
 
     // get cell index
     const auto icell = m_matrix_container->get_cell_index( iphi, ir, iz );
+    const auto& cell_result = results[icell];
+    if( !cell_result.valid ) continue;
 
-    // minimum number of entries per bin
-    static constexpr int min_cluster_count = 10;
     const auto cell_entries = m_matrix_container->get_entries(icell);
-    if( cell_entries < min_cluster_count ) continue;
-
-    // build eigen matrices from container
-    matrix_t lhs;
-    for( int i = 0; i < ncoord; ++i )
-      for( int j = 0; j < ncoord; ++j )
-    { lhs(i,j) = m_matrix_container->get_lhs( icell, i, j ); }
-
-    column_t rhs;
-    for( int i = 0; i < ncoord; ++i )
-    { rhs(i) = m_matrix_container->get_rhs( icell, i ); }
-
     if (Verbosity())
     {
-      // print matrices and entries
-      std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortions - inverting bin " << iz << ", " << ir << ", " << iphi << std::endl;
+      // print entries
+      std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortions - inverted bin " << iz << ", " << ir << ", " << iphi << std::endl;
       std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortions - entries: " << cell_entries << std::endl;
-      std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortions - lhs: \n" << lhs << std::endl;
-      std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortions - rhs: \n" << rhs << std::endl;
     }
 
-    // calculate result using linear solving
-    const auto cov = lhs.inverse();
-    auto partialLu = lhs.partialPivLu();
-    const auto result = partialLu.solve( rhs );
+    const auto& result = cell_result.result;
+    const auto& error = cell_result.error;
 
     // fill histograms
     hentries->SetBinContent( iphi+1, ir+1, iz+1, cell_entries );
 
-    hphi->SetBinContent( iphi+1, ir+1, iz+1, result(0) );
-    hphi->SetBinError( iphi+1, ir+1, iz+1, std::sqrt( cov(0,0) ) );
+    hphi->SetBinContent( iphi+1, ir+1, iz+1, result[0] );
+    hphi->SetBinError( iphi+1, ir+1, iz+1, error[0] );
 
-    hz->SetBinContent( iphi+1, ir+1, iz+1, result(1) );
-    hz->SetBinError( iphi+1, ir+1, iz+1, std::sqrt( cov(1,1) ) );
+    hz->SetBinContent( iphi+1, ir+1, iz+1, result[1] );
+    hz->SetBinError( iphi+1, ir+1, iz+1, error[1] );
 
-    hr->SetBinContent( iphi+1, ir+1, iz+1, result(2) );
-    hr->SetBinError( iphi+1, ir+1, iz+1, std::sqrt( cov(2,2) ) );
+    hr->SetBinContent( iphi+1, ir+1, iz+1, result[2] );
+    hr->SetBinError( iphi+1, ir+1, iz+1, error[2] );
 
     if (Verbosity())
     {
-      std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortions - drphi: " << result(0) << " +/- " << std::sqrt( cov(0,0) ) << std::endl;
-      std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortions - dz: " << result(1) << " +/- " << std::sqrt( cov(1,1) ) << std::endl;
-      std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortions - dr: " << result(2) << " +/- " << std::sqrt( cov(2,2) ) << std::endl;
+      std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortions - drphi: " << result[0] << " +/- " << error[0] << std::endl;
+      std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortions - dz: " << result[1] << " +/- " << error[1] << std::endl;
+      std::cout << "TpcSpaceChargeMatrixInversion::calculate_distortions - dr: " << result[2] << " +/- " << error[2] << std::endl;
       std::cout << std::endl;
     }
   }
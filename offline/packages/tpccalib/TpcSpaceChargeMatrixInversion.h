@@ -8,6 +8,8 @@
 #include <fun4all/Fun4AllBase.h>
 
 #include <memory>
+#include <string>
+#include <vector>
 
 // forward declaration
 class TpcSpaceChargeMatrixContainer;
@@ -37,12 +39,31 @@ class TpcSpaceChargeMatrixInversion: public Fun4AllBase
    * they are suitable for being read by TpcClusterizer
    */
   void set_outputfile( const std::string& filename );
+
+  /// set number of threads used for adding matrices from files and for inverting matrices
+  void set_nthreads( unsigned int value )
+  { m_nthreads = value; }
   
   /// add space charge correction matrix to current. Returns true on success
   bool add( const TpcSpaceChargeMatrixContainer& );
 
   /// add space charge correction matrix, loaded from file, to current. Returns true on success
   bool add_from_file( const std::string& filename, const std::string& objectname = "TpcSpaceChargeMatrixContainer" );
+
+  /// add space charge correction matrices, loaded from several files, to current. Returns true on success
+  /**
+   * files are split among m_nthreads threads, each accumulating in its own container.
+   * Containers are then added to the current one, in thread order, so that the result is reproducible
+   * for a given number of threads
+   */
+  bool add_from_files( const std::vector<std::string>& filenames, const std::string& objectname = "TpcSpaceChargeMatrixContainer" );
+
+  /// save current (accumulated) matrices to file. Returns true on success
+  /**
+   * this allows to merge partial results incrementally: the output file can be added back,
+   * using add_from_file, together with new input files, without re-reading the files that have already been merged
+   */
+  bool save_matrix_container( const std::string& filename, const std::string& objectname = "TpcSpaceChargeMatrixContainer" ) const;
   
   /// calculate distortions by inverting stored matrices, and save relevant histograms
   void calculate_distortions();
@@ -57,6 +78,9 @@ class TpcSpaceChargeMatrixInversion: public Fun4AllBase
   /// true if only tracks with micromegas must be used
   bool m_use_micromegas = true;
 
+  /// number of threads
+  unsigned int m_nthreads = 1;
+
   /// matrix container
   std::unique_ptr<TpcSpaceChargeMatrixContainer> m_matrix_container;
 
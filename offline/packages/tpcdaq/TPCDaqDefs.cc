@@ -20,6 +20,380 @@ namespace TPCDaqDefs
 //! TPC v1 FEE test stand decoder
 namespace FEEv1
 {
+namespace
+{
+//! number of parameters of SignalShape_PowerLawDoubleExp
+const int kNParameters = 7;
+
+//! parameter default value and limits
+struct default_values_t
+{
+  default_values_t(double default_value, double min_value, double max_value)
+    : def(default_value)
+    , min(min_value)
+    , max(max_value)
+  {
+  }
+  double def;
+  double min;
+  double max;
+};
+
+//! inital guesses and limits, from pedestal (first sample) and peak
+vector<default_values_t> get_default_values(const vector<double> &samples, const int verbosity)
+{
+  const int n_samples = samples.size();
+
+  int peakPos = 0.;
+  const double pedestal = samples[0];  //(double) PEDESTAL;
+  double peakval = pedestal;
+  const double risetime = 1.5;
+
+  for (int iSample = 0; iSample < n_samples - risetime * 3; iSample++)
+  {
+    if (abs(samples[iSample] - pedestal) > abs(peakval - pedestal))
+    {
+      peakval = samples[iSample];
+      peakPos = iSample;
+    }
+  }
+  peakval -= pedestal;
+
+  if (verbosity)
+  {
+    cout << "SampleFit_PowerLawDoubleExp - "
+         << "pedestal = " << pedestal << ", "
+         << "peakval = " << peakval << ", "
+         << "peakPos = " << peakPos << endl;
+  }
+
+  vector<default_values_t> default_values(kNParameters, default_values_t(numeric_limits<double>::signaling_NaN(), numeric_limits<double>::signaling_NaN(), numeric_limits<double>::signaling_NaN()));
+
+  default_values[0] = default_values_t(peakval * .7, peakval * -1.5, peakval * 1.5);
+  default_values[1] = default_values_t(peakPos - risetime, peakPos - 3 * risetime, peakPos + risetime);
+  default_values[2] = default_values_t(5., 1, 10.);
+  default_values[3] = default_values_t(risetime, risetime * .2, risetime * 10);
+  default_values[4] = default_values_t(pedestal, pedestal - abs(peakval), pedestal + abs(peakval));
+  //  default_values[5] = default_values_t(0.3, 0, 1);
+  //  default_values[6] = default_values_t(5, risetime * .2, risetime * 10);
+  default_values[5] = default_values_t(0, 0, 0);  // disable 2nd component
+  default_values[6] = default_values_t(risetime, risetime, risetime);
+
+  return default_values;
+}
+
+//! one component of SignalShape_PowerLawDoubleExp, normalized to unit height at x = peak_time, and its derivatives
+struct shape_t
+{
+  double value = 0;
+  double d_x = 0;
+  double d_power = 0;
+  double d_peaktime = 0;
+};
+
+shape_t power_law_exp(double x, double power, double peak_time)
+{
+  shape_t out;
+  if (x <= 0) return out;
+
+  // (x/peak_time)^power * exp(power*(1 - x/peak_time))
+  const double u = x / peak_time;
+  const double log_term = log(u) + 1 - u;
+  out.value = exp(power * log_term);
+  out.d_x = out.value * power / peak_time * (1 / u - 1);
+  out.d_power = out.value * log_term;
+  out.d_peaktime = out.value * power / peak_time * (u - 1);
+  return out;
+}
+
+//! SignalShape_PowerLawDoubleExp without amplitude and pedestal, at sample position x
+double pulse_shape(double x, const double *par)
+{
+  return (1. - par[5]) * power_law_exp(x - par[1], par[2], par[3]).value + par[5] * power_law_exp(x - par[1], par[2], par[6]).value;
+}
+
+//! peak position and amplitude of the fitted function, matching TF1::GetMaximumX in SampleFit_PowerLawDoubleExp
+void get_peak(const double *par, const int n_samples, double &peak, double &peak_sample)
+{
+  double max_peakpos = par[1] + (par[3] > par[6] ? par[3] : par[6]);
+  if (max_peakpos > n_samples - 1) max_peakpos = n_samples - 1;
+
+  if (par[5] == 0)
+  {
+    // single component, increasing up to the peak time
+    peak_sample = min(par[1] + par[3], max_peakpos);
+  }
+  else
+  {
+    // coarse scan, then golden section search
+    static const int n_scan = 100;
+    const double step = (max_peakpos - par[1]) / n_scan;
+    double best = par[1];
+    for (int i = 0; i <= n_scan; ++i)
+    {
+      const double x = par[1] + i * step;
+      if (pulse_shape(x, par) > pulse_shape(best, par)) best = x;
+    }
+
+    static const double golden = (sqrt(5.) - 1) / 2;
+    double a = max(par[1], best - step);
+    double b = min(max_peakpos, best + step);
+    while (b - a > 1e-6)
+    {
+      const double c = b - golden * (b - a);
+      const double d = a + golden * (b - a);
+      if (pulse_shape(c, par) > pulse_shape(d, par))
+        b = d;
+      else
+        a = c;
+    }
+    peak_sample = (a + b) / 2;
+  }
+
+  peak = par[0] * pulse_shape(peak_sample, par);
+}
+
+//! closed form least square amplitude and pedestal for a given shape. Returns chi2, or a negative value if degenerate
+double linear_fit(const vector<double> &samples, const vector<double> &shape, double &amplitude, double &pedestal)
+{
+  const int n_samples = samples.size();
+  double sum_s = 0, sum_ss = 0, sum_y = 0, sum_sy = 0, sum_yy = 0;
+  for (int i = 0; i < n_samples; ++i)
+  {
+    sum_s += shape[i];
+    sum_ss += shape[i] * shape[i];
+    sum_y += samples[i];
+    sum_sy += shape[i] * samples[i];
+    sum_yy += samples[i] * samples[i];
+  }
+
+  const double det = n_samples * sum_ss - sum_s * sum_s;
+  if (!(det > 0)) return -1;
+
+  amplitude = (n_samples * sum_sy - sum_s * sum_y) / det;
+  pedestal = (sum_y - amplitude * sum_s) / n_samples;
+  return sum_yy - amplitude * sum_sy - pedestal * sum_y;
+}
+
+//! shape table for the template scan: single component, on a grid of power and peak time, with sample start at half sample steps
+class shape_table_t
+{
+ public:
+  static const int kStepsPerSample = 2;
+
+  shape_table_t()
+  {
+    for (const double power : m_powers)
+    {
+      for (const double peak_time : m_peak_times)
+      {
+        vector<double> values(kStepsPerSample * kSAMPLE_LENGTH + 1);
+        for (unsigned int i = 0; i < values.size(); ++i)
+        {
+          values[i] = power_law_exp(double(i) / kStepsPerSample, power, peak_time).value;
+        }
+        m_values.push_back(values);
+      }
+    }
+  }
+
+  static const shape_table_t &get()
+  {
+    static const shape_table_t table;
+    return table;
+  }
+
+  //! powers in the table
+  const vector<double> &powers() const { return m_powers; }
+
+  //! peak times in the table
+  const vector<double> &peak_times() const { return m_peak_times; }
+
+  //! shape for given power and peak time indices at x, in half samples, relative to sample start
+  double value(unsigned int power_index, unsigned int peak_time_index, int x) const
+  {
+    const vector<double> &values = m_values[power_index * m_peak_times.size() + peak_time_index];
+    return (x <= 0 || x >= (int) values.size()) ? 0 : values[x];
+  }
+
+ private:
+  vector<double> m_powers = {2., 3.5, 5., 7.};
+  vector<double> m_peak_times = {0.5, 0.75, 1., 1.5, 2., 3., 4., 6., 8., 12.};
+  vector<vector<double>> m_values;
+};
+
+//! solve the linear system a.x = b, in place. Returns false if singular
+bool solve(vector<double> &a, vector<double> &b, const int n)
+{
+  for (int col = 0; col < n; ++col)
+  {
+    int pivot = col;
+    for (int row = col + 1; row < n; ++row)
+    {
+      if (abs(a[row * n + col]) > abs(a[pivot * n + col])) pivot = row;
+    }
+    if (!(abs(a[pivot * n + col]) > 0)) return false;
+    if (pivot != col)
+    {
+      for (int k = 0; k < n; ++k) swap(a[col * n + k], a[pivot * n + k]);
+      swap(b[col], b[pivot]);
+    }
+    for (int row = col + 1; row < n; ++row)
+    {
+      const double factor = a[row * n + col] / a[col * n + col];
+      for (int k = col; k < n; ++k) a[row * n + k] -= factor * a[col * n + k];
+      b[row] -= factor * b[col];
+    }
+  }
+  for (int row = n - 1; row >= 0; --row)
+  {
+    for (int k = row + 1; k < n; ++k) b[row] -= a[row * n + k] * b[k];
+    b[row] /= a[row * n + row];
+  }
+  return true;
+}
+
+//! Levenberg-Marquardt fit of SignalShape_PowerLawDoubleExp, with unit weights and parameters clamped to their limits.
+//! Returns false if not converged
+bool levenberg_marquardt(const vector<double> &samples, double *par, const bool *is_free, const vector<default_values_t> &limits)
+{
+  static const int max_iterations = 200;
+  const int n_samples = samples.size();
+
+  vector<int> free_index;
+  for (int i = 0; i < kNParameters; ++i)
+  {
+    if (is_free[i]) free_index.push_back(i);
+  }
+  const int n_free = free_index.size();
+  if (n_free == 0) return true;
+
+  // residuals and jacobian, for the free parameters
+  vector<double> residuals(n_samples);
+  vector<double> jacobian(n_samples * n_free);
+  auto evaluate = [&](const double *p, bool with_jacobian) {
+    double chi2 = 0;
+    for (int i = 0; i < n_samples; ++i)
+    {
+      const double x = i - p[1];
+      const shape_t g1 = power_law_exp(x, p[2], p[3]);
+      const shape_t g2 = power_law_exp(x, p[2], p[6]);
+      const double shape = (1. - p[5]) * g1.value + p[5] * g2.value;
+      residuals[i] = samples[i] - (p[4] + p[0] * shape);
+      chi2 += residuals[i] * residuals[i];
+      if (!with_jacobian) continue;
+
+      double derivatives[kNParameters] = {
+          shape,
+          -p[0] * ((1. - p[5]) * g1.d_x + p[5] * g2.d_x),
+          p[0] * ((1. - p[5]) * g1.d_power + p[5] * g2.d_power),
+          p[0] * (1. - p[5]) * g1.d_peaktime,
+          1.,
+          p[0] * (g2.value - g1.value),
+          p[0] * p[5] * g2.d_peaktime};
+      for (int j = 0; j < n_free; ++j) jacobian[i * n_free + j] = derivatives[free_index[j]];
+    }
+    return chi2;
+  };
+
+  double chi2 = evaluate(par, true);
+  double lambda = 1e-3;
+  vector<double> alpha_full(n_free * n_free);
+  vector<double> beta_full(n_free);
+  vector<double> alpha(n_free * n_free);
+  vector<double> beta(n_free);
+  vector<bool> at_limit(n_free);
+  double trial[kNParameters];
+  for (int iteration = 0; iteration < max_iterations; ++iteration)
+  {
+    if (!std::isfinite(chi2)) return false;
+
+    // normal equations, with damped diagonal
+    fill(alpha_full.begin(), alpha_full.end(), 0);
+    fill(beta_full.begin(), beta_full.end(), 0);
+    for (int i = 0; i < n_samples; ++i)
+    {
+      const double *row = &jacobian[i * n_free];
+      for (int j = 0; j < n_free; ++j)
+      {
+        beta_full[j] += row[j] * residuals[i];
+        for (int k = 0; k < n_free; ++k) alpha_full[j * n_free + k] += row[j] * row[k];
+      }
+    }
+    for (int j = 0; j < n_free; ++j) alpha_full[j * n_free + j] *= (1 + lambda);
+
+    // parameters at their limits, with the step pointing outwards, are kept fixed for this step
+    fill(at_limit.begin(), at_limit.end(), false);
+    bool solved = false;
+    for (int pass = 0; pass <= n_free; ++pass)
+    {
+      alpha = alpha_full;
+      beta = beta_full;
+      for (int j = 0; j < n_free; ++j)
+      {
+        if (!at_limit[j]) continue;
+        for (int k = 0; k < n_free; ++k) alpha[j * n_free + k] = alpha[k * n_free + j] = 0;
+        alpha[j * n_free + j] = 1;
+        beta[j] = 0;
+      }
+
+      solved = solve(alpha, beta, n_free);
+      if (!solved) break;
+
+      bool changed = false;
+      for (int j = 0; j < n_free; ++j)
+      {
+        const int i = free_index[j];
+        if (!at_limit[j] && ((par[i] <= limits[i].min && beta[j] < 0) || (par[i] >= limits[i].max && beta[j] > 0)))
+        {
+          at_limit[j] = true;
+          changed = true;
+        }
+      }
+      if (!changed) break;
+    }
+
+    if (!solved)
+    {
+      lambda *= 10;
+      if (lambda > 1e10) return false;
+      continue;
+    }
+
+    // clamped step
+    copy(par, par + kNParameters, trial);
+    double max_step = 0;
+    for (int j = 0; j < n_free; ++j)
+    {
+      const int i = free_index[j];
+      trial[i] = min(max(par[i] + beta[j], limits[i].min), limits[i].max);
+      max_step = max(max_step, abs(trial[i] - par[i]));
+    }
+
+    const double trial_chi2 = evaluate(trial, false);
+    if (trial_chi2 <= chi2)
+    {
+      const bool converged = (chi2 - trial_chi2) <= 1e-5 * chi2 + 1e-12 || max_step < 1e-6;
+      copy(trial, trial + kNParameters, par);
+      chi2 = evaluate(par, true);
+      if (converged) return std::isfinite(chi2);
+      lambda = max(lambda / 10, 1e-7);
+    }
+    else
+    {
+      if (max_step < 1e-6) return true;
+      lambda *= 10;
+      if (lambda > 1e10) return false;
+      // restore residuals and jacobian at current parameters
+      evaluate(par, true);
+    }
+  }
+
+  return false;
+}
+
+}  // namespace
+
 SampleFit_PowerLawDoubleExp_PDFMaker::SampleFit_PowerLawDoubleExp_PDFMaker()
 {
   gStyle->SetOptFit(1111);
@@ -73,10 +447,7 @@ bool SampleFit_PowerLawDoubleExp(        //
     std::map<int, double> &parameters_io,
     const int verbosity)
 {
-  static const int n_parameter = 7;
-
-  // inital guesses
-  int peakPos = 0.;
+  static const int n_parameter = kNParameters;
 
   //  assert(samples.size() == n_samples);
   const int n_samples = samples.size();
@@ -98,53 +469,7 @@ bool SampleFit_PowerLawDoubleExp(        //
   //      ipoint--;
   //    }
 
-  pedestal = gpulse.GetY()[0];  //(double) PEDESTAL;
-  double peakval = pedestal;
-  const double risetime = 1.5;
-
-  for (int iSample = 0; iSample < n_samples - risetime * 3; iSample++)
-  {
-    if (abs(gpulse.GetY()[iSample] - pedestal) > abs(peakval - pedestal))
-    {
-      peakval = gpulse.GetY()[iSample];
-      peakPos = iSample;
-    }
-  }
-  peakval -= pedestal;
-
-  if (verbosity)
-  {
-    cout << "SampleFit_PowerLawDoubleExp - "
-         << "pedestal = " << pedestal << ", "
-         << "peakval = " << peakval << ", "
-         << "peakPos = " << peakPos << endl;
-  }
-
-  // build default value
-  struct default_values_t
-  {
-    default_values_t(double default_value, double min_value, double max_value)
-      : def(default_value)
-      , min(min_value)
-      , max(max_value)
-    {
-    }
-    double def;
-    double min;
-    double max;
-  };
-
-  vector<default_values_t> default_values(n_parameter, default_values_t(numeric_limits<double>::signaling_NaN(), numeric_limits<double>::signaling_NaN(), numeric_limits<double>::signaling_NaN()));
-
-  default_values[0] = default_values_t(peakval * .7, peakval * -1.5, peakval * 1.5);
-  default_values[1] = default_values_t(peakPos - risetime, peakPos - 3 * risetime, peakPos + risetime);
-  default_values[2] = default_values_t(5., 1, 10.);
-  default_values[3] = default_values_t(risetime, risetime * .2, risetime * 10);
-  default_values[4] = default_values_t(pedestal, pedestal - abs(peakval), pedestal + abs(peakval));
-  //  default_values[5] = default_values_t(0.3, 0, 1);
-  //  default_values[6] = default_values_t(5, risetime * .2, risetime * 10);
-  default_values[5] = default_values_t(0, 0, 0);  // disable 2nd component
-  default_values[6] = default_values_t(risetime, risetime, risetime);
+  const vector<default_values_t> default_values = get_default_values(samples, verbosity);
 
   // fit function
   TF1 fits("f_SignalShape_PowerLawDoubleExp", SignalShape_PowerLawDoubleExp, 0., n_samples, n_parameter);
@@ -282,6 +607,212 @@ bool SampleFit_PowerLawDoubleExp(        //
   return true;
 }
 
+bool SampleFit_PowerLawDoubleExp_Fast(  //
+    const std::vector<double> &samples,  //
+    double &peak,                        //
+    double &peak_sample,                 //
+    double &pedestal,                    //
+    std::map<int, double> &parameters_io,
+    const int verbosity)
+{
+  // fixed amplitude or pedestal are not supported. Verbose fits are drawn by the Minuit version
+  if (verbosity || samples.size() < 3 || parameters_io.find(0) != parameters_io.end() || parameters_io.find(4) != parameters_io.end())
+  {
+    return SampleFit_PowerLawDoubleExp(samples, peak, peak_sample, pedestal, parameters_io, verbosity);
+  }
+
+  const int n_samples = samples.size();
+  const vector<default_values_t> default_values = get_default_values(samples, verbosity);
+
+  double par[kNParameters];
+  bool is_free[kNParameters];
+  for (int i = 0; i < kNParameters; ++i)
+  {
+    const auto iter = parameters_io.find(i);
+    if (iter == parameters_io.end())
+    {
+      par[i] = default_values[i].def;
+      is_free[i] = default_values[i].min < default_values[i].max;
+    }
+    else
+    {
+      par[i] = iter->second;
+      is_free[i] = false;
+    }
+  }
+
+  // initial guess: template scan over sample start and peak time, amplitude and pedestal in closed form
+  if (is_free[1] && is_free[2] && is_free[3] && !is_free[5] && par[5] == 0)
+  {
+    const shape_table_t &table = shape_table_t::get();
+    const int steps = shape_table_t::kStepsPerSample;
+    const int first_start = ceil(default_values[1].min * steps);
+    const int last_start = floor(default_values[1].max * steps);
+
+    vector<double> shape(n_samples);
+    double best_chi2 = numeric_limits<double>::max();
+    for (unsigned int power_index = 0; power_index < table.powers().size(); ++power_index)
+    {
+      for (unsigned int peak_time_index = 0; peak_time_index < table.peak_times().size(); ++peak_time_index)
+      {
+        const double peak_time = table.peak_times()[peak_time_index];
+        if (peak_time < default_values[3].min || peak_time > default_values[3].max) continue;
+
+        for (int start = first_start; start <= last_start; ++start)
+        {
+          for (int i = 0; i < n_samples; ++i) shape[i] = table.value(power_index, peak_time_index, i * steps - start);
+
+          double amplitude = 0;
+          double ped = 0;
+          const double chi2 = linear_fit(samples, shape, amplitude, ped);
+          if (chi2 >= 0 && chi2 < best_chi2)
+          {
+            best_chi2 = chi2;
+            par[0] = amplitude;
+            par[1] = double(start) / steps;
+            par[2] = table.powers()[power_index];
+            par[3] = peak_time;
+            par[4] = ped;
+          }
+        }
+      }
+    }
+  }
+  else
+  {
+    // amplitude and pedestal for the initial shape
+    vector<double> shape(n_samples);
+    for (int i = 0; i < n_samples; ++i) shape[i] = pulse_shape(i, par);
+    linear_fit(samples, shape, par[0], par[4]);
+  }
+
+  // keep initial guess within limits
+  for (int i = 0; i < kNParameters; ++i)
+  {
+    if (is_free[i]) par[i] = min(max(par[i], default_values[i].min), default_values[i].max);
+  }
+
+  if (!levenberg_marquardt(samples, par, is_free, default_values))
+  {
+    return SampleFit_PowerLawDoubleExp(samples, peak, peak_sample, pedestal, parameters_io, verbosity);
+  }
+
+  // store results
+  pedestal = par[4];
+  get_peak(par, n_samples, peak, peak_sample);
+
+  for (int i = 0; i < kNParameters; ++i)
+  {
+    parameters_io[i] = par[i];
+  }
+
+  return true;
+}
+
+bool SampleFit_PowerLawDoubleExp_Batch(           //
+    const std::vector<double> &waveforms,         //
+    const unsigned int n_channels,                //
+    const std::map<int, double> &shape_parameters,  //
+    std::vector<double> &peaks,                   //
+    double &peak_sample,                          //
+    std::vector<double> &pedestals,               //
+    const int verbosity)
+{
+  peaks.assign(n_channels, NAN);
+  pedestals.assign(n_channels, NAN);
+  if (n_channels == 0) return true;
+
+  const int n_samples = waveforms.size() / n_channels;
+  assert(waveforms.size() == n_samples * n_channels);
+
+  double par[kNParameters] = {1, 0, 0, 0, 0, 0, 0};
+  for (const int i : {1, 2, 3, 5, 6})
+  {
+    const auto iter = shape_parameters.find(i);
+    if (iter == shape_parameters.end())
+    {
+      cout << "SampleFit_PowerLawDoubleExp_Batch - missing shape parameter " << i << endl;
+      return false;
+    }
+    par[i] = iter->second;
+  }
+
+  // common shape, and its sums
+  vector<double> shape(n_samples);
+  double sum_s = 0, sum_ss = 0;
+  for (int i = 0; i < n_samples; ++i)
+  {
+    shape[i] = pulse_shape(i, par);
+    sum_s += shape[i];
+    sum_ss += shape[i] * shape[i];
+  }
+  const double det = n_samples * sum_ss - sum_s * sum_s;
+
+  // unit amplitude peak, common to all channels
+  double unit_peak = 0;
+  get_peak(par, n_samples, unit_peak, peak_sample);
+
+  // per channel sums, and the quantities used for the limits of SampleFit_PowerLawDoubleExp.
+  // The inner loops run over contiguous channels and vectorize
+  vector<double> sum_y(n_channels, 0);
+  vector<double> sum_sy(n_channels, 0);
+  vector<double> peakval(n_channels, 0);
+  const double *first = &waveforms[0];
+  const int n_scan = ceil(n_samples - 1.5 * 3);
+  for (int i = 0; i < n_samples; ++i)
+  {
+    const double *y = &waveforms[i * n_channels];
+    const double s = shape[i];
+    for (unsigned int ch = 0; ch < n_channels; ++ch)
+    {
+      sum_y[ch] += y[ch];
+      sum_sy[ch] += s * y[ch];
+    }
+
+    if (i < n_scan)
+    {
+      for (unsigned int ch = 0; ch < n_channels; ++ch)
+      {
+        const double value = y[ch] - first[ch];
+        peakval[ch] = (abs(value) > abs(peakval[ch])) ? value : peakval[ch];
+      }
+    }
+  }
+
+  bool success = true;
+  vector<double> samples(n_samples);
+  for (unsigned int ch = 0; ch < n_channels; ++ch)
+  {
+    if (det > 0)
+    {
+      const double amplitude = (n_samples * sum_sy[ch] - sum_s * sum_y[ch]) / det;
+      const double pedestal = (sum_y[ch] - amplitude * sum_s) / n_samples;
+
+      // same limits as SampleFit_PowerLawDoubleExp
+      const double max_amplitude = abs(peakval[ch]) * 1.5;
+      if (abs(amplitude) <= max_amplitude && abs(pedestal - first[ch]) <= abs(peakval[ch]))
+      {
+        peaks[ch] = amplitude * unit_peak;
+        pedestals[ch] = pedestal;
+        continue;
+      }
+    }
+
+    // fall back to Minuit fit for this channel
+    if (verbosity)
+    {
+      cout << "SampleFit_PowerLawDoubleExp_Batch - channel " << ch << " refitted with SampleFit_PowerLawDoubleExp" << endl;
+    }
+
+    for (int i = 0; i < n_samples; ++i) samples[i] = waveforms[i * n_channels + ch];
+    map<int, double> parameters_io(shape_parameters);
+    double channel_peak_sample = NAN;
+    success &= SampleFit_PowerLawDoubleExp(samples, peaks[ch], channel_peak_sample, pedestals[ch], parameters_io, verbosity);
+  }
+
+  return success;
+}
+
 double
 SignalShape_PowerLawExp(double *x, double *par)
 {
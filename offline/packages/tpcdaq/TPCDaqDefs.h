@@ -44,6 +44,31 @@ bool SampleFit_PowerLawDoubleExp(          //
     std::map<int, double> &parameters_io,  //! IO for fullset of parameters. If a parameter exist and not an NAN, the fit parameter will be fixed to that value. The order of the parameters are ("Amplitude 1", "Sample Start", "Power", "Peak Time 1", "Pedestal", "Amplitude 2", "Peak Time 2")
     const int verbosity = 0);
 
+//! Fast version of SampleFit_PowerLawDoubleExp, with the same interface.
+//! Pedestal and amplitude are solved in closed form. The remaining free parameters are fitted with a
+//! Levenberg-Marquardt iteration using analytic derivatives, starting from a template scan over a precomputed shape table.
+//! Falls back to SampleFit_PowerLawDoubleExp (Minuit) if the fit fails, if the amplitude or pedestal are fixed,
+//! or if verbosity is set, so that fits are drawn.
+bool SampleFit_PowerLawDoubleExp_Fast(     //
+    const std::vector<double> &samples,    //
+    double &peak,                          //! peak amplitude.
+    double &peak_sample,                   //! peak sample position
+    double &pedestal,                      //! pedestal
+    std::map<int, double> &parameters_io,  //! same as SampleFit_PowerLawDoubleExp
+    const int verbosity = 0);
+
+//! Batch fit of many channels sharing a fixed pulse shape, with only amplitude and pedestal free, solved in closed form.
+//! Waveforms are stored sample major, waveforms[sample * n_channels + channel], so that the per-channel sums vectorize.
+//! Channels for which the result is outside of the SampleFit_PowerLawDoubleExp parameter limits are refitted with it.
+bool SampleFit_PowerLawDoubleExp_Batch(           //
+    const std::vector<double> &waveforms,         //
+    const unsigned int n_channels,                //
+    const std::map<int, double> &shape_parameters,  //! fixed parameters "Sample Start", "Power", "Peak Time 1", "Amplitude 2", "Peak Time 2" (1, 2, 3, 5 and 6)
+    std::vector<double> &peaks,                   //! peak amplitude, per channel
+    double &peak_sample,                          //! peak sample position, common to all channels
+    std::vector<double> &pedestals,               //! pedestal, per channel
+    const int verbosity = 0);
+
 // Abhisek's power-law + exp signal shape model
 double
 SignalShape_PowerLawExp(double *x, double *par);
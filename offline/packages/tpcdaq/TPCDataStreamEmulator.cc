@@ -12,12 +12,13 @@
 
 #include "TPCDaqDefs.h"
 
-#include <g4detectors/PHG4Cell.h>
-#include <g4detectors/PHG4CellContainer.h>
 #include <g4detectors/PHG4CylinderCellGeom.h>
 #include <g4detectors/PHG4CylinderCellGeomContainer.h>
-#include <trackbase_historic/SvtxHit.h>
-#include <trackbase_historic/SvtxHitMap.h>
+#include <tpc/TpcDefs.h>
+#include <trackbase/TrkrDefs.h>
+#include <trackbase/TrkrHit.h>
+#include <trackbase/TrkrHitSet.h>
+#include <trackbase/TrkrHitSetContainer.h>
 #include <g4main/PHG4Hit.h>
 #include <g4main/PHG4HitContainer.h>
 #include <g4main/PHG4Particle.h>
@@ -50,6 +51,7 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <chrono>
 #include <cmath>
 #include <iostream>
 #include <limits>
@@ -63,7 +65,7 @@ TPCDataStreamEmulator::TPCDataStreamEmulator(
     unsigned int m_maxLayer,
     const std::string& outputfilename)
   : SubsysReco("TPCDataStreamEmulator")
-  , m_saveDataStreamFile(true)
+  , m_saveDataStreamFile(false)
   , m_outputFileNameBase(outputfilename)
   , m_minLayer(minLayer)
   , m_maxLayer(m_maxLayer)
@@ -80,6 +82,7 @@ TPCDataStreamEmulator::TPCDataStreamEmulator(
   , m_hLayerDataSize(nullptr)
   , m_hLayerSumHit(nullptr)
   , m_hLayerSumDataSize(nullptr)
+  , m_streamWavelets(0)
 {
 }
 
@@ -108,6 +111,32 @@ int TPCDataStreamEmulator::End(PHCompositeNode* topNode)
   assert(T_Index);
   T_Index->Write();
 
+  if (m_streamFile.is_open())
+  {
+    m_streamFile.close();
+
+    // throughput per sector
+    const int nEvents = m_evtCounter + 1;
+    double sumBytes = 0;
+    double sumTime = 0;
+    cout << "TPCDataStreamEmulator::End - data stream written to " << m_outputFileNameBase + ".bin" << endl;
+    for (unsigned int i = 0; i < m_streamSectorBytes.size(); ++i)
+    {
+      sumBytes += m_streamSectorBytes[i];
+      sumTime += m_streamSectorTime[i];
+      if (m_streamSectorTime[i] <= 0) continue;
+      cout << "TPCDataStreamEmulator::End - side " << i / TPCDataStreamFormat::kNSectors
+           << " sector " << i % TPCDataStreamFormat::kNSectors
+           << ": " << m_streamSectorBytes[i] / 1e6 / max(nEvents, 1) << " MB/event"
+           << ", " << m_streamSectorBytes[i] / 1e6 / m_streamSectorTime[i] << " MB/s" << endl;
+    }
+    if (sumTime > 0)
+    {
+      cout << "TPCDataStreamEmulator::End - total: " << sumBytes / 1e6 << " MB in " << nEvents << " events"
+           << ", " << sumBytes / 1e6 / sumTime << " MB/s" << endl;
+    }
+  }
+
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
@@ -142,8 +171,29 @@ int TPCDataStreamEmulator::InitRun(PHCompositeNode* topNode)
         exit(1);
       }
     }
+
+    m_streamHeader.layer_phibins[layer] = layerGeom->get_phibins();
   }  //   for (int layer = m_minLayer; layer <= m_maxLayer; ++layer)
 
+  if (m_saveDataStreamFile)
+  {
+    m_streamHeader.n_zbins = nZBins;
+
+    const string streamFileName = m_outputFileNameBase + ".bin";
+    if (Verbosity() >= VERBOSITY_SOME)
+      cout << "TPCDataStreamEmulator::InitRun - writing data stream to " << streamFileName << endl;
+    m_streamFile.open(streamFileName, ios::out | ios::binary);
+    if (!m_streamFile)
+    {
+      cout << "TPCDataStreamEmulator::InitRun - Fatal Error - cannot open " << streamFileName << endl;
+      exit(1);
+    }
+    m_streamHeader.write(m_streamFile);
+
+    m_streamSectorBytes.assign(2 * TPCDataStreamFormat::kNSectors, 0);
+    m_streamSectorTime.assign(2 * TPCDataStreamFormat::kNSectors, 0);
+  }
+
   if (Verbosity() >= VERBOSITY_SOME)
     cout << "TPCDataStreamEmulator::get_HistoManager - Making PHTFileServer " << m_outputFileNameBase + ".root"
          << endl;
@@ -251,21 +301,13 @@ int TPCDataStreamEmulator::process_event(PHCompositeNode* topNode)
     return Fun4AllReturnCodes::ABORTRUN;
   }
 
-  SvtxHitMap* hits = findNode::getClass<SvtxHitMap>(topNode, "SvtxHitMap");
-  if (!hits)
+  TrkrHitSetContainer* hitsets = findNode::getClass<TrkrHitSetContainer>(topNode, "TRKR_HITSET");
+  if (!hitsets)
   {
-    cout << "PCDataStreamEmulator::process_event - ERROR: Can't find node SvtxHitMap" << endl;
+    cout << "TPCDataStreamEmulator::process_event - ERROR: Can't find node TRKR_HITSET" << endl;
     return Fun4AllReturnCodes::ABORTRUN;
   }
 
-  PHG4CellContainer* cells = findNode::getClass<PHG4CellContainer>(topNode, "G4CELL_SVTX");
-  if (!cells)
-  {
-    cout << "TPCDataStreamEmulator::process_event - could not locate cell node "
-         << "G4CELL_SVTX" << endl;
-    exit(1);
-  }
-
   PHG4CylinderCellGeomContainer* seggeo = findNode::getClass<PHG4CylinderCellGeomContainer>(topNode, "CYLINDERCELLGEOM_SVTX");
   if (!seggeo)
   {
@@ -390,6 +432,10 @@ int TPCDataStreamEmulator::process_event(PHCompositeNode* topNode)
 
   assert(nZBins > 0);
 
+  // data stream event payload
+  m_streamPayload.clear();
+  m_streamWavelets = 0;
+
   // count hits and make wavelets
   int last_layer = -1;
   int last_side = -1;
@@ -398,96 +444,105 @@ int TPCDataStreamEmulator::process_event(PHCompositeNode* topNode)
   vector<unsigned int> last_wavelet;
   int last_wavelet_hittime = -1;
 
-  for (SvtxHitMap::Iter iter = hits->begin(); iter != hits->end(); ++iter)
+  // TPC hits are stored per (layer, sector, side) hitset, ordered by pad then time bin.
+  // Hits on side 1 are visited in reverse order, so that each wavelet starts from its earliest sample
+  vector<pair<TrkrDefs::hitkey, TrkrHit*> > sortedHits;
+  TrkrHitSetContainer::ConstRange hitsetrange = hitsets->getHitSets(TrkrDefs::TrkrId::tpcId);
+  for (TrkrHitSetContainer::ConstIterator hitsetitr = hitsetrange.first; hitsetitr != hitsetrange.second; ++hitsetitr)
   {
-    SvtxHit* hit = iter->second;
-
-    const int layer = hit->get_layer();
-
+    const int layer = TrkrDefs::getLayer(hitsetitr->first);
     if (layer < m_minLayer or layer > m_maxLayer) continue;
 
-    PHG4Cell* cell = cells->findCell(hit->get_cellid());                           //not needed once geofixed
-    const int phibin = PHG4CellDefs::SizeBinning::get_phibin(cell->get_cellid());  //cell->get_binphi();
-    const int zbin = PHG4CellDefs::SizeBinning::get_zbin(cell->get_cellid());      //cell->get_binz();
-    const int side = (zbin < nZBins / 2) ? 0 : 1;
+    TrkrHitSet::ConstRange hitrange = hitsetitr->second->getHits();
+    sortedHits.assign(hitrange.first, hitrange.second);
+    if (TpcDefs::getSide(hitsetitr->first) == 1) std::reverse(sortedHits.begin(), sortedHits.end());
 
-    // new wavelet?
-    if (last_layer != layer or last_phibin != phibin or last_side != side or abs(last_zbin - zbin) != 1)
+    for (const auto& hitpair : sortedHits)
     {
-      // save last wavelet
-      if (last_wavelet.size() > 0)
-      {
-        const int datasize = writeWavelet(last_layer, last_side, last_phibin, last_wavelet_hittime, last_wavelet);
-        assert(datasize > 0);
+      TrkrHit* hit = hitpair.second;
 
-        nWavelet += 1;
-        sumDataSize += datasize;
-        layerChanDataSize[last_layer][last_side][last_phibin] += datasize;
+      const int phibin = TpcDefs::getPad(hitpair.first);
+      const int zbin = TpcDefs::getTBin(hitpair.first);
+      const int side = (zbin < nZBins / 2) ? 0 : 1;
 
-        last_wavelet.clear();
-        last_zbin = -1;
-      }
+      // new wavelet?
+      if (last_layer != layer or last_phibin != phibin or last_side != side or abs(last_zbin - zbin) != 1)
+      {
+        // save last wavelet
+        if (last_wavelet.size() > 0)
+        {
+          const int datasize = writeWavelet(last_layer, last_side, last_phibin, last_wavelet_hittime, last_wavelet);
+          assert(datasize > 0);
 
-      // z-R cut on digitized wavelet
-      PHG4CylinderCellGeom* layerGeom =
-          seggeo->GetLayerCellGeom(layer);
-      assert(layerGeom);
-      const double z_abs = fabs(layerGeom->get_zcenter(zbin));
-      const double r = layerGeom->get_radius();
-      TVector3 acceptanceVec(r, 0, z_abs - m_vertexZAcceptanceCut);
-      const double eta = acceptanceVec.PseudoRapidity();
-
-      if (eta > m_etaAcceptanceCut) continue;
-
-      // make new wavelet
-      last_layer = layer;
-      last_side = side;
-      last_phibin = phibin;
-
-      // time check
-      last_wavelet_hittime = (side == 0) ? (zbin) : (nZBins - 1 - zbin);
-      assert(last_wavelet_hittime >= 0);
-      assert(last_wavelet_hittime <= nZBins / 2);
-    }  //     if (last_layer != layer or last_phibin != phibin)
-
-    if (Verbosity() >= VERBOSITY_A_LOT)
-    {
-      cout << "TPCDataStreamEmulator::process_event -  layer " << layer << " hit with "
-
-           << "phibin = " << phibin
-           << ",zbin = " << zbin
-           << ",side = " << side
-           << ",last_wavelet.size() = " << last_wavelet.size()
-           << ",last_zbin = " << last_zbin
-           << endl;
-    }
+          nWavelet += 1;
+          sumDataSize += datasize;
+          layerChanDataSize[last_layer][last_side][last_phibin] += datasize;
 
-    // more checks on signal continuity
-    if (last_wavelet.size() > 0)
-    {
-      if (side == 0)
+          last_wavelet.clear();
+          last_zbin = -1;
+        }
+
+        // z-R cut on digitized wavelet
+        PHG4CylinderCellGeom* layerGeom =
+            seggeo->GetLayerCellGeom(layer);
+        assert(layerGeom);
+        const double z_abs = fabs(layerGeom->get_zcenter(zbin));
+        const double r = layerGeom->get_radius();
+        TVector3 acceptanceVec(r, 0, z_abs - m_vertexZAcceptanceCut);
+        const double eta = acceptanceVec.PseudoRapidity();
+
+        if (eta > m_etaAcceptanceCut) continue;
+
+        // make new wavelet
+        last_layer = layer;
+        last_side = side;
+        last_phibin = phibin;
+
+        // time check
+        last_wavelet_hittime = (side == 0) ? (zbin) : (nZBins - 1 - zbin);
+        assert(last_wavelet_hittime >= 0);
+        assert(last_wavelet_hittime <= nZBins / 2);
+      }  //     if (last_layer != layer or last_phibin != phibin)
+
+      if (Verbosity() >= VERBOSITY_A_LOT)
       {
-        assert(zbin - last_zbin == 1);
+        cout << "TPCDataStreamEmulator::process_event -  layer " << layer << " hit with "
+
+             << "phibin = " << phibin
+             << ",zbin = " << zbin
+             << ",side = " << side
+             << ",last_wavelet.size() = " << last_wavelet.size()
+             << ",last_zbin = " << last_zbin
+             << endl;
       }
-      else
+
+      // more checks on signal continuity
+      if (last_wavelet.size() > 0)
       {
-        assert(last_zbin - zbin == 1);
+        if (side == 0)
+        {
+          assert(zbin - last_zbin == 1);
+        }
+        else
+        {
+          assert(last_zbin - zbin == 1);
+        }
       }
-    }
 
-    // record adc
-    unsigned int adc = hit->get_adc();
-    last_wavelet.push_back(adc);
-    last_zbin = zbin;
+      // record adc
+      unsigned int adc = hit->getAdc();
+      last_wavelet.push_back(adc);
+      last_zbin = zbin;
 
-    // statistics
-    layerChanHit[layer][side][phibin] += 1;
-    assert(m_hLayerZBinHit);
-    m_hLayerZBinHit->Fill(zbin, layer, 1);
-    assert(m_hLayerZBinADC);
-    m_hLayerZBinADC->Fill(zbin, layer, adc);
+      // statistics
+      layerChanHit[layer][side][phibin] += 1;
+      assert(m_hLayerZBinHit);
+      m_hLayerZBinHit->Fill(zbin, layer, 1);
+      assert(m_hLayerZBinADC);
+      m_hLayerZBinADC->Fill(zbin, layer, adc);
 
-  }  //   for(SvtxHitMap::Iter iter = hits->begin(); iter != hits->end(); ++iter) {
+    }  //   for (const auto& hitpair : sortedHits)
+  }  //   for (hitsetitr = hitsetrange.first; hitsetitr != hitsetrange.second; ++hitsetitr)
 
   // save last wavelet
   if (last_wavelet.size() > 0)
@@ -552,6 +607,11 @@ int TPCDataStreamEmulator::process_event(PHCompositeNode* topNode)
   m_hDataSize->Fill(sumDataSize);
   h_norm->Fill("TPC DataSize", sumDataSize);
 
+  if (m_streamFile.is_open())
+  {
+    TPCDataStreamFormat::write_event(m_streamFile, m_evtCounter, m_streamWavelets, m_streamPayload);
+  }
+
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
@@ -567,6 +627,24 @@ int TPCDataStreamEmulator::writeWavelet(int layer, int side, int phibin, int hit
   assert(m_hLayerWaveletSize);
   m_hLayerWaveletSize->Fill(layer, wavelet.size());
 
+  if (m_streamFile.is_open())
+  {
+    const auto start = chrono::steady_clock::now();
+
+    TPCDataStreamFormat::Wavelet streamWavelet;
+    streamWavelet.layer = layer;
+    streamWavelet.side = side;
+    streamWavelet.phibin = phibin;
+    streamWavelet.start_time = hittime;
+    streamWavelet.adc.assign(wavelet.begin(), wavelet.end());
+    const size_t bits = TPCDataStreamFormat::write_wavelet(m_streamPayload, m_streamHeader, streamWavelet);
+    ++m_streamWavelets;
+
+    const unsigned int index = side * TPCDataStreamFormat::kNSectors + m_streamHeader.get_sector(layer, phibin);
+    m_streamSectorBytes[index] += bits / 8.;
+    m_streamSectorTime[index] += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  }
+
   return headersize + datasizebyte;
 }
 
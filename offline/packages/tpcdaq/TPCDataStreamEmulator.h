@@ -11,8 +11,12 @@
 #ifndef TPCDATASTREAMEMULATOR_H_
 #define TPCDATASTREAMEMULATOR_H_
 
+#include "TPCDataStreamFormat.h"
+
 #include <fun4all/SubsysReco.h>
 
+#include <fstream>
+#include <string>
 #include <vector>
 
 class PHCompositeNode;
@@ -52,11 +56,35 @@ class TPCDataStreamEmulator : public SubsysReco
     m_outputFileNameBase = outputFileNameBase;
   }
 
+  //! write the emulated data stream to <outputFileNameBase>.bin, in the TPCDataStreamFormat packed format
   void saveDataStreamFile(bool saveDataStreamFile)
   {
     m_saveDataStreamFile = saveDataStreamFile;
   }
 
+  //!@name bit widths used in the data stream file
+  //@{
+  void setADCBits(unsigned int bits)
+  {
+    m_streamHeader.adc_bits = bits;
+  }
+
+  void setTimeBits(unsigned int bits)
+  {
+    m_streamHeader.time_bits = bits;
+  }
+
+  void setPadBits(unsigned int bits)
+  {
+    m_streamHeader.pad_bits = bits;
+  }
+
+  void setLayerBits(unsigned int bits)
+  {
+    m_streamHeader.layer_bits = bits;
+  }
+  //@}
+
  private:
 #if !defined(__CINT__) || defined(__CLING__)
 
@@ -87,6 +115,18 @@ class TPCDataStreamEmulator : public SubsysReco
   TH2 *m_hLayerSumHit;
   TH2 *m_hLayerSumDataSize;
 
+  //!@name data stream file
+  //@{
+  TPCDataStreamFormat::FileHeader m_streamHeader;
+  TPCDataStreamFormat::BitWriter m_streamPayload;
+  std::ofstream m_streamFile;
+  unsigned int m_streamWavelets;
+
+  //! bytes written and time spent packing, per sector, indexed by side * kNSectors + sector
+  std::vector<double> m_streamSectorBytes;
+  std::vector<double> m_streamSectorTime;
+  //@}
+
 #endif  // #if !defined(__CINT__) || defined(__CLING__)
 };
 
@@ -0,0 +1,192 @@
+/*!
+ * \file TPCDataStreamFormat.cc
+ * \brief packed, zero suppressed binary format for the emulated TPC FEE data stream
+ */
+
+#include "TPCDataStreamFormat.h"
+
+#include <algorithm>
+
+namespace
+{
+  //! write little endian integer
+  template <class T>
+  size_t write_value(std::ostream &out, T value)
+  {
+    char buffer[sizeof(T)];
+    for (size_t i = 0; i < sizeof(T); ++i)
+    {
+      buffer[i] = (value >> (8 * i)) & 0xff;
+    }
+    out.write(buffer, sizeof(T));
+    return sizeof(T);
+  }
+
+  //! read little endian integer
+  template <class T>
+  bool read_value(std::istream &in, T &value)
+  {
+    unsigned char buffer[sizeof(T)];
+    if (!in.read(reinterpret_cast<char *>(buffer), sizeof(T))) return false;
+    value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i)
+    {
+      value |= T(buffer[i]) << (8 * i);
+    }
+    return true;
+  }
+}  // namespace
+
+namespace TPCDataStreamFormat
+{
+  //_____________________________________________________________________________
+  unsigned int FileHeader::get_sector(unsigned int layer, unsigned int phibin) const
+  {
+    const auto iter = layer_phibins.find(layer);
+    if (iter == layer_phibins.end() || iter->second < kNSectors) return 0;
+    const unsigned int pads_per_sector = iter->second / kNSectors;
+    return std::min(phibin / pads_per_sector, kNSectors - 1);
+  }
+
+  //_____________________________________________________________________________
+  size_t FileHeader::write(std::ostream &out) const
+  {
+    size_t size = 0;
+    size += write_value(out, kFileMagic);
+    size += write_value(out, kVersion);
+    size += write_value(out, adc_bits);
+    size += write_value(out, time_bits);
+    size += write_value(out, pad_bits);
+    size += write_value(out, layer_bits);
+    size += write_value(out, n_zbins);
+    size += write_value(out, uint16_t(layer_phibins.size()));
+    for (const auto &pair : layer_phibins)
+    {
+      size += write_value(out, pair.first);
+      size += write_value(out, pair.second);
+    }
+    return size;
+  }
+
+  //_____________________________________________________________________________
+  bool FileHeader::read(std::istream &in)
+  {
+    uint32_t magic = 0;
+    uint16_t version = 0;
+    if (!(read_value(in, magic) && magic == kFileMagic))
+    {
+      std::cout << "TPCDataStreamFormat::FileHeader::read - invalid file magic word" << std::endl;
+      return false;
+    }
+
+    if (!(read_value(in, version) && version == kVersion))
+    {
+      std::cout << "TPCDataStreamFormat::FileHeader::read - unsupported version " << version << std::endl;
+      return false;
+    }
+
+    uint16_t n_layers = 0;
+    if (!(read_value(in, adc_bits) && read_value(in, time_bits) && read_value(in, pad_bits) && read_value(in, layer_bits) && read_value(in, n_zbins) && read_value(in, n_layers)))
+    {
+      std::cout << "TPCDataStreamFormat::FileHeader::read - truncated header" << std::endl;
+      return false;
+    }
+
+    layer_phibins.clear();
+    for (unsigned int i = 0; i < n_layers; ++i)
+    {
+      uint8_t layer = 0;
+      uint16_t phibins = 0;
+      if (!(read_value(in, layer) && read_value(in, phibins)))
+      {
+        std::cout << "TPCDataStreamFormat::FileHeader::read - truncated header" << std::endl;
+        return false;
+      }
+      layer_phibins[layer] = phibins;
+    }
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  size_t write_wavelet(BitWriter &writer, const FileHeader &header, const Wavelet &wavelet)
+  {
+    const size_t start = writer.size_bits();
+    const uint32_t max_adc = (1u << header.adc_bits) - 1;
+    writer.write(wavelet.layer, header.layer_bits);
+    writer.write(wavelet.side, 1);
+    writer.write(wavelet.phibin, header.pad_bits);
+    writer.write(wavelet.start_time, header.time_bits);
+    writer.write(wavelet.adc.size(), header.time_bits);
+    for (const uint16_t adc : wavelet.adc)
+    {
+      writer.write(std::min<uint32_t>(adc, max_adc), header.adc_bits);
+    }
+    return writer.size_bits() - start;
+  }
+
+  //_____________________________________________________________________________
+  bool read_wavelet(BitReader &reader, const FileHeader &header, Wavelet &wavelet)
+  {
+    wavelet.layer = reader.read(header.layer_bits);
+    wavelet.side = reader.read(1);
+    wavelet.phibin = reader.read(header.pad_bits);
+    wavelet.start_time = reader.read(header.time_bits);
+    const unsigned int n_samples = reader.read(header.time_bits);
+    wavelet.adc.resize(n_samples);
+    for (unsigned int i = 0; i < n_samples; ++i)
+    {
+      wavelet.adc[i] = reader.read(header.adc_bits);
+    }
+    return !reader.overflow();
+  }
+
+  //_____________________________________________________________________________
+  size_t write_event(std::ostream &out, uint32_t event, uint32_t n_wavelets, BitWriter &payload)
+  {
+    payload.align();
+    const std::vector<uint8_t> &data = payload.data();
+
+    size_t size = 0;
+    size += write_value(out, kEventMagic);
+    size += write_value(out, event);
+    size += write_value(out, n_wavelets);
+    size += write_value(out, uint32_t(data.size()));
+    out.write(reinterpret_cast<const char *>(data.data()), data.size());
+    return size + data.size();
+  }
+
+  //_____________________________________________________________________________
+  bool read_event(std::istream &in, uint32_t &event, uint32_t &n_wavelets, std::vector<uint8_t> &payload)
+  {
+    uint32_t magic = 0;
+    if (!read_value(in, magic))
+    {
+      // end of file
+      return false;
+    }
+
+    if (magic != kEventMagic)
+    {
+      std::cout << "TPCDataStreamFormat::read_event - invalid event magic word" << std::endl;
+      return false;
+    }
+
+    uint32_t size = 0;
+    if (!(read_value(in, event) && read_value(in, n_wavelets) && read_value(in, size)))
+    {
+      std::cout << "TPCDataStreamFormat::read_event - truncated event header" << std::endl;
+      return false;
+    }
+
+    payload.resize(size);
+    if (!in.read(reinterpret_cast<char *>(payload.data()), size))
+    {
+      std::cout << "TPCDataStreamFormat::read_event - truncated event " << event << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+}  // namespace TPCDataStreamFormat
@@ -0,0 +1,179 @@
+/*!
+ * \file TPCDataStreamFormat.h
+ * \brief packed, zero suppressed binary format for the emulated TPC FEE data stream
+ */
+
+#ifndef TPCDATASTREAMFORMAT_H_
+#define TPCDATASTREAMFORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <vector>
+
+/*!
+ * \brief packed, zero suppressed binary format for the emulated TPC FEE data stream.
+ *
+ * The file starts with a FileHeader, byte aligned, little endian, holding the bit widths and the readout geometry.
+ * It is followed by one record per event: a byte aligned event header
+ * (magic word, event number, number of wavelets, payload size in bytes), then the bit packed payload.
+ * Inside the payload, each wavelet is stored as
+ * layer (layer_bits), side (1 bit), phi bin (pad_bits), first time bin (time_bits),
+ * number of samples (time_bits), and the ADC samples (adc_bits each, saturated). Bits are packed LSB first.
+ * The time bin of sample i is the first time bin + i, time being counted from the central membrane
+ */
+namespace TPCDataStreamFormat
+{
+  static const uint32_t kFileMagic = 0x5a435054;   // "TPCZ"
+  static const uint32_t kEventMagic = 0x54564545;  // "EEVT"
+  static const uint16_t kVersion = 1;
+
+  //! number of readout sectors per side, used to assign phi bins to sectors
+  static const unsigned int kNSectors = 12;
+
+  //! file header
+  struct FileHeader
+  {
+    uint8_t adc_bits = 10;
+    uint8_t time_bits = 10;
+    uint8_t pad_bits = 12;
+    uint8_t layer_bits = 7;
+
+    //! number of z bins, both sides
+    uint16_t n_zbins = 0;
+
+    //! number of phi bins per layer
+    std::map<uint8_t, uint16_t> layer_phibins;
+
+    //! sector from layer and phi bin
+    unsigned int get_sector(unsigned int layer, unsigned int phibin) const;
+
+    //! write to stream. Returns number of bytes written
+    size_t write(std::ostream &) const;
+
+    //! read from stream. Returns false on error
+    bool read(std::istream &);
+  };
+
+  //! contiguous ADC samples from one channel
+  struct Wavelet
+  {
+    uint8_t layer = 0;
+    uint8_t side = 0;
+    uint16_t phibin = 0;
+    uint16_t start_time = 0;
+    std::vector<uint16_t> adc;
+  };
+
+  //! LSB first bit packer
+  class BitWriter
+  {
+   public:
+    //! append the nbits lower bits of value
+    void write(uint32_t value, unsigned int nbits)
+    {
+      m_buffer |= uint64_t(value & ((uint64_t(1) << nbits) - 1)) << m_nbits;
+      m_nbits += nbits;
+      while (m_nbits >= 8)
+      {
+        m_data.push_back(m_buffer & 0xff);
+        m_buffer >>= 8;
+        m_nbits -= 8;
+      }
+    }
+
+    //! pad to the next byte boundary
+    void align()
+    {
+      if (m_nbits > 0) write(0, 8 - m_nbits);
+    }
+
+    //! number of bits written
+    size_t size_bits() const
+    {
+      return 8 * m_data.size() + m_nbits;
+    }
+
+    //! packed data. Only complete bytes are included, call align first
+    const std::vector<uint8_t> &data() const
+    {
+      return m_data;
+    }
+
+    void clear()
+    {
+      m_data.clear();
+      m_buffer = 0;
+      m_nbits = 0;
+    }
+
+   private:
+    std::vector<uint8_t> m_data;
+    uint64_t m_buffer = 0;
+    unsigned int m_nbits = 0;
+  };
+
+  //! LSB first bit unpacker, refilling a 64 bit buffer several bytes at a time
+  class BitReader
+  {
+   public:
+    BitReader(const uint8_t *data, size_t size)
+      : m_data(data)
+      , m_end(data + size)
+    {
+    }
+
+    //! read nbits, at most 32
+    uint32_t read(unsigned int nbits)
+    {
+      if (m_nbits < nbits) refill();
+      if (m_nbits < nbits)
+      {
+        m_overflow = true;
+        return 0;
+      }
+      const uint32_t value = m_buffer & ((uint64_t(1) << nbits) - 1);
+      m_buffer >>= nbits;
+      m_nbits -= nbits;
+      return value;
+    }
+
+    //! true if reading past the end of data was attempted
+    bool overflow() const
+    {
+      return m_overflow;
+    }
+
+   private:
+    void refill()
+    {
+      while (m_nbits <= 56 && m_data < m_end)
+      {
+        m_buffer |= uint64_t(*m_data++) << m_nbits;
+        m_nbits += 8;
+      }
+    }
+
+    const uint8_t *m_data = nullptr;
+    const uint8_t *m_end = nullptr;
+    uint64_t m_buffer = 0;
+    unsigned int m_nbits = 0;
+    bool m_overflow = false;
+  };
+
+  //! append wavelet to event payload. Returns the number of bits written
+  size_t write_wavelet(BitWriter &, const FileHeader &, const Wavelet &);
+
+  //! read next wavelet from event payload. Returns false on error
+  bool read_wavelet(BitReader &, const FileHeader &, Wavelet &);
+
+  //! write event record, aligning the payload first. Returns number of bytes written
+  size_t write_event(std::ostream &, uint32_t event, uint32_t n_wavelets, BitWriter &payload);
+
+  //! read next event record. Returns false at end of file or on error
+  bool read_event(std::istream &, uint32_t &event, uint32_t &n_wavelets, std::vector<uint8_t> &payload);
+
+}  // namespace TPCDataStreamFormat
+
+#endif /* TPCDATASTREAMFORMAT_H_ */
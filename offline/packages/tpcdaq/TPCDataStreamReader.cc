@@ -0,0 +1,164 @@
+#include "TPCDataStreamReader.h"
+
+#include <tpc/TpcDefs.h>
+
+#include <trackbase/TrkrDefs.h>
+#include <trackbase/TrkrHitSet.h>
+#include <trackbase/TrkrHitSetContainerv1.h>
+#include <trackbase/TrkrHitv2.h>
+
+#include <fun4all/Fun4AllReturnCodes.h>
+
+#include <phool/PHCompositeNode.h>
+#include <phool/PHIODataNode.h>
+#include <phool/PHNodeIterator.h>
+#include <phool/getClass.h>
+
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+//_____________________________________________________________________________
+TPCDataStreamReader::TPCDataStreamReader(const std::string& inputfilename)
+  : SubsysReco("TPCDataStreamReader")
+  , m_inputFileName(inputfilename)
+  , m_hitsets(nullptr)
+  , m_nEvents(0)
+{
+}
+
+//_____________________________________________________________________________
+int TPCDataStreamReader::InitRun(PHCompositeNode* topNode)
+{
+  m_inputFile.open(m_inputFileName, ios::in | ios::binary);
+  if (!m_inputFile)
+  {
+    cout << "TPCDataStreamReader::InitRun - Fatal Error - cannot open " << m_inputFileName << endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+
+  if (!m_header.read(m_inputFile))
+  {
+    cout << "TPCDataStreamReader::InitRun - Fatal Error - cannot read header from " << m_inputFileName << endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+
+  if (Verbosity())
+  {
+    cout << "TPCDataStreamReader::InitRun - " << m_inputFileName
+         << ": adc_bits = " << int(m_header.adc_bits)
+         << ", time_bits = " << int(m_header.time_bits)
+         << ", pad_bits = " << int(m_header.pad_bits)
+         << ", layer_bits = " << int(m_header.layer_bits)
+         << ", n_zbins = " << m_header.n_zbins
+         << ", layers = " << m_header.layer_phibins.size() << endl;
+  }
+
+  // hitset container
+  m_hitsets = findNode::getClass<TrkrHitSetContainer>(topNode, "TRKR_HITSET");
+  if (!m_hitsets)
+  {
+    PHNodeIterator iter(topNode);
+    auto dstNode = dynamic_cast<PHCompositeNode*>(iter.findFirst("PHCompositeNode", "DST"));
+    if (!dstNode)
+    {
+      cout << "TPCDataStreamReader::InitRun - DST Node missing, doing nothing." << endl;
+      return Fun4AllReturnCodes::ABORTRUN;
+    }
+
+    PHNodeIterator dstiter(dstNode);
+    auto DetNode = dynamic_cast<PHCompositeNode*>(dstiter.findFirst("PHCompositeNode", "TRKR"));
+    if (!DetNode)
+    {
+      DetNode = new PHCompositeNode("TRKR");
+      dstNode->addNode(DetNode);
+    }
+
+    m_hitsets = new TrkrHitSetContainerv1;
+    auto newNode = new PHIODataNode<PHObject>(m_hitsets, "TRKR_HITSET", "PHObject");
+    DetNode->addNode(newNode);
+  }
+
+  m_sectorBytes.assign(2 * TPCDataStreamFormat::kNSectors, 0);
+  m_sectorTime.assign(2 * TPCDataStreamFormat::kNSectors, 0);
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+//_____________________________________________________________________________
+int TPCDataStreamReader::process_event(PHCompositeNode* topNode)
+{
+  uint32_t event = 0;
+  uint32_t n_wavelets = 0;
+  if (!TPCDataStreamFormat::read_event(m_inputFile, event, n_wavelets, m_payload))
+  {
+    if (Verbosity())
+      cout << "TPCDataStreamReader::process_event - end of " << m_inputFileName << " after " << m_nEvents << " events" << endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+
+  if (Verbosity() >= VERBOSITY_SOME)
+    cout << "TPCDataStreamReader::process_event - event " << event << " with " << n_wavelets << " wavelets" << endl;
+
+  TPCDataStreamFormat::BitReader reader(m_payload.data(), m_payload.size());
+  TPCDataStreamFormat::Wavelet wavelet;
+  const int nZBins = m_header.n_zbins;
+  for (uint32_t i = 0; i < n_wavelets; ++i)
+  {
+    const auto start = chrono::steady_clock::now();
+
+    if (!TPCDataStreamFormat::read_wavelet(reader, m_header, wavelet))
+    {
+      cout << "TPCDataStreamReader::process_event - corrupted payload in event " << event << ", wavelet " << i << endl;
+      return Fun4AllReturnCodes::ABORTEVENT;
+    }
+
+    const unsigned int sector = m_header.get_sector(wavelet.layer, wavelet.phibin);
+    const TrkrDefs::hitsetkey hitsetkey = TpcDefs::genHitSetKey(wavelet.layer, sector, wavelet.side);
+    TrkrHitSet* hitset = m_hitsets->findOrAddHitSet(hitsetkey)->second;
+
+    for (unsigned int sample = 0; sample < wavelet.adc.size(); ++sample)
+    {
+      // time is counted from the central membrane, see TPCDataStreamEmulator::process_event
+      const int hittime = wavelet.start_time + sample;
+      const int zbin = (wavelet.side == 0) ? hittime : (nZBins - 1 - hittime);
+
+      TrkrHit* hit = new TrkrHitv2;
+      hit->setAdc(wavelet.adc[sample]);
+      hitset->addHitSpecificKey(TpcDefs::genHitKey(wavelet.phibin, zbin), hit);
+    }
+
+    const unsigned int index = wavelet.side * TPCDataStreamFormat::kNSectors + sector;
+    m_sectorBytes[index] += (m_header.layer_bits + 1 + m_header.pad_bits + 2 * m_header.time_bits + wavelet.adc.size() * m_header.adc_bits) / 8.;
+    m_sectorTime[index] += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  }
+
+  ++m_nEvents;
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+//_____________________________________________________________________________
+int TPCDataStreamReader::End(PHCompositeNode* topNode)
+{
+  double sumBytes = 0;
+  double sumTime = 0;
+  for (unsigned int i = 0; i < m_sectorBytes.size(); ++i)
+  {
+    sumBytes += m_sectorBytes[i];
+    sumTime += m_sectorTime[i];
+    if (m_sectorTime[i] <= 0) continue;
+    cout << "TPCDataStreamReader::End - side " << i / TPCDataStreamFormat::kNSectors
+         << " sector " << i % TPCDataStreamFormat::kNSectors
+         << ": " << m_sectorBytes[i] / 1e6 << " MB"
+         << ", " << m_sectorBytes[i] / 1e6 / m_sectorTime[i] << " MB/s" << endl;
+  }
+  if (sumTime > 0)
+  {
+    cout << "TPCDataStreamReader::End - total: " << sumBytes / 1e6 << " MB in " << m_nEvents << " events"
+         << ", " << sumBytes / 1e6 / sumTime << " MB/s" << endl;
+  }
+
+  m_inputFile.close();
+  return Fun4AllReturnCodes::EVENT_OK;
+}
@@ -0,0 +1,56 @@
+#ifndef TPCDATASTREAMREADER_H_
+#define TPCDATASTREAMREADER_H_
+
+#include <fun4all/SubsysReco.h>
+
+#if !defined(__CINT__) || defined(__CLING__)
+#include "TPCDataStreamFormat.h"
+
+#include <cstdint>
+#include <fstream>
+#endif
+
+#include <string>
+#include <vector>
+
+class PHCompositeNode;
+class TrkrHitSetContainer;
+
+/*!
+ * \brief reads back the packed data stream written by TPCDataStreamEmulator
+ * and fills TPC hits in TRKR_HITSET, for reconstruction of the emulated stream
+ */
+class TPCDataStreamReader : public SubsysReco
+{
+ public:
+  TPCDataStreamReader(const std::string &inputfilename = "TPCDataStreamEmulator.bin");
+
+  ~TPCDataStreamReader() override {}
+
+  int InitRun(PHCompositeNode *topNode) override;
+  int process_event(PHCompositeNode *topNode) override;
+  int End(PHCompositeNode *topNode) override;
+
+ private:
+#if !defined(__CINT__) || defined(__CLING__)
+
+  std::string m_inputFileName;
+  std::ifstream m_inputFile;
+
+  TPCDataStreamFormat::FileHeader m_header;
+
+  //! current event payload
+  std::vector<uint8_t> m_payload;
+
+  TrkrHitSetContainer *m_hitsets;
+
+  int m_nEvents;
+
+  //! bytes decoded and time spent decoding, per sector, indexed by side * kNSectors + sector
+  std::vector<double> m_sectorBytes;
+  std::vector<double> m_sectorTime;
+
+#endif  // #if !defined(__CINT__) || defined(__CLING__)
+};
+
+#endif /* TPCDATASTREAMREADER_H_ */
@@ -75,6 +75,7 @@ TPCFEETestRecov1::TPCFEETestRecov1(const std::string& outputfilename)
   , m_clusteringZeroSuppression(50)
   , m_nPreSample(5)
   , m_nPostSample(5)
+  , m_fastFit(false)
   , m_XRayLocationX(-1)
   , m_XRayLocationY(-1)
   , m_pdfMaker(nullptr)
@@ -438,8 +439,12 @@ void TPCFEETestRecov1::Clustering()
       double peak_sample = NAN;
       double pedstal = NAN;
       map<int, double> parameters_io;
-      SampleFit_PowerLawDoubleExp(cluster.sum_samples, peak,
-                                  peak_sample, pedstal, parameters_io, Verbosity());
+      if (m_fastFit)
+        SampleFit_PowerLawDoubleExp_Fast(cluster.sum_samples, peak,
+                                         peak_sample, pedstal, parameters_io, Verbosity());
+      else
+        SampleFit_PowerLawDoubleExp(cluster.sum_samples, peak,
+                                    peak_sample, pedstal, parameters_io, Verbosity());
 
       parameters_constraints[1] = parameters_io[1];
       parameters_constraints[2] = parameters_io[2];
@@ -454,21 +459,14 @@ void TPCFEETestRecov1::Clustering()
 
     // fit - X
     {
+      cluster.padx_peaks = FitPads(cluster.padx_samples, parameters_constraints);
+
       double sum_peak = 0;
       double sum_peak_padx = 0;
-      for (int pad_x = *cluster.padxs.begin(); pad_x <= *cluster.padxs.rbegin(); ++pad_x)
+      for (const auto& pad : cluster.padx_peaks)
       {
-        double peak = NAN;
-        double peak_sample = NAN;
-        double pedstal = NAN;
-        map<int, double> parameters_io(parameters_constraints);
-
-        SampleFit_PowerLawDoubleExp(cluster.padx_samples[pad_x], peak,
-                                    peak_sample, pedstal, parameters_io, Verbosity());
-
-        cluster.padx_peaks[pad_x] = peak;
-        sum_peak += peak;
-        sum_peak_padx += peak * pad_x;
+        sum_peak += pad.second;
+        sum_peak_padx += pad.second * pad.first;
       }
       cluster.avg_padx = sum_peak_padx / sum_peak;
       cluster.size_pad_x = cluster.padxs.size();
@@ -476,21 +474,14 @@ void TPCFEETestRecov1::Clustering()
 
     // fit - Y
     {
+      cluster.pady_peaks = FitPads(cluster.pady_samples, parameters_constraints);
+
       double sum_peak = 0;
       double sum_peak_pady = 0;
-      for (int pad_y = *cluster.padys.begin(); pad_y <= *cluster.padys.rbegin(); ++pad_y)
+      for (const auto& pad : cluster.pady_peaks)
       {
-        double peak = NAN;
-        double peak_sample = NAN;
-        double pedstal = NAN;
-        map<int, double> parameters_io(parameters_constraints);
-
-        SampleFit_PowerLawDoubleExp(cluster.pady_samples[pad_y], peak,
-                                    peak_sample, pedstal, parameters_io, Verbosity());
-
-        cluster.pady_peaks[pad_y] = peak;
-        sum_peak += peak;
-        sum_peak_pady += peak * pad_y;
+        sum_peak += pad.second;
+        sum_peak_pady += pad.second * pad.first;
       }
       cluster.avg_pady = sum_peak_pady / sum_peak;
       cluster.size_pad_y = cluster.padys.size();
@@ -517,6 +508,58 @@ void TPCFEETestRecov1::Clustering()
   }
 }
 
+map<int, double> TPCFEETestRecov1::FitPads(const map<int, vector<double>>& pad_samples, const map<int, double>& parameters_constraints)
+{
+  map<int, double> peaks;
+  if (pad_samples.empty()) return peaks;
+
+  if (!m_fastFit || Verbosity())
+  {
+    // one Minuit fit per pad
+    for (const auto& pad : pad_samples)
+    {
+      double peak = NAN;
+      double peak_sample = NAN;
+      double pedstal = NAN;
+      map<int, double> parameters_io(parameters_constraints);
+
+      SampleFit_PowerLawDoubleExp(pad.second, peak,
+                                  peak_sample, pedstal, parameters_io, Verbosity());
+
+      peaks[pad.first] = peak;
+    }
+    return peaks;
+  }
+
+  // batch fit of all pads, stored sample major
+  const unsigned int n_pads = pad_samples.size();
+  const unsigned int n_sample = pad_samples.begin()->second.size();
+  vector<double> waveforms(n_sample * n_pads);
+  unsigned int ipad = 0;
+  for (const auto& pad : pad_samples)
+  {
+    assert(pad.second.size() == n_sample);
+    for (unsigned int i = 0; i < n_sample; ++i)
+    {
+      waveforms[i * n_pads + ipad] = pad.second[i];
+    }
+    ++ipad;
+  }
+
+  vector<double> pad_peaks;
+  vector<double> pad_pedestals;
+  double peak_sample = NAN;
+  SampleFit_PowerLawDoubleExp_Batch(waveforms, n_pads, parameters_constraints,
+                                    pad_peaks, peak_sample, pad_pedestals, Verbosity());
+
+  ipad = 0;
+  for (const auto& pad : pad_samples)
+  {
+    peaks[pad.first] = pad_peaks[ipad++];
+  }
+  return peaks;
+}
+
 TPCFEETestRecov1::PadPlaneData::
     PadPlaneData()
   : m_data(kMaxPadY, vector<vector<int>>(kMaxPadX, vector<int>(kSAMPLE_LENGTH, 0)))
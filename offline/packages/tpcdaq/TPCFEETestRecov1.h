@@ -61,6 +61,13 @@ class TPCFEETestRecov1 : public SubsysReco
     m_nPreSample = nPreSample;
   }
 
+  //! use the fast pulse fits (SampleFit_PowerLawDoubleExp_Fast and SampleFit_PowerLawDoubleExp_Batch) rather than Minuit. Off by default.
+  //! Minuit is always used when verbosity is set, so that fits are drawn
+  void setFastFit(bool fastFit)
+  {
+    m_fastFit = fastFit;
+  }
+
   //! simple event header class for ROOT file IO
   class EventHeader : public TObject
   {
@@ -258,11 +265,16 @@ class TPCFEETestRecov1 : public SubsysReco
   //! Clustering then prepare IOs
   void Clustering(void);
 
+  //! fit pad projections with shape parameters fixed from the cluster sum fit.
+  //! \return peak amplitude per pad
+  std::map<int, double> FitPads(const std::map<int, std::vector<double>> &pad_samples, const std::map<int, double> &parameters_constraints);
+
 #endif  // #if !defined(__CINT__) || defined(__CLING__)
 
   int m_clusteringZeroSuppression;
   int m_nPreSample;
   int m_nPostSample;
+  bool m_fastFit;
 
   void get_motor_loc(Event *evt);
 
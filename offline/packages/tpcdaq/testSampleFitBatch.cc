@@ -0,0 +1,93 @@
+// fits synthetic pulses with a known shape using SampleFit_PowerLawDoubleExp_Batch
+// and SampleFit_PowerLawDoubleExp with the same fixed shape parameters, and compares
+// run with make check
+
+#include "TPCDaqDefs.h"
+
+#include <phool/PHTestCheck.h>
+
+#include <cmath>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+  PHTestCheck check("testSampleFitBatch");
+
+  const int kNSamples = 60;
+
+  bool close(double a, double b, double tolerance)
+  {
+    return std::abs(a - b) <= tolerance;
+  }
+}  // namespace
+
+int main()
+{
+  using namespace TPCDaqDefs::FEEv1;
+
+  // fixed shape: "Sample Start", "Power", "Peak Time 1", "Amplitude ratio", "Peak Time 2"
+  const std::map<int, double> shape = {{1, 20.3}, {2, 4.}, {3, 3.5}, {5, 0.}, {6, 3.5}};
+
+  // amplitude and pedestal per channel. The last channel has no pulse, only noise
+  const std::vector<std::pair<double, double>> pulses = {
+      {40, 100}, {150, 80}, {400, 120}, {800, 60}, {1000, 95}, {250, 110}, {0, 100}};
+  const unsigned int n_channels = pulses.size();
+
+  // sample major, with gaussian noise
+  std::mt19937 generator(12345);
+  std::normal_distribution<double> noise(0, 2);
+  std::vector<double> waveforms(kNSamples * n_channels);
+  double par[7] = {0, shape.at(1), shape.at(2), shape.at(3), 0, shape.at(5), shape.at(6)};
+  for (unsigned int ch = 0; ch < n_channels; ++ch)
+  {
+    par[0] = pulses[ch].first;
+    par[4] = pulses[ch].second;
+    for (int i = 0; i < kNSamples; ++i)
+    {
+      double x = i;
+      waveforms[i * n_channels + ch] = SignalShape_PowerLawDoubleExp(&x, par) + noise(generator);
+    }
+  }
+
+  std::vector<double> peaks;
+  std::vector<double> pedestals;
+  double peak_sample = NAN;
+  check(SampleFit_PowerLawDoubleExp_Batch(waveforms, n_channels, shape, peaks, peak_sample, pedestals), "batch fit");
+  check(peaks.size() == n_channels && pedestals.size() == n_channels, "batch fit output size");
+  if (check.nfailed()) return check.result();
+
+  for (unsigned int ch = 0; ch < n_channels; ++ch)
+  {
+    const std::string name = "channel " + std::to_string(ch);
+
+    std::vector<double> samples(kNSamples);
+    for (int i = 0; i < kNSamples; ++i) samples[i] = waveforms[i * n_channels + ch];
+
+    double minuit_peak = NAN;
+    double minuit_peak_sample = NAN;
+    double minuit_pedestal = NAN;
+    std::map<int, double> parameters_io(shape);
+    check(SampleFit_PowerLawDoubleExp(samples, minuit_peak, minuit_peak_sample, minuit_pedestal, parameters_io), name + " Minuit fit");
+
+    // both are least squares fits of the same model, up to the Minuit tolerance
+    const double tolerance = 1e-3 * pulses[ch].first + 0.1;
+    check(close(peaks[ch], minuit_peak, tolerance), name + " peak matches Minuit");
+    check(close(pedestals[ch], minuit_pedestal, tolerance), name + " pedestal matches Minuit");
+    if (pulses[ch].first > 0)
+    {
+      check(close(peak_sample, minuit_peak_sample, 0.01), name + " peak sample matches Minuit");
+    }
+
+    // and both are close to the generated pulse, given the noise
+    check(close(peaks[ch], pulses[ch].first, 5), name + " peak matches the pulse");
+    check(close(pedestals[ch], pulses[ch].second, 1.5), name + " pedestal matches the pulse");
+  }
+
+  // unit amplitude pulse peaks at "Sample Start" + "Peak Time 1" with a single component
+  check(close(peak_sample, shape.at(1) + shape.at(3), 1e-6), "peak sample");
+
+  return check.result();
+}
@@ -0,0 +1,136 @@
+// writes a header and events in the packed TPC data stream format to memory,
+// reads them back and compares
+// run with make check
+
+#include "TPCDataStreamFormat.h"
+
+#include <phool/PHTestCheck.h>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  PHTestCheck check("testTPCDataStreamFormat");
+
+  TPCDataStreamFormat::Wavelet make_wavelet(uint8_t layer, uint8_t side, uint16_t phibin, uint16_t start_time, const std::vector<uint16_t> &adc)
+  {
+    TPCDataStreamFormat::Wavelet wavelet;
+    wavelet.layer = layer;
+    wavelet.side = side;
+    wavelet.phibin = phibin;
+    wavelet.start_time = start_time;
+    wavelet.adc = adc;
+    return wavelet;
+  }
+
+  bool same(const TPCDataStreamFormat::Wavelet &a, const TPCDataStreamFormat::Wavelet &b)
+  {
+    return a.layer == b.layer && a.side == b.side && a.phibin == b.phibin && a.start_time == b.start_time && a.adc == b.adc;
+  }
+}  // namespace
+
+int main()
+{
+  using namespace TPCDataStreamFormat;
+
+  // non default widths, so that the fields are not byte aligned
+  FileHeader header;
+  header.adc_bits = 9;
+  header.time_bits = 11;
+  header.pad_bits = 13;
+  header.layer_bits = 6;
+  header.n_zbins = 498;
+  header.layer_phibins[7] = 1152;
+  header.layer_phibins[23] = 1536;
+  header.layer_phibins[55] = 2304;
+
+  // the last event is empty
+  const std::vector<std::vector<Wavelet>> events = {
+      {make_wavelet(7, 0, 0, 0, {1, 2, 3}),
+       make_wavelet(23, 1, 1535, 2047, {511}),
+       make_wavelet(55, 1, 2303, 100, {0, 510, 17, 42, 300})},
+      {make_wavelet(23, 0, 600, 248, {}),
+       make_wavelet(55, 0, 8191, 1, {5, 6})},
+      {}};
+
+  std::stringstream stream;
+  size_t size = header.write(stream);
+  BitWriter writer;
+  for (unsigned int ievent = 0; ievent < events.size(); ++ievent)
+  {
+    writer.clear();
+    for (const Wavelet &wavelet : events[ievent])
+    {
+      write_wavelet(writer, header, wavelet);
+    }
+    size += write_event(stream, 100 + ievent, events[ievent].size(), writer);
+  }
+  check(size == stream.str().size(), "returned sizes match the stream size");
+
+  FileHeader header_in;
+  check(header_in.read(stream), "read header");
+  check(header_in.adc_bits == header.adc_bits && header_in.time_bits == header.time_bits &&
+            header_in.pad_bits == header.pad_bits && header_in.layer_bits == header.layer_bits,
+        "header bit widths");
+  check(header_in.n_zbins == header.n_zbins, "header z bins");
+  check(header_in.layer_phibins == header.layer_phibins, "header phi bins");
+
+  for (unsigned int ievent = 0; ievent < events.size(); ++ievent)
+  {
+    uint32_t event = 0;
+    uint32_t n_wavelets = 0;
+    std::vector<uint8_t> payload;
+    const std::string name = "event " + std::to_string(ievent);
+    if (!read_event(stream, event, n_wavelets, payload))
+    {
+      check(false, "read " + name);
+      break;
+    }
+    check(event == 100 + ievent, name + " number");
+    check(n_wavelets == events[ievent].size(), name + " number of wavelets");
+
+    BitReader reader(payload.data(), payload.size());
+    for (unsigned int i = 0; i < n_wavelets && i < events[ievent].size(); ++i)
+    {
+      Wavelet wavelet;
+      check(read_wavelet(reader, header_in, wavelet), name + " read wavelet");
+      check(same(wavelet, events[ievent][i]), name + " wavelet " + std::to_string(i));
+    }
+  }
+
+  uint32_t event = 0;
+  uint32_t n_wavelets = 0;
+  std::vector<uint8_t> payload;
+  check(!read_event(stream, event, n_wavelets, payload), "end of stream");
+
+  // samples above the ADC range are saturated
+  {
+    writer.clear();
+    write_wavelet(writer, header, make_wavelet(7, 0, 3, 4, {600, 511, 1023}));
+    writer.align();
+    BitReader reader(writer.data().data(), writer.data().size());
+    Wavelet wavelet;
+    check(read_wavelet(reader, header, wavelet) && wavelet.adc == std::vector<uint16_t>({511, 511, 511}), "saturated samples");
+  }
+
+  // truncated payload and event are refused
+  {
+    writer.clear();
+    write_wavelet(writer, header, make_wavelet(7, 0, 3, 4, {1, 2, 3, 4, 5, 6}));
+    writer.align();
+    BitReader reader(writer.data().data(), writer.data().size() - 2);
+    Wavelet wavelet;
+    check(!read_wavelet(reader, header, wavelet), "truncated payload");
+
+    std::stringstream truncated;
+    write_event(truncated, 1, 1, writer);
+    const std::string data = truncated.str();
+    std::istringstream in(data.substr(0, data.size() - 1));
+    check(!read_event(in, event, n_wavelets, payload), "truncated event");
+  }
+
+  return check.result();
+}
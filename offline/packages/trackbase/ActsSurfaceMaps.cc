@@ -5,11 +5,126 @@
  */
 
 #include "ActsSurfaceMaps.h"
+#include "ActsTrackingGeometry.h"
 
 #include <Acts/Surfaces/Surface.hpp>
 
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  //! phi difference, in ]-pi, pi]
+  double delta_phi( double phi )
+  {
+    if( phi > M_PI ) return phi - 2*M_PI;
+    else if( phi <= -M_PI ) return phi + 2*M_PI;
+    else return phi;
+  }
+}
+
 bool ActsSurfaceMaps::isTpcSurface( const Acts::Surface& surface ) const
 { return tpcVolumeIds.find( surface.geometryId().volume() ) != tpcVolumeIds.end(); }
   
 bool ActsSurfaceMaps::isMicromegasSurface( const Acts::Surface& surface ) const
 { return micromegasVolumeIds.find( surface.geometryId().volume() ) != micromegasVolumeIds.end(); }
+
+//_____________________________________________________________________________
+void ActsSurfaceMaps::buildTpcSurfaceIndex( const ActsTrackingGeometry& geometry )
+{
+  tpcSurfStepPhi = geometry.tpcSurfStepPhi;
+  tpcSurfStepZ = geometry.tpcSurfStepZ;
+  tpcSurfaceIndex.clear();
+
+  for( const auto& [hitsetkey, surfaces]:tpcSurfaceMap )
+  {
+    if( surfaces.empty() ) continue;
+    TpcSurfaceIndex& index = tpcSurfaceIndex[hitsetkey];
+    index.surfaces = surfaces;
+
+    // surface centers, converted from mm to cm
+    for( const auto& surface:surfaces )
+    {
+      const auto center = surface->center(geometry.geoContext)/10.;
+      const double phi = std::atan2(center(1), center(0));
+      if( index.centers.empty() ) index.phi_ref = phi;
+      index.centers.emplace_back( delta_phi(phi - index.phi_ref), center(2) );
+    }
+
+    // binning
+    double phi_max = index.phi_min = index.centers.front().first;
+    double z_max = index.z_min = index.centers.front().second;
+    for( const auto& [phi, z]:index.centers )
+    {
+      index.phi_min = std::min( index.phi_min, phi );
+      phi_max = std::max( phi_max, phi );
+      index.z_min = std::min( index.z_min, z );
+      z_max = std::max( z_max, z );
+    }
+
+    index.phi_min -= tpcSurfStepPhi/2;
+    index.z_min -= tpcSurfStepZ/2;
+    index.nphi = std::lround( (phi_max - index.phi_min)/tpcSurfStepPhi + 0.5 );
+    index.nz = std::lround( (z_max - index.z_min)/tpcSurfStepZ + 0.5 );
+    index.bins.assign( index.nphi*index.nz, -1 );
+
+    for( size_t i = 0; i < index.centers.size(); ++i )
+    {
+      const int iphi = std::floor( (index.centers[i].first - index.phi_min)/tpcSurfStepPhi );
+      const int iz = std::floor( (index.centers[i].second - index.z_min)/tpcSurfStepZ );
+      int& bin = index.bins[iphi*index.nz + iz];
+
+      // keep first surface, as the linear search did
+      if( bin < 0 ) bin = i;
+    }
+  }
+}
+
+//_____________________________________________________________________________
+Surface ActsSurfaceMaps::getTpcSurface( TrkrDefs::hitsetkey hitsetkey, double world_x, double world_y, double world_z, TrkrDefs::subsurfkey& subsurfkey ) const
+{
+  const auto iter = tpcSurfaceIndex.find( hitsetkey );
+  if( iter == tpcSurfaceIndex.end() ) return nullptr;
+  const TpcSurfaceIndex& index = iter->second;
+
+  const double world_phi = delta_phi( std::atan2( world_y, world_x ) - index.phi_ref );
+
+  // true if surface contains world position
+  auto contains = [&]( int i )
+  {
+    const auto& [phi, z] = index.centers[i];
+    return std::abs( world_phi - phi ) < tpcSurfStepPhi/2 && std::abs( world_z - z ) < tpcSurfStepZ/2;
+  };
+
+  const int iphi = std::floor( (world_phi - index.phi_min)/tpcSurfStepPhi );
+  const int iz = std::floor( (world_z - index.z_min)/tpcSurfStepZ );
+  if( iphi >= 0 && iphi < index.nphi && iz >= 0 && iz < index.nz )
+  {
+    const int i = index.bins[iphi*index.nz + iz];
+    if( i >= 0 && contains( i ) )
+    {
+      subsurfkey = i;
+      return index.surfaces[i];
+    }
+  }
+
+  // surfaces not aligned with the binning. Fall back to searching the precomputed centers
+  for( size_t i = 0; i < index.centers.size(); ++i )
+  {
+    if( contains( i ) )
+    {
+      subsurfkey = i;
+      return index.surfaces[i];
+    }
+  }
+
+  return nullptr;
+}
+
+//_____________________________________________________________________________
+Surface ActsSurfaceMaps::getTpcSurface( TrkrDefs::hitsetkey hitsetkey, TrkrDefs::subsurfkey subsurfkey ) const
+{
+  const auto iter = tpcSurfaceIndex.find( hitsetkey );
+  if( iter == tpcSurfaceIndex.end() || subsurfkey >= iter->second.surfaces.size() ) return nullptr;
+  return iter->second.surfaces[subsurfkey];
+}
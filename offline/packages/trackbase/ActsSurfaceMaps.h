@@ -10,10 +10,12 @@
 
 namespace Acts{ class Surface; }
 class TGeoNode;
+struct ActsTrackingGeometry;
 
 #include <map>
 #include <memory>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 using Surface = std::shared_ptr<const Acts::Surface>;
@@ -29,6 +31,15 @@ struct ActsSurfaceMaps
     
   //! true if given surface corresponds to Micromegas
   bool isMicromegasSurface( const Acts::Surface& surface ) const;
+
+  //! build TPC surface index from tpcSurfaceMap. Must be called once tpcSurfaceMap is filled
+  void buildTpcSurfaceIndex( const ActsTrackingGeometry& );
+
+  //! TPC surface matching given hitset and world position (cm). Sets subsurfkey. Returns nullptr if not found
+  Surface getTpcSurface( TrkrDefs::hitsetkey, double world_x, double world_y, double world_z, TrkrDefs::subsurfkey& ) const;
+
+  //! TPC surface matching given hitset and sub surface key. Returns nullptr if not found
+  Surface getTpcSurface( TrkrDefs::hitsetkey, TrkrDefs::subsurfkey ) const;
   
   //! map hitset to Surface for the silicon detectors (MVTX and INTT)
   std::map<TrkrDefs::hitsetkey, Surface> siliconSurfaceMap;
@@ -36,6 +47,38 @@ struct ActsSurfaceMaps
   //! map hitset to surface vector for the TPC
   std::map<TrkrDefs::hitsetkey, SurfaceVec> tpcSurfaceMap;
 
+  //! TPC surfaces of one hitset, binned in phi and z
+  /** bins have the surface size. Phi is measured relative to the first surface, to avoid the -pi, pi discontinuity */
+  struct TpcSurfaceIndex
+  {
+    //! surfaces, indexed by sub surface key
+    SurfaceVec surfaces;
+
+    //! surface center phi (relative to reference) and z (cm), indexed by sub surface key
+    std::vector<std::pair<double,double>> centers;
+
+    //! reference phi
+    double phi_ref = 0;
+
+    //! lower edge of first bin in phi (relative to reference) and z (cm)
+    double phi_min = 0;
+    double z_min = 0;
+
+    //! number of bins
+    int nphi = 0;
+    int nz = 0;
+
+    //! sub surface key for each bin (iphi*nz + iz), -1 if empty
+    std::vector<int> bins;
+  };
+
+  //! indexed TPC surfaces, built from tpcSurfaceMap in buildTpcSurfaceIndex
+  std::unordered_map<TrkrDefs::hitsetkey, TpcSurfaceIndex> tpcSurfaceIndex;
+
+  //! TPC surface size in phi (rad) and z (cm), used for the index binning
+  double tpcSurfStepPhi = 0;
+  double tpcSurfStepZ = 0;
+
   //! map hitset to surface vector for the micromegas
   std::map<TrkrDefs::hitsetkey, Surface> mmSurfaceMap;
   
@@ -9,6 +9,9 @@
 
 #include "TrkrCluster.h"
 #include "TrkrDefs.h"
+
+#include <phool/PHObjectPool.h>
+
 #include <iostream>
 
 class PHObject;
@@ -28,6 +31,10 @@ class TrkrClusterv3 : public TrkrCluster
 
   //!dtor
   ~TrkrClusterv3() override {}
+
+  //! recycled allocation when enabled, see PHObjectPool
+  PHOBJECTPOOL_OPERATORS(TrkrClusterv3)
+
   // PHObject virtual overloads
   void identify(std::ostream& os = std::cout) const override;
   void Reset() override {}
@@ -11,6 +11,7 @@
 #include "TrkrHit.h"
 
 #include <phool/PHObject.h>
+#include <phool/PHObjectPool.h>
 
 #include <iostream>
 
@@ -29,6 +30,10 @@ class TrkrHitv2 : public TrkrHit
 
   //! dtor
   ~TrkrHitv2() override {}
+
+  //! recycled allocation when enabled, see PHObjectPool
+  PHOBJECTPOOL_OPERATORS(TrkrHitv2)
+
   // PHObject virtual overloads
   void identify(std::ostream& os = std::cout) const override
   {
@@ -353,15 +353,8 @@ Surface ActsTransformations::getTpcSurface(TrkrDefs::hitsetkey hitsetkey,
 					   TrkrDefs::subsurfkey surfkey,
 					   ActsSurfaceMaps* maps) const
 {
-  const auto iter = maps->tpcSurfaceMap.find(hitsetkey);
-  if(iter != maps->tpcSurfaceMap.end())
-  {
-    auto surfvec = iter->second;
-    return surfvec.at(surfkey);
-  }
-  
-  /// If it can't be found, return nullptr to skip this cluster
-  return nullptr;
+  /// indexed lookup, returns nullptr if it can't be found, to skip this cluster
+  return maps->getTpcSurface(hitsetkey, surfkey);
 }
 
 
@@ -848,15 +848,8 @@ Surface ActsEvaluator::getSiliconSurface(TrkrDefs::hitsetkey hitsetkey)
 //___________________________________________________________________________________
 Surface ActsEvaluator::getTpcSurface(TrkrDefs::hitsetkey hitsetkey, TrkrDefs::subsurfkey surfkey)
 {
-  const auto iter = m_surfMaps->tpcSurfaceMap.find(hitsetkey);
-  if(iter != m_surfMaps->tpcSurfaceMap.end())
-  {
-    auto surfvec = iter->second;
-    return surfvec.at(surfkey);
-  }
-  
-  /// If it can't be found, return nullptr to skip this cluster
-  return nullptr;
+  /// indexed lookup, returns nullptr if it can't be found, to skip this cluster
+  return m_surfMaps->getTpcSurface(hitsetkey, surfkey);
 }
 
 //___________________________________________________________________________________
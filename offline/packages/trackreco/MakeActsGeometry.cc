@@ -64,12 +64,19 @@
 #include <TSystem.h>
 #include <TVector3.h>
 
+#include <unistd.h>
+
 #include <cmath>
 #include <cstddef>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <sstream>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -91,6 +98,35 @@ namespace
     // not found
     return nullptr;
   }
+
+  /// surface map cache format version. Increment when the format or the surface association changes
+  const unsigned int geometry_cache_version = 1;
+
+  /// 64 bit FNV-1a checksum
+  uint64_t checksum( uint64_t hash, const char* data, size_t size )
+  {
+    for( size_t i = 0; i < size; ++i )
+    {
+      hash ^= static_cast<unsigned char>( data[i] );
+      hash *= 0x100000001b3ULL;
+    }
+    return hash;
+  }
+
+  /// checksum of a file content. Returns hash unchanged if file cannot be read
+  uint64_t file_checksum( uint64_t hash, const std::string& filename )
+  {
+    std::ifstream in( filename, std::ios::binary );
+    std::ostringstream content;
+    content << in.rdbuf();
+    const std::string data = content.str();
+    return checksum( hash, data.data(), data.size() );
+  }
+
+  /// checksum of a value
+  template<class T>
+  uint64_t value_checksum( uint64_t hash, const T& value )
+  { return checksum( hash, reinterpret_cast<const char*>( &value ), sizeof( T ) ); }
 }
 
 MakeActsGeometry::MakeActsGeometry(const std::string &name)
@@ -125,6 +161,9 @@ int MakeActsGeometry::InitRun(PHCompositeNode *topNode)
   m_surfMaps->mmSurfaceMap = m_clusterSurfaceMapMmEdit;
   m_surfMaps->tGeoNodeMap = m_clusterNodeMap;
 
+  // index TPC surfaces by phi and z, for cluster to surface association
+  m_surfMaps->buildTpcSurfaceIndex(*m_actsGeometry);
+
   // fill TPC volume ids
   for( const auto& [hitsetid, surfaceVector]:m_clusterSurfaceMapTpcEdit )
     for( const auto& surface:surfaceVector )
@@ -159,6 +198,21 @@ int MakeActsGeometry::End(PHCompositeNode */*topNode*/)
 int MakeActsGeometry::buildAllGeometry(PHCompositeNode *topNode)
 {
 
+  /// Checksum of the input geometry, before the TPC edits, to key the surface map cache
+  if(!m_geometryCacheDir.empty())
+    {
+      const PHGeomIOTGeo *dstGeomIO = PHGeomUtility::GetGeomIOTGeoNode(topNode, false);
+      if(dstGeomIO && dstGeomIO->isValid())
+	{
+	  const auto& data = dstGeomIO->GetData();
+	  m_geometryChecksum = checksum(0xcbf29ce484222325ULL, data.data(), data.size());
+	}
+      else
+	{
+	  std::cout << PHWHERE << "No input geometry IO node, surface map cache disabled" << std::endl;
+	}
+    }
+
   /// Add the TPC surfaces to the copy of the TGeoManager. 
   // this also adds the micromegas surfaces
   // Do this before anything else, so that the geometry is finalized
@@ -518,6 +572,7 @@ void MakeActsGeometry::buildActsSurfaces()
 
   std::string responseFile, materialFile;
   setMaterialResponseFile(responseFile, materialFile);
+  m_geometryCacheFile = geometryCacheFileName(responseFile, materialFile);
 
   // Response file contains arguments necessary for geometry building
   std::string argstr[argc]{
@@ -663,7 +718,12 @@ void MakeActsGeometry::makeGeometry(int argc, char* argv[], ActsExamples::IBaseD
   m_magFieldContext = context.magFieldContext;
   m_geoCtxt = context.geoContext;
     
-  unpackVolumes();
+  /// Restore the surface maps from cache if possible, otherwise build them from the Acts volumes
+  if(!readGeometryCache())
+    {
+      unpackVolumes();
+      writeGeometryCache();
+    }
   
   return;
 }
@@ -717,6 +777,160 @@ void MakeActsGeometry::unpackVolumes()
   return;
 }
 
+std::string MakeActsGeometry::geometryCacheFileName(const std::string& responseFile,
+						    const std::string& materialFile) const
+{
+  if(m_geometryCacheDir.empty() || !m_geometryChecksum) return std::string();
+
+  uint64_t hash = m_geometryChecksum;
+  hash = file_checksum(hash, responseFile);
+  hash = file_checksum(hash, materialFile);
+  hash = value_checksum(hash, geometry_cache_version);
+  hash = value_checksum(hash, m_minSurfZ);
+  hash = value_checksum(hash, m_maxSurfZ);
+  hash = value_checksum(hash, m_nSurfZ);
+  hash = value_checksum(hash, m_nSurfPhi);
+  hash = value_checksum(hash, fake_surfaces);
+  hash = value_checksum(hash, m_buildMMs);
+
+  std::ostringstream out;
+  out << m_geometryCacheDir << "/ActsSurfaceMaps_" 
+      << std::hex << std::setw(16) << std::setfill('0') << hash << ".txt";
+  return out.str();
+}
+
+bool MakeActsGeometry::readGeometryCache()
+{
+  if(m_geometryCacheFile.empty()) return false;
+
+  std::ifstream in(m_geometryCacheFile);
+  if(!in) 
+    {
+      if(Verbosity() > 0)
+	std::cout << "MakeActsGeometry::readGeometryCache - no cache file " << m_geometryCacheFile << std::endl;
+      return false;
+    }
+
+  /// Acts surfaces by geometry id
+  std::unordered_map<uint64_t, Surface> surfaces;
+  m_tGeometry->visitSurfaces([&surfaces](const Acts::Surface* surface)
+    { surfaces[surface->geometryId().value()] = surface->getSharedPtr(); });
+
+  auto find_surface = [&surfaces](uint64_t id) -> Surface
+    {
+      const auto iter = surfaces.find(id);
+      return iter == surfaces.end() ? nullptr : iter->second;
+    };
+
+  std::string tag;
+  unsigned int version = 0;
+  bool valid = (in >> tag >> version) && tag == "ActsSurfaceMaps" && version == geometry_cache_version;
+
+  /// silicon and micromegas: one surface per hitset
+  size_t nSilicon = 0;
+  valid = valid && (in >> tag >> nSilicon) && tag == "silicon";
+  for(size_t i = 0; valid && i < nSilicon; ++i)
+    {
+      TrkrDefs::hitsetkey hitsetkey = 0;
+      uint64_t id = 0;
+      valid = bool(in >> hitsetkey >> id);
+      const auto surface = find_surface(id);
+      valid = valid && surface;
+      m_clusterSurfaceMapSilicon[hitsetkey] = surface;
+    }
+
+  size_t nMm = 0;
+  valid = valid && (in >> tag >> nMm) && tag == "micromegas";
+  for(size_t i = 0; valid && i < nMm; ++i)
+    {
+      TrkrDefs::hitsetkey hitsetkey = 0;
+      uint64_t id = 0;
+      valid = bool(in >> hitsetkey >> id);
+      const auto surface = find_surface(id);
+      valid = valid && surface;
+      m_clusterSurfaceMapMmEdit[hitsetkey] = surface;
+    }
+
+  /// TPC: surfaces per hitset, in sub surface key order
+  size_t nTpc = 0;
+  valid = valid && (in >> tag >> nTpc) && tag == "tpc";
+  for(size_t i = 0; valid && i < nTpc; ++i)
+    {
+      TrkrDefs::hitsetkey hitsetkey = 0;
+      size_t nSurfaces = 0;
+      valid = bool(in >> hitsetkey >> nSurfaces);
+      auto& surfaceVector = m_clusterSurfaceMapTpcEdit[hitsetkey];
+      for(size_t j = 0; valid && j < nSurfaces; ++j)
+	{
+	  uint64_t id = 0;
+	  valid = bool(in >> id);
+	  const auto surface = find_surface(id);
+	  valid = valid && surface;
+	  surfaceVector.push_back(surface);
+	}
+    }
+
+  if(!valid)
+    {
+      std::cout << PHWHERE << "Surface map cache " << m_geometryCacheFile 
+		<< " does not match the geometry, rebuilding surface maps" << std::endl;
+      m_clusterSurfaceMapSilicon.clear();
+      m_clusterSurfaceMapMmEdit.clear();
+      m_clusterSurfaceMapTpcEdit.clear();
+      return false;
+    }
+
+  if(Verbosity() > 0)
+    std::cout << "MakeActsGeometry::readGeometryCache - surface maps read from " << m_geometryCacheFile << std::endl;
+  return true;
+}
+
+void MakeActsGeometry::writeGeometryCache() const
+{
+  if(m_geometryCacheFile.empty()) return;
+
+  /// write to a temporary file first, so that concurrent jobs never read a partial cache
+  const std::string tmpFile = m_geometryCacheFile + "." + std::to_string(getpid());
+  {
+    std::ofstream out(tmpFile);
+    out << "ActsSurfaceMaps " << geometry_cache_version << std::endl;
+
+    out << "silicon " << m_clusterSurfaceMapSilicon.size() << std::endl;
+    for(const auto& [hitsetkey, surface]:m_clusterSurfaceMapSilicon)
+      out << hitsetkey << " " << surface->geometryId().value() << std::endl;
+
+    out << "micromegas " << m_clusterSurfaceMapMmEdit.size() << std::endl;
+    for(const auto& [hitsetkey, surface]:m_clusterSurfaceMapMmEdit)
+      out << hitsetkey << " " << surface->geometryId().value() << std::endl;
+
+    out << "tpc " << m_clusterSurfaceMapTpcEdit.size() << std::endl;
+    for(const auto& [hitsetkey, surfaceVector]:m_clusterSurfaceMapTpcEdit)
+      {
+	out << hitsetkey << " " << surfaceVector.size();
+	for(const auto& surface:surfaceVector)
+	  out << " " << surface->geometryId().value();
+	out << std::endl;
+      }
+
+    if(!out)
+      {
+	std::cout << PHWHERE << "Could not write surface map cache " << tmpFile << std::endl;
+	std::remove(tmpFile.c_str());
+	return;
+      }
+  }
+
+  if(std::rename(tmpFile.c_str(), m_geometryCacheFile.c_str()) != 0)
+    {
+      std::cout << PHWHERE << "Could not write surface map cache " << m_geometryCacheFile << std::endl;
+      std::remove(tmpFile.c_str());
+      return;
+    }
+
+  if(Verbosity() > 0)
+    std::cout << "MakeActsGeometry::writeGeometryCache - surface maps written to " << m_geometryCacheFile << std::endl;
+}
+
 void MakeActsGeometry::makeTpcMapPairs(TrackingVolumePtr &tpcVolume)
 {
   if(Verbosity() > 10)
@@ -26,6 +26,7 @@
 #include <ActsExamples/Fitting/TrkrClusterFittingAlgorithm.hpp>
 #include <ActsExamples/Plugins/BField/BFieldOptions.hpp>
 
+#include <cstdint>
 #include <map>
 #include <memory>            
 #include <string>
@@ -88,6 +89,16 @@ class MakeActsGeometry : public SubsysReco
 
   void add_fake_surfaces(bool add){fake_surfaces = add;}
 
+  //! directory of the surface map cache. Empty (default) disables the cache
+  /**
+   * The cache stores the association of hitsetkeys to Acts surface geometry ids.
+   * It is keyed by a checksum of the input geometry, of the material and response files,
+   * and of the TPC surface divisions. When a matching cache file is found, the surface maps
+   * are restored from the geometry ids instead of being computed from the surface positions
+   */
+  void setGeometryCacheDir(const std::string& dir)
+    {m_geometryCacheDir = dir;}
+
  private:
   /// Main function to build all acts geometry for use in the fitting modules
   int buildAllGeometry(PHCompositeNode *topNode);
@@ -149,6 +160,16 @@ class MakeActsGeometry : public SubsysReco
   
   void unpackVolumes();
 
+  /// surface map cache file name, from checksums of the geometry and of the input files. Empty if cache is disabled
+  std::string geometryCacheFileName(const std::string& responseFile,
+				    const std::string& materialFile) const;
+
+  /// restore surface maps from cache. Returns false if not found or not matching the geometry
+  bool readGeometryCache();
+
+  /// write surface maps to cache
+  void writeGeometryCache() const;
+
   /// Subdetector geometry containers for getting layer information
   PHG4CylinderGeomContainer* m_geomContainerMvtx = nullptr;
   PHG4CylinderGeomContainer* m_geomContainerIntt = nullptr;
@@ -221,6 +242,11 @@ class MakeActsGeometry : public SubsysReco
 
   bool m_buildMMs = false;
   bool fake_surfaces = true;
+
+  /// surface map cache
+  std::string m_geometryCacheDir;
+  std::string m_geometryCacheFile;
+  uint64_t m_geometryChecksum = 0;
 };
 
 #endif
@@ -16,11 +16,12 @@
 #include <phool/getClass.h>
 #include <phool/phool.h>
 
+#include <algorithm>                          // for sort, lower_bound, find_if
 #include <cmath>                              // for sqrt, fabs, atan2, cos
 #include <iostream>                           // for operator<<, basic_ostream
-#include <map>                                // for map
 #include <set>                                // for _Rb_tree_const_iterator
 #include <utility>                            // for pair, make_pair
+#include <vector>                             // for vector
 
 //____________________________________________________________________________..
 PHGhostRejection::PHGhostRejection(const std::string &name)
@@ -80,10 +81,36 @@ int  PHGhostRejection::GetNodes(PHCompositeNode* topNode)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
-void PHGhostRejection::findGhostTracks()
+namespace
+{
+  // phi difference, accounting for the wraparound at +/- pi
+  inline double delta_phi( double phi1, double phi2 )
+  {
+    double dphi = std::fabs( phi1 - phi2 );
+    if( dphi > M_PI ) dphi = 2*M_PI - dphi;
+    return dphi;
+  }
+}
+
+//____________________________________________________________________________..
+bool PHGhostRejection::isMatch(SvtxTrack *track1, SvtxTrack *track2, bool wrap_phi) const
+{
+  const double dphi = wrap_phi ?
+    delta_phi( track1->get_phi(), track2->get_phi() ):
+    fabs( track1->get_phi() - track2->get_phi() );
+
+  return
+    dphi < _phi_cut &&
+    fabs( track1->get_eta() - track2->get_eta() ) < _eta_cut &&
+    fabs( track1->get_x() - track2->get_x() ) < _x_cut &&
+    fabs( track1->get_y() - track2->get_y() ) < _y_cut &&
+    fabs( track1->get_z() - track2->get_z() ) < _z_cut;
+}
+
+//____________________________________________________________________________..
+PHGhostRejection::MatchList PHGhostRejection::findMatchesAllPairs() const
 {
-  std::set<unsigned int> matches_set;
-  std::multimap<unsigned int, unsigned int>  matches;
+  MatchList matches;
   for (auto tr1_iter = _track_map->begin();
        tr1_iter != _track_map->end(); 
        ++tr1_iter)
@@ -97,30 +124,92 @@ void PHGhostRejection::findGhostTracks()
 	  if((tr2_iter)->first  ==  (tr1_iter)->first) continue;
 	  
 	  auto track2 = (tr2_iter)->second;
-	  if( 
-	     fabs( track1->get_phi() - track2->get_phi() ) < _phi_cut &&
-	     fabs( track1->get_eta() - track2->get_eta() ) < _eta_cut &&
-	     fabs( track1->get_x() - track2->get_x() ) < _x_cut &&
-	     fabs( track1->get_y() - track2->get_y() ) < _y_cut &&
-	     fabs( track1->get_z() - track2->get_z() ) < _z_cut
-	      )
-	    {
-	      matches_set.insert(tr1_iter->first);
-	      matches.insert( std::pair( (tr1_iter)->first, (tr2_iter)->first) );
-
-	      if(Verbosity() > 1)
-		std::cout << "Found match for tracks " << (tr1_iter)->first << " and " << (tr2_iter)->first << std::endl;
-	    }
+	  if( isMatch( track1, track2, false ) )
+	    { matches.emplace_back( (tr1_iter)->first, (tr2_iter)->first ); }
 	}
     }
 
+  return matches;
+}
+
+//____________________________________________________________________________..
+PHGhostRejection::MatchList PHGhostRejection::findMatchesBinned() const
+{
+  /*
+   * tracks are put in phi bins at least _phi_cut wide, and sorted by eta inside each bin.
+   * A track can then only match tracks from its own and the two neighbouring phi bins (with wraparound),
+   * and within those only tracks inside the eta window, which is found by bisection.
+   */
+  struct track_entry_t
+  {
+    double eta;
+    unsigned int id;
+    SvtxTrack* track;
+    bool operator < (const track_entry_t& other) const { return eta < other.eta; }
+  };
+
+  const int nphibins = std::max( 1, int( 2*M_PI/_phi_cut ) );
+  auto get_phibin = [nphibins]( double phi )
+  {
+    const int bin = std::floor( (phi + M_PI)*nphibins/(2*M_PI) );
+    return ((bin % nphibins) + nphibins) % nphibins;
+  };
+
+  std::vector<std::vector<track_entry_t>> phibins( nphibins );
+  for( const auto& [id, track]:*_track_map )
+  { phibins[get_phibin( track->get_phi() )].push_back( {track->get_eta(), id, track} ); }
+
+  for( auto& bin:phibins ) { std::sort( bin.begin(), bin.end() ); }
+
+  MatchList matches;
+  for( int iphi = 0; iphi < nphibins; ++iphi )
+  {
+    // neighbouring bins, without duplicates when there are less than three bins
+    std::set<int> neighbours = { (iphi+nphibins-1)%nphibins, iphi, (iphi+1)%nphibins };
+
+    for( const auto& entry1:phibins[iphi] )
+    {
+      for( const int jphi:neighbours )
+      {
+        const auto& bin = phibins[jphi];
+        auto iter = std::lower_bound( bin.begin(), bin.end(), track_entry_t{entry1.eta - _eta_cut, 0, nullptr} );
+        for( ; iter != bin.end() && iter->eta < entry1.eta + _eta_cut; ++iter )
+        {
+          // each pair is stored once, lower id first, as in the all-pairs search
+          if( iter->id <= entry1.id ) continue;
+          if( isMatch( entry1.track, iter->track, true ) )
+          { matches.emplace_back( entry1.id, iter->id ); }
+        }
+      }
+    }
+  }
+
+  std::sort( matches.begin(), matches.end() );
+  return matches;
+}
+
+//____________________________________________________________________________..
+void PHGhostRejection::findGhostTracks()
+{
+  const auto matches = _binned_search ? findMatchesBinned():findMatchesAllPairs();
+
+  if(Verbosity() > 1)
+  {
+    for( const auto& [id1, id2]:matches )
+    { std::cout << "Found match for tracks " << id1 << " and " << id2 << std::endl; }
+  }
+
   std::set<unsigned int> ghost_reject_list;
 
-  for(auto set_it : matches_set)
+  for(auto match_begin = matches.begin(); match_begin != matches.end();)
     {
-      if(ghost_reject_list.find(set_it) != ghost_reject_list.end()) continue;  // already rejected  
+      // all matches of a given track are contiguous in the sorted list
+      const unsigned int set_it = match_begin->first;
+      const auto match_end = std::find_if( match_begin, matches.end(), [set_it]( const auto& match ) { return match.first != set_it; } );
+      const auto match_list = std::make_pair( match_begin, match_end );
+      match_begin = match_end;
 
-      auto match_list = matches.equal_range(set_it);
+      if(ghost_reject_list.find(set_it) != ghost_reject_list.end()) continue;  // already rejected  
 
       auto tr1 = _track_map->get(set_it);
       double best_qual = tr1->get_chisq() / tr1->get_ndf();
@@ -136,10 +225,12 @@ void PHGhostRejection::findGhostTracks()
 	  
 	  auto tr2 = _track_map->get(it->second);	  
 
+	  // a track without clusters was never found to share them (0/0 sharing fraction), so its matches are not used
+	  if( tr1->size_cluster_keys() == 0 ) continue;
+
 	  // Check that these two tracks actually share the same clusters, if not skip this pair
 
-	  bool is_same_track = checkClusterSharing(tr1, tr2);
-	  if(!is_same_track) continue;
+	  if( _check_cluster_sharing && !checkClusterSharing(tr1, tr2) ) continue;
 
 	  // which one has the best quality?
 	  double tr2_qual = tr2->get_chisq() / tr2->get_ndf();
@@ -191,37 +282,34 @@ bool PHGhostRejection::checkClusterSharing(SvtxTrack * tr1, SvtxTrack *tr2)
 
   bool is_same_track = false;
 
-  std::multimap<TrkrDefs::cluskey, unsigned int> cluskey_map;
-  std::vector<TrkrDefs::cluskey> clusterkeys;
-
-  for (SvtxTrack::ConstClusterKeyIter key_iter = tr1->begin_cluster_keys();
-       key_iter != tr1->end_cluster_keys();
-       ++key_iter)
+  auto get_sorted_keys = [this]( SvtxTrack* track )
+  {
+    std::vector<TrkrDefs::cluskey> clusterkeys( track->begin_cluster_keys(), track->end_cluster_keys() );
+    if(Verbosity() > 2)
     {
-	  TrkrDefs::cluskey cluster_key = *key_iter;
-	  if(Verbosity() > 2) std::cout << " track id: " << tr1->get_id() <<  " adding clusterkey " << cluster_key << std::endl;
-	  cluskey_map.insert( std::make_pair(cluster_key, tr1->get_id()) );
-	  clusterkeys.push_back(cluster_key);
+      for( const auto& cluster_key:clusterkeys )
+      { std::cout << " track id: " << track->get_id() <<  " adding clusterkey " << cluster_key << std::endl; }
     }
+    std::sort( clusterkeys.begin(), clusterkeys.end() );
+    return clusterkeys;
+  };
 
-  for (SvtxTrack::ConstClusterKeyIter key_iter = tr2->begin_cluster_keys();
-       key_iter != tr2->end_cluster_keys();
-       ++key_iter)
-    {
-	  TrkrDefs::cluskey cluster_key = *key_iter;  
-	  if(Verbosity() > 2) std::cout << " track id: " << tr2->get_id() <<  " adding clusterkey " << cluster_key << std::endl;
-	  cluskey_map.insert( std::make_pair(cluster_key, tr2->get_id()) );
-    }
-  
-  unsigned int nclus = clusterkeys.size();
+  const auto clusterkeys1 = get_sorted_keys( tr1 );
+  const auto clusterkeys2 = get_sorted_keys( tr2 );
 
+  // count the clusters of tr1 that are also used by tr2, walking both sorted lists once
+  unsigned int nclus = clusterkeys1.size();
   unsigned int nclus_used = 0;
-  for (TrkrDefs::cluskey cluskey : clusterkeys)
+  auto iter1 = clusterkeys1.begin();
+  auto iter2 = clusterkeys2.begin();
+  while( iter1 != clusterkeys1.end() && iter2 != clusterkeys2.end() )
   {
-    if(cluskey_map.count(cluskey)>0) nclus_used++;
+    if( *iter1 < *iter2 ) ++iter1;
+    else if( *iter2 < *iter1 ) ++iter2;
+    else { ++nclus_used; ++iter1; ++iter2; }
   }
 
-  if( (float) nclus_used / (float) nclus > 0.5)
+  if( nclus > 0 && (float) nclus_used / (float) nclus > 0.5)
     is_same_track = true;
 
   if(Verbosity() > 1)
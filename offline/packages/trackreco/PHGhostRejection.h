@@ -13,6 +13,7 @@
 #include <fun4all/SubsysReco.h>
 
 #include <string>
+#include <utility>
 #include <vector>
 #include <map>
 
@@ -36,10 +37,22 @@ class PHGhostRejection : public SubsysReco
   void set_track_map_name(const std::string &map_name) { _track_map_name = map_name; }
   void SetIteration(int iter){_n_iteration = iter;}
 
+  //! only compare tracks in neighbouring phi bins and within the eta cut, rather than all pairs
+  void set_binned_search(bool value) { _binned_search = value; }
+
+  //! require matched tracks to share more than half of their clusters before one of them is rejected
+  void set_check_cluster_sharing(bool value) { _check_cluster_sharing = value; }
+
  private:
 
   int GetNodes(PHCompositeNode* topNode);
+  //! matching track id pairs, with the lower id first, sorted
+  using MatchList = std::vector<std::pair<unsigned int, unsigned int>>;
+
   void findGhostTracks();
+  MatchList findMatchesAllPairs() const;
+  MatchList findMatchesBinned() const;
+  bool isMatch(SvtxTrack *tr1, SvtxTrack *tr2, bool wrap_phi) const;
   bool checkClusterSharing(SvtxTrack *tr1, SvtxTrack *tr2);
 
 SvtxTrackMap *_track_map{nullptr};
@@ -50,6 +63,8 @@ SvtxTrackMap *_track_map{nullptr};
   double _y_cut = 0.3;
   double _z_cut = 0.4;
   int _n_iteration = 0;
+  bool _binned_search = true;
+  bool _check_cluster_sharing = false;
   std::string _track_map_name = "SvtxTrackMap";
 
 };
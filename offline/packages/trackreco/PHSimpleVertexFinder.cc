@@ -33,6 +33,10 @@
 #include <iostream>
 #include <algorithm>
 #include <functional>
+#include <limits>
+#include <tuple>
+
+#include <pthread.h>
 
 #include <Eigen/Dense>
 
@@ -274,16 +278,112 @@ int PHSimpleVertexFinder::GetNodes(PHCompositeNode* topNode)
 
 void PHSimpleVertexFinder::checkDCAs()
 {
-  // Loop over tracks and check for close DCA match with all other tracks
-  for(auto tr1_it = _track_map->begin(); tr1_it != _track_map->end(); ++tr1_it)
+  // select tracks passing quality cuts once, rather than for every pair
+  const auto tracks = selectTracks();
+
+  // order in which the track pairs are scanned
+  const auto scan = makePairScan(tracks);
+  if(Verbosity() > 0) std::cout << PHWHERE << " selected tracks " << tracks.size() << " z0 bound tracks " << scan.sorted.size() << std::endl;
+
+  // calculate DCA for candidate pairs, keeping only the accepted ones
+  std::vector<PairResult> results;
+  const unsigned int nscan = scan.size();
+  const unsigned int nthreads = std::max(1U, std::min(_nthreads, nscan));
+  if(nthreads == 1)
+    {
+      evaluatePairs(tracks, scan, 0, 1, results);
+    }
+  else
+    {
+      // create structure to store given thread and associated data
+      struct thread_pair_t
+      {
+	pthread_t thread;
+	bool running = false;
+	PairThreadData data;
+      };
+
+      std::vector<thread_pair_t> threads;
+      threads.reserve(nthreads);
+
+      pthread_attr_t attr;
+      pthread_attr_init(&attr);
+      pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
+
+      // interleave the scanned tracks between threads, which balances
+      // the number of pairs also when earlier tracks have more partners
+      for(unsigned int ithread = 0; ithread < nthreads; ++ithread)
+	{
+	  auto& thread_pair = threads.emplace_back();
+	  thread_pair.data.finder = this;
+	  thread_pair.data.tracks = &tracks;
+	  thread_pair.data.scan = &scan;
+	  thread_pair.data.first = ithread;
+	  thread_pair.data.stride = nthreads;
+
+	  const int rc = pthread_create(&thread_pair.thread, &attr, evaluatePairsThread, (void *)&thread_pair.data);
+	  if(rc)
+	    {
+	      // process pairs in current thread
+	      std::cout << PHWHERE << " unable to create thread, " << rc << std::endl;
+	      evaluatePairsThread(&thread_pair.data);
+	    }
+	  else thread_pair.running = true;
+	}
+
+      pthread_attr_destroy(&attr);
+
+      // wait for completion of all threads, and collect their accepted pairs
+      for(auto& thread_pair : threads)
+	{
+	  if(thread_pair.running)
+	    {
+	      const int rc = pthread_join(thread_pair.thread, nullptr);
+	      if(rc) std::cout << PHWHERE << " unable to join, " << rc << std::endl;
+	    }
+	  results.insert(results.end(), thread_pair.data.results.begin(), thread_pair.data.results.end());
+	}
+    }
+
+  // order accepted pairs by track index, so that the maps are filled in the same order as a full loop over tracks
+  std::sort(results.begin(), results.end(), [](const PairResult& lhs, const PairResult& rhs)
+	    { return std::tie(lhs.first, lhs.second) < std::tie(rhs.first, rhs.second); });
+
+  // capture the results for successful matches
+  for(const auto& result : results)
+    {
+      const auto& tr1 = tracks[result.first];
+      const auto& tr2 = tracks[result.second];
+      if(Verbosity() > 3)
+	{
+	  std::cout << " good match for tracks " << tr1.id << " and " << tr2.id << " with pT " << tr1.pt  << " and " << tr2.pt << std::endl;
+	  std::cout << "    a1.x " << tr1.pos.x() << " a1.y " << tr1.pos.y() << " a1.z " << tr1.pos.z() << std::endl;
+	  std::cout << "    a2.x  " << tr2.pos.x()  << " a2.y " << tr2.pos.y() << " a2.z " << tr2.pos.z() << std::endl;
+	  std::cout << "    PCA1.x() " << result.PCA1.x() << " PCA1.y " << result.PCA1.y() << " PCA1.z " << result.PCA1.z() << std::endl;
+	  std::cout << "    PCA2.x() " << result.PCA2.x() << " PCA2.y " << result.PCA2.y() << " PCA2.z " << result.PCA2.z() << std::endl;      
+	  std::cout << "    dca " << result.dca << std::endl;
+	}  
+
+      _track_pair_map.insert(std::make_pair(tr1.id,std::make_pair(tr2.id, result.dca)));
+      _track_pair_pca_map.insert( std::make_pair(tr1.id, std::make_pair(tr2.id, std::make_pair(result.PCA1, result.PCA2))) );
+    }
+}
+
+std::vector<PHSimpleVertexFinder::VertexTrack> PHSimpleVertexFinder::selectTracks() const
+{
+  std::vector<VertexTrack> tracks;
+  tracks.reserve(_track_map->size());
+
+  // max transverse distance to the beam line for the PCA of an accepted pair
+  const double rmax = std::sqrt(2.)*_beamline_xy_cut;
+
+  for(const auto& [id, track] : *_track_map)
     {
-      auto id1 = tr1_it->first;
-      auto tr1 = tr1_it->second;
-      if(tr1->get_quality() > _qual_cut) continue;
+      if(track->get_quality() > _qual_cut) continue;
       if(_require_mvtx)
 	{
 	  unsigned int nmvtx = 0;
-	  for(auto clusit = tr1->begin_cluster_keys(); clusit != tr1->end_cluster_keys(); ++clusit)
+	  for(auto clusit = track->begin_cluster_keys(); clusit != track->end_cluster_keys(); ++clusit)
 	    {
 	      if(TrkrDefs::getTrkrId(*clusit) == TrkrDefs::mvtxId )
 		{
@@ -292,84 +392,145 @@ void PHSimpleVertexFinder::checkDCAs()
 	      if(nmvtx >= _nmvtx_required) break;
 	    }
 	  if(nmvtx < _nmvtx_required) continue;
-	  if(Verbosity() > 3) std::cout << " tr1 has nmvtx at least " << nmvtx << std::endl;
+	  if(Verbosity() > 3) std::cout << " track " << id << " has nmvtx at least " << nmvtx << std::endl;
 	}
-      
-      // look for close DCA matches with all other such tracks
-      for(auto tr2_it = std::next(tr1_it); tr2_it != _track_map->end(); ++tr2_it)
+      if(track->get_pt() < _track_pt_cut) continue;
+
+      // get the line equation for the track
+      VertexTrack vtrack;
+      vtrack.id = track->get_id();
+      vtrack.pt = track->get_pt();
+      vtrack.pos = Eigen::Vector3d(track->get_x(), track->get_y(), track->get_z());
+      vtrack.dir = Eigen::Vector3d(track->get_px() / track->get_p(), track->get_py() / track->get_p(), track->get_pz() / track->get_p());
+
+      /*
+       * z0 is the z of the line at its closest approach to the beam line.
+       * For an accepted pair, PCA1 is within rmax of the beam line and PCA2 within rmax + dcacut,
+       * and they are less than dcacut apart. Their z then differ from the respective track z0
+       * by at most (rmax + dcacut)*|cot(theta)|, which gives a conservative z0 window for each track
+       */
+      const double dir_t2 = vtrack.dir.x()*vtrack.dir.x() + vtrack.dir.y()*vtrack.dir.y();
+      if(dir_t2 > 0)
 	{
-	  auto id2 = tr2_it->first;
-	  auto tr2 = tr2_it->second;
-	  if(tr2->get_quality() > _qual_cut) continue;
-	  if(_require_mvtx)
-	    {
-	      unsigned int nmvtx = 0;
-	      for(auto clusit = tr2->begin_cluster_keys(); clusit != tr2->end_cluster_keys(); ++clusit)
-		{
-		  if(TrkrDefs::getTrkrId(*clusit) == TrkrDefs::mvtxId)
-		    {
-		      nmvtx++;
-		    }
-		  if(nmvtx >= _nmvtx_required) break;
-		}
-	      if(nmvtx < _nmvtx_required) continue;
-	      if(Verbosity() > 3)  std::cout << " tr2 has nmvtx at least " << nmvtx << std::endl;
-	    }
-	  
-	  // find DCA of these two tracks
-	  if(Verbosity() > 3) std::cout << "Check DCA for tracks " << id1 << " and  " << id2 << std::endl;
-	  
-	  findDcaTwoTracks(tr1, tr2);
+	  const double s = -(vtrack.pos.x()*vtrack.dir.x() + vtrack.pos.y()*vtrack.dir.y())/dir_t2;
+	  vtrack.z0 = vtrack.pos.z() + s*vtrack.dir.z();
+	  vtrack.dz0 = (rmax + _dcacut)*std::abs(vtrack.dir.z())/std::sqrt(dir_t2) + 0.5*_dcacut;
+	}
+      else
+	{
+	  // parallel to the beam line, compatible with every other track
+	  vtrack.z0 = vtrack.pos.z();
+	  vtrack.dz0 = std::numeric_limits<double>::infinity();
+	}
 
+      if(!std::isfinite(vtrack.z0) || std::isnan(vtrack.dz0))
+	{
+	  vtrack.z0 = vtrack.pos.z();
+	  vtrack.dz0 = std::numeric_limits<double>::infinity();
 	}
+
+      tracks.push_back(vtrack);
     }
 
+  return tracks;
+}
+
+PHSimpleVertexFinder::PairScan PHSimpleVertexFinder::makePairScan(const std::vector<VertexTrack> &tracks) const
+{
+  PairScan scan;
+  const unsigned int ntracks = tracks.size();
+  scan.bound.assign(ntracks, false);
 
+  // sort tracks with a finite z0 window along z0. Others are paired with everything.
+  // Without z0 preselection, all tracks are unbound, which gives all pairs
+  for(unsigned int i = 0; i < ntracks; ++i)
+    {
+      if(_use_z0_preselection && std::isfinite(tracks[i].dz0))
+	{
+	  scan.sorted.push_back(i);
+	  scan.bound[i] = true;
+	  scan.max_dz0 = std::max(scan.max_dz0, tracks[i].dz0);
+	}
+      else scan.unbound.push_back(i);
+    }
+
+  std::sort(scan.sorted.begin(), scan.sorted.end(), [&tracks](unsigned int i, unsigned int j)
+	    { return tracks[i].z0 < tracks[j].z0; });
+
+  return scan;
 }
 
-void PHSimpleVertexFinder::findDcaTwoTracks(SvtxTrack *tr1, SvtxTrack *tr2)
+void PHSimpleVertexFinder::evaluatePairs(const std::vector<VertexTrack> &tracks, const PairScan &scan,
+					 unsigned int first, unsigned int stride, std::vector<PairResult> &results) const
 {
-  if(tr1->get_pt() < _track_pt_cut) return;
-  if(tr2->get_pt() < _track_pt_cut) return;
+  const unsigned int nsorted = scan.sorted.size();
+  const unsigned int ntracks = tracks.size();
+  PairResult result;
 
-  unsigned int id1 = tr1->get_id();
-  unsigned int id2 = tr2->get_id();
+  // evaluate the pair if it passes the cuts, and store it ordered by track index
+  auto evaluate = [&](unsigned int i, unsigned int j)
+  {
+    result.first = std::min(i, j);
+    result.second = std::max(i, j);
+    if(findDcaTwoTracks(tracks[result.first], tracks[result.second], result)) results.push_back(result);
+  };
 
-  // get the line equations for the tracks
-  
-  Eigen::Vector3d a1(tr1->get_x(), tr1->get_y(), tr1->get_z());
-  Eigen::Vector3d b1(tr1->get_px() / tr1->get_p(), tr1->get_py() / tr1->get_p(), tr1->get_pz() / tr1->get_p());
-  Eigen::Vector3d a2(tr2->get_x(), tr2->get_y(), tr2->get_z());
-  Eigen::Vector3d b2(tr2->get_px() / tr2->get_p(), tr2->get_py() / tr2->get_p(), tr2->get_pz() / tr2->get_p());
-  
+  for(unsigned int iscan = first; iscan < scan.size(); iscan += stride)
+    {
+      if(iscan < nsorted)
+	{
+	  // scan forward in z0 until no track can be compatible anymore
+	  const unsigned int i = scan.sorted[iscan];
+	  const auto& tr1 = tracks[i];
+	  for(unsigned int jscan = iscan+1; jscan < nsorted; ++jscan)
+	    {
+	      const unsigned int j = scan.sorted[jscan];
+	      const double dz = tracks[j].z0 - tr1.z0;
+	      if(dz >= tr1.dz0 + scan.max_dz0) break;
+	      if(dz >= tr1.dz0 + tracks[j].dz0) continue;
+	      evaluate(i, j);
+	    }
+	}
+      else
+	{
+	  const unsigned int i = scan.unbound[iscan - nsorted];
+	  for(unsigned int j = 0; j < ntracks; ++j)
+	    {
+	      if(i == j) continue;
+	      if(scan.bound[j] || j > i) evaluate(i, j);
+	    }
+	}
+    }
+}
+
+void *PHSimpleVertexFinder::evaluatePairsThread(void *threadarg)
+{
+  auto data = static_cast<PairThreadData*>(threadarg);
+  data->finder->evaluatePairs(*data->tracks, *data->scan, data->first, data->stride, data->results);
+  return nullptr;
+}
+
+bool PHSimpleVertexFinder::findDcaTwoTracks(const VertexTrack &tr1, const VertexTrack &tr2, PairResult &result) const
+{
   Eigen::Vector3d PCA1(0,0,0);
   Eigen::Vector3d PCA2(0,0,0);  
-  double dca = dcaTwoLines(a1, b1, a2,  b2, PCA1, PCA2);
+  double dca = dcaTwoLines(tr1.pos, tr1.dir, tr2.pos, tr2.dir, PCA1, PCA2);
 
   // check dca cut is satisfied, and that PCA is close to beam line
-if( fabs(dca) < _dcacut && (fabs(PCA1.x()) < _beamline_xy_cut && fabs(PCA1.y()) < _beamline_xy_cut) )
+  if( fabs(dca) < _dcacut && (fabs(PCA1.x()) < _beamline_xy_cut && fabs(PCA1.y()) < _beamline_xy_cut) )
     {
-      if(Verbosity() > 3)
-	{
-	  std::cout << " good match for tracks " << tr1->get_id() << " and " << tr2->get_id() << " with pT " << tr1->get_pt()  << " and " << tr2->get_pt() << std::endl;
-	  std::cout << "    a1.x " << a1.x() << " a1.y " << a1.y() << " a1.z " << a1.z() << std::endl;
-	  std::cout << "    a2.x  " << a2.x()  << " a2.y " << a2.y() << " a2.z " << a2.z() << std::endl;
-	  std::cout << "    PCA1.x() " << PCA1.x() << " PCA1.y " << PCA1.y() << " PCA1.z " << PCA1.z() << std::endl;
-	  std::cout << "    PCA2.x() " << PCA2.x() << " PCA2.y " << PCA2.y() << " PCA2.z " << PCA2.z() << std::endl;      
-	  std::cout << "    dca " << dca << std::endl;
-	}  
-
-      // capture the results for successful matches
-      _track_pair_map.insert(std::make_pair(id1,std::make_pair(id2, dca)));
-      _track_pair_pca_map.insert( std::make_pair(id1, std::make_pair(id2, std::make_pair(PCA1, PCA2))) );
+      result.dca = dca;
+      result.PCA1 = PCA1;
+      result.PCA2 = PCA2;
+      return true;
     }
 
-  return;
+  return false;
 }
 
 double PHSimpleVertexFinder::dcaTwoLines(const Eigen::Vector3d &a1,const Eigen::Vector3d &b1,
 					 const Eigen::Vector3d &a2,const Eigen::Vector3d &b2,
-					 Eigen::Vector3d &PCA1, Eigen::Vector3d &PCA2)
+					 Eigen::Vector3d &PCA1, Eigen::Vector3d &PCA2) const
 {
   // The shortest distance between two skew lines described by
   //  a1 + c * b1
@@ -427,59 +588,56 @@ double PHSimpleVertexFinder::dcaTwoLines(const Eigen::Vector3d &a1,const Eigen::
 
 std::vector<std::set<unsigned int>> PHSimpleVertexFinder::findConnectedTracks()
 {
- std::vector<std::set<unsigned int>> connected_tracks;
-  std::set<unsigned int> connected;
-  std::set<unsigned int> used;
-  for(auto it : _track_pair_map)
+  std::vector<std::set<unsigned int>> connected_tracks;
+
+  // list of track ids appearing in any pair
+  std::vector<unsigned int> ids;
+  for(const auto& it : _track_pair_map)
     {
-      unsigned int id1 = it.first;
-      unsigned int id2 = it.second.first;
+      ids.push_back(it.first);
+      ids.push_back(it.second.first);
+    }
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
 
-      if( (used.find(id1) != used.end()) && (used.find(id2) != used.end()) )
-	{
-	  if(Verbosity() > 3) std::cout << " tracks " << id1 << " and " << id2 << " are both in used , skip them" << std::endl;
-	  continue;
-	}
-      else if( (used.find(id1) == used.end()) && (used.find(id2) == used.end()))
-	{
-	  if(Verbosity() > 3) std::cout << " tracks " << id1 << " and " << id2 << " are both not in used , start a new connected set" << std::endl;
-	  // close out and start a new connections set
-	  if(connected.size() > 0)
-	    {
-	      connected_tracks.push_back(connected);
-	      connected.clear();
-	      if(Verbosity() > 3) std::cout << "           closing out set " << std::endl;
-	    }
-	}
+  auto get_index = [&ids](unsigned int id)
+    { return std::lower_bound(ids.begin(), ids.end(), id) - ids.begin(); };
 
-      // get everything connected to id1 and id2
-      connected.insert(id1);
-      used.insert(id1);
-      connected.insert(id2);
-      used.insert(id2);
-      for(auto cit :  _track_pair_map)
+  // union-find over track indices. The root of each set is its lowest index
+  std::vector<unsigned int> parent(ids.size());
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find_root = [&parent](unsigned int i)
+    {
+      while(parent[i] != i)
 	{
-	  unsigned int id3 = cit.first;
-	  unsigned int id4 = cit.second.first;
-	  if( (connected.find(id3) != connected.end()) || (connected.find(id4) != connected.end()) )
-	    {
-	      if(Verbosity() > 3) std::cout << " found connection to " << id3 << " and " << id4 << std::endl;
-	      connected.insert(id3);
-	      used.insert(id3);
-	      connected.insert(id4);
-	      used.insert(id4);
-	    }
+	  parent[i] = parent[parent[i]];
+	  i = parent[i];
 	}
+      return i;
+    };
+
+  for(const auto& it : _track_pair_map)
+    {
+      const unsigned int root1 = find_root(get_index(it.first));
+      const unsigned int root2 = find_root(get_index(it.second.first));
+      if(root1 == root2) continue;
+      if(Verbosity() > 3) std::cout << " found connection between " << it.first << " and " << it.second.first << std::endl;
+      parent[std::max(root1, root2)] = std::min(root1, root2);
     }
-  
-  // close out the last set
-  if(connected.size() > 0)
+
+  // each set of connected tracks, ordered by lowest track id
+  std::vector<int> set_index(ids.size(), -1);
+  for(unsigned int i = 0; i < ids.size(); ++i)
     {
-      connected_tracks.push_back(connected);
-      connected.clear();
-      if(Verbosity() > 3) std::cout << "           closing out last set " << std::endl;
+      const unsigned int root = find_root(i);
+      if(set_index[root] < 0)
+	{
+	  set_index[root] = connected_tracks.size();
+	  connected_tracks.emplace_back();
+	}
+      connected_tracks[set_index[root]].insert(ids[i]);
     }
-    
+
   if(Verbosity() > 3)   std::cout << "connected_tracks size " << connected_tracks.size() << std::endl;
 
   return connected_tracks;
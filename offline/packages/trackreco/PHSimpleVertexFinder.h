@@ -44,6 +44,10 @@ class PHSimpleVertexFinder : public SubsysReco
  void setNmvtxRequired(unsigned int n) {_nmvtx_required = n;}
  // void setUseTrackCovariance(bool set) {_use_track_covariance = set;}
  void setOutlierPairCut(const double cut) {_outlier_cut = cut;}
+ // only evaluate DCA for track pairs whose z0 at the beam line are compatible (default true)
+ void setZ0Preselection(bool set) {_use_z0_preselection = set;}
+ // number of threads used to evaluate track pair DCAs (default 1)
+ void setNThreads(unsigned int n) {_nthreads = n;}
 
  private:
 
@@ -52,10 +56,61 @@ class PHSimpleVertexFinder : public SubsysReco
   
   void checkDCAs();
 
-  void findDcaTwoTracks(SvtxTrack *tr1, SvtxTrack *tr2);  
+  // track passing quality cuts, as a line near the beam line
+  struct VertexTrack
+  {
+    unsigned int id = 0;
+    Eigen::Vector3d pos = Eigen::Vector3d::Zero();
+    Eigen::Vector3d dir = Eigen::Vector3d::Zero();
+    double pt = 0;
+    // z at closest approach to the beam line, and max z0 difference to a matching track
+    double z0 = 0;
+    double dz0 = 0;
+  };
+
+  // track pair passing the DCA and beam line cuts
+  struct PairResult
+  {
+    unsigned int first = 0;
+    unsigned int second = 0;
+    double dca = 999;
+    Eigen::Vector3d PCA1 = Eigen::Vector3d::Zero();
+    Eigen::Vector3d PCA2 = Eigen::Vector3d::Zero();
+  };
+
+  // order in which track pairs are scanned.
+  // Each track in sorted is paired with the following ones until their z0 are incompatible,
+  // each track in unbound is paired with all bound tracks and the unbound tracks after it
+  struct PairScan
+  {
+    std::vector<unsigned int> sorted;
+    std::vector<unsigned int> unbound;
+    std::vector<bool> bound;
+    double max_dz0 = 0;
+    unsigned int size() const { return sorted.size() + unbound.size(); }
+  };
+
+  // data needed to evaluate the pairs of every nthreads-th scanned track in a given thread
+  struct PairThreadData
+  {
+    const PHSimpleVertexFinder *finder = nullptr;
+    const std::vector<VertexTrack> *tracks = nullptr;
+    const PairScan *scan = nullptr;
+    unsigned int first = 0;
+    unsigned int stride = 1;
+    std::vector<PairResult> results;
+  };
+
+  std::vector<VertexTrack> selectTracks() const;
+  PairScan makePairScan(const std::vector<VertexTrack> &tracks) const;
+  void evaluatePairs(const std::vector<VertexTrack> &tracks, const PairScan &scan,
+		     unsigned int first, unsigned int stride, std::vector<PairResult> &results) const;
+  static void *evaluatePairsThread(void *threadarg);
+
+  bool findDcaTwoTracks(const VertexTrack &tr1, const VertexTrack &tr2, PairResult &result) const;  
   double dcaTwoLines(const Eigen::Vector3d &p1, const Eigen::Vector3d &v1, 
 		     const Eigen::Vector3d &p2, const Eigen::Vector3d &v2, 
-		     Eigen::Vector3d &PCA1, Eigen::Vector3d &PCA2);
+		     Eigen::Vector3d &PCA1, Eigen::Vector3d &PCA2) const;
   std::vector<std::set<unsigned int>> findConnectedTracks();
  void removeOutlierTrackPairs();
  double getMedian(std::vector<double> &v);
@@ -72,6 +127,8 @@ class PHSimpleVertexFinder : public SubsysReco
   unsigned int _nmvtx_required = 3; 
   double _track_pt_cut = 0.0;
   double _outlier_cut = 0.015;
+  bool _use_z0_preselection = true;
+  unsigned int _nthreads = 1;
 
   std::multimap<unsigned int, unsigned int> _vertex_track_map;
   using matrix_t = Eigen::Matrix<double,3,3>;
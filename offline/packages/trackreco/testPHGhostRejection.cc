@@ -0,0 +1,93 @@
+// checks which tracks PHGhostRejection removes, in particular that a
+// track without clusters does not reject its matches (as before the binned search)
+// run with make check
+
+#include "PHGhostRejection.h"
+
+#include <trackbase_historic/SvtxTrackMap_v1.h>
+#include <trackbase_historic/SvtxTrack_v2.h>
+
+#include <phool/PHCompositeNode.h>
+#include <phool/PHIODataNode.h>
+#include <phool/PHObject.h>
+#include <phool/PHTestCheck.h>
+
+#include <set>
+#include <string>
+
+namespace
+{
+  PHTestCheck check("testPHGhostRejection");
+
+  // all tracks are at the same place and direction, so they all match
+  void add_track(SvtxTrackMap *trackmap, float chisq, unsigned int nclusters)
+  {
+    SvtxTrack_v2 track;
+    track.set_px(1.);
+    track.set_py(0.5);
+    track.set_pz(0.2);
+    track.set_x(0.01);
+    track.set_y(-0.02);
+    track.set_z(1.5);
+    track.set_chisq(chisq);
+    track.set_ndf(10);
+    for (unsigned int i = 0; i < nclusters; ++i)
+    {
+      track.insert_cluster_key(1000 + i);
+    }
+    trackmap->insert(&track);
+  }
+
+  // track ids left after ghost rejection
+  std::set<unsigned int> run(SvtxTrackMap *trackmap, bool binned)
+  {
+    PHCompositeNode topNode("TOP");
+    topNode.addNode(new PHIODataNode<PHObject>(trackmap, "SvtxTrackMap", "PHObject"));
+
+    PHGhostRejection ghost;
+    ghost.set_binned_search(binned);
+    ghost.InitRun(&topNode);
+    ghost.process_event(&topNode);
+
+    std::set<unsigned int> ids;
+    for (const auto &[id, track] : *trackmap)
+    {
+      ids.insert(id);
+    }
+    return ids;
+  }
+}  // namespace
+
+int main()
+{
+  for (const bool binned : {false, true})
+  {
+    const std::string mode = binned ? " (binned)" : " (all pairs)";
+
+    // the track with the worse chisq/ndf is removed
+    {
+      SvtxTrackMap *trackmap = new SvtxTrackMap_v1;
+      add_track(trackmap, 20, 10);
+      add_track(trackmap, 10, 10);
+      check(run(trackmap, binned) == std::set<unsigned int>{1}, "worse track rejected" + mode);
+    }
+
+    // a first track without clusters keeps both tracks
+    {
+      SvtxTrackMap *trackmap = new SvtxTrackMap_v1;
+      add_track(trackmap, 20, 0);
+      add_track(trackmap, 10, 10);
+      check(run(trackmap, binned) == std::set<unsigned int>{0, 1}, "track without clusters does not reject" + mode);
+    }
+
+    // a second track without clusters is still compared with the first one
+    {
+      SvtxTrackMap *trackmap = new SvtxTrackMap_v1;
+      add_track(trackmap, 10, 10);
+      add_track(trackmap, 20, 0);
+      check(run(trackmap, binned) == std::set<unsigned int>{0}, "track without clusters can be rejected" + mode);
+    }
+  }
+
+  return check.result();
+}
@@ -15,6 +15,7 @@
 #include <g4detectors/PHG4Cell.h>
 #include <g4detectors/PHG4CellContainer.h>
 #include <g4detectors/PHG4CellDefs.h>
+#include <g4detectors/PHG4CylinderCellArray.h>
 
 #include <g4main/PHG4Utils.h>
 
@@ -121,16 +122,70 @@ int RawTowerBuilder::process_event(PHCompositeNode *topNode)
     std::cout << PHWHERE << "Process event entered" << std::endl;
   }
 
-  // get cells
-  std::string cellnodename = "G4CELL_" + m_Detector;
-  PHG4CellContainer *cells = findNode::getClass<PHG4CellContainer>(topNode, cellnodename);
-  if (!cells)
+  // dense cell array from PHG4CylinderCellReco, used instead of the cells when present
+  double cellE = 0;
+  PHG4CylinderCellArray *cellarray = findNode::getClass<PHG4CylinderCellArray>(topNode, "G4CELLARRAY_" + m_Detector);
+  if (cellarray)
   {
-    cout << PHWHERE << " " << cellnodename
-         << " Node missing, doing nothing." << std::endl;
-    return Fun4AllReturnCodes::ABORTEVENT;
+    FillTowersFromCellArray(*cellarray);
+    if (m_ChkEnergyConservationFlag)
+    {
+      cellE = cellarray->get_total_edep();
+    }
+  }
+  else
+  {
+    // get cells
+    std::string cellnodename = "G4CELL_" + m_Detector;
+    PHG4CellContainer *cells = findNode::getClass<PHG4CellContainer>(topNode, cellnodename);
+    if (!cells)
+    {
+      cout << PHWHERE << " " << cellnodename
+           << " Node missing, doing nothing." << std::endl;
+      return Fun4AllReturnCodes::ABORTEVENT;
+    }
+    FillTowersFromCells(cells);
+    if (m_ChkEnergyConservationFlag)
+    {
+      cellE = cells->getTotalEdep();
+    }
+  }
+
+  double towerE = 0;
+  if (m_ChkEnergyConservationFlag)
+  {
+    towerE = m_TowerContainer->getTotalEdep();
+    if (fabs(cellE - towerE) / cellE > 1e-5)
+    {
+      cout << "towerE: " << towerE << ", cellE: " << cellE << ", delta: "
+           << cellE - towerE << endl;
+    }
+  }
+  if (Verbosity())
+  {
+    towerE = m_TowerContainer->getTotalEdep();
+  }
+
+  m_TowerContainer->compress(m_Emin);
+  if (Verbosity())
+  {
+    cout << "Energy lost by dropping towers with less than " << m_Emin
+         << " GeV energy, lost energy: " << towerE - m_TowerContainer->getTotalEdep()
+         << endl;
+    m_TowerContainer->identify();
+    RawTowerContainer::ConstRange begin_end = m_TowerContainer->getTowers();
+    RawTowerContainer::ConstIterator iter;
+    for (iter = begin_end.first; iter != begin_end.second; ++iter)
+    {
+      iter->second->identify();
+    }
   }
 
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+void RawTowerBuilder::FillTowersFromCells(PHG4CellContainer *cells)
+{
   // loop over all cells in an event
   PHG4CellContainer::ConstIterator cell_iter;
   PHG4CellContainer::ConstRange cell_range = cells->getCells();
@@ -195,42 +250,62 @@ int RawTowerBuilder::process_event(PHCompositeNode *topNode)
 
     if (Verbosity() > 2)
     {
-      m_RawTowerGeomContainer = findNode::getClass<RawTowerGeomContainer>(topNode, m_TowerGeomNodeName);
       tower->identify();
     }
   }
-  double towerE = 0;
-  if (m_ChkEnergyConservationFlag)
+}
+
+void RawTowerBuilder::FillTowersFromCellArray(const PHG4CylinderCellArray &cellarray)
+{
+  for (const auto &layer_pair : cellarray.get_layers())
   {
-    double cellE = cells->getTotalEdep();
-    towerE = m_TowerContainer->getTotalEdep();
-    if (fabs(cellE - towerE) / cellE > 1e-5)
+    const PHG4CylinderCellArray::Layer &layer = layer_pair.second;
+    for (unsigned int bin : layer.get_fired_bins())
     {
-      cout << "towerE: " << towerE << ", cellE: " << cellE << ", delta: "
-           << cellE - towerE << endl;
+      // towers are indexed by z (or eta) bin and phi bin, summed over layers
+      const int firstpar = layer.get_zbin(bin);
+      const int secondpar = layer.get_phibin(bin);
+      const unsigned int index = firstpar * m_NumPhiBins + secondpar;
+      if (index >= m_DenseTowers.size())
+      {
+        cout << PHWHERE << " bin outside of tower range, layer " << layer.get_layer()
+             << " z/eta bin " << firstpar << " phi bin " << secondpar << endl;
+        continue;
+      }
+      RawTower *tower = m_DenseTowers[index];
+      if (!tower)
+      {
+        tower = new RawTowerv1();
+        tower->set_energy(0);
+        m_TowerContainer->AddTower(firstpar, secondpar, tower);
+        m_DenseTowers[index] = tower;
+        m_FiredTowers.push_back(index);
+      }
+      const float cell_weight = (m_TowerEnergySrcEnum == kEnergyDeposition) ? layer.get_edep(bin) : layer.get_light_yield(bin);
+      if (cellarray.has_truth_links())
+      {
+        tower->add_ecell(layer.get_cellkey(bin), cell_weight);
+      }
+      tower->set_energy(tower->get_energy() + cell_weight);
     }
-  }
-  if (Verbosity())
-  {
-    towerE = m_TowerContainer->getTotalEdep();
-  }
 
-  m_TowerContainer->compress(m_Emin);
-  if (Verbosity())
-  {
-    cout << "Energy lost by dropping towers with less than " << m_Emin
-         << " GeV energy, lost energy: " << towerE - m_TowerContainer->getTotalEdep()
-         << endl;
-    m_TowerContainer->identify();
-    RawTowerContainer::ConstRange begin_end = m_TowerContainer->getTowers();
-    RawTowerContainer::ConstIterator iter;
-    for (iter = begin_end.first; iter != begin_end.second; ++iter)
+    // shower contributions
+    for (const PHG4CylinderCellArray::TruthLink &link : layer.get_truth_links())
     {
-      iter->second->identify();
+      const unsigned int index = layer.get_zbin(link.bin) * m_NumPhiBins + layer.get_phibin(link.bin);
+      if (index < m_DenseTowers.size() && m_DenseTowers[index])
+      {
+        m_DenseTowers[index]->add_eshower(link.showerid, link.edep);
+      }
     }
   }
 
-  return Fun4AllReturnCodes::EVENT_OK;
+  // towers are owned by the container, which may delete them in compress
+  for (unsigned int index : m_FiredTowers)
+  {
+    m_DenseTowers[index] = nullptr;
+  }
+  m_FiredTowers.clear();
 }
 
 void RawTowerBuilder::CreateNodes(PHCompositeNode *topNode)
@@ -405,6 +480,7 @@ void RawTowerBuilder::CreateNodes(PHCompositeNode *topNode)
   //  m_RawTowerGeomContainer->set_phistep(m_PhiStep);
   //  m_RawTowerGeomContainer->set_phimin(m_PhiMin);
   m_RawTowerGeomContainer->set_etabins(m_NumEtaBins);
+  m_DenseTowers.assign(m_NumEtaBins * m_NumPhiBins, nullptr);
 
   if (!first_cellgeo)
   {
@@ -4,8 +4,12 @@
 #include <fun4all/SubsysReco.h>
 
 #include <string>
+#include <vector>
 
 class PHCompositeNode;
+class PHG4CellContainer;
+class PHG4CylinderCellArray;
+class RawTower;
 class RawTowerContainer;
 class RawTowerGeomContainer;
 
@@ -56,6 +60,12 @@ class RawTowerBuilder : public SubsysReco
  protected:
   void CreateNodes(PHCompositeNode *topNode);
 
+  //! accumulate cells into towers
+  void FillTowersFromCells(PHG4CellContainer *cells);
+
+  //! accumulate the dense cell array from PHG4CylinderCellReco into towers, without PHG4Cells
+  void FillTowersFromCellArray(const PHG4CylinderCellArray &cellarray);
+
   RawTowerContainer *m_TowerContainer;
   RawTowerGeomContainer *m_RawTowerGeomContainer;
 
@@ -75,6 +85,10 @@ class RawTowerBuilder : public SubsysReco
   double m_PhiMin;
   double m_EtaStep;
   double m_PhiStep;
+
+  //! towers of the current event, indexed by etabin * m_NumPhiBins + phibin. Used by FillTowersFromCellArray
+  std::vector<RawTower *> m_DenseTowers;
+  std::vector<unsigned int> m_FiredTowers;
 };
 
 #endif  // G4CALO_RAWTOWERBUILDER_H
@@ -27,6 +27,7 @@
 #include <gsl/gsl_randist.h>
 #include <gsl/gsl_rng.h>
 
+#include <algorithm>  // for max
 #include <cmath>
 #include <cstdlib>    // for exit
 #include <exception>  // for exception
@@ -99,6 +100,11 @@ int RawTowerDigitizer::InitRun(PHCompositeNode *topNode)
     cout << e.what() << endl;
     return Fun4AllReturnCodes::ABORTRUN;
   }
+
+  if (m_BatchDigitization)
+  {
+    init_batch_digitization();
+  }
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
@@ -120,6 +126,12 @@ int RawTowerDigitizer::process_event(PHCompositeNode */*topNode*/)
     }
     cout << endl;
   }
+
+  if (m_BatchDigitization && (m_DigiAlgorithm == kSimple_photon_digitization || m_DigiAlgorithm == kSiPM_photon_digitization))
+  {
+    return batch_digitization();
+  }
+
   // loop over all possible towers, even empty ones. The digitization can add towers containing
   // pedestals
   RawTowerGeomContainer::ConstRange all_towers = m_RawTowerGeom->get_tower_geometries();
@@ -130,52 +142,8 @@ int RawTowerDigitizer::process_event(PHCompositeNode */*topNode*/)
        it != all_towers.second; ++it)
   {
     const RawTowerDefs::keytype key = it->second->get_id();
-    RawTowerDefs::CalorimeterId caloid = RawTowerDefs::decode_caloid(key);
-    const int eta = it->second->get_bineta();
-    const int phi = it->second->get_binphi();
-
-    if (caloid == RawTowerDefs::LFHCAL) 
-    {
-      const int l = it->second->get_binl();
-      if (m_ZeroSuppressionFile == true)
-      {
-        const string zsName = "ZS_ADC_eta" + to_string(eta) + "_phi" + to_string(phi) + "_l" + to_string(l);
-        m_ZeroSuppressionADC =
-          _tower_params.get_double_param(zsName);
-      }
-
-      if (m_pedestalFile == true)
-      {
-        const string pedCentralName = "PedCentral_ADC_eta" + to_string(eta) + "_phi" + to_string(phi) + "_l" + to_string(l);
-        m_PedstalCentralADC =
-          _tower_params.get_double_param(pedCentralName);
-        const string pedWidthName = "PedWidth_ADC_eta" + to_string(eta) + "_phi" + to_string(phi) + "_l" + to_string(l);
-        m_PedstalWidthADC =
-          _tower_params.get_double_param(pedWidthName);
-      }
-    }
-    else 
-    {
-      if (m_ZeroSuppressionFile == true)
-      {
-        const string zsName = "ZS_ADC_eta" + to_string(eta) + "_phi" + to_string(phi);
-        m_ZeroSuppressionADC =
-          _tower_params.get_double_param(zsName);
-      }
-
-      if (m_pedestalFile == true)
-      {
-        const string pedCentralName = "PedCentral_ADC_eta" + to_string(eta) + "_phi" + to_string(phi);
-        m_PedstalCentralADC =
-          _tower_params.get_double_param(pedCentralName);
-        const string pedWidthName = "PedWidth_ADC_eta" + to_string(eta) + "_phi" + to_string(phi);
-        m_PedstalWidthADC =
-          _tower_params.get_double_param(pedWidthName);
-      }
-    } 
+    update_tower_parameters(it->second);
 
-    
-    
     if (m_TowerType >= 0)
     {
       // Skip towers that don't match the type we are supposed to digitize
@@ -256,6 +224,53 @@ int RawTowerDigitizer::process_event(PHCompositeNode */*topNode*/)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+void RawTowerDigitizer::update_tower_parameters(const RawTowerGeom *tower_geom)
+{
+  RawTowerDefs::CalorimeterId caloid = RawTowerDefs::decode_caloid(tower_geom->get_id());
+  const int eta = tower_geom->get_bineta();
+  const int phi = tower_geom->get_binphi();
+
+  if (caloid == RawTowerDefs::LFHCAL)
+  {
+    const int l = tower_geom->get_binl();
+    if (m_ZeroSuppressionFile == true)
+    {
+      const string zsName = "ZS_ADC_eta" + to_string(eta) + "_phi" + to_string(phi) + "_l" + to_string(l);
+      m_ZeroSuppressionADC =
+        _tower_params.get_double_param(zsName);
+    }
+
+    if (m_pedestalFile == true)
+    {
+      const string pedCentralName = "PedCentral_ADC_eta" + to_string(eta) + "_phi" + to_string(phi) + "_l" + to_string(l);
+      m_PedstalCentralADC =
+        _tower_params.get_double_param(pedCentralName);
+      const string pedWidthName = "PedWidth_ADC_eta" + to_string(eta) + "_phi" + to_string(phi) + "_l" + to_string(l);
+      m_PedstalWidthADC =
+        _tower_params.get_double_param(pedWidthName);
+    }
+  }
+  else
+  {
+    if (m_ZeroSuppressionFile == true)
+    {
+      const string zsName = "ZS_ADC_eta" + to_string(eta) + "_phi" + to_string(phi);
+      m_ZeroSuppressionADC =
+        _tower_params.get_double_param(zsName);
+    }
+
+    if (m_pedestalFile == true)
+    {
+      const string pedCentralName = "PedCentral_ADC_eta" + to_string(eta) + "_phi" + to_string(phi);
+      m_PedstalCentralADC =
+        _tower_params.get_double_param(pedCentralName);
+      const string pedWidthName = "PedWidth_ADC_eta" + to_string(eta) + "_phi" + to_string(phi);
+      m_PedstalWidthADC =
+        _tower_params.get_double_param(pedWidthName);
+    }
+  }
+}
+
 RawTower *
 RawTowerDigitizer::simple_photon_digitization(RawTower *sim_tower)
 {
@@ -386,6 +401,180 @@ RawTowerDigitizer::sipm_photon_digitization(RawTower *sim_tower)
   return digi_tower;
 }
 
+void RawTowerDigitizer::init_batch_digitization()
+{
+  m_BatchIndex.clear();
+  m_BatchKeys.clear();
+  m_BatchPedCentral.clear();
+  m_BatchPedWidth.clear();
+  m_BatchZeroSuppression.clear();
+  m_BatchNoiseThreshold.clear();
+  m_BatchNoiseProb.clear();
+  m_BatchDead.clear();
+  m_BatchMaxNoiseProb = 0;
+
+  RawTowerGeomContainer::ConstRange all_towers = m_RawTowerGeom->get_tower_geometries();
+  for (RawTowerGeomContainer::ConstIterator it = all_towers.first;
+       it != all_towers.second; ++it)
+  {
+    if (m_TowerType >= 0 && m_TowerType != it->second->get_tower_type())
+    {
+      continue;
+    }
+
+    const RawTowerDefs::keytype key = it->second->get_id();
+    update_tower_parameters(it->second);
+
+    // an empty tower passes the zero suppression if (int) pedestal > zero suppression.
+    // With m the smallest integer above the zero suppression, and truncation toward zero,
+    // this is pedestal >= m for m > 0 and pedestal > m - 1 otherwise
+    const double m = floor(m_ZeroSuppressionADC) + 1;
+    const double threshold = (m > 0) ? m : m - 1;
+    double noise_prob = 0;
+    if (m_PedstalWidthADC > 0)
+    {
+      noise_prob = gsl_cdf_gaussian_Q(threshold - m_PedstalCentralADC, m_PedstalWidthADC);
+    }
+    else
+    {
+      noise_prob = ((int) m_PedstalCentralADC > m_ZeroSuppressionADC) ? 1 : 0;
+    }
+
+    m_BatchIndex[key] = m_BatchKeys.size();
+    m_BatchKeys.push_back(key);
+    m_BatchPedCentral.push_back(m_PedstalCentralADC);
+    m_BatchPedWidth.push_back(m_PedstalWidthADC);
+    m_BatchZeroSuppression.push_back(m_ZeroSuppressionADC);
+    m_BatchNoiseThreshold.push_back(threshold);
+    m_BatchNoiseProb.push_back(noise_prob);
+    m_BatchDead.push_back(m_DeadMap && m_DeadMap->isDeadTower(key));
+    m_BatchMaxNoiseProb = max(m_BatchMaxNoiseProb, noise_prob);
+  }
+  m_BatchHasSignal.assign(m_BatchKeys.size(), 0);
+
+  if (Verbosity())
+  {
+    cout << Name() << "::" << m_Detector << "::" << __PRETTY_FUNCTION__
+         << " towers: " << m_BatchKeys.size()
+         << ", max probability for an empty tower to pass zero suppression: " << m_BatchMaxNoiseProb
+         << endl;
+  }
+}
+
+int RawTowerDigitizer::batch_digitization()
+{
+  double deadChanEnergy = 0;
+
+  // towers with energy
+  m_BatchSignalIndex.clear();
+  m_BatchSignalTower.clear();
+  RawTowerContainer::ConstRange sim_range = m_SimTowers->getTowers();
+  for (RawTowerContainer::ConstIterator it = sim_range.first; it != sim_range.second; ++it)
+  {
+    const auto index_iter = m_BatchIndex.find(it->first);
+    if (index_iter == m_BatchIndex.end())
+    {
+      continue;
+    }
+    const unsigned int index = index_iter->second;
+    if (m_BatchDead[index])
+    {
+      // dead towers are digitized as empty towers
+      deadChanEnergy += it->second->get_energy();
+      continue;
+    }
+    m_BatchSignalIndex.push_back(index);
+    m_BatchSignalTower.push_back(it->second);
+  }
+
+  // photon statistics
+  const size_t nsignal = m_BatchSignalIndex.size();
+  m_BatchSignalADC.resize(nsignal);
+  for (size_t i = 0; i < nsignal; ++i)
+  {
+    const double photon_count_mean = m_BatchSignalTower[i]->get_energy() * m_PhotonElecYieldVisibleGeV;
+    if (m_DigiAlgorithm == kSimple_photon_digitization)
+    {
+      m_BatchSignalADC[i] = floor(gsl_ran_poisson(m_RandomGenerator, photon_count_mean) / m_PhotonElecADC);
+    }
+    else if (photon_count_mean > 0)
+    {
+      const double prob_activated_per_pixel = gsl_cdf_poisson_Q(0, photon_count_mean / m_SiPMEffectivePixel);
+      const double active_pixel = gsl_ran_binomial(m_RandomGenerator, prob_activated_per_pixel, m_SiPMEffectivePixel);
+      m_BatchSignalADC[i] = floor(active_pixel / m_PhotonElecADC);
+    }
+    else
+    {
+      m_BatchSignalADC[i] = 0;
+    }
+  }
+
+  // pedestal and zero suppression
+  for (size_t i = 0; i < nsignal; ++i)
+  {
+    const unsigned int index = m_BatchSignalIndex[i];
+    m_BatchHasSignal[index] = 1;
+    const double pedstal = m_BatchPedCentral[index] + ((m_BatchPedWidth[index] > 0) ? gsl_ran_gaussian(m_RandomGenerator, m_BatchPedWidth[index]) : 0);
+    const int sum_ADC = m_BatchSignalADC[i] + (int) pedstal;
+    if (sum_ADC > m_BatchZeroSuppression[index])
+    {
+      RawTower *digi_tower = new RawTowerv2(*m_BatchSignalTower[i]);
+      digi_tower->set_energy((double) sum_ADC);
+      m_RawTowers->AddTower(m_BatchKeys[index], digi_tower);
+    }
+  }
+
+  // empty towers. Towers passing the zero suppression are selected with the largest probability,
+  // skipping geometrically distributed numbers of towers, then thinned to their own probability.
+  // Their pedestal is drawn from the tail above the zero suppression threshold
+  if (m_BatchMaxNoiseProb > 0)
+  {
+    const size_t ntowers = m_BatchKeys.size();
+    for (size_t index = gsl_ran_geometric(m_RandomGenerator, m_BatchMaxNoiseProb) - 1;
+         index < ntowers;
+         index += gsl_ran_geometric(m_RandomGenerator, m_BatchMaxNoiseProb))
+    {
+      if (m_BatchHasSignal[index])
+      {
+        continue;
+      }
+      if (m_BatchNoiseProb[index] < m_BatchMaxNoiseProb && gsl_rng_uniform(m_RandomGenerator) * m_BatchMaxNoiseProb >= m_BatchNoiseProb[index])
+      {
+        continue;
+      }
+      double pedstal = m_BatchPedCentral[index];
+      if (m_BatchPedWidth[index] > 0)
+      {
+        pedstal += gsl_ran_gaussian_tail(m_RandomGenerator, m_BatchNoiseThreshold[index] - m_BatchPedCentral[index], m_BatchPedWidth[index]);
+      }
+      const int sum_ADC = (int) pedstal;
+      if (sum_ADC > m_BatchZeroSuppression[index])
+      {
+        RawTower *digi_tower = new RawTowerv2();
+        digi_tower->set_energy((double) sum_ADC);
+        m_RawTowers->AddTower(m_BatchKeys[index], digi_tower);
+      }
+    }
+  }
+
+  for (unsigned int index : m_BatchSignalIndex)
+  {
+    m_BatchHasSignal[index] = 0;
+  }
+
+  if (Verbosity())
+  {
+    cout << Name() << "::" << m_Detector << "::" << __PRETTY_FUNCTION__
+         << "input sum energy = " << m_SimTowers->getTotalEdep() << " GeV"
+         << ", dead channel masked energy = " << deadChanEnergy << " GeV"
+         << ", towers with energy = " << nsignal
+         << ", output towers = " << m_RawTowers->size()
+         << ", output sum digitalized value = " << m_RawTowers->getTotalEdep() << " ADC"
+         << endl;
+  }
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
 void RawTowerDigitizer::CreateNodes(PHCompositeNode *topNode)
 {
   PHNodeIterator iter(topNode);
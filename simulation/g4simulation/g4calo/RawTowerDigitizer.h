@@ -5,10 +5,15 @@
 
 #include <phparameter/PHParameters.h>
 
+#include <calobase/RawTowerDefs.h>
+
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 class PHCompositeNode;
 class RawTowerContainer;
+class RawTowerGeom;
 class RawTowerGeomContainer;
 class RawTowerDeadMap;
 
@@ -167,6 +172,13 @@ class RawTowerDigitizer : public SubsysReco
   // ! SiPM effective pixel per tower, only used with kSiPM_photon_digitalization
   unsigned int get_sipm_effective_pixel() { return m_SiPMEffectivePixel; }
 
+  //! digitize the whole calorimeter at once, only used with photon digitization.
+  //! Tower parameters are cached at InitRun, and pedestal noise is only sampled
+  //! for the empty towers passing the zero suppression, drawing from the tail of the pedestal distribution.
+  //! The output is statistically equivalent, but not identical, to the tower by tower digitization
+  void set_batch_digitization(const bool b) { m_BatchDigitization = b; }
+  bool get_batch_digitization() const { return m_BatchDigitization; }
+
  private:
   void CreateNodes(PHCompositeNode *topNode);
 
@@ -179,6 +191,15 @@ class RawTowerDigitizer : public SubsysReco
   //! this function use the effective pixel to count for the effect that the sipm is not evenly lit
   RawTower *sipm_photon_digitization(RawTower *sim_tower);
 
+  //! update pedestal and zero suppression from the tower parameters, if read from file
+  void update_tower_parameters(const RawTowerGeom *tower_geom);
+
+  //! cache per tower parameters for batch digitization
+  void init_batch_digitization();
+
+  //! digitize all towers at once
+  int batch_digitization();
+
   enu_digi_algorithm m_DigiAlgorithm;
 
   RawTowerContainer *m_SimTowers;
@@ -223,6 +244,38 @@ class RawTowerDigitizer : public SubsysReco
   PHParameters _tower_params;
 
   gsl_rng *m_RandomGenerator;
+
+  //!@name batch digitization
+  //@{
+  bool m_BatchDigitization = false;
+
+  //! tower index from key
+  std::unordered_map<RawTowerDefs::keytype, unsigned int> m_BatchIndex;
+
+  //! per tower parameters, as arrays
+  std::vector<RawTowerDefs::keytype> m_BatchKeys;
+  std::vector<double> m_BatchPedCentral;
+  std::vector<double> m_BatchPedWidth;
+  std::vector<double> m_BatchZeroSuppression;
+
+  //! pedestal value above which an empty tower passes the zero suppression
+  std::vector<double> m_BatchNoiseThreshold;
+
+  //! probability for an empty tower to pass the zero suppression
+  std::vector<double> m_BatchNoiseProb;
+  double m_BatchMaxNoiseProb = 0;
+
+  //! true for dead towers
+  std::vector<unsigned char> m_BatchDead;
+
+  //! per event: true for towers digitized from a sim tower
+  std::vector<unsigned char> m_BatchHasSignal;
+
+  //! per event: towers with energy, and their sim towers
+  std::vector<unsigned int> m_BatchSignalIndex;
+  std::vector<RawTower *> m_BatchSignalTower;
+  std::vector<double> m_BatchSignalADC;
+  //@}
 };
 
 #endif /* G4CALO_RAWTOWERDIGITIZER_H */
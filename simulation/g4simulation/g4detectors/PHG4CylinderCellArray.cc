@@ -0,0 +1,80 @@
+#include "PHG4CylinderCellArray.h"
+
+#include <utility>  // for forward_as_tuple, piecewise_construct
+
+PHG4CylinderCellArray::Layer::Layer(const int layer, const int binning, const int nphibins, const int nzbins)
+  : m_Layer(layer)
+  , m_Binning(binning)
+  , m_NPhiBins(nphibins)
+  , m_NZBins(nzbins)
+  , m_Edep(nphibins * nzbins, 0)
+  , m_LightYield(nphibins * nzbins, 0)
+  , m_FiredIndex(nphibins * nzbins, -1)
+{
+}
+
+PHG4CellDefs::keytype PHG4CylinderCellArray::Layer::get_cellkey(const unsigned int bin) const
+{
+  if (m_Binning == PHG4CellDefs::etaphibinning)
+  {
+    return PHG4CellDefs::EtaPhiBinning::genkey(m_Layer, get_zbin(bin), get_phibin(bin));
+  }
+  return PHG4CellDefs::SizeBinning::genkey(m_Layer, get_zbin(bin), get_phibin(bin));
+}
+
+double PHG4CylinderCellArray::Layer::get_total_edep() const
+{
+  double sum = 0;
+  for (unsigned int bin : m_FiredBins)
+  {
+    sum += m_Edep[bin];
+  }
+  return sum;
+}
+
+void PHG4CylinderCellArray::Layer::Reset()
+{
+  // only touch the bins which were fired, the arrays are mostly empty
+  for (unsigned int bin : m_FiredBins)
+  {
+    m_Edep[bin] = 0;
+    m_LightYield[bin] = 0;
+    m_FiredIndex[bin] = -1;
+  }
+  m_FiredBins.clear();
+  m_TruthLinks.clear();
+  m_HasLightYield = false;
+}
+
+PHG4CylinderCellArray::Layer &PHG4CylinderCellArray::add_layer(const int layer, const int binning, const int nphibins, const int nzbins)
+{
+  m_Layers.erase(layer);
+  return m_Layers.emplace(std::piecewise_construct,
+                          std::forward_as_tuple(layer),
+                          std::forward_as_tuple(layer, binning, nphibins, nzbins))
+      .first->second;
+}
+
+PHG4CylinderCellArray::Layer *PHG4CylinderCellArray::get_layer(const int layer)
+{
+  LayerMap::iterator iter = m_Layers.find(layer);
+  return iter == m_Layers.end() ? nullptr : &iter->second;
+}
+
+double PHG4CylinderCellArray::get_total_edep() const
+{
+  double sum = 0;
+  for (const auto &pair : m_Layers)
+  {
+    sum += pair.second.get_total_edep();
+  }
+  return sum;
+}
+
+void PHG4CylinderCellArray::Reset()
+{
+  for (auto &pair : m_Layers)
+  {
+    pair.second.Reset();
+  }
+}
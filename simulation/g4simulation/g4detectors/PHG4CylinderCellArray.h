@@ -0,0 +1,141 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef G4DETECTORS_PHG4CYLINDERCELLARRAY_H
+#define G4DETECTORS_PHG4CYLINDERCELLARRAY_H
+
+#include "PHG4CellDefs.h"
+
+#include <g4main/PHG4HitDefs.h>
+
+#include <map>
+#include <vector>
+
+/*!
+ * \brief transient, dense per layer storage of the cylinder cell energies.
+ *
+ * PHG4CylinderCellReco accumulates the g4hit energy in flat arrays indexed by phibin * nzbins + zbin,
+ * which are allocated once per run and cleared event by event, using the list of fired bins.
+ * Truth links (g4hit and shower contributions to each bin) are kept as a sparse list, when requested.
+ * The array is put on the node tree as a PHDataNode, it is not saved to the DST.
+ * RawTowerBuilder reads it directly when present, without going through PHG4Cell objects.
+ */
+class PHG4CylinderCellArray
+{
+ public:
+  //! contribution of one g4hit to one bin
+  struct TruthLink
+  {
+    unsigned int bin = 0;
+    PHG4HitDefs::keytype hitkey = 0;
+    int showerid = 0;
+    float edep = 0;
+  };
+
+  //! dense arrays for one layer
+  class Layer
+  {
+   public:
+    Layer(const int layer, const int binning, const int nphibins, const int nzbins);
+
+    int get_layer() const { return m_Layer; }
+    int get_binning() const { return m_Binning; }
+    int get_phibins() const { return m_NPhiBins; }
+    int get_zbins() const { return m_NZBins; }
+
+    //!@name bin index
+    //@{
+    unsigned int get_bin(const int phibin, const int zbin) const { return phibin * m_NZBins + zbin; }
+    int get_phibin(const unsigned int bin) const { return bin / m_NZBins; }
+    int get_zbin(const unsigned int bin) const { return bin % m_NZBins; }
+    //@}
+
+    //! PHG4Cell key matching a given bin (z bin is the eta bin for eta/phi binning)
+    PHG4CellDefs::keytype get_cellkey(const unsigned int bin) const;
+
+    //! add energy to bin
+    void add_edep(const unsigned int bin, const float edep)
+    {
+      if (m_FiredIndex[bin] < 0)
+      {
+        m_FiredIndex[bin] = m_FiredBins.size();
+        m_FiredBins.push_back(bin);
+      }
+      m_Edep[bin] += edep;
+    }
+
+    //! add light yield to bin. Must be called after add_edep for the same bin
+    void add_light_yield(const unsigned int bin, const float light_yield)
+    {
+      m_LightYield[bin] += light_yield;
+      m_HasLightYield = true;
+    }
+
+    //! add truth link
+    void add_truth_link(const unsigned int bin, const PHG4HitDefs::keytype hitkey, const int showerid, const float edep)
+    {
+      m_TruthLinks.push_back({bin, hitkey, showerid, edep});
+    }
+
+    float get_edep(const unsigned int bin) const { return m_Edep[bin]; }
+    float get_light_yield(const unsigned int bin) const { return m_LightYield[bin]; }
+
+    //! true if light yield was provided by the g4hits in this event
+    bool has_light_yield() const { return m_HasLightYield; }
+
+    //! position of bin in the list of fired bins, -1 if not fired
+    int get_fired_index(const unsigned int bin) const { return m_FiredIndex[bin]; }
+
+    //! bins which received energy in this event, in order of first deposit
+    const std::vector<unsigned int> &get_fired_bins() const { return m_FiredBins; }
+
+    //! truth links for this event
+    const std::vector<TruthLink> &get_truth_links() const { return m_TruthLinks; }
+
+    //! total energy deposited in this layer
+    double get_total_edep() const;
+
+    //! clear fired bins and truth links. Capacity is kept
+    void Reset();
+
+   private:
+    int m_Layer = 0;
+    int m_Binning = PHG4CellDefs::undefined;
+    int m_NPhiBins = 0;
+    int m_NZBins = 0;
+    bool m_HasLightYield = false;
+
+    std::vector<float> m_Edep;
+    std::vector<float> m_LightYield;
+    std::vector<int> m_FiredIndex;
+    std::vector<unsigned int> m_FiredBins;
+    std::vector<TruthLink> m_TruthLinks;
+  };
+
+  using LayerMap = std::map<int, Layer>;
+
+  virtual ~PHG4CylinderCellArray() = default;
+
+  //! add layer. Existing layer is replaced
+  Layer &add_layer(const int layer, const int binning, const int nphibins, const int nzbins);
+
+  //! layer arrays, nullptr if not found
+  Layer *get_layer(const int layer);
+
+  const LayerMap &get_layers() const { return m_Layers; }
+
+  //! true if truth links are recorded
+  bool has_truth_links() const { return m_TruthLinks; }
+  void set_truth_links(const bool value) { m_TruthLinks = value; }
+
+  //! total energy deposited in all layers
+  double get_total_edep() const;
+
+  //! clear all layers
+  void Reset();
+
+ private:
+  LayerMap m_Layers;
+  bool m_TruthLinks = true;
+};
+
+#endif
@@ -20,6 +20,7 @@
 #include <fun4all/SubsysReco.h>  // for SubsysReco
 
 #include <phool/PHCompositeNode.h>
+#include <phool/PHDataNode.h>
 #include <phool/PHIODataNode.h>
 #include <phool/PHNode.h>  // for PHNode
 #include <phool/PHNodeIterator.h>
@@ -52,6 +53,10 @@ int PHG4CylinderCellReco::ResetEvent(PHCompositeNode */*topNode*/)
 {
   sum_energy_before_cuts = 0.;
   sum_energy_g4hit = 0.;
+  if (m_CellArray)
+  {
+    m_CellArray->Reset();
+  }
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
@@ -91,23 +96,33 @@ int PHG4CylinderCellReco::InitRun(PHCompositeNode *topNode)
     cout << "Could not locate g4 hit node " << hitnodename << endl;
     exit(1);
   }
+  PHNodeIterator dstiter(dstNode);
+  PHCompositeNode *DetNode =
+      dynamic_cast<PHCompositeNode *>(dstiter.findFirst("PHCompositeNode",
+                                                        detector));
+  if (!DetNode)
+  {
+    DetNode = new PHCompositeNode(detector);
+    dstNode->addNode(DetNode);
+  }
   cellnodename = "G4CELL_" + outdetector;
   PHG4CellContainer *cells = findNode::getClass<PHG4CellContainer>(topNode, cellnodename);
-  if (!cells)
+  if (!cells && m_CellOutput)
   {
-    PHNodeIterator dstiter(dstNode);
-    PHCompositeNode *DetNode =
-        dynamic_cast<PHCompositeNode *>(dstiter.findFirst("PHCompositeNode",
-                                                          detector));
-    if (!DetNode)
-    {
-      DetNode = new PHCompositeNode(detector);
-      dstNode->addNode(DetNode);
-    }
     cells = new PHG4CellContainer();
     PHIODataNode<PHObject> *newNode = new PHIODataNode<PHObject>(cells, cellnodename.c_str(), "PHObject");
     DetNode->addNode(newNode);
   }
+  // transient cell array, not saved to the DST
+  cellarraynodename = "G4CELLARRAY_" + outdetector;
+  m_CellArray = findNode::getClass<PHG4CylinderCellArray>(topNode, cellarraynodename);
+  if (!m_CellArray)
+  {
+    m_CellArray = new PHG4CylinderCellArray();
+    DetNode->addNode(new PHDataNode<PHG4CylinderCellArray>(m_CellArray, cellarraynodename));
+  }
+  // cells cannot be filled without the g4hit and shower contributions
+  m_CellArray->set_truth_links(m_CellOutput || m_TruthLinks);
 
   geonodename = "CYLINDERGEOM_" + detector;
   PHG4CylinderGeomContainer *geo = findNode::getClass<PHG4CylinderGeomContainer>(topNode, geonodename.c_str());
@@ -328,6 +343,7 @@ int PHG4CylinderCellReco::InitRun(PHCompositeNode *topNode)
     }
     // add geo object filled by different binning methods
     seggeo->AddLayerCellGeom(layerseggeo);
+    m_CellArray->add_layer(layer, binning[layer], n_phi_z_bins[layer].first, n_phi_z_bins[layer].second);
     if (Verbosity() > 1)
     {
       layerseggeo->identify();
@@ -375,12 +391,17 @@ int PHG4CylinderCellReco::process_event(PHCompositeNode *topNode)
     cout << "Could not locate g4 hit node " << hitnodename << endl;
     exit(1);
   }
-  PHG4CellContainer *cells = findNode::getClass<PHG4CellContainer>(topNode, cellnodename);
-  if (!cells)
+  PHG4CellContainer *cells = nullptr;
+  if (m_CellOutput)
   {
-    cout << "could not locate cell node " << cellnodename << endl;
-    exit(1);
+    cells = findNode::getClass<PHG4CellContainer>(topNode, cellnodename);
+    if (!cells)
+    {
+      cout << "could not locate cell node " << cellnodename << endl;
+      exit(1);
+    }
   }
+  const bool truth_links = m_CellArray->has_truth_links();
 
   PHG4CylinderCellGeomContainer *seggeo = findNode::getClass<PHG4CylinderCellGeomContainer>(topNode, seggeonodename.c_str());
   if (!seggeo)
@@ -410,6 +431,7 @@ int PHG4CylinderCellReco::process_event(PHCompositeNode *topNode)
     PHG4CylinderCellGeom *geo = seggeo->GetLayerCellGeom(*layer);
     int nphibins = n_phi_z_bins[*layer].first;
     int nzbins = n_phi_z_bins[*layer].second;
+    PHG4CylinderCellArray::Layer *cellarray = m_CellArray->get_layer(*layer);
 
     // ------- eta/phi binning ------------------------------------------------------------------------
     if (binning[*layer] == PHG4CellDefs::etaphibinning)
@@ -537,45 +559,26 @@ int PHG4CylinderCellReco::process_event(PHCompositeNode *topNode)
           int iphibin = vphi[i1];
           int ietabin = veta[i1];
 
-          // This is the key for cellptmap
-          // It is constructed using the phi and z (or eta) bin index values
-          // It will be unique for a given phi and z (or eta) bin combination
-          unsigned long long tmp = iphibin;
-          unsigned long long key = tmp << 32;
-          key += ietabin;
+          const unsigned int bin = cellarray->get_bin(iphibin, ietabin);
           if (Verbosity() > 1)
           {
-            cout << " iphibin " << iphibin << " ietabin " << ietabin << " key 0x" << hex << key << dec << endl;
-          }
-          PHG4Cell *cell = nullptr;
-          it = cellptmap.find(key);
-          if (it != cellptmap.end())
-          {
-            cell = it->second;
-          }
-          else
-          {
-            PHG4CellDefs::keytype cellkey = PHG4CellDefs::EtaPhiBinning::genkey(*layer, ietabin, iphibin);
-            cell = new PHG4Cellv1(cellkey);
-            cellptmap[key] = cell;
+            cout << " iphibin " << iphibin << " ietabin " << ietabin << " bin " << bin << endl;
           }
-          if (!isfinite(hiter->second->get_edep() * vdedx[i1]))
+          const double edep = hiter->second->get_edep() * vdedx[i1];
+          // just a sanity check - we don't want to mess up by having Nan's or Infs in our energy deposition
+          if (!isfinite(edep))
           {
-            cout << "hit 0x" << hex << hiter->first << dec << " not finite, edep: "
-                 << hiter->second->get_edep() << " weight " << vdedx[i1] << endl;
+            cout << PHWHERE << " invalid energy dep " << hiter->second->get_edep()
+                 << " or path length: " << vdedx[i1] << endl;
           }
-          cell->add_edep(hiter->first, hiter->second->get_edep() * vdedx[i1]);  // add hit with edep to g4hit list
-          cell->add_edep(hiter->second->get_edep() * vdedx[i1]);                // add edep to cell
+          cellarray->add_edep(bin, edep);
           if (hiter->second->has_property(PHG4Hit::prop_light_yield))
           {
-            cell->add_light_yield(hiter->second->get_light_yield() * vdedx[i1]);
+            cellarray->add_light_yield(bin, hiter->second->get_light_yield() * vdedx[i1]);
           }
-          cell->add_shower_edep(hiter->second->get_shower_id(), hiter->second->get_edep() * vdedx[i1]);
-          // just a sanity check - we don't want to mess up by having Nan's or Infs in our energy deposition
-          if (!isfinite(hiter->second->get_edep() * vdedx[i1]))
+          if (truth_links)
           {
-            cout << PHWHERE << " invalid energy dep " << hiter->second->get_edep()
-                 << " or path length: " << vdedx[i1] << endl;
+            cellarray->add_truth_link(bin, hiter->first, hiter->second->get_shower_id(), edep);
           }
         }
         vphi.clear();
@@ -583,26 +586,9 @@ int PHG4CylinderCellReco::process_event(PHCompositeNode *topNode)
 
       }  // end loop over g4hits
 
-      int numcells = 0;
-
-      for (it = cellptmap.begin(); it != cellptmap.end(); ++it)
-      {
-        cells->AddCell(it->second);
-        numcells++;
-        if (Verbosity() > 1)
-        {
-          cout << "Adding cell in bin phi: " << PHG4CellDefs::EtaPhiBinning::get_phibin(it->second->get_cellid())
-               << " phi: " << geo->get_phicenter(PHG4CellDefs::EtaPhiBinning::get_phibin(it->second->get_cellid())) * 180. / M_PI
-               << ", eta bin: " << PHG4CellDefs::EtaPhiBinning::get_etabin(it->second->get_cellid())
-               << ", eta: " << geo->get_etacenter(PHG4CellDefs::EtaPhiBinning::get_etabin(it->second->get_cellid()))
-               << ", energy dep: " << it->second->get_edep()
-               << endl;
-        }
-      }
-
       if (Verbosity() > 0)
       {
-        cout << Name() << ": found " << numcells << " eta/phi cells with energy deposition" << endl;
+        cout << Name() << ": found " << cellarray->get_fired_bins().size() << " eta/phi cells with energy deposition" << endl;
       }
     }
 
@@ -768,101 +754,48 @@ int PHG4CylinderCellReco::process_event(PHCompositeNode *topNode)
           int iphibin = vphi[i1];
           int izbin = vz[i1];
 
-          unsigned long long tmp = iphibin;
-          unsigned long long key = tmp << 32;
-          key += izbin;
+          const unsigned int bin = cellarray->get_bin(iphibin, izbin);
           if (Verbosity() > 1)
           {
-            cout << " iphibin " << iphibin << " izbin " << izbin << " key 0x" << hex << key << dec << endl;
-          }
-          // check to see if there is already an entry for this cell
-          PHG4Cell *cell = nullptr;
-          it = cellptmap.find(key);
-
-          if (it != cellptmap.end())
-          {
-            cell = it->second;
-            if (Verbosity() > 1)
-            {
-              cout << "  add energy to existing cell for key = " << cellptmap.find(key)->first << endl;
-            }
-
-            if (Verbosity() > 1 && hiter->second->has_property(PHG4Hit::prop_light_yield) && std::isnan(hiter->second->get_light_yield() * vdedx[i1]))
-            {
-              cout << "    NAN lighy yield with vdedx[i1] = " << vdedx[i1]
-                   << " and hiter->second->get_light_yield() = " << hiter->second->get_light_yield() << endl;
-            }
-          }
-          else
-          {
-            if (Verbosity() > 1)
-            {
-              cout << "    did not find a previous entry for key = 0x" << hex << key << dec << " create a new one" << endl;
-            }
-            PHG4CellDefs::keytype cellkey = PHG4CellDefs::SizeBinning::genkey(*layer, izbin, iphibin);
-            cell = new PHG4Cellv1(cellkey);
-            cellptmap[key] = cell;
+            cout << " iphibin " << iphibin << " izbin " << izbin << " bin " << bin << endl;
           }
-          if (!isfinite(hiter->second->get_edep() * vdedx[i1]))
+          const double edep = hiter->second->get_edep() * vdedx[i1];
+          if (!isfinite(edep))
           {
             cout << "hit 0x" << hex << hiter->first << dec << " not finite, edep: "
                  << hiter->second->get_edep() << " weight " << vdedx[i1] << endl;
           }
-          cell->add_edep(hiter->first, hiter->second->get_edep() * vdedx[i1]);
-          cell->add_edep(hiter->second->get_edep() * vdedx[i1]);  // add edep to cell
+          cellarray->add_edep(bin, edep);
           if (hiter->second->has_property(PHG4Hit::prop_light_yield))
           {
-            cell->add_light_yield(hiter->second->get_light_yield() * vdedx[i1]);
+            cellarray->add_light_yield(bin, hiter->second->get_light_yield() * vdedx[i1]);
             if (Verbosity() > 1 && !std::isfinite(hiter->second->get_light_yield() * vdedx[i1]))
             {
               cout << "    NAN lighy yield with vdedx[i1] = " << vdedx[i1]
                    << " and hiter->second->get_light_yield() = " << hiter->second->get_light_yield() << endl;
             }
           }
-          cell->add_shower_edep(hiter->second->get_shower_id(), hiter->second->get_edep() * vdedx[i1]);
+          if (truth_links)
+          {
+            cellarray->add_truth_link(bin, hiter->first, hiter->second->get_shower_id(), edep);
+          }
         }
         vphi.clear();
         vz.clear();
 
       }  // end loop over hits
 
-      int numcells = 0;
-
-      for (it = cellptmap.begin(); it != cellptmap.end(); ++it)
-      {
-        cells->AddCell(it->second);
-        numcells++;
-        if (Verbosity() > 1)
-        {
-          cout << "Adding cell for key " << hex << it->first << dec << " in bin phi: " << PHG4CellDefs::SizeBinning::get_phibin(it->second->get_cellid())
-               << " phi: " << geo->get_phicenter(PHG4CellDefs::SizeBinning::get_phibin(it->second->get_cellid())) * 180. / M_PI
-               << ", z bin: " << PHG4CellDefs::SizeBinning::get_zbin(it->second->get_cellid())
-               << ", z: " << geo->get_zcenter(PHG4CellDefs::SizeBinning::get_zbin(it->second->get_cellid()))
-               << ", energy dep: " << it->second->get_edep()
-               << endl;
-        }
-      }
-
       if (Verbosity() > 0)
       {
-        cout << "found " << numcells << " z/phi cells with energy deposition" << endl;
+        cout << "found " << cellarray->get_fired_bins().size() << " z/phi cells with energy deposition" << endl;
       }
     }
 
     //==========================================================
-    // now reset the cell map before moving on to the next layer
-    if (Verbosity() > 1)
-    {
-      cout << "cellptmap for layer " << *layer << " has final length " << cellptmap.size();
-    }
-    while (cellptmap.begin() != cellptmap.end())
+    // cells are only created if they are stored on the node tree
+    if (cells)
     {
-      // Assumes that memmory is freed by the cylinder cell container when it is destroyed
-      cellptmap.erase(cellptmap.begin());
-    }
-    if (Verbosity() > 1)
-    {
-      cout << " reset it to " << cellptmap.size() << endl;
+      FillCells(*cellarray, cells, geo);
     }
   }
   if (chkenergyconservation)
@@ -911,26 +844,88 @@ void PHG4CylinderCellReco::set_timing_window(const int detid, const double tmin,
   return;
 }
 
+void PHG4CylinderCellReco::FillCells(const PHG4CylinderCellArray::Layer &cellarray, PHG4CellContainer *cells, PHG4CylinderCellGeom *geo)
+{
+  const std::vector<unsigned int> &fired_bins = cellarray.get_fired_bins();
+  std::vector<PHG4Cell *> newcells;
+  newcells.reserve(fired_bins.size());
+  for (unsigned int bin : fired_bins)
+  {
+    PHG4Cell *cell = new PHG4Cellv1(cellarray.get_cellkey(bin));
+    cell->add_edep(cellarray.get_edep(bin));
+    if (cellarray.has_light_yield())
+    {
+      cell->add_light_yield(cellarray.get_light_yield(bin));
+    }
+    newcells.push_back(cell);
+  }
+
+  // g4hit and shower contributions
+  for (const PHG4CylinderCellArray::TruthLink &link : cellarray.get_truth_links())
+  {
+    PHG4Cell *cell = newcells[cellarray.get_fired_index(link.bin)];
+    cell->add_edep(link.hitkey, link.edep);
+    cell->add_shower_edep(link.showerid, link.edep);
+  }
+
+  for (unsigned int i = 0; i < newcells.size(); ++i)
+  {
+    cells->AddCell(newcells[i]);
+    if (Verbosity() > 1)
+    {
+      const int phibin = cellarray.get_phibin(fired_bins[i]);
+      const int zbin = cellarray.get_zbin(fired_bins[i]);
+      cout << "Adding cell in bin phi: " << phibin
+           << " phi: " << geo->get_phicenter(phibin) * 180. / M_PI;
+      if (cellarray.get_binning() == PHG4CellDefs::etaphibinning)
+      {
+        cout << ", eta bin: " << zbin << ", eta: " << geo->get_etacenter(zbin);
+      }
+      else
+      {
+        cout << ", z bin: " << zbin << ", z: " << geo->get_zcenter(zbin);
+      }
+      cout << ", energy dep: " << newcells[i]->get_edep() << endl;
+    }
+  }
+}
+
 int PHG4CylinderCellReco::CheckEnergy(PHCompositeNode *topNode)
 {
-  PHG4CellContainer *cells = findNode::getClass<PHG4CellContainer>(topNode, cellnodename);
   double sum_energy_cells = 0.;
   double sum_energy_stored_hits = 0.;
   double sum_energy_stored_showers = 0.;
-  PHG4CellContainer::ConstRange cell_begin_end = cells->getCells();
-  PHG4CellContainer::ConstIterator citer;
-  for (citer = cell_begin_end.first; citer != cell_begin_end.second; ++citer)
+  if (m_CellOutput)
   {
-    sum_energy_cells += citer->second->get_edep();
-    PHG4Cell::EdepConstRange cellrange = citer->second->get_g4hits();
-    for (PHG4Cell::EdepConstIterator iter = cellrange.first; iter != cellrange.second; ++iter)
+    PHG4CellContainer *cells = findNode::getClass<PHG4CellContainer>(topNode, cellnodename);
+    PHG4CellContainer::ConstRange cell_begin_end = cells->getCells();
+    PHG4CellContainer::ConstIterator citer;
+    for (citer = cell_begin_end.first; citer != cell_begin_end.second; ++citer)
     {
-      sum_energy_stored_hits += iter->second;
+      sum_energy_cells += citer->second->get_edep();
+      PHG4Cell::EdepConstRange cellrange = citer->second->get_g4hits();
+      for (PHG4Cell::EdepConstIterator iter = cellrange.first; iter != cellrange.second; ++iter)
+      {
+        sum_energy_stored_hits += iter->second;
+      }
+      PHG4Cell::ShowerEdepConstRange shwrrange = citer->second->get_g4showers();
+      for (PHG4Cell::ShowerEdepConstIterator iter = shwrrange.first; iter != shwrrange.second; ++iter)
+      {
+        sum_energy_stored_showers += iter->second;
+      }
     }
-    PHG4Cell::ShowerEdepConstRange shwrrange = citer->second->get_g4showers();
-    for (PHG4Cell::ShowerEdepConstIterator iter = shwrrange.first; iter != shwrrange.second; ++iter)
+  }
+  else
+  {
+    // no cells, use the cell array
+    sum_energy_cells = m_CellArray->get_total_edep();
+    for (const auto &pair : m_CellArray->get_layers())
     {
-      sum_energy_stored_showers += iter->second;
+      for (const PHG4CylinderCellArray::TruthLink &link : pair.second.get_truth_links())
+      {
+        sum_energy_stored_hits += link.edep;
+        sum_energy_stored_showers += link.edep;
+      }
     }
   }
   // the fractional eloss for particles traversing eta bins leads to minute rounding errors
@@ -3,6 +3,8 @@
 #ifndef G4DETECTORS_PHG4CYLINDERCELLRECO_H
 #define G4DETECTORS_PHG4CYLINDERCELLRECO_H
 
+#include "PHG4CylinderCellArray.h"
+
 #include <phparameter/PHParameterContainerInterface.h>
 
 #include <fun4all/SubsysReco.h>
@@ -13,7 +15,8 @@
 #include <utility>  // for pair
 
 class PHCompositeNode;
-class PHG4Cell;
+class PHG4CellContainer;
+class PHG4CylinderCellGeom;
 
 class PHG4CylinderCellReco : public SubsysReco, public PHParameterContainerInterface
 {
@@ -42,10 +45,19 @@ class PHG4CylinderCellReco : public SubsysReco, public PHParameterContainerInter
   double get_timing_window_max(const int i) { return tmin_max[i].second; }
   void set_timing_window(const int detid, const double tmin, const double tmax);
 
+  //! store PHG4Cells in the G4CELL node (default). If false, only the transient cell array is filled
+  void set_cell_output(const bool b) { m_CellOutput = b; }
+
+  //! keep g4hit and shower contributions in the cell array when cells are not stored (default)
+  void set_truth_links(const bool b) { m_TruthLinks = b; }
+
  protected:
   void set_size(const int i, const double sizeA, const double sizeB);
   int CheckEnergy(PHCompositeNode *topNode);
 
+  //! create PHG4Cells from the fired bins of a layer
+  void FillCells(const PHG4CylinderCellArray::Layer &cellarray, PHG4CellContainer *cells, PHG4CylinderCellGeom *geo);
+
   std::map<int, int> binning;
   std::map<int, std::pair<double, double> > cell_size;  // cell size in phi/z
   std::map<int, std::pair<double, double> > zmin_max;   // zmin/zmax for each layer for faster lookup
@@ -56,15 +68,17 @@ class PHG4CylinderCellReco : public SubsysReco, public PHParameterContainerInter
   std::string outdetector;
   std::string hitnodename;
   std::string cellnodename;
+  std::string cellarraynodename;
   std::string geonodename;
   std::string seggeonodename;
   std::map<int, std::pair<int, int> > n_phi_z_bins;
-  std::map<unsigned long long, PHG4Cell *> cellptmap;  // This map holds the hit cells
-  std::map<unsigned long long, PHG4Cell *>::iterator it;
+  PHG4CylinderCellArray *m_CellArray = nullptr;  // dense per layer cell energies
   std::map<int, std::pair<double, double> > tmin_max;
 
   int nbins[2];
   int chkenergyconservation;
+  bool m_CellOutput = true;
+  bool m_TruthLinks = true;
 
   double sum_energy_before_cuts;
   double sum_energy_g4hit;
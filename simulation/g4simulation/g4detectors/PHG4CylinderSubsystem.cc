@@ -10,7 +10,9 @@
 #include <g4main/PHG4DisplayAction.h>  // for PHG4DisplayAction
 #include <g4main/PHG4HitContainer.h>
 #include <g4main/PHG4SteppingAction.h>  // for PHG4SteppingAction
+#include <g4main/PHG4SubEventMergeContext.h>
 #include <g4main/PHG4Utils.h>
+#include <g4main/PHG4WorkerActions.h>
 
 #include <phool/PHCompositeNode.h>
 #include <phool/PHIODataNode.h>    // for PHIODataNode
@@ -130,6 +132,7 @@ int PHG4CylinderSubsystem::InitRunSubsystem(PHCompositeNode *topNode)
     }
     PHG4CylinderGeom *mygeom = new PHG4CylinderGeomv1(GetParams()->get_double_param("radius"), GetParams()->get_double_param("place_z") - detlength / 2., GetParams()->get_double_param("place_z") + detlength / 2., GetParams()->get_double_param("thickness"));
     geo->AddLayerGeom(GetLayer(), mygeom);
+    m_HitNodeName = nodename;
     auto *tmp = new PHG4CylinderSteppingAction(this, m_Detector, GetParams());
     tmp->HitNodeName(nodename);
     m_SteppingAction = tmp;
@@ -157,6 +160,52 @@ int PHG4CylinderSubsystem::process_event(PHCompositeNode *topNode)
   return 0;
 }
 
+//_______________________________________________________________________
+int PHG4CylinderSubsystem::InitSubEventNode(PHCompositeNode *subEventNode)
+{
+  if (m_HitNodeName.empty())
+  {
+    return 0;
+  }
+  PHNodeIterator iter(subEventNode);
+  PHCompositeNode *dstNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", "DST"));
+  PHG4HitContainer *cylinder_hits = findNode::getClass<PHG4HitContainer>(subEventNode, m_HitNodeName);
+  if (!cylinder_hits)
+  {
+    dstNode->addNode(new PHIODataNode<PHObject>(cylinder_hits = new PHG4HitContainer(m_HitNodeName), m_HitNodeName, "PHObject"));
+  }
+  cylinder_hits->AddLayer(GetLayer());
+  return 0;
+}
+
+//_______________________________________________________________________
+void PHG4CylinderSubsystem::CreateWorkerActions(PHG4WorkerActions &actions)
+{
+  if (!m_SteppingAction)
+  {
+    return;
+  }
+  auto *tmp = new PHG4CylinderSteppingAction(this, m_Detector, GetParams());
+  if (!m_HitNodeName.empty())
+  {
+    tmp->HitNodeName(m_HitNodeName);
+  }
+  tmp->SaveAllHits(m_SaveAllHitsFlag);
+  actions.AddSteppingAction(tmp);
+}
+
+//_______________________________________________________________________
+int PHG4CylinderSubsystem::MergeSubEvent(PHCompositeNode *subEventNode, PHCompositeNode *topNode, PHG4SubEventMergeContext &context)
+{
+  if (m_HitNodeName.empty())
+  {
+    return 0;
+  }
+  // hit containers shared between layers of a super detector are merged by the first layer, the others find them empty
+  context.MergeHits(findNode::getClass<PHG4HitContainer>(subEventNode, m_HitNodeName), findNode::getClass<PHG4HitContainer>(topNode, m_HitNodeName));
+  return 0;
+}
+
 void PHG4CylinderSubsystem::SetDefaultParameters()
 {
   set_default_double_param("length", NAN);
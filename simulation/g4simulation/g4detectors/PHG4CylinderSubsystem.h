@@ -38,6 +38,14 @@ class PHG4CylinderSubsystem : public PHG4DetectorSubsystem
   */
   int process_event(PHCompositeNode*) override;
 
+  //!@name multithreaded running
+  //@{
+  bool SupportsWorkerThreads() const override { return true; }
+  int InitSubEventNode(PHCompositeNode*) override;
+  void CreateWorkerActions(PHG4WorkerActions&) override;
+  int MergeSubEvent(PHCompositeNode* subEventNode, PHCompositeNode* topNode, PHG4SubEventMergeContext&) override;
+  //@}
+
   //! Print info (from SubsysReco)
   void Print(const std::string& what = "ALL") const override;
 
@@ -79,6 +87,10 @@ class PHG4CylinderSubsystem : public PHG4DetectorSubsystem
   PHG4DisplayAction* m_DisplayAction = nullptr;
 
   bool m_SaveAllHitsFlag = false;
+
+  //! hit node name, for active layers
+  std::string m_HitNodeName;
+
   //! Color setting if we want to override the default
   std::array<double, 4> m_ColorArray;
 };
@@ -664,51 +664,14 @@ void DSTEmulator::evaluate_tracks()
      ActsTrackingGeometry *tGeometry,
      TrkrDefs::subsurfkey& subsurfkey){
      */
-    std::map<TrkrDefs::hitsetkey, std::vector<Surface>>::iterator mapIter;
-    mapIter = m_surfMaps->tpcSurfaceMap.find(hitsetkey);
-    
-    if(mapIter == m_surfMaps->tpcSurfaceMap.end()){
+    TrkrDefs::subsurfkey subsurfkey = 0;
+    Surface surface = m_surfMaps->getTpcSurface(hitsetkey, global[0], global[1], global[2], subsurfkey);
+    if(!surface){
       std::cout << PHWHERE 
-		<< "Error: hitsetkey not found in clusterSurfaceMap, layer = " << 
-	trk_r//layer 
-		<< " hitsetkey = "
+		<< "Error: TPC surface index not defined, skipping cluster! hitsetkey = "
 		<< hitsetkey << std::endl;
-      continue;// nullptr;
-    }
-
-    double global_phi = atan2(global[1], global[0]);
-    double global_z = global[2];
-  
-    std::vector<Surface> surf_vec = mapIter->second;
-    unsigned int surf_index = 999;
-  
-    double surfStepPhi = m_tGeometry->tpcSurfStepPhi;
-    double surfStepZ = m_tGeometry->tpcSurfStepZ;
-
-    for(unsigned int i=0;i<surf_vec.size(); ++i){
-      Surface this_surf = surf_vec[i];
-      auto vec3d = this_surf->center(m_tGeometry->geoContext);
-      std::vector<double> surf_center = {vec3d(0) / 10.0, vec3d(1) / 10.0, vec3d(2) / 10.0};  // convert from mm to cm
-      double surf_phi = atan2(surf_center[1], surf_center[0]);
-      double surf_z = surf_center[2];
-      
-      if( (global_phi > surf_phi - surfStepPhi / 2.0 && global_phi < surf_phi + surfStepPhi / 2.0 ) &&
-	  (global_z > surf_z - surfStepZ / 2.0 && global_z < surf_z + surfStepZ / 2.0) ){
-	surf_index = i;	  
-	break;
-      }
-    }
-  
-    //   subsurfkey = surf_index;
-
-    if(surf_index == 999){
-      std::cout << PHWHERE 
-		<< "Error: TPC surface index not defined, skipping cluster!" 
-		<< std::endl;
       continue;
     }
-    
-    Surface surface = surf_vec[surf_index];
 
     Acts::Vector3D center = surface->center(m_tGeometry->geoContext) 
       / Acts::UnitConstants::cm;
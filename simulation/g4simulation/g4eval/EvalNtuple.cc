@@ -0,0 +1,147 @@
+#include "EvalNtuple.h"
+
+#include <TNtuple.h>
+#include <TTree.h>
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+const Int_t EvalNtuple::kIntNaN = std::numeric_limits<Int_t>::min();
+
+EvalNtuple::EvalNtuple(const std::string &name, const std::string &title, const std::string &varlist, const bool columnar)
+  : m_Columnar(columnar)
+{
+  std::istringstream vars(varlist);
+  std::string column;
+  while (std::getline(vars, column, ':'))
+  {
+    m_Columns.push_back(column);
+  }
+  m_Types.assign(m_Columns.size(), kFloat);
+
+  if (m_Columnar)
+  {
+    m_Tree = new TTree(name.c_str(), title.c_str());
+  }
+  else
+  {
+    m_Ntuple = new TNtuple(name.c_str(), title.c_str(), varlist.c_str());
+    m_Tree = m_Ntuple;
+  }
+}
+
+bool EvalNtuple::set_column_type(const std::string &column, const ColumnType type)
+{
+  if (m_Branched)
+  {
+    std::cout << "EvalNtuple::set_column_type - " << m_Tree->GetName()
+              << " is already filled, cannot change type of " << column << std::endl;
+    return false;
+  }
+  bool found = false;
+  for (unsigned int i = 0; i < m_Columns.size(); ++i)
+  {
+    if (m_Columns[i] == column)
+    {
+      m_Types[i] = type;
+      found = true;
+    }
+  }
+  return found;
+}
+
+void EvalNtuple::set_float16_bits(const unsigned int nbits)
+{
+  if (nbits < 2 || nbits > 14)
+  {
+    std::cout << "EvalNtuple::set_float16_bits - " << nbits
+              << " mantissa bits not supported, use 2 - 14" << std::endl;
+    return;
+  }
+  m_Float16Bits = nbits;
+}
+
+void EvalNtuple::set_auto_flush(const Long64_t autoflush)
+{
+  m_Tree->SetAutoFlush(autoflush);
+}
+
+void EvalNtuple::CreateBranches()
+{
+  m_Branched = true;
+  if (m_Columnar)
+  {
+    // sized once, the branches keep the addresses of the elements
+    m_FloatBuffer.assign(m_Columns.size(), 0);
+    m_IntBuffer.assign(m_Columns.size(), 0);
+    for (unsigned int i = 0; i < m_Columns.size(); ++i)
+    {
+      const std::string &column = m_Columns[i];
+      switch (m_Types[i])
+      {
+      case kInt:
+        m_Tree->Branch(column.c_str(), &m_IntBuffer[i], (column + "/I").c_str());
+        break;
+      case kFloat16:
+      {
+        std::ostringstream leaf;
+        leaf << column << "/f[0,0," << m_Float16Bits << "]";
+        m_Tree->Branch(column.c_str(), &m_FloatBuffer[i], leaf.str().c_str());
+        break;
+      }
+      default:
+        m_Tree->Branch(column.c_str(), &m_FloatBuffer[i], (column + "/F").c_str());
+        break;
+      }
+    }
+  }
+  if (m_BasketSize > 0)
+  {
+    m_Tree->SetBasketSize("*", m_BasketSize);
+  }
+}
+
+Int_t EvalNtuple::Fill(const Float_t *row)
+{
+  if (!m_Branched)
+  {
+    CreateBranches();
+  }
+  if (!m_Columnar)
+  {
+    return m_Ntuple->Fill(row);
+  }
+  for (unsigned int i = 0; i < m_Columns.size(); ++i)
+  {
+    if (m_Types[i] == kInt)
+    {
+      const Float_t value = row[i];
+      // the negated comparison is true for NaN, 2^31 is the first float above the Int_t range
+      if (!(value >= -2147483648.F && value < 2147483648.F))
+      {
+        m_IntBuffer[i] = kIntNaN;
+      }
+      else
+      {
+        m_IntBuffer[i] = static_cast<Int_t>(std::lround(value));
+      }
+    }
+    else
+    {
+      m_FloatBuffer[i] = row[i];
+    }
+  }
+  return m_Tree->Fill();
+}
+
+Int_t EvalNtuple::Write()
+{
+  // an empty ntuple still gets its columns
+  if (!m_Branched)
+  {
+    CreateBranches();
+  }
+  return m_Tree->Write();
+}
@@ -0,0 +1,90 @@
+#ifndef G4EVAL_EVALNTUPLE_H
+#define G4EVAL_EVALNTUPLE_H
+
+#include <Rtypes.h>
+
+#include <string>
+#include <vector>
+
+class TNtuple;
+class TTree;
+
+/// \class EvalNtuple
+///
+/// \brief flat ntuple output of the evaluators, as TNtuple or as typed TTree
+///
+/// Takes the TNtuple variable list and rows of floats, so the evaluators
+/// fill it exactly like a TNtuple. By default a TNtuple is written. In
+/// columnar mode a TTree with one branch per variable is written instead,
+/// where each column can be stored as
+///  - kFloat:   Float_t (the default)
+///  - kInt:     Int_t, for ids and counters. NaN (and values outside the
+///              Int_t range) are stored as kIntNaN
+///  - kFloat16: Float16_t keeping only nbits of the mantissa ("/f[0,0,nbits]"),
+///              a lossy format for columns which do not need float precision
+///
+/// The column types have to be set before the first Fill. Basket size and
+/// auto flush apply to both modes, larger baskets mean fewer and larger
+/// (compressed) basket writes.
+///
+class EvalNtuple
+{
+ public:
+  enum ColumnType
+  {
+    kFloat = 0,
+    kInt = 1,
+    kFloat16 = 2
+  };
+
+  //! value of an Int_t column for a NaN entry
+  static const Int_t kIntNaN;
+
+  //! creates the ntuple in the current directory
+  EvalNtuple(const std::string &name, const std::string &title, const std::string &varlist, const bool columnar = false);
+  virtual ~EvalNtuple() = default;
+
+  bool is_columnar() const { return m_Columnar; }
+
+  //! type of a column, ignored for a TNtuple. Returns false if there is no such column
+  bool set_column_type(const std::string &column, const ColumnType type);
+
+  //! mantissa bits kept in the kFloat16 columns (2 - 14, default 12)
+  void set_float16_bits(const unsigned int nbits);
+
+  //! basket size in bytes for all branches (ROOT default is 32000)
+  void set_basket_size(const Int_t bytes) { m_BasketSize = bytes; }
+
+  //! auto flush: > 0 entries, < 0 bytes (see TTree::SetAutoFlush)
+  void set_auto_flush(const Long64_t autoflush);
+
+  const std::vector<std::string> &get_columns() const { return m_Columns; }
+
+  //! fill one row, it needs one value for each column
+  Int_t Fill(const Float_t *row);
+
+  Int_t Write();
+
+  //! the TNtuple or TTree, owned by its directory
+  TTree *get_tree() { return m_Tree; }
+
+ private:
+  void CreateBranches();
+
+  bool m_Columnar = false;
+  bool m_Branched = false;
+  unsigned int m_Float16Bits = 12;
+  Int_t m_BasketSize = 0;
+
+  TNtuple *m_Ntuple = nullptr;
+  TTree *m_Tree = nullptr;
+
+  std::vector<std::string> m_Columns;
+  std::vector<ColumnType> m_Types;
+
+  //! branch buffers of the columnar mode, one of them is used per column
+  std::vector<Float_t> m_FloatBuffer;
+  std::vector<Int_t> m_IntBuffer;
+};
+
+#endif  // G4EVAL_EVALNTUPLE_H
@@ -1,5 +1,6 @@
 #include "SvtxEvaluator.h"
 
+#include "EvalNtuple.h"
 #include "SvtxEvalStack.h"
 
 #include "SvtxClusterEval.h"
@@ -45,7 +46,6 @@
 #include <phool/recoConsts.h>
 
 #include <TFile.h>
-#include <TNtuple.h>
 #include <TVector3.h>
 
 #include <cmath>
@@ -60,6 +60,23 @@
 
 using namespace std;
 
+namespace
+{
+  // columns holding ids and counters, stored as Int_t in the columnar output
+  const std::vector<std::string> int_columns = {
+      "event", "seed", "layer", "glayer", "phielem", "zelem", "size", "niter",
+      "trackID", "gtrackID", "gflavor", "gflav", "gembed", "gprimary", "gnembed",
+      "ntracks", "gntracks", "gntracksmaps", "nclusters", "nparticles", "nreco", "ntrk", "charge",
+      "nhits", "nmaps", "nintt", "ntpc", "nmms", "ntpc1", "ntpc11", "ntpc2", "ntpc3",
+      "nlmaps", "nlintt", "nltpc", "nlmms", "layers",
+      "gnhits", "gnmaps", "gnintt", "gntpc", "gnmms", "gnlmaps", "gnlintt", "gnltpc", "gnlmms",
+      "gnintt1", "gnintt2", "gnintt3", "gnintt4", "gnintt5", "gnintt6", "gnintt7", "gnintt8",
+      "nfromtruth", "nwrong", "ntrumaps", "ntruintt", "ntrutpc", "ntrumms",
+      "ntrutpc1", "ntrutpc11", "ntrutpc2", "ntrutpc3", "layersfromtruth",
+      "nhittpcall", "nhittpcin", "nhittpcmid", "nhittpcout",
+      "nclusall", "nclustpc", "nclusintt", "nclusmaps", "nclusmms"};
+}  // namespace
+
 SvtxEvaluator::SvtxEvaluator(const string& /*name*/, const string& filename, const string& trackmapname,
                              unsigned int nlayers_maps,
                              unsigned int nlayers_intt,
@@ -118,14 +135,14 @@ int SvtxEvaluator::Init(PHCompositeNode* /*topNode*/)
   _ievent = 0;
 
   _tfile = new TFile(_filename.c_str(), "RECREATE");
-  _tfile->SetCompressionLevel(0);
-  if (_do_info_eval) _ntp_info = new TNtuple("ntp_info", "event info",
+  _tfile->SetCompressionSettings(_compression_settings);
+  if (_do_info_eval) _ntp_info = makeNtuple("ntp_info", "event info",
                                                  "event:seed:"
 					         "occ11:occ116:occ21:occ216:occ31:occ316:"
                                                  "gntrkall:gntrkprim:ntrk:"
                                                  "nhittpcall:nhittpcin:nhittpcmid:nhittpcout:nclusall:nclustpc:nclusintt:nclusmaps:nclusmms");
 
-  if (_do_vertex_eval) _ntp_vertex = new TNtuple("ntp_vertex", "vertex => max truth",
+  if (_do_vertex_eval) _ntp_vertex = makeNtuple("ntp_vertex", "vertex => max truth",
 						 "event:seed:vx:vy:vz:ntracks:chi2:ndof:"
 						 "gvx:gvy:gvz:gvt:gembed:gntracks:gntracksmaps:"
 						 "gnembed:nfromtruth:"
@@ -133,13 +150,13 @@ int SvtxEvaluator::Init(PHCompositeNode* /*topNode*/)
 
     
     
-  if (_do_gpoint_eval) _ntp_gpoint = new TNtuple("ntp_gpoint", "g4point => best vertex",
+  if (_do_gpoint_eval) _ntp_gpoint = makeNtuple("ntp_gpoint", "g4point => best vertex",
                                                  "event:seed:gvx:gvy:gvz:gvt:gntracks:gembed:"
                                                  "vx:vy:vz:ntracks:"
                                                  "nfromtruth:"
                                                  "nhittpcall:nhittpcin:nhittpcmid:nhittpcout:nclusall:nclustpc:nclusintt:nclusmaps:nclusmms");
 
-  if (_do_g4hit_eval) _ntp_g4hit = new TNtuple("ntp_g4hit", "g4hit => best svtxcluster",
+  if (_do_g4hit_eval) _ntp_g4hit = makeNtuple("ntp_g4hit", "g4hit => best svtxcluster",
                                                "event:seed:g4hitID:gx:gy:gz:gt:gpl:gedep:geta:gphi:"
                                                "gdphi:gdz:"
                                                "glayer:gtrackID:gflavor:"
@@ -151,7 +168,7 @@ int SvtxEvaluator::Init(PHCompositeNode* /*topNode*/)
                                                "efromtruth:dphitru:detatru:dztru:drtru:"
                                                "nhittpcall:nhittpcin:nhittpcmid:nhittpcout:nclusall:nclustpc:nclusintt:nclusmaps:nclusmms");
 
-  if (_do_hit_eval) _ntp_hit = new TNtuple("ntp_hit", "svtxhit => max truth",
+  if (_do_hit_eval) _ntp_hit = makeNtuple("ntp_hit", "svtxhit => max truth",
                                            "event:seed:hitID:e:adc:layer:phielem:zelem:"
                                            "cellID:ecell:phibin:zbin:phi:z:"
                                            "g4hitID:gedep:gx:gy:gz:gt:"
@@ -161,7 +178,7 @@ int SvtxEvaluator::Init(PHCompositeNode* /*topNode*/)
                                            "gembed:gprimary:efromtruth:"
                                            "nhittpcall:nhittpcin:nhittpcmid:nhittpcout:nclusall:nclustpc:nclusintt:nclusmaps:nclusmms");
 
-  if (_do_cluster_eval) _ntp_cluster = new TNtuple("ntp_cluster", "svtxcluster => max truth",
+  if (_do_cluster_eval) _ntp_cluster = makeNtuple("ntp_cluster", "svtxcluster => max truth",
                                                    "event:seed:hitID:x:y:z:r:phi:eta:theta:ex:ey:ez:ephi:"
                                                    "e:adc:maxadc:layer:phielem:zelem:size:"
                                                    "trackID:niter:g4hitID:gx:"
@@ -171,10 +188,10 @@ int SvtxEvaluator::Init(PHCompositeNode* /*topNode*/)
                                                    "gembed:gprimary:efromtruth:nparticles:"
                                                    "nhittpcall:nhittpcin:nhittpcmid:nhittpcout:nclusall:nclustpc:nclusintt:nclusmaps:nclusmms");
 
-  if (_do_g4cluster_eval) _ntp_g4cluster = new TNtuple("ntp_g4cluster", "g4cluster => max truth",
+  if (_do_g4cluster_eval) _ntp_g4cluster = makeNtuple("ntp_g4cluster", "g4cluster => max truth",
 						       "event:layer:gx:gy:gz:gt:gedep:gr:gphi:geta:gtrackID:gflavor:gembed:gprimary:gphisize:gzsize:gadc:nreco:x:y:z:r:phi:eta:ex:ey:ez:ephi:adc"); 
                                                        
-  if (_do_gtrack_eval) _ntp_gtrack = new TNtuple("ntp_gtrack", "g4particle => best svtxtrack",
+  if (_do_gtrack_eval) _ntp_gtrack = makeNtuple("ntp_gtrack", "g4particle => best svtxtrack",
                                                  "event:seed:gntracks:gtrackID:gflavor:gnhits:gnmaps:gnintt:gnmms:"
                                                  "gnintt1:gnintt2:gnintt3:gnintt4:"
                                                  "gnintt5:gnintt6:gnintt7:gnintt8:"
@@ -188,7 +205,7 @@ int SvtxEvaluator::Init(PHCompositeNode* /*topNode*/)
                                                  "dca2d:dca2dsigma:dca3dxy:dca3dxysigma:dca3dz:dca3dzsigma:pcax:pcay:pcaz:nfromtruth:nwrong:ntrumaps:ntruintt:ntrutpc:ntrumms:ntrutpc1:ntrutpc11:ntrutpc2:ntrutpc3:layersfromtruth:"
                                                  "nhittpcall:nhittpcin:nhittpcmid:nhittpcout:nclusall:nclustpc:nclusintt:nclusmaps:nclusmms");
 
-  if (_do_track_eval) _ntp_track = new TNtuple("ntp_track", "svtxtrack => max truth",
+  if (_do_track_eval) _ntp_track = makeNtuple("ntp_track", "svtxtrack => max truth",
                                                "event:seed:trackID:px:py:pz:pt:eta:phi:deltapt:deltaeta:deltaphi:charge:"
                                                "quality:chisq:ndf:nhits:nmaps:nintt:ntpc:nmms:ntpc1:ntpc11:ntpc2:ntpc3:nlmaps:nlintt:nltpc:nlmms:layers:"
                                                "dca2d:dca2dsigma:dca3dxy:dca3dxysigma:dca3dz:dca3dzsigma:pcax:pcay:pcaz:"
@@ -204,7 +221,7 @@ int SvtxEvaluator::Init(PHCompositeNode* /*topNode*/)
 					       "ntrutpc:ntrumms:ntrutpc1:ntrutpc11:ntrutpc2:ntrutpc3:layersfromtruth:"
                                                "nhittpcall:nhittpcin:nhittpcmid:nhittpcout:nclusall:nclustpc:nclusintt:nclusmaps:nclusmms");
 
-  if (_do_gseed_eval) _ntp_gseed = new TNtuple("ntp_gseed", "seeds from truth",
+  if (_do_gseed_eval) _ntp_gseed = makeNtuple("ntp_gseed", "seeds from truth",
                                                "event:seed:ntrk:gx:gy:gz:gr:geta:gphi:"
                                                "glayer:"
                                                "gpx:gpy:gpz:gtpt:gtphi:gteta:"
@@ -305,6 +322,14 @@ int SvtxEvaluator::End(PHCompositeNode* /*topNode*/)
 
   delete _tfile;
 
+  // the trees went with the file
+  for (EvalNtuple** ntp : {&_ntp_info, &_ntp_vertex, &_ntp_gpoint, &_ntp_g4hit, &_ntp_hit,
+                           &_ntp_cluster, &_ntp_g4cluster, &_ntp_gtrack, &_ntp_track, &_ntp_gseed})
+  {
+    delete *ntp;
+    *ntp = nullptr;
+  }
+
   if (Verbosity() > 1)
   {
     cout << "========================= SvtxEvaluator::End() ============================" << endl;
@@ -330,6 +355,79 @@ int SvtxEvaluator::End(PHCompositeNode* /*topNode*/)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+EvalNtuple* SvtxEvaluator::makeNtuple(const std::string& name, const std::string& title, const std::string& varlist)
+{
+  EvalNtuple* ntp = new EvalNtuple(name, title, varlist, _columnar_output);
+  if (_columnar_output)
+  {
+    for (const std::string& column : int_columns)
+    {
+      ntp->set_column_type(column, EvalNtuple::kInt);
+    }
+    ntp->set_float16_bits(_float16_bits);
+    for (const std::string& column : _float16_columns)
+    {
+      ntp->set_column_type(column, EvalNtuple::kFloat16);
+    }
+  }
+  if (_basket_size > 0)
+  {
+    ntp->set_basket_size(_basket_size);
+  }
+  return ntp;
+}
+
+int SvtxEvaluator::particleTruthIndex(PHG4Particle* g4particle, SvtxTruthEval* trutheval)
+{
+  if (!g4particle)
+  {
+    return -1;
+  }
+  std::unordered_map<PHG4Particle*, int>::const_iterator iter = _particle_index.find(g4particle);
+  if (iter != _particle_index.end())
+  {
+    return iter->second;
+  }
+
+  ParticleTruth truth;
+  truth.gtrackID = g4particle->get_track_id();
+  truth.gflavor = g4particle->get_pid();
+  truth.gpx = g4particle->get_px();
+  truth.gpy = g4particle->get_py();
+  truth.gpz = g4particle->get_pz();
+
+  PHG4VtxPoint* vtx = trutheval->get_vertex(g4particle);
+  if (vtx)
+  {
+    truth.gvx = vtx->get_x();
+    truth.gvy = vtx->get_y();
+    truth.gvz = vtx->get_z();
+    truth.gvt = vtx->get_t();
+  }
+
+  PHG4Hit* outerhit = nullptr;
+  if (_do_eval_light == false)
+    outerhit = trutheval->get_outermost_truth_hit(g4particle);
+  if (outerhit)
+  {
+    truth.has_outerhit = true;
+    truth.gfpx = outerhit->get_px(1);
+    truth.gfpy = outerhit->get_py(1);
+    truth.gfpz = outerhit->get_pz(1);
+    truth.gfx = outerhit->get_x(1);
+    truth.gfy = outerhit->get_y(1);
+    truth.gfz = outerhit->get_z(1);
+  }
+
+  truth.gembed = trutheval->get_embed(g4particle);
+  truth.gprimary = trutheval->is_primary(g4particle);
+
+  const int index = _particle_truth.size();
+  _particle_truth.push_back(truth);
+  _particle_index.insert(std::make_pair(g4particle, index));
+  return index;
+}
+
 void SvtxEvaluator::printInputInfo(PHCompositeNode* topNode)
 {
   if (Verbosity() > 1) cout << "SvtxEvaluator::printInputInfo() entered" << endl;
@@ -797,6 +895,9 @@ void SvtxEvaluator::fillOutputNtuples(PHCompositeNode* topNode)
   SvtxHitEval* hiteval = _svtxevalstack->get_hit_eval();
   SvtxTruthEval* trutheval = _svtxevalstack->get_truth_eval();
 
+  _particle_truth.clear();
+  _particle_index.clear();
+
   float nhit_tpc_all = 0;
   float nhit_tpc_in = 0;
   float nhit_tpc_mid = 0;
@@ -1315,6 +1416,8 @@ void SvtxEvaluator::fillOutputNtuples(PHCompositeNode* topNode)
       cout << "Filling ntp_g4hit " << endl;
       _timer->restart();
     }
+    TrkrClusterContainer* clustermap = findNode::getClass<TrkrClusterContainer>(topNode, "TRKR_CLUSTER");
+    TrkrClusterHitAssoc *cluster_hit_map = findNode::getClass<TrkrClusterHitAssoc>(topNode, "TRKR_CLUSTERHITASSOC");
     std::set<PHG4Hit*> g4hits = trutheval->all_truth_hits();
     for (std::set<PHG4Hit*>::iterator iter = g4hits.begin();
          iter != g4hits.end();
@@ -1362,40 +1465,33 @@ void SvtxEvaluator::fillOutputNtuples(PHCompositeNode* topNode)
 
       if (g4particle)
       {
+        const ParticleTruth& truth = _particle_truth[particleTruthIndex(g4particle, trutheval)];
         if (_scan_for_embedded)
         {
-          if (trutheval->get_embed(g4particle) <= 0) continue;
+          if (truth.gembed <= 0) continue;
         }
 
-        gflavor = g4particle->get_pid();
-        gpx = g4particle->get_px();
-        gpy = g4particle->get_py();
-        gpz = g4particle->get_pz();
+        gflavor = truth.gflavor;
+        gpx = truth.gpx;
+        gpy = truth.gpy;
+        gpz = truth.gpz;
 
-        PHG4VtxPoint* vtx = trutheval->get_vertex(g4particle);
+        gvx = truth.gvx;
+        gvy = truth.gvy;
+        gvz = truth.gvz;
 
-        if (vtx)
+        if (truth.has_outerhit)
         {
-          gvx = vtx->get_x();
-          gvy = vtx->get_y();
-          gvz = vtx->get_z();
+          gfpx = truth.gfpx;
+          gfpy = truth.gfpy;
+          gfpz = truth.gfpz;
+          gfx = truth.gfx;
+          gfy = truth.gfy;
+          gfz = truth.gfz;
         }
-        PHG4Hit* outerhit = nullptr;
-        if (_do_eval_light == false)
-          outerhit = trutheval->get_outermost_truth_hit(g4particle);
 
-        if (outerhit)
-        {
-          gfpx = outerhit->get_px(1);
-          gfpy = outerhit->get_py(1);
-          gfpz = outerhit->get_pz(1);
-          gfx = outerhit->get_x(1);
-          gfy = outerhit->get_y(1);
-          gfz = outerhit->get_z(1);
-        }
-
-        gembed = trutheval->get_embed(g4particle);
-        gprimary = trutheval->is_primary(g4particle);
+        gembed = truth.gembed;
+        gprimary = truth.gprimary;
       }  //       if (g4particle)
 
       std::set<TrkrDefs::cluskey> clusters = clustereval->all_clusters_from(g4hit);
@@ -1420,7 +1516,6 @@ void SvtxEvaluator::fillOutputNtuples(PHCompositeNode* topNode)
       float dztru = NAN;
       float drtru = NAN;
 
-      TrkrClusterContainer* clustermap = findNode::getClass<TrkrClusterContainer>(topNode, "TRKR_CLUSTER");
       TrkrCluster *cluster = clustermap->findCluster(cluster_key);
 
       if (cluster)
@@ -1439,7 +1534,6 @@ void SvtxEvaluator::fillOutputNtuples(PHCompositeNode* topNode)
         size = 0.0;
 	// count all hits for this cluster
 
-	TrkrClusterHitAssoc *cluster_hit_map = findNode::getClass<TrkrClusterHitAssoc>(topNode, "TRKR_CLUSTERHITASSOC");
 	std::pair<std::multimap<TrkrDefs::cluskey, TrkrDefs::hitkey>::const_iterator, std::multimap<TrkrDefs::cluskey, TrkrDefs::hitkey>::const_iterator> 
 	  hitrange = cluster_hit_map->getHits(cluster_key);  
 	for(std::multimap<TrkrDefs::cluskey, TrkrDefs::hitkey>::const_iterator
@@ -1619,41 +1713,32 @@ void SvtxEvaluator::fillOutputNtuples(PHCompositeNode* topNode)
 		
 		if (g4particle)
 		  {
+		    const ParticleTruth& truth = _particle_truth[particleTruthIndex(g4particle, trutheval)];
 		    if (_scan_for_embedded)
 		      {
-			if (trutheval->get_embed(g4particle) <= 0) continue;
+			if (truth.gembed <= 0) continue;
 		      }
 		    
-		    gtrackID = g4particle->get_track_id();
-		    gflavor = g4particle->get_pid();
-		    gpx = g4particle->get_px();
-		    gpy = g4particle->get_py();
-		    gpz = g4particle->get_pz();
-		    
-		    PHG4VtxPoint* vtx = trutheval->get_vertex(g4particle);
+		    gtrackID = truth.gtrackID;
+		    gflavor = truth.gflavor;
+		    gpx = truth.gpx;
+		    gpy = truth.gpy;
+		    gpz = truth.gpz;
 		    
-		    if (vtx)
-		      {
-			gvx = vtx->get_x();
-			gvy = vtx->get_y();
-			gvz = vtx->get_z();
-			gvt = vtx->get_t();
-		      }
-
-		    PHG4Hit* outerhit = nullptr;
-		    if (_do_eval_light == false)
-		      outerhit = trutheval->get_outermost_truth_hit(g4particle);
-		    if (outerhit)
-		      {
-			gfpx = outerhit->get_px(1);
-			gfpy = outerhit->get_py(1);
-			gfpz = outerhit->get_pz(1);
-			gfx = outerhit->get_x(1);
-			gfy = outerhit->get_y(1);
-			gfz = outerhit->get_z(1);
-		      }
-		    gembed = trutheval->get_embed(g4particle);
-		    gprimary = trutheval->is_primary(g4particle);
+		    gvx = truth.gvx;
+		    gvy = truth.gvy;
+		    gvz = truth.gvz;
+		    gvt = truth.gvt;
+
+		    gfpx = truth.gfpx;
+		    gfpy = truth.gfpy;
+		    gfpz = truth.gfpz;
+		    gfx = truth.gfx;
+		    gfy = truth.gfy;
+		    gfz = truth.gfz;
+
+		    gembed = truth.gembed;
+		    gprimary = truth.gprimary;
 		  }  //   if (g4particle){
 	      }
 	    
@@ -1762,8 +1847,9 @@ void SvtxEvaluator::fillOutputNtuples(PHCompositeNode* topNode)
 	for( auto iter = range.first; iter != range.second; ++iter ){
 	  TrkrDefs::cluskey cluster_key = iter->first;
 	  TrkrCluster *cluster = clustermap->findCluster(cluster_key);
-	  SvtxTrack* track = trackeval->best_track_from(cluster_key);
-	  PHG4Particle* g4particle = clustereval->max_truth_particle_by_cluster_energy(cluster_key);
+	  // particle truth is computed once per particle and event, and shared with the other ntuples
+	  const int particle = particleTruthIndex(clustereval->max_truth_particle_by_cluster_energy(cluster_key), trutheval);
+	  const ParticleTruth* ptruth = (particle < 0) ? nullptr : &_particle_truth[particle];
 	  float niter = 0;
 	  if(_iteration_map!=NULL)
 	    niter = _iteration_map->getIteration(cluster_key);
@@ -1816,7 +1902,8 @@ void SvtxEvaluator::fillOutputNtuples(PHCompositeNode* topNode)
 	  e = sumadc;
 	  
 	  float trackID = NAN;
-	  if (track!=NULL) trackID = track->get_id();
+	  SvtxTrack* track = trackeval->best_track_from(cluster_key);
+	  if (track) trackID = track->get_id();
 	  
 	  float g4hitID = NAN;
 	  float gx = NAN;
@@ -1855,7 +1942,7 @@ void SvtxEvaluator::fillOutputNtuples(PHCompositeNode* topNode)
 	    }
 	  float nparticles = NAN;
 
-	  // get best matching truth cluster from clustereval
+	  // best matching truth cluster from clustereval
 	  std::shared_ptr<TrkrCluster> truth_cluster = clustereval->max_truth_cluster_by_energy(cluster_key);
 	  if(truth_cluster)
 	    {
@@ -1876,39 +1963,29 @@ void SvtxEvaluator::fillOutputNtuples(PHCompositeNode* topNode)
 	      gphi = gpos.Phi();
 	      geta = gpos.Eta();
 	      
-	      if (g4particle)
+	      if (ptruth)
 		{
-		  gtrackID = g4particle->get_track_id();
-		  gflavor = g4particle->get_pid();
-		  gpx = g4particle->get_px();
-		  gpy = g4particle->get_py();
-		  gpz = g4particle->get_pz();
+		  gtrackID = ptruth->gtrackID;
+		  gflavor = ptruth->gflavor;
+		  gpx = ptruth->gpx;
+		  gpy = ptruth->gpy;
+		  gpz = ptruth->gpz;
 		  
-		  PHG4VtxPoint* vtx = trutheval->get_vertex(g4particle);
-		  if (vtx)
-		    {
-		      gvx = vtx->get_x();
-		      gvy = vtx->get_y();
-		      gvz = vtx->get_z();
-		      gvt = vtx->get_t();
-		    }
+		  gvx = ptruth->gvx;
+		  gvy = ptruth->gvy;
+		  gvz = ptruth->gvz;
+		  gvt = ptruth->gvt;
 		  
-		  PHG4Hit* outerhit = nullptr;
-		  if (_do_eval_light == false)
-		    outerhit = trutheval->get_outermost_truth_hit(g4particle);
-		  if (outerhit)
-		    {
-		      gfpx = outerhit->get_px(1);
-		      gfpy = outerhit->get_py(1);
-		      gfpz = outerhit->get_pz(1);
-		      gfx = outerhit->get_x(1);
-		      gfy = outerhit->get_y(1);
-		      gfz = outerhit->get_z(1);
-		    }
+		  gfpx = ptruth->gfpx;
+		  gfpy = ptruth->gfpy;
+		  gfpz = ptruth->gfpz;
+		  gfx = ptruth->gfx;
+		  gfy = ptruth->gfy;
+		  gfz = ptruth->gfz;
 		  
-		  gembed = trutheval->get_embed(g4particle);
-		  gprimary = trutheval->is_primary(g4particle);
-		}  //   if (g4particle){
+		  gembed = ptruth->gembed;
+		  gprimary = ptruth->gprimary;
+		}  //   if (ptruth){
 	      
 	      if(Verbosity() > 1)
 		{
@@ -1917,10 +1994,6 @@ void SvtxEvaluator::fillOutputNtuples(PHCompositeNode* topNode)
 		}
 	    }    //  if (truth_cluster) {
 	  
-	  if (g4particle)
-	    {
-	      
-	    }
 	  nparticles = clustereval->all_truth_particles(cluster_key).size();
 
 	  float cluster_data[] = {(float) _ievent,
@@ -2123,35 +2196,27 @@ void SvtxEvaluator::fillOutputNtuples(PHCompositeNode* topNode)
 		  
 		  if (g4particle)
 		    {
-		      gtrackID = g4particle->get_track_id();
-		      gflavor = g4particle->get_pid();
-		      gpx = g4particle->get_px();
-		      gpy = g4particle->get_py();
-		      gpz = g4particle->get_pz();
+		      const ParticleTruth& truth = _particle_truth[particleTruthIndex(g4particle, trutheval)];
+		      gtrackID = truth.gtrackID;
+		      gflavor = truth.gflavor;
+		      gpx = truth.gpx;
+		      gpy = truth.gpy;
+		      gpz = truth.gpz;
 		      
-		      PHG4VtxPoint* vtx = trutheval->get_vertex(g4particle);
-		      if (vtx)
-			{
-			  gvx = vtx->get_x();
-			  gvy = vtx->get_y();
-			  gvz = vtx->get_z();
-			  gvt = vtx->get_t();
-			}
-		      PHG4Hit* outerhit = nullptr;
-		      if (_do_eval_light == false)
-			outerhit = trutheval->get_outermost_truth_hit(g4particle);
-		      if (outerhit)
-			{
-			  gfpx = outerhit->get_px(1);
-			  gfpy = outerhit->get_py(1);
-			  gfpz = outerhit->get_pz(1);
-			  gfx = outerhit->get_x(1);
-			  gfy = outerhit->get_y(1);
-			  gfz = outerhit->get_z(1);
-			}
+		      gvx = truth.gvx;
+		      gvy = truth.gvy;
+		      gvz = truth.gvz;
+		      gvt = truth.gvt;
+		      
+		      gfpx = truth.gfpx;
+		      gfpy = truth.gfpy;
+		      gfpz = truth.gfpz;
+		      gfx = truth.gfx;
+		      gfy = truth.gfy;
+		      gfz = truth.gfz;
 		      
-		      gembed = trutheval->get_embed(g4particle);
-		      gprimary = trutheval->is_primary(g4particle);
+		      gembed = truth.gembed;
+		      gprimary = truth.gprimary;
 		    }  //   if (g4particle){
 		}    //  if (g4hit) {
 	      
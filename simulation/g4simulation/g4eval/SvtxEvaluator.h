@@ -9,18 +9,23 @@
 
 #include <fun4all/SubsysReco.h>
 
+#include <cmath>
+#include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <TMatrixFfwd.h>
 #include <TMatrixT.h>   
 #include <TMatrixTUtils.h>
 
+class EvalNtuple;
 class PHCompositeNode;
+class PHG4Particle;
 class PHTimer;
 class TrkrCluster;
 class SvtxEvalStack;
+class SvtxTruthEval;
 class TFile;
-class TNtuple;
-//class TrkrClusterContainer;
 
 /// \class SvtxEvaluator
 ///
@@ -68,6 +73,16 @@ class SvtxEvaluator : public SubsysReco
   void scan_for_embedded(bool b) { _scan_for_embedded = b; }
   void scan_for_primaries(bool b) { _scan_for_primaries = b; }
 
+  //! write typed TTrees instead of TNtuples: ids and counters as Int_t (NaN -> EvalNtuple::kIntNaN)
+  void set_columnar_output(bool b) { _columnar_output = b; }
+  //! store this column as Float16_t with reduced mantissa (columnar output only)
+  void set_float16_column(const std::string &column) { _float16_columns.insert(column); }
+  void set_float16_bits(unsigned int nbits) { _float16_bits = nbits; }
+  //! ROOT compression settings of the output file (100 * algorithm + level), default 0 (uncompressed)
+  void set_compression_settings(int settings) { _compression_settings = settings; }
+  //! basket size in bytes of all ntuples, 0 keeps the ROOT default
+  void set_basket_size(int bytes) { _basket_size = bytes; }
+
 
  private:
   unsigned int _ievent;
@@ -110,16 +125,49 @@ class SvtxEvaluator : public SubsysReco
   unsigned int _nlayers_tpc = 48;
   unsigned int _nlayers_mms = 2;
 
-  TNtuple *_ntp_info;
-  TNtuple *_ntp_vertex;
-  TNtuple *_ntp_gpoint;
-  TNtuple *_ntp_g4hit;
-  TNtuple *_ntp_hit;
-  TNtuple *_ntp_cluster;
-  TNtuple *_ntp_g4cluster;
-  TNtuple *_ntp_gtrack;
-  TNtuple *_ntp_track;
-  TNtuple *_ntp_gseed;
+  EvalNtuple *_ntp_info;
+  EvalNtuple *_ntp_vertex;
+  EvalNtuple *_ntp_gpoint;
+  EvalNtuple *_ntp_g4hit;
+  EvalNtuple *_ntp_hit;
+  EvalNtuple *_ntp_cluster;
+  EvalNtuple *_ntp_g4cluster;
+  EvalNtuple *_ntp_gtrack;
+  EvalNtuple *_ntp_track;
+  EvalNtuple *_ntp_gseed;
+
+  bool _columnar_output = false;
+  std::set<std::string> _float16_columns;
+  unsigned int _float16_bits = 12;
+  int _compression_settings = 0;
+  int _basket_size = 0;
+
+  /// truth of one particle as it goes into the ntuple rows
+  struct ParticleTruth
+  {
+    float gtrackID = NAN;
+    float gflavor = NAN;
+    float gpx = NAN;
+    float gpy = NAN;
+    float gpz = NAN;
+    float gvx = NAN;
+    float gvy = NAN;
+    float gvz = NAN;
+    float gvt = NAN;
+    bool has_outerhit = false;
+    float gfpx = NAN;
+    float gfpy = NAN;
+    float gfpz = NAN;
+    float gfx = NAN;
+    float gfy = NAN;
+    float gfz = NAN;
+    float gembed = NAN;
+    float gprimary = NAN;
+  };
+
+  //! per event table, filled once per particle per event and used by all ntuple rows
+  std::vector<ParticleTruth> _particle_truth;
+  std::unordered_map<PHG4Particle *, int> _particle_index;
 
   // evaluator output file
   std::string _filename;
@@ -129,6 +177,11 @@ class SvtxEvaluator : public SubsysReco
 
   PHTimer *_timer;
 
+  EvalNtuple *makeNtuple(const std::string &name, const std::string &title, const std::string &varlist);
+
+  //! row of a particle in _particle_truth, added on first use. -1 for nullptr
+  int particleTruthIndex(PHG4Particle *g4particle, SvtxTruthEval *trutheval);
+
   // output subroutines
   void fillOutputNtuples(PHCompositeNode *topNode);  ///< dump the evaluator information into ntuple for external analysis
   void printInputInfo(PHCompositeNode *topNode);     ///< print out the input object information (debugging upstream components)
@@ -4,7 +4,6 @@
  */
 
 #include "Fun4AllDstPileupInputManager.h"
-#include "Fun4AllDstPileupMerger.h"
 
 #include <fun4all/Fun4AllReturnCodes.h>
 #include <fun4all/Fun4AllServer.h>
@@ -23,6 +22,7 @@
 
 #include <gsl/gsl_randist.h>
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>  // for operator<<, basic_ostream, endl
 #include <utility>   // for pair
@@ -178,6 +178,14 @@ int Fun4AllDstPileupInputManager::run(const int nevents)
     for (int icollision = 0; icollision < ncollisions; ++icollision)
     {
 
+      if( m_cache_size > 0 )
+      {
+        // merge from cache
+        const auto result = mergeCachedEvent( merger, crossing_time );
+        if( result != 0 ) return result;
+        continue;
+      }
+
       // read one event
       const auto result = runOne( 1 );
       if( result != 0 ) return result;
@@ -195,6 +203,44 @@ int Fun4AllDstPileupInputManager::run(const int nevents)
   return 0;
 }
 
+//_____________________________________________________________________________
+int Fun4AllDstPileupInputManager::mergeCachedEvent( Fun4AllDstPileupMerger& merger, double crossing_time )
+{
+  // fill cache from file
+  /* once the input files are exhausted, the remaining cached events are still used */
+  while( m_cache.size() < m_cache_size )
+  {
+    if( runOne( 1 ) != 0 ) break;
+    auto event = merger.make_background_event(m_dstNodeInternal.get());
+    if( !event ) continue;
+    if (Verbosity() > 1)
+    {
+      std::cout << "Fun4AllDstPileupInputManager::mergeCachedEvent - cached background event " << m_ievent_thisfile << " size: " << event->size() << std::endl;
+    }
+    m_cache.push_back( { std::move(event), std::max(m_background_reuse, 1u) } );
+  }
+
+  if( m_cache.empty() ) return -1;
+
+  // pick random event and merge
+  const auto index = gsl_rng_uniform_int(m_rng.get(), m_cache.size());
+  auto& cached = m_cache[index];
+  if (Verbosity() > 0)
+  {
+    std::cout << "Fun4AllDstPileupInputManager::mergeCachedEvent - merged cached background event " << index << " time: " << crossing_time << std::endl;
+  }
+  merger.copy_background_event(*cached.m_event, crossing_time);
+
+  // remove event once used the requested number of times
+  if( --cached.m_remaining == 0 )
+  {
+    std::swap( cached, m_cache.back() );
+    m_cache.pop_back();
+  }
+
+  return 0;
+}
+
 //_____________________________________________________________________________
 int Fun4AllDstPileupInputManager::fileclose()
 {
@@ -11,6 +11,8 @@
 #include <fun4all/Fun4AllInputManager.h>
 #include <fun4all/Fun4AllReturnCodes.h>   // for SYNC_NOOBJECT, SYNC_OK
 
+#include "Fun4AllDstPileupMerger.h"
+
 #include <phool/PHCompositeNode.h>  // for PHCompositeNode
 #include <phool/PHNodeIOManager.h>  // for PHNodeIOManager
 
@@ -19,6 +21,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 class SyncObject;
 
@@ -58,11 +61,26 @@ class Fun4AllDstPileupInputManager : public Fun4AllInputManager
     m_tmax = tmax;
   }
 
+  /// maximum number of decoded background events kept in memory. 0 (default) disables the cache
+  /**
+   * when enabled, background events read from file are stored in compact form,
+   * and merged events are built from events randomly picked from the cache.
+   */
+  void setBackgroundCacheSize(unsigned int n)
+  { m_cache_size = n; }
+
+  /// number of times each background event read from file is merged, at random crossings and signal events. Requires the cache
+  void setBackgroundReuse(unsigned int n)
+  { m_background_reuse = n; }
+
  private:
 
   //! loads one event on internal DST node
   int runOne(const int nevents = 0);
 
+  //! get one background event from cache, reading from file if needed, and merge it. Returns non zero if no event is available
+  int mergeCachedEvent(Fun4AllDstPileupMerger&, double crossing_time);
+
   //!@name event counters
   //@{
   bool m_ReadRunTTree = true;
@@ -114,6 +132,21 @@ class Fun4AllDstPileupInputManager : public Fun4AllInputManager
 
   std::unique_ptr<gsl_rng, Deleter> m_rng;
 
+  //!@name background event cache
+  //@{
+  unsigned int m_cache_size = 0;
+  unsigned int m_background_reuse = 1;
+
+  //! cached event and remaining number of uses
+  struct CachedEvent
+  {
+    std::unique_ptr<Fun4AllDstPileupMerger::BackgroundEvent> m_event;
+    unsigned int m_remaining = 0;
+  };
+
+  std::vector<CachedEvent> m_cache;
+  //@}
+
 };
 
 #endif /* __Fun4AllDstPileupInputManager_H__ */
@@ -34,12 +34,17 @@
 #include <iterator>
 #include <utility>
 
-// convenient aliases for deep copying nodes
 namespace
 {
-  using PHG4Particle_t = PHG4Particlev3;
-  using PHG4VtxPoint_t = PHG4VtxPointv1;
-  using PHG4Hit_t = PHG4Hitv1;
+  using PHG4Particle_t = Fun4AllDstPileupMerger::PHG4Particle_t;
+  using PHG4VtxPoint_t = Fun4AllDstPileupMerger::PHG4VtxPoint_t;
+  using PHG4Hit_t = Fun4AllDstPileupMerger::PHG4Hit_t;
+
+  //! convert event relative id to destination id, given destination max and min indices
+  inline int convert_id(int id, int max_index, int min_index)
+  {
+    return id > 0 ? max_index + id : (id < 0 ? min_index + id : 0);
+  }
 
   //! utility class to find all PHG4Hit container nodes from the DST node
   class FindG4HitContainer : public PHNodeOperation
@@ -77,6 +82,25 @@ namespace
 
 }  // namespace
 
+//_____________________________________________________________________________
+Fun4AllDstPileupMerger::BackgroundEvent::BackgroundEvent() = default;
+
+//_____________________________________________________________________________
+Fun4AllDstPileupMerger::BackgroundEvent::~BackgroundEvent() = default;
+
+//_____________________________________________________________________________
+size_t Fun4AllDstPileupMerger::BackgroundEvent::size() const
+{
+  size_t out = sizeof(BackgroundEvent);
+  out += (m_primary_vertices.capacity() + m_secondary_vertices.capacity()) * sizeof(PHG4VtxPoint_t);
+  out += (m_primary_particles.capacity() + m_secondary_particles.capacity()) * sizeof(PHG4Particle_t);
+  for (const auto &container : m_hitcontainers)
+  {
+    out += sizeof(HitContainer) + container.m_hits.capacity() * sizeof(PHG4Hit_t) + container.m_layers.capacity() * sizeof(unsigned int);
+  }
+  return out;
+}
+
 //_____________________________________________________________________________
 void Fun4AllDstPileupMerger::load_nodes(PHCompositeNode *dstNode)
 {
@@ -334,3 +358,228 @@ void Fun4AllDstPileupMerger::copy_background_event(PHCompositeNode *dstNode, dou
     }
   }
 }
+
+//_____________________________________________________________________________
+std::unique_ptr<Fun4AllDstPileupMerger::BackgroundEvent> Fun4AllDstPileupMerger::make_background_event(PHCompositeNode *dstNode) const
+{
+  std::unique_ptr<BackgroundEvent> event(new BackgroundEvent);
+
+  // hepmc
+  const auto map = findNode::getClass<PHHepMCGenEventMap>(dstNode, "PHHepMCGenEventMap");
+  if (map && m_geneventmap)
+  {
+    if (map->size() != 1)
+    {
+      std::cout << "Fun4AllDstPileupMerger::make_background_event - cannot merge events that contain more than one PHHepMCGenEventMap" << std::endl;
+      return nullptr;
+    }
+
+    // see copy_background_event for the reason of the swap
+    auto genevent = map->get_map().begin()->second;
+    event->m_genevent.reset(static_cast<PHHepMCGenEvent *>(genevent->CloneMe()));
+    event->m_genevent->getEvent()->swap(*genevent->getEvent());
+  }
+
+  // truth container
+  // source to event relative ids, for vertices and tracks
+  using ConversionMap = std::map<int, int>;
+  ConversionMap vtxid_map;
+  ConversionMap trkid_map;
+
+  const auto container_truth = findNode::getClass<PHG4TruthInfoContainer>(dstNode, "G4TruthInfo");
+  if (container_truth && m_g4truthinfo)
+  {
+    // vertices. Ids are assigned in the same order as copy_background_event
+    const auto primary_vtxrange = container_truth->GetPrimaryVtxRange();
+    for (auto iter = primary_vtxrange.first; iter != primary_vtxrange.second; ++iter)
+    {
+      event->m_primary_vertices.emplace_back(iter->second);
+      const int id = event->m_primary_vertices.size();
+      event->m_primary_vertices.back().set_id(id);
+      vtxid_map.insert(std::make_pair(iter->second->get_id(), id));
+    }
+
+    const auto secondary_vtxrange = container_truth->GetSecondaryVtxRange();
+    for (
+        auto iter = std::reverse_iterator<PHG4TruthInfoContainer::ConstVtxIterator>(secondary_vtxrange.second);
+        iter != std::reverse_iterator<PHG4TruthInfoContainer::ConstVtxIterator>(secondary_vtxrange.first);
+        ++iter)
+    {
+      event->m_secondary_vertices.emplace_back(iter->second);
+      const int id = -static_cast<int>(event->m_secondary_vertices.size());
+      event->m_secondary_vertices.back().set_id(id);
+      vtxid_map.insert(std::make_pair(iter->second->get_id(), id));
+    }
+
+    auto convert_vtx_id = [&vtxid_map](int source_id)
+    {
+      const auto keyiter = vtxid_map.find(source_id);
+      if (keyiter != vtxid_map.end()) return keyiter->second;
+      std::cout << "Fun4AllDstPileupMerger::make_background_event - vertex id " << source_id << " not found in map" << std::endl;
+      return 0;
+    };
+
+    auto convert_trk_id = [&trkid_map](int source_id)
+    {
+      const auto keyiter = trkid_map.find(source_id);
+      if (keyiter != trkid_map.end()) return keyiter->second;
+      std::cout << "Fun4AllDstPileupMerger::make_background_event - track id " << source_id << " not found in map" << std::endl;
+      return 0;
+    };
+
+    // primary particles
+    const auto primary_range = container_truth->GetPrimaryParticleRange();
+    for (auto iter = primary_range.first; iter != primary_range.second; ++iter)
+    {
+      event->m_primary_particles.emplace_back(iter->second);
+      auto &dest = event->m_primary_particles.back();
+      const int id = event->m_primary_particles.size();
+      dest.set_track_id(id);
+      dest.set_parent_id(0);
+      dest.set_primary_id(id);
+      dest.set_vtx_id(convert_vtx_id(iter->second->get_vtx_id()));
+      trkid_map.insert(std::make_pair(iter->second->get_track_id(), id));
+    }
+
+    // secondary particles, from last to first so that parents are converted before their daughters
+    const auto secondary_range = container_truth->GetSecondaryParticleRange();
+    for (
+        auto iter = std::reverse_iterator<PHG4TruthInfoContainer::ConstIterator>(secondary_range.second);
+        iter != std::reverse_iterator<PHG4TruthInfoContainer::ConstIterator>(secondary_range.first);
+        ++iter)
+    {
+      event->m_secondary_particles.emplace_back(iter->second);
+      auto &dest = event->m_secondary_particles.back();
+      const int id = -static_cast<int>(event->m_secondary_particles.size());
+      dest.set_track_id(id);
+      dest.set_parent_id(convert_trk_id(iter->second->get_parent_id()));
+      dest.set_primary_id(convert_trk_id(iter->second->get_primary_id()));
+      dest.set_vtx_id(convert_vtx_id(iter->second->get_vtx_id()));
+      trkid_map.insert(std::make_pair(iter->second->get_track_id(), id));
+    }
+  }
+
+  // g4hits
+  for (const auto &pair : m_g4hitscontainers)
+  {
+    auto container_hit = findNode::getClass<PHG4HitContainer>(dstNode, pair.first);
+    if (!container_hit)
+    {
+      std::cout << "Fun4AllDstPileupMerger::make_background_event - invalid source container " << pair.first << std::endl;
+      continue;
+    }
+
+    event->m_hitcontainers.emplace_back();
+    auto &dest = event->m_hitcontainers.back();
+    dest.m_name = pair.first;
+
+    const auto range = container_hit->getHits();
+    dest.m_hits.reserve(container_hit->size());
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+      dest.m_hits.emplace_back(iter->second);
+      auto &hit = dest.m_hits.back();
+
+      const auto keyiter = trkid_map.find(iter->second->get_trkid());
+      if (keyiter != trkid_map.end())
+        hit.set_trkid(keyiter->second);
+      else
+      {
+        std::cout << "Fun4AllDstPileupMerger::make_background_event - track id " << iter->second->get_trkid() << " not found in map" << std::endl;
+        hit.set_trkid(0);
+      }
+
+      // showers from background events are not copied, see copy_background_event
+      hit.set_shower_id(INT_MIN);
+    }
+
+    const auto layers = container_hit->getLayers();
+    dest.m_layers.assign(layers.first, layers.second);
+  }
+
+  return event;
+}
+
+//_____________________________________________________________________________
+void Fun4AllDstPileupMerger::copy_background_event(BackgroundEvent &event, double delta_t) const
+{
+  // hepmc
+  int new_embed_id = -1;
+  if (event.m_genevent && m_geneventmap)
+  {
+    auto newevent = m_geneventmap->insert_background_event(event.m_genevent.get());
+    newevent->getEvent()->swap(*event.m_genevent->getEvent());
+    newevent->moveVertex(0, 0, 0, delta_t);
+    new_embed_id = newevent->get_embedding_id();
+  }
+
+  // destination offsets. Ids stored in the event are relative to them
+  int max_trkindex = 0;
+  int min_trkindex = 0;
+
+  if (m_g4truthinfo)
+  {
+    const int max_vtxindex = m_g4truthinfo->maxvtxindex();
+    const int min_vtxindex = m_g4truthinfo->minvtxindex();
+    max_trkindex = m_g4truthinfo->maxtrkindex();
+    min_trkindex = m_g4truthinfo->mintrkindex();
+
+    // vertices
+    for (const auto &vertices : {&event.m_primary_vertices, &event.m_secondary_vertices})
+    {
+      for (const auto &source : *vertices)
+      {
+        auto newVertex = new PHG4VtxPoint_t(&source);
+        const int id = convert_id(source.get_id(), max_vtxindex, min_vtxindex);
+        newVertex->set_t(source.get_t() + delta_t);
+        m_g4truthinfo->AddVertex(id, newVertex);
+
+        /* embed flag is stored only for primary vertices, consistently with PHG4TruthEventAction */
+        if (source.get_id() > 0) m_g4truthinfo->AddEmbededVtxId(id, new_embed_id);
+      }
+    }
+
+    // particles
+    for (const auto &particles : {&event.m_primary_particles, &event.m_secondary_particles})
+    {
+      for (const auto &source : *particles)
+      {
+        auto dest = new PHG4Particle_t(&source);
+        const int id = convert_id(source.get_track_id(), max_trkindex, min_trkindex);
+        dest->set_track_id(id);
+        dest->set_parent_id(convert_id(source.get_parent_id(), max_trkindex, min_trkindex));
+        dest->set_primary_id(convert_id(source.get_primary_id(), max_trkindex, min_trkindex));
+        dest->set_vtx_id(convert_id(source.get_vtx_id(), max_vtxindex, min_vtxindex));
+        m_g4truthinfo->AddParticle(id, dest);
+
+        /* embed flag is stored only for primary tracks, consistently with PHG4TruthEventAction */
+        if (source.get_track_id() > 0) m_g4truthinfo->AddEmbededTrkId(id, new_embed_id);
+      }
+    }
+  }
+
+  // g4hits
+  for (const auto &container : event.m_hitcontainers)
+  {
+    const auto iter = m_g4hitscontainers.find(container.m_name);
+    if (iter == m_g4hitscontainers.end() || !iter->second)
+    {
+      std::cout << "Fun4AllDstPileupMerger::copy_background_event - invalid destination container " << container.m_name << std::endl;
+      continue;
+    }
+
+    for (const auto &source : container.m_hits)
+    {
+      auto newHit = new PHG4Hit_t(&source);
+      newHit->set_t(0, source.get_t(0) + delta_t);
+      newHit->set_t(1, source.get_t(1) + delta_t);
+      newHit->set_trkid(convert_id(source.get_trkid(), max_trkindex, min_trkindex));
+      iter->second->AddHit(newHit->get_detid(), newHit);
+    }
+
+    for (const auto &layer : container.m_layers)
+    {
+      iter->second->AddLayer(layer);
+    }
+  }
+}
@@ -8,12 +8,19 @@
  * \author Hugo Pereira Da Costa <hugo.pereira-da-costa@cea.fr>
  */
 
+#include "PHG4Hitv1.h"
+#include "PHG4Particlev3.h"
+#include "PHG4VtxPointv1.h"
+
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 class PHCompositeNode;
 class PHG4HitContainer;
 class PHG4TruthInfoContainer;
+class PHHepMCGenEvent;
 class PHHepMCGenEventMap;
 
 /*!
@@ -26,6 +33,58 @@ class Fun4AllDstPileupMerger final
 
   public:
 
+  //!@name convenient aliases for deep copying nodes
+  //@{
+  using PHG4Particle_t = PHG4Particlev3;
+  using PHG4VtxPoint_t = PHG4VtxPointv1;
+  using PHG4Hit_t = PHG4Hitv1;
+  //@}
+
+  /*!
+   * compact copy of a background event, so that it can be merged several times without reading it again.
+   * Track and vertex ids are stored relative to the event: primary ids count up from 1 and secondary ids down from -1,
+   * in the order in which they are inserted in the destination containers. Merging then only requires
+   * to offset ids by the destination current max (min) indices and to shift times, without id lookup.
+   */
+  class BackgroundEvent
+  {
+    public:
+
+    //! constructor
+    BackgroundEvent();
+
+    //! destructor
+    ~BackgroundEvent();
+
+    //! approximate memory footprint (bytes), not counting the hepmc record
+    size_t size() const;
+
+    private:
+
+    friend class Fun4AllDstPileupMerger;
+
+    //! hepmc record, if any
+    std::unique_ptr<PHHepMCGenEvent> m_genevent;
+
+    //!@name truth information, with event relative ids
+    //@{
+    std::vector<PHG4VtxPoint_t> m_primary_vertices;
+    std::vector<PHG4VtxPoint_t> m_secondary_vertices;
+    std::vector<PHG4Particle_t> m_primary_particles;
+    std::vector<PHG4Particle_t> m_secondary_particles;
+    //@}
+
+    //! g4hits and layers for a given container, with event relative track ids
+    struct HitContainer
+    {
+      std::string m_name;
+      std::vector<PHG4Hit_t> m_hits;
+      std::vector<unsigned int> m_layers;
+    };
+
+    std::vector<HitContainer> m_hitcontainers;
+  };
+
   //! constructor
   Fun4AllDstPileupMerger() = default;
 
@@ -38,6 +97,12 @@ class Fun4AllDstPileupMerger final
   //! time-shift and copy content of source nodes to destination
   void copy_background_event(PHCompositeNode *, double delta_t) const;
 
+  //! decode content of source nodes into compact, reusable, form
+  std::unique_ptr<BackgroundEvent> make_background_event(PHCompositeNode *) const;
+
+  //! time-shift and copy compact background event to destination
+  void copy_background_event(BackgroundEvent &, double delta_t) const;
+
   private:
 
   //! hepmc
@@ -63,6 +63,8 @@ class PHG4HitContainer: public PHObject
      { return make_pair(layers.begin(), layers.end());} 
   void AddLayer(const unsigned int ilayer) {layers.insert(ilayer);}
   void RemoveZeroEDep();
+  //! forget all hits without deleting them. Used once their ownership has been passed to another container
+  void ReleaseHits() { hitmap.clear(); }
   PHG4HitDefs::keytype getmaxkey(const unsigned int detid);
 
  protected:
@@ -6,6 +6,8 @@
 #include "PHG4Hit.h"
 #include "PHG4HitDefs.h"
 
+#include <phool/PHObjectPool.h>
+
 #include <climits>  // for INT_MIN, ULONG_LONG_MAX
 #include <cmath>
 #include <cstdint>
@@ -18,6 +20,10 @@ class PHG4Hitv1 : public PHG4Hit
   PHG4Hitv1() = default;
   explicit PHG4Hitv1(const PHG4Hit* g4hit);
   ~PHG4Hitv1() override = default;
+
+  //! recycled allocation when enabled, see PHObjectPool
+  PHOBJECTPOOL_OPERATORS(PHG4Hitv1)
+
   void identify(std::ostream& os = std::cout) const override;
   void Reset() override;
 
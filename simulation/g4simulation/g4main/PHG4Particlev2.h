@@ -5,6 +5,8 @@
 
 #include "PHG4Particlev1.h"
 
+#include <phool/PHObjectPool.h>
+
 #include <iostream>
 #include <string>
 
@@ -19,6 +21,9 @@ class PHG4Particlev2 : public PHG4Particlev1
 
   ~PHG4Particlev2() override {}
 
+  //! recycled allocation when enabled, see PHObjectPool
+  PHOBJECTPOOL_OPERATORS(PHG4Particlev2)
+
   void identify(std::ostream &os = std::cout) const override;
 
   int get_track_id() const override { return trkid; }
@@ -18,6 +18,7 @@
 #include <Geant4/G4Region.hh>
 #include <Geant4/G4RegionStore.hh>
 #include <Geant4/G4String.hh>               // for G4String
+#include <Geant4/G4Threading.hh>
 #include <Geant4/G4SolidStore.hh>
 #include <Geant4/G4SystemOfUnits.hh>
 #include <Geant4/G4ThreeVector.hh>                 // for G4ThreeVector
@@ -35,7 +36,8 @@ using namespace std;
 
 //____________________________________________________________________________
 PHG4PhenixDetector::PHG4PhenixDetector(PHG4Reco *subsys)
-  : m_DisplayAction(dynamic_cast<PHG4PhenixDisplayAction *>(subsys->GetDisplayAction()))
+  : m_Reco(subsys)
+  , m_DisplayAction(dynamic_cast<PHG4PhenixDisplayAction *>(subsys->GetDisplayAction()))
   , m_Verbosity(0)
   , logicWorld(nullptr)
   , physiWorld(nullptr)
@@ -124,3 +126,13 @@ G4VPhysicalVolume *PHG4PhenixDetector::Construct()
 
   return physiWorld;
 }
+
+//_______________________________________________________________________________________________
+void PHG4PhenixDetector::ConstructSDandField()
+{
+  // the master field setup is created by PHG4Reco::InitField
+  if (G4Threading::IsWorkerThread())
+  {
+    m_Reco->ConstructWorkerField();
+  }
+}
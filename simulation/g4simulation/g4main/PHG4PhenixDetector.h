@@ -37,6 +37,9 @@ class PHG4PhenixDetector : public G4VUserDetectorConstruction
   //! this is called by geant to actually construct all detectors
   G4VPhysicalVolume* Construct() override;
 
+  //! this is called by geant in each worker thread, when running multithreaded, to create the thread local field setup
+  void ConstructSDandField() override;
+
   G4double GetWorldSizeX() const { return WorldSizeX; }
 
   G4double GetWorldSizeY() const { return WorldSizeY; }
@@ -51,6 +54,8 @@ class PHG4PhenixDetector : public G4VUserDetectorConstruction
   G4VPhysicalVolume* GetPhysicalVolume(void) { return physiWorld; }
 
  private:
+  PHG4Reco* m_Reco;
+
   PHG4PhenixDisplayAction* m_DisplayAction;
 
   int m_Verbosity;
@@ -7,6 +7,7 @@
 
 class G4Event;
 class PHG4InEvent;
+class PHG4VtxPoint;
 
 class PHG4PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 {
@@ -34,6 +35,9 @@ class PHG4PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
   int Verbosity() const { return verbosity; }
 
  protected:
+  //! add one vertex, and the particles attached to it, to a geant event
+  void GenerateVertex(G4Event* anEvent, PHG4InEvent* inevt, const int vtxid, const PHG4VtxPoint& vtx);
+
   int verbosity;
 
  private:
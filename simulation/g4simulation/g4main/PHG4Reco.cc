@@ -11,10 +11,16 @@
 #include "PHG4PhenixSteppingAction.h"
 #include "PHG4PhenixTrackingAction.h"
 #include "PHG4PrimaryGeneratorAction.h"
+#include "PHG4SubEventMergeContext.h"
 #include "PHG4Subsystem.h"
 #include "PHG4TrackingAction.h"
+#include "PHG4TruthInfoContainer.h"
+#include "PHG4TruthSubsystem.h"
 #include "PHG4UIsession.h"
 #include "PHG4Utils.h"
+#include "PHG4VtxPoint.h"
+#include "PHG4WorkerActions.h"
+#include "PHG4WorkerInitialization.h"
 
 #include <g4decayer/EDecayType.hh>
 #include <g4decayer/P6DExtDecayerPhysics.hh>
@@ -23,6 +29,7 @@
 
 #include <g4gdml/PHG4GDMLUtility.hh>
 
+#include <phfield/PHField.h>
 #include <phfield/PHFieldConfigv1.h>
 #include <phfield/PHFieldConfigv2.h>
 #include <phfield/PHFieldUtility.h>
@@ -46,6 +53,7 @@
 
 #include <CLHEP/Random/Random.h>
 
+#include <Geant4/G4AutoLock.hh>
 #include <Geant4/G4Cerenkov.hh>
 #include <Geant4/G4Scintillation.hh>
 #include <Geant4/G4Element.hh>       // for G4Element
@@ -74,6 +82,7 @@
 #include <Geant4/G4StepLimiterPhysics.hh>
 #include <Geant4/G4String.hh>  // for G4String
 #include <Geant4/G4SystemOfUnits.hh>
+#include <Geant4/G4Threading.hh>
 #include <Geant4/G4Types.hh>  // for G4double, G4int
 #include <Geant4/G4UIExecutive.hh>
 #include <Geant4/G4UImanager.hh>
@@ -83,6 +92,10 @@
 #include <Geant4/G4VisExecutive.hh>
 #include <Geant4/G4VisManager.hh>  // for G4VisManager
 
+#ifdef G4MULTITHREADED
+#include <Geant4/G4MTRunManager.hh>
+#endif
+
 // physics lists
 #include <Geant4/FTFP_BERT.hh>
 #include <Geant4/FTFP_BERT_HP.hh>
@@ -107,13 +120,18 @@
 
 class G4TrackingManager;
 class G4VPhysicalVolume;
-class PHField;
 class PHG4EventAction;
 class PHG4StackingAction;
 class PHG4SteppingAction;
 
 using namespace std;
 
+namespace
+{
+  //! serializes the creation of worker thread actions, which accesses the subsystems
+  G4Mutex worker_mutex = G4MUTEX_INITIALIZER;
+}
+
 //_________________________________________________________________
 PHG4Reco::PHG4Reco(const string &name)
   : SubsysReco(name)
@@ -160,6 +178,22 @@ PHG4Reco::~PHG4Reco(void)
   // they are non zero is not needed
   delete m_Field;
   delete m_RunManager;
+  for (G4TBMagneticFieldSetup *field: m_WorkerFields)
+  {
+    delete field;
+  }
+  for (PHField *fieldmap: m_WorkerFieldMaps)
+  {
+    delete fieldmap;
+  }
+  if (m_UseWorkerThreads)
+  {
+    // master actions are not registered to geant, which would otherwise delete them
+    delete m_EventAction;
+    delete m_StackingAction;
+    delete m_SteppingAction;
+    delete m_TrackingAction;
+  }
   delete m_UISession;
   delete m_VisManager;
   delete m_Fun4AllMessenger;
@@ -194,7 +228,38 @@ int PHG4Reco::Init(PHCompositeNode *topNode)
     uimanager->SetCoutDestination(m_UISession);
   }
 
-  m_RunManager = new G4RunManager();
+  // worker threads are used only if requested and supported by all subsystems
+  m_UseWorkerThreads = false;
+  if (m_NumberOfThreads > 1)
+  {
+#ifdef G4MULTITHREADED
+    m_UseWorkerThreads = true;
+    for (PHG4Subsystem *g4sub: m_SubsystemList)
+    {
+      if (!g4sub->SupportsWorkerThreads())
+      {
+        cout << "PHG4Reco::Init - " << g4sub->Name() << " does not support worker threads, geant runs sequentially" << endl;
+        m_UseWorkerThreads = false;
+      }
+    }
+#else
+    cout << "PHG4Reco::Init - geant is built without multithreading, geant runs sequentially" << endl;
+#endif
+  }
+
+#ifdef G4MULTITHREADED
+  if (m_UseWorkerThreads)
+  {
+    if (Verbosity() > 0) cout << "PHG4Reco::Init - using " << m_NumberOfThreads << " worker threads" << endl;
+    G4MTRunManager *mtRunManager = new G4MTRunManager();
+    mtRunManager->SetNumberOfThreads(m_NumberOfThreads);
+    m_RunManager = mtRunManager;
+  }
+  else
+#endif
+  {
+    m_RunManager = new G4RunManager();
+  }
 
   DefineMaterials();
   // create physics processes
@@ -313,6 +378,18 @@ int PHG4Reco::InitField(PHCompositeNode *topNode)
 
   m_Field = new G4TBMagneticFieldSetup(phfield);
 
+  if (m_UseWorkerThreads)
+  {
+    // field maps cache their last lookup and cannot be shared, build one per worker thread, with the same configuration
+    // the matching field setups are created by the worker threads (see ConstructWorkerField)
+    const PHFieldConfig *field_cfg = PHFieldUtility::GetFieldConfigNode(default_field_cfg.get(), topNode, Verbosity() + 1);
+    for (int i = 0; i < m_NumberOfThreads; ++i)
+    {
+      m_WorkerFieldMaps.push_back(PHFieldUtility::BuildFieldMap(field_cfg, Verbosity() + 1));
+    }
+    m_WorkerFields.assign(m_NumberOfThreads, nullptr);
+  }
+
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
@@ -411,7 +488,8 @@ int PHG4Reco::InitRun(PHCompositeNode *topNode)
     }
   }
 
-  if (not m_disableUserActions)
+  // with worker threads, actions are created per thread by PHG4WorkerInitialization
+  if (not m_disableUserActions && !m_UseWorkerThreads)
   {
     m_RunManager->SetUserAction(m_EventAction);
   }
@@ -431,7 +509,8 @@ int PHG4Reco::InitRun(PHCompositeNode *topNode)
     }
   }
 
-  if (not m_disableUserActions)
+  // with worker threads, actions are created per thread by PHG4WorkerInitialization
+  if (not m_disableUserActions && !m_UseWorkerThreads)
   {
     m_RunManager->SetUserAction(m_StackingAction);
   }
@@ -452,7 +531,8 @@ int PHG4Reco::InitRun(PHCompositeNode *topNode)
     }
   }
 
-  if (not m_disableUserActions)
+  // with worker threads, actions are created per thread by PHG4WorkerInitialization
+  if (not m_disableUserActions && !m_UseWorkerThreads)
   {
     m_RunManager->SetUserAction(m_SteppingAction);
   }
@@ -474,11 +554,17 @@ int PHG4Reco::InitRun(PHCompositeNode *topNode)
     }
   }
 
-  if (not m_disableUserActions)
+  // with worker threads, actions are created per thread by PHG4WorkerInitialization
+  if (not m_disableUserActions && !m_UseWorkerThreads)
   {
     m_RunManager->SetUserAction(m_TrackingAction);
   }
 
+  if (m_UseWorkerThreads)
+  {
+    m_RunManager->SetUserInitialization(new PHG4WorkerInitialization(this));
+  }
+
   // initialize
   m_RunManager->Initialize();
 
@@ -626,7 +712,10 @@ int PHG4Reco::process_event(PHCompositeNode *topNode)
 {
   // make sure Actions and subsystems have the relevant pointers set
   PHG4InEvent *ineve = findNode::getClass<PHG4InEvent>(topNode, "PHG4INEVENT");
-  m_GeneratorAction->SetInEvent(ineve);
+  if (m_GeneratorAction)
+  {
+    m_GeneratorAction->SetInEvent(ineve);
+  }
 
   for (SubsysReco *reco: m_SubsystemList)
   {
@@ -653,7 +742,18 @@ int PHG4Reco::process_event(PHCompositeNode *topNode)
          << "run one event :" << endl;
     ineve->identify();
   }
-  m_RunManager->BeamOn(1);
+  if (m_UseWorkerThreads)
+  {
+    const int iret = process_event_workers(topNode, ineve);
+    if (iret != Fun4AllReturnCodes::EVENT_OK)
+    {
+      return iret;
+    }
+  }
+  else
+  {
+    m_RunManager->BeamOn(1);
+  }
 
   for (PHG4Subsystem *g4sub: m_SubsystemList)
   {
@@ -674,6 +774,90 @@ int PHG4Reco::process_event(PHCompositeNode *topNode)
   return 0;
 }
 
+//_________________________________________________________________
+int PHG4Reco::process_event_workers(PHCompositeNode *topNode, PHG4InEvent *ineve)
+{
+  // one sub-event per vertex, each with its own output node tree
+  m_SubEvents.clear();
+  std::pair<std::map<int, PHG4VtxPoint *>::const_iterator, std::map<int, PHG4VtxPoint *>::const_iterator> vtxbegin_end = ineve->GetVertices();
+  for (auto vtxiter = vtxbegin_end.first; vtxiter != vtxbegin_end.second; ++vtxiter)
+  {
+    SubEvent subevent;
+    subevent.node = new PHCompositeNode("SUBEVENT");
+    subevent.node->addNode(new PHCompositeNode("DST"));
+    subevent.node->addNode(new PHCompositeNode("RUN"));
+    subevent.inevent = ineve;
+    subevent.vtxid = vtxiter->first;
+    subevent.vtx = vtxiter->second;
+    for (PHG4Subsystem *g4sub: m_SubsystemList)
+    {
+      g4sub->InitSubEventNode(subevent.node);
+    }
+    m_SubEvents.push_back(subevent);
+  }
+
+  // geant event ids match sub-event indices. Per event seeds are drawn by the master
+  // in event id order, so that results do not depend on the worker scheduling
+  if (!m_SubEvents.empty())
+  {
+    m_RunManager->BeamOn(m_SubEvents.size());
+  }
+
+  // merge sub-events in vertex order. Truth is merged last, since it references hit keys
+  int iret = Fun4AllReturnCodes::EVENT_OK;
+  PHG4SubEventMergeContext context;
+  for (const SubEvent &subevent: m_SubEvents)
+  {
+    context.Reset(findNode::getClass<PHG4TruthInfoContainer>(topNode, "G4TruthInfo"));
+    for (PHG4Subsystem *g4sub: m_SubsystemList)
+    {
+      if (!dynamic_cast<PHG4TruthSubsystem *>(g4sub) && g4sub->MergeSubEvent(subevent.node, topNode, context) != Fun4AllReturnCodes::EVENT_OK)
+      {
+        cout << PHWHERE << " failed to merge sub-event from " << g4sub->Name() << endl;
+        iret = Fun4AllReturnCodes::ABORTEVENT;
+      }
+    }
+    for (PHG4Subsystem *g4sub: m_SubsystemList)
+    {
+      if (dynamic_cast<PHG4TruthSubsystem *>(g4sub) && g4sub->MergeSubEvent(subevent.node, topNode, context) != Fun4AllReturnCodes::EVENT_OK)
+      {
+        cout << PHWHERE << " failed to merge sub-event from " << g4sub->Name() << endl;
+        iret = Fun4AllReturnCodes::ABORTEVENT;
+      }
+    }
+    delete subevent.node;
+  }
+  m_SubEvents.clear();
+  return iret;
+}
+
+//_________________________________________________________________
+void PHG4Reco::CreateWorkerActions(PHG4WorkerActions &actions)
+{
+  // subsystems are shared between worker threads
+  G4AutoLock lock(&worker_mutex);
+  if (m_disableUserActions)
+  {
+    return;
+  }
+  for (PHG4Subsystem *g4sub: m_SubsystemList)
+  {
+    g4sub->CreateWorkerActions(actions);
+  }
+}
+
+//_________________________________________________________________
+void PHG4Reco::ConstructWorkerField()
+{
+  const int thread_id = G4Threading::G4GetThreadId();
+  if (thread_id < 0 || thread_id >= (int) m_WorkerFieldMaps.size())
+  {
+    cout << PHWHERE << " no field map for worker thread " << thread_id << endl;
+    return;
+  }
+  m_WorkerFields[thread_id] = new G4TBMagneticFieldSetup(m_WorkerFieldMaps[thread_id]);
+}
+
 int PHG4Reco::ResetEvent(PHCompositeNode *topNode)
 {
   for (SubsysReco *reco: m_SubsystemList)
@@ -710,6 +894,11 @@ int PHG4Reco::setupInputEventNodeReader(PHCompositeNode *topNode)
     PHDataNode<PHObject> *newNode = new PHDataNode<PHObject>(ineve, "PHG4INEVENT", "PHObject");
     dstNode->addNode(newNode);
   }
+  // with worker threads, generators are created per thread by PHG4WorkerInitialization
+  if (m_UseWorkerThreads)
+  {
+    return 0;
+  }
   // check if we have already registered a generator before creating the default which uses PHG4InEvent Node
   if (!m_GeneratorAction)
   {
@@ -11,6 +11,7 @@
 
 #include <list>
 #include <string>  // for string
+#include <vector>
 
 // Forward declerations
 class G4RunManager;
@@ -19,7 +20,9 @@ class G4UImanager;
 class G4UImessenger;
 class G4VisManager;
 class PHCompositeNode;
+class PHField;
 class PHG4DisplayAction;
+class PHG4InEvent;
 class PHG4PhenixDetector;
 class PHG4PhenixEventAction;
 class PHG4PhenixStackingAction;
@@ -28,6 +31,8 @@ class PHG4PhenixTrackingAction;
 class PHG4PrimaryGeneratorAction;
 class PHG4Subsystem;
 class PHG4UIsession;
+class PHG4VtxPoint;
+class PHG4WorkerActions;
 
 /*!
   \class   PHG4Reco
@@ -124,12 +129,56 @@ class PHG4Reco : public SubsysReco
   void setDisableUserActions(bool b = true) { m_disableUserActions = b; }
   void ApplyDisplayAction();
 
+  //! number of geant worker threads. Default is 1, which runs the standard, sequential, G4RunManager
+  /*!
+   * With more than one thread, each PHG4InEvent vertex is simulated as a separate geant event (sub-event)
+   * on a G4MTRunManager, and the outputs are merged back into the node tree in vertex order.
+   * This requires geant to be built with multithreading and all registered subsystems to support it
+   * (see PHG4Subsystem::SupportsWorkerThreads), otherwise the sequential run manager is used.
+   */
+  void set_number_of_threads(const int n) { m_NumberOfThreads = n; }
+  int get_number_of_threads() const { return m_NumberOfThreads; }
+
+  //! true if geant runs with worker threads
+  bool use_worker_threads() const { return m_UseWorkerThreads; }
+
+  //!@name multithreaded running, used by the geant worker threads
+  //@{
+
+  //! sub-event, simulated as one geant event by a worker thread
+  struct SubEvent
+  {
+    //! node tree holding the sub-event output
+    PHCompositeNode *node = nullptr;
+
+    //! input event
+    PHG4InEvent *inevent = nullptr;
+
+    //! vertex id and vertex
+    int vtxid = 0;
+    const PHG4VtxPoint *vtx = nullptr;
+  };
+
+  //! sub-event matching a given geant event id
+  const SubEvent &GetSubEvent(const int i) const { return m_SubEvents.at(i); }
+
+  //! create subsystem actions for the calling worker thread
+  void CreateWorkerActions(PHG4WorkerActions &actions);
+
+  //! create magnetic field setup for the calling worker thread
+  void ConstructWorkerField();
+
+  //@}
+
  private:
   static void g4guithread(void *ptr);
   int InitUImanager();
   void DefineMaterials();
   void DefineRegions();
 
+  //! multithreaded event processing
+  int process_event_workers(PHCompositeNode *topNode, PHG4InEvent *ineve);
+
   float m_MagneticField = 0.;
   float m_MagneticFieldRescale;
   double m_WorldSize[3];
@@ -137,6 +186,12 @@ class PHG4Reco : public SubsysReco
   //! magnetic field
   G4TBMagneticFieldSetup *m_Field;
 
+  //! per worker thread field maps. Field maps keep caches and cannot be shared between threads
+  std::vector<PHField *> m_WorkerFieldMaps;
+
+  //! per worker thread field setups
+  std::vector<G4TBMagneticFieldSetup *> m_WorkerFields;
+
   //! pointer to geant run manager
   G4RunManager *m_RunManager;
 
@@ -190,6 +245,13 @@ class PHG4Reco : public SubsysReco
 
   bool m_SaveDstGeometryFlag;
   bool m_disableUserActions;
+
+  //!@name multithreaded running
+  //@{
+  int m_NumberOfThreads = 1;
+  bool m_UseWorkerThreads = false;
+  std::vector<SubEvent> m_SubEvents;
+  //@}
 };
 
 #endif
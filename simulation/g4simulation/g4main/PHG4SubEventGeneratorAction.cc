@@ -0,0 +1,13 @@
+#include "PHG4SubEventGeneratorAction.h"
+
+#include "PHG4Reco.h"
+
+#include <Geant4/G4Event.hh>
+
+//____________________________________________________________________________
+void PHG4SubEventGeneratorAction::GeneratePrimaries(G4Event *anEvent)
+{
+  const PHG4Reco::SubEvent &subevent = m_Reco->GetSubEvent(anEvent->GetEventID());
+  m_WorkerActions.SetInterfacePointers(subevent.node);
+  GenerateVertex(anEvent, subevent.inevent, subevent.vtxid, *subevent.vtx);
+}
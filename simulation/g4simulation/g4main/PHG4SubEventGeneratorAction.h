@@ -0,0 +1,42 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef G4MAIN_PHG4SUBEVENTGENERATORACTION_H
+#define G4MAIN_PHG4SUBEVENTGENERATORACTION_H
+
+#include "PHG4PrimaryGeneratorAction.h"
+#include "PHG4WorkerActions.h"
+
+class G4Event;
+class PHG4Reco;
+
+/*!
+  \class   PHG4SubEventGeneratorAction
+  \ingroup supermodules
+  \brief   worker thread generator, passing a single PHG4InEvent vertex to geant
+
+  The geant event id is used as index of the sub-event prepared by PHG4Reco.
+  Before generating, the worker actions are pointed to the sub-event node tree,
+  where their output is stored until merged into the main node tree.
+*/
+class PHG4SubEventGeneratorAction : public PHG4PrimaryGeneratorAction
+{
+ public:
+  PHG4SubEventGeneratorAction(PHG4Reco *reco)
+    : m_Reco(reco)
+  {
+  }
+
+  ~PHG4SubEventGeneratorAction() override {}
+
+  void GeneratePrimaries(G4Event *anEvent) override;
+
+  //! subsystem actions of this worker thread
+  PHG4WorkerActions &GetWorkerActions() { return m_WorkerActions; }
+
+ private:
+  PHG4Reco *m_Reco = nullptr;
+
+  PHG4WorkerActions m_WorkerActions;
+};
+
+#endif
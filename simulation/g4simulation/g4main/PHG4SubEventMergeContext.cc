@@ -0,0 +1,76 @@
+#include "PHG4SubEventMergeContext.h"
+
+#include "PHG4Hit.h"
+#include "PHG4HitContainer.h"
+#include "PHG4TruthInfoContainer.h"
+
+#include <climits>
+#include <vector>
+
+//_________________________________________________________________
+void PHG4SubEventMergeContext::Reset(const PHG4TruthInfoContainer *truth)
+{
+  m_HitKeys.clear();
+  if (truth)
+  {
+    m_PrimaryTrackOffset = truth->maxtrkindex();
+    m_SecondaryTrackOffset = truth->mintrkindex();
+    m_PrimaryVtxOffset = truth->maxvtxindex();
+    m_SecondaryVtxOffset = truth->minvtxindex();
+  }
+  else
+  {
+    m_PrimaryTrackOffset = 0;
+    m_SecondaryTrackOffset = 0;
+    m_PrimaryVtxOffset = 0;
+    m_SecondaryVtxOffset = 0;
+  }
+}
+
+//_________________________________________________________________
+PHG4HitDefs::keytype PHG4SubEventMergeContext::HitKey(const int container_id, const PHG4HitDefs::keytype key) const
+{
+  auto iter = m_HitKeys.find(container_id);
+  if (iter == m_HitKeys.end())
+  {
+    return key;
+  }
+  auto keyiter = iter->second.find(key);
+  return keyiter == iter->second.end() ? key : keyiter->second;
+}
+
+//_________________________________________________________________
+void PHG4SubEventMergeContext::MergeHits(PHG4HitContainer *source, PHG4HitContainer *target)
+{
+  if (!source || !target)
+  {
+    return;
+  }
+
+  auto layers = source->getLayers();
+  for (auto layer = layers.first; layer != layers.second; ++layer)
+  {
+    target->AddLayer(*layer);
+  }
+
+  // hits are moved in key order, so that new keys follow the sub-event ordering
+  auto &keys = m_HitKeys[source->GetID()];
+  std::vector<PHG4Hit *> hits;
+  hits.reserve(source->size());
+  PHG4HitContainer::ConstRange range = source->getHits();
+  for (PHG4HitContainer::ConstIterator hititer = range.first; hititer != range.second; ++hititer)
+  {
+    hits.push_back(hititer->second);
+  }
+  source->ReleaseHits();
+
+  for (PHG4Hit *hit : hits)
+  {
+    const PHG4HitDefs::keytype key = hit->get_hit_id();
+    const unsigned int detid = key >> PHG4HitDefs::hit_idbits;
+    // unset ids are left untouched
+    if (hit->get_trkid() != INT_MIN) hit->set_trkid(TrackId(hit->get_trkid()));
+    if (hit->get_shower_id() != INT_MIN) hit->set_shower_id(ShowerId(hit->get_shower_id()));
+    keys[key] = target->AddHit(detid, hit)->first;
+  }
+}
@@ -0,0 +1,64 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef G4MAIN_PHG4SUBEVENTMERGECONTEXT_H
+#define G4MAIN_PHG4SUBEVENTMERGECONTEXT_H
+
+#include "PHG4HitDefs.h"
+
+#include <map>
+
+class PHG4HitContainer;
+class PHG4TruthInfoContainer;
+
+/*!
+  \class   PHG4SubEventMergeContext
+  \ingroup supermodules
+  \brief   id translation used to merge sub-events simulated in worker threads into the main node tree
+
+  Each sub-event is simulated with its own truth and hit containers, so that its track,
+  vertex and hit ids start from scratch. When merged, primary (positive) ids are shifted
+  above the largest id already in the main truth container, and secondary (negative) ids below
+  the smallest one, the same way consecutive Geant4 passes append to the truth container.
+  Hits get new keys in their target container, which are recorded for the shower references.
+*/
+class PHG4SubEventMergeContext
+{
+ public:
+  //! prepare for a new sub-event, using the current content of the main truth container
+  void Reset(const PHG4TruthInfoContainer *truth);
+
+  //! translated track id
+  int TrackId(const int id) const
+  {
+    return id > 0 ? id + m_PrimaryTrackOffset : (id < 0 ? id + m_SecondaryTrackOffset : 0);
+  }
+
+  //! translated vertex id
+  int VtxId(const int id) const
+  {
+    return id > 0 ? id + m_PrimaryVtxOffset : (id < 0 ? id + m_SecondaryVtxOffset : 0);
+  }
+
+  //! translated shower id. Shower ids follow the id of the track that created them
+  int ShowerId(const int id) const
+  {
+    return TrackId(id);
+  }
+
+  //! translated hit key for a given hit container id. Returns the input key if unknown
+  PHG4HitDefs::keytype HitKey(const int container_id, const PHG4HitDefs::keytype key) const;
+
+  //! move all hits from source to target, translating track and shower ids and recording new keys
+  void MergeHits(PHG4HitContainer *source, PHG4HitContainer *target);
+
+ private:
+  int m_PrimaryTrackOffset = 0;
+  int m_SecondaryTrackOffset = 0;
+  int m_PrimaryVtxOffset = 0;
+  int m_SecondaryVtxOffset = 0;
+
+  //! hit key translation, per hit container id
+  std::map<int, std::map<PHG4HitDefs::keytype, PHG4HitDefs::keytype>> m_HitKeys;
+};
+
+#endif
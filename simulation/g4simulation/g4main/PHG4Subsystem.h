@@ -17,7 +17,9 @@ class PHG4DisplayAction;
 class PHG4EventAction;
 class PHG4StackingAction;
 class PHG4SteppingAction;
+class PHG4SubEventMergeContext;
 class PHG4TrackingAction;
+class PHG4WorkerActions;
 
 class PHG4Subsystem : public SubsysReco
 {
@@ -90,6 +92,23 @@ class PHG4Subsystem : public SubsysReco
 // define materials used in detector
   virtual void DefineMaterials() {}
 
+  //!@name multithreaded running, see PHG4Reco::set_number_of_threads
+  //@{
+
+  //! true if the subsystem implements the methods below. All subsystems must for multithreaded running to be enabled
+  virtual bool SupportsWorkerThreads() const { return false; }
+
+  //! create, on a sub-event node tree, the output nodes filled by worker actions
+  virtual int InitSubEventNode(PHCompositeNode */*subEventNode*/) { return 0; }
+
+  //! create the actions used by one worker thread. Called once per worker thread, serialized by PHG4Reco
+  virtual void CreateWorkerActions(PHG4WorkerActions &/*actions*/) {}
+
+  //! move the output of a sub-event into the main node tree, translating ids with the merge context
+  virtual int MergeSubEvent(PHCompositeNode */*subEventNode*/, PHCompositeNode */*topNode*/, PHG4SubEventMergeContext &/*context*/) { return 0; }
+
+  //@}
+
  private:
   PHG4Subsystem *m_MyMotherSubsystem = nullptr;
   G4LogicalVolume *m_MyLogicalVolume = nullptr;
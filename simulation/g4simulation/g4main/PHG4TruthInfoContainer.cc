@@ -47,6 +47,15 @@ void PHG4TruthInfoContainer::Reset()
   return;
 }
 
+void PHG4TruthInfoContainer::ReleaseContent()
+{
+  particlemap.clear();
+  vtxmap.clear();
+  showermap.clear();
+  particle_embed_flags.clear();
+  vertex_embed_flags.clear();
+}
+
 void PHG4TruthInfoContainer::identify(ostream& os) const
 {
   os << "---particlemap--------------------------" << endl;
@@ -40,6 +40,10 @@ class PHG4TruthInfoContainer : public PHObject
 
 // from PHObject
   void Reset() override;
+
+  //! forget all particles, vertices, showers and embed flags without deleting them.
+  //! Used once their ownership has been passed to another container
+  void ReleaseContent();
   void identify(std::ostream& os = std::cout) const override;
 
   // --- particle storage ------------------------------------------------------
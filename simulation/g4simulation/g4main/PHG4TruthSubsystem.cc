@@ -1,9 +1,13 @@
 #include "PHG4TruthSubsystem.h"
 
 #include "PHG4Particle.h"                // for PHG4Particle
+#include "PHG4Shower.h"
+#include "PHG4SubEventMergeContext.h"
 #include "PHG4TruthEventAction.h"
 #include "PHG4TruthTrackingAction.h"
 #include "PHG4TruthInfoContainer.h"
+#include "PHG4VtxPoint.h"
+#include "PHG4WorkerActions.h"
 
 #include <fun4all/Fun4AllReturnCodes.h>
 
@@ -18,8 +22,10 @@
 #include <cassert>
 #include <cstdlib>                      // for exit
 #include <iostream>
+#include <map>
 #include <set>                           // for _Rb_tree_iterator, set, _Rb_...
 #include <utility>                       // for pair
+#include <vector>
 
 class PHG4EventAction;
 class PHG4TrackingAction;
@@ -147,6 +153,113 @@ int PHG4TruthSubsystem::ResetEvent(PHCompositeNode* topNode)
   return 0;
 }
 
+//_______________________________________________________________________
+int PHG4TruthSubsystem::InitSubEventNode(PHCompositeNode* subEventNode)
+{
+  PHNodeIterator iter(subEventNode);
+  PHCompositeNode* dstNode = dynamic_cast<PHCompositeNode*>(iter.findFirst("PHCompositeNode", "DST"));
+  if (!dstNode)
+  {
+    cout << PHWHERE << " DST Node missing on sub-event node tree" << endl;
+    return Fun4AllReturnCodes::ABORTEVENT;
+  }
+  dstNode->addNode(new PHIODataNode<PHObject>(new PHG4TruthInfoContainer(), "G4TruthInfo", "PHObject"));
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+//_______________________________________________________________________
+void PHG4TruthSubsystem::CreateWorkerActions(PHG4WorkerActions& actions)
+{
+  PHG4TruthEventAction* eventAction = new PHG4TruthEventAction();
+  actions.AddEventAction(eventAction);
+  actions.AddTrackingAction(new PHG4TruthTrackingAction(eventAction));
+}
+
+//_______________________________________________________________________
+int PHG4TruthSubsystem::MergeSubEvent(PHCompositeNode* subEventNode, PHCompositeNode* topNode, PHG4SubEventMergeContext& context)
+{
+  PHG4TruthInfoContainer* source = findNode::getClass<PHG4TruthInfoContainer>(subEventNode, "G4TruthInfo");
+  PHG4TruthInfoContainer* target = findNode::getClass<PHG4TruthInfoContainer>(topNode, "G4TruthInfo");
+  if (!source || !target)
+  {
+    cout << PHWHERE << " G4TruthInfo missing, sub-event not merged" << endl;
+    return Fun4AllReturnCodes::ABORTEVENT;
+  }
+
+  // particles
+  PHG4TruthInfoContainer::Range range = source->GetParticleRange();
+  for (PHG4TruthInfoContainer::Iterator iter = range.first; iter != range.second; ++iter)
+  {
+    PHG4Particle* particle = iter->second;
+    particle->set_track_id(context.TrackId(particle->get_track_id()));
+    particle->set_parent_id(context.TrackId(particle->get_parent_id()));
+    particle->set_primary_id(context.TrackId(particle->get_primary_id()));
+    particle->set_vtx_id(context.VtxId(particle->get_vtx_id()));
+    target->AddParticle(context.TrackId(iter->first), particle);
+  }
+
+  // vertices
+  PHG4TruthInfoContainer::VtxRange vtxrange = source->GetVtxRange();
+  for (PHG4TruthInfoContainer::VtxIterator iter = vtxrange.first; iter != vtxrange.second; ++iter)
+  {
+    iter->second->set_id(context.VtxId(iter->second->get_id()));
+    target->AddVertex(context.VtxId(iter->first), iter->second);
+  }
+
+  // showers. Hits were merged before and got new keys
+  PHG4TruthInfoContainer::ShowerRange showerrange = source->GetShowerRange();
+  for (PHG4TruthInfoContainer::ShowerIterator iter = showerrange.first; iter != showerrange.second; ++iter)
+  {
+    PHG4Shower* shower = iter->second;
+    shower->set_id(context.ShowerId(shower->get_id()));
+    shower->set_parent_particle_id(context.TrackId(shower->get_parent_particle_id()));
+    shower->set_parent_shower_id(context.ShowerId(shower->get_parent_shower_id()));
+
+    const PHG4Shower::ParticleIdSet particle_ids = shower->g4particle_ids();
+    shower->clear_g4particle_id();
+    for (int id : particle_ids)
+    {
+      shower->add_g4particle_id(context.TrackId(id));
+    }
+
+    const PHG4Shower::VertexIdSet vertex_ids = shower->g4vertex_ids();
+    shower->clear_g4vertex_id();
+    for (int id : vertex_ids)
+    {
+      shower->add_g4vertex_id(context.VtxId(id));
+    }
+
+    const PHG4Shower::HitIdMap hit_ids(shower->begin_g4hit_id(), shower->end_g4hit_id());
+    for (const auto& [volume, keys] : hit_ids)
+    {
+      shower->remove_g4hit_volume(volume);
+      for (PHG4HitDefs::keytype key : keys)
+      {
+        shower->add_g4hit_id(volume, context.HitKey(volume, key));
+      }
+    }
+
+    target->AddShower(context.ShowerId(iter->first), shower);
+  }
+
+  // embed flags
+  auto trkflags = source->GetEmbeddedTrkIds();
+  for (auto iter = trkflags.first; iter != trkflags.second; ++iter)
+  {
+    target->AddEmbededTrkId(context.TrackId(iter->first), iter->second);
+  }
+
+  auto vtxflags = source->GetEmbeddedVtxIds();
+  for (auto iter = vtxflags.first; iter != vtxflags.second; ++iter)
+  {
+    target->AddEmbededVtxId(context.VtxId(iter->first), iter->second);
+  }
+
+  // ownership was passed to the target container
+  source->ReleaseContent();
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
 //_______________________________________________________________________
 PHG4EventAction* PHG4TruthSubsystem::GetEventAction(void) const
 {
@@ -40,6 +40,14 @@ class PHG4TruthSubsystem : public PHG4Subsystem
   PHG4EventAction *GetEventAction(void) const override;
   PHG4TrackingAction *GetTrackingAction(void) const override;
 
+  //!@name multithreaded running
+  //@{
+  bool SupportsWorkerThreads() const override { return true; }
+  int InitSubEventNode(PHCompositeNode *) override;
+  void CreateWorkerActions(PHG4WorkerActions &) override;
+  int MergeSubEvent(PHCompositeNode *subEventNode, PHCompositeNode *topNode, PHG4SubEventMergeContext &) override;
+  //@}
+
   //! only save the G4 truth information that is associated with the embedded particle
   void SetSaveOnlyEmbeded(bool b = true) { m_SaveOnlyEmbededFlag = b; };
 
@@ -0,0 +1,37 @@
+#include "PHG4WorkerActions.h"
+
+#include "PHG4EventAction.h"
+#include "PHG4StackingAction.h"
+#include "PHG4SteppingAction.h"
+#include "PHG4TrackingAction.h"
+
+//_________________________________________________________________
+void PHG4WorkerActions::SetInterfacePointers(PHCompositeNode *subEventNode)
+{
+  // reset per event state first, it may refer to the previous sub-event output
+  for (PHG4EventAction *action : m_EventActions)
+  {
+    action->ResetEvent(subEventNode);
+  }
+  for (PHG4TrackingAction *action : m_TrackingActions)
+  {
+    action->ResetEvent(subEventNode);
+  }
+
+  for (PHG4EventAction *action : m_EventActions)
+  {
+    action->SetInterfacePointers(subEventNode);
+  }
+  for (PHG4StackingAction *action : m_StackingActions)
+  {
+    action->SetInterfacePointers(subEventNode);
+  }
+  for (PHG4SteppingAction *action : m_SteppingActions)
+  {
+    action->SetInterfacePointers(subEventNode);
+  }
+  for (PHG4TrackingAction *action : m_TrackingActions)
+  {
+    action->SetInterfacePointers(subEventNode);
+  }
+}
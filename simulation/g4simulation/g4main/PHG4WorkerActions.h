@@ -0,0 +1,60 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef G4MAIN_PHG4WORKERACTIONS_H
+#define G4MAIN_PHG4WORKERACTIONS_H
+
+#include <vector>
+
+class PHCompositeNode;
+class PHG4EventAction;
+class PHG4StackingAction;
+class PHG4SteppingAction;
+class PHG4TrackingAction;
+
+/*!
+  \class   PHG4WorkerActions
+  \ingroup supermodules
+  \brief   subsystem actions used by a single Geant4 worker thread
+
+  Actions are created by PHG4Subsystem::CreateWorkerActions and owned, once registered to Geant4,
+  by the worker composite actions (PHG4PhenixEventAction, etc.).
+*/
+class PHG4WorkerActions
+{
+ public:
+  void AddEventAction(PHG4EventAction *action)
+  {
+    if (action) m_EventActions.push_back(action);
+  }
+
+  void AddStackingAction(PHG4StackingAction *action)
+  {
+    if (action) m_StackingActions.push_back(action);
+  }
+
+  void AddSteppingAction(PHG4SteppingAction *action)
+  {
+    if (action) m_SteppingActions.push_back(action);
+  }
+
+  void AddTrackingAction(PHG4TrackingAction *action)
+  {
+    if (action) m_TrackingActions.push_back(action);
+  }
+
+  //! reset per event state and point all actions to the output nodes of a new sub-event
+  void SetInterfacePointers(PHCompositeNode *subEventNode);
+
+  const std::vector<PHG4EventAction *> &EventActions() const { return m_EventActions; }
+  const std::vector<PHG4StackingAction *> &StackingActions() const { return m_StackingActions; }
+  const std::vector<PHG4SteppingAction *> &SteppingActions() const { return m_SteppingActions; }
+  const std::vector<PHG4TrackingAction *> &TrackingActions() const { return m_TrackingActions; }
+
+ private:
+  std::vector<PHG4EventAction *> m_EventActions;
+  std::vector<PHG4StackingAction *> m_StackingActions;
+  std::vector<PHG4SteppingAction *> m_SteppingActions;
+  std::vector<PHG4TrackingAction *> m_TrackingActions;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#include "PHG4WorkerInitialization.h"
+
+#include "PHG4EventAction.h"
+#include "PHG4PhenixEventAction.h"
+#include "PHG4PhenixStackingAction.h"
+#include "PHG4PhenixSteppingAction.h"
+#include "PHG4PhenixTrackingAction.h"
+#include "PHG4Reco.h"
+#include "PHG4StackingAction.h"
+#include "PHG4SteppingAction.h"
+#include "PHG4SubEventGeneratorAction.h"
+#include "PHG4TrackingAction.h"
+#include "PHG4WorkerActions.h"
+
+#include <Geant4/G4EventManager.hh>
+
+class G4TrackingManager;
+
+//____________________________________________________________________________
+void PHG4WorkerInitialization::Build() const
+{
+  PHG4SubEventGeneratorAction *generator = new PHG4SubEventGeneratorAction(m_Reco);
+  SetUserAction(generator);
+
+  PHG4WorkerActions &actions = generator->GetWorkerActions();
+  m_Reco->CreateWorkerActions(actions);
+
+  PHG4PhenixEventAction *eventAction = new PHG4PhenixEventAction();
+  for (PHG4EventAction *action : actions.EventActions())
+  {
+    eventAction->AddAction(action);
+  }
+  SetUserAction(eventAction);
+
+  PHG4PhenixStackingAction *stackingAction = new PHG4PhenixStackingAction();
+  for (PHG4StackingAction *action : actions.StackingActions())
+  {
+    stackingAction->AddAction(action);
+  }
+  SetUserAction(stackingAction);
+
+  PHG4PhenixSteppingAction *steppingAction = new PHG4PhenixSteppingAction();
+  for (PHG4SteppingAction *action : actions.SteppingActions())
+  {
+    steppingAction->AddAction(action);
+  }
+  SetUserAction(steppingAction);
+
+  // the event manager, and its tracking manager, are thread local
+  G4TrackingManager *trackingManager = G4EventManager::GetEventManager()->GetTrackingManager();
+  PHG4PhenixTrackingAction *trackingAction = new PHG4PhenixTrackingAction();
+  for (PHG4TrackingAction *action : actions.TrackingActions())
+  {
+    if (trackingManager)
+    {
+      action->SetTrackingManagerPointer(trackingManager);
+    }
+    trackingAction->AddAction(action);
+  }
+  SetUserAction(trackingAction);
+}
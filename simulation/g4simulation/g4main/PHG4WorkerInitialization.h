@@ -0,0 +1,32 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef G4MAIN_PHG4WORKERINITIALIZATION_H
+#define G4MAIN_PHG4WORKERINITIALIZATION_H
+
+#include <Geant4/G4VUserActionInitialization.hh>
+
+class PHG4Reco;
+
+/*!
+  \class   PHG4WorkerInitialization
+  \ingroup supermodules
+  \brief   creates the user actions of each geant worker thread, when PHG4Reco runs multithreaded
+*/
+class PHG4WorkerInitialization : public G4VUserActionInitialization
+{
+ public:
+  PHG4WorkerInitialization(PHG4Reco *reco)
+    : m_Reco(reco)
+  {
+  }
+
+  ~PHG4WorkerInitialization() override {}
+
+  //! called once per worker thread
+  void Build() const override;
+
+ private:
+  PHG4Reco *m_Reco = nullptr;
+};
+
+#endif
@@ -25,6 +25,7 @@
 #include <gsl/gsl_rng.h>                                // for gsl_rng_alloc
 #include <gsl/gsl_randist.h>
 
+#include <cmath>
 #include <cstdlib>                                     // for exit
 #include <iostream>
 #include <limits>
@@ -46,6 +47,7 @@ PHG4TpcDigitizer::PHG4TpcDigitizer(const string &name)
   ADCSignalConversionGain(numeric_limits<float>::signaling_NaN())
   ,  // will be assigned in PHG4TpcDigitizer::InitRun
   ADCNoiseConversionGain(numeric_limits<float>::signaling_NaN())  // will be assigned in PHG4TpcDigitizer::InitRun
+  , NoiseTailProbability(1)
 {
   unsigned int seed = PHRandomSeed();  // fixed seed is handled in this funtcion
   cout << Name() << " random seed: " << seed << endl;
@@ -72,6 +74,13 @@ int PHG4TpcDigitizer::InitRun(PHCompositeNode *topNode)
   // The noise is by definition the RMS noise width voltage divided by ChargeToPeakVolts
   ADCNoiseConversionGain = ChargeToPeakVolts * 1.60e-04;  // 20 (or 30) mV/fC * fC/electron
 
+  // probability for a noise only bin to pass the threshold, used for sparse noise generation
+  // sparse noise is disabled if the threshold is not above the pedestal
+  const double noise_threshold = ADCThreshold - Pedestal;  // electrons
+  NoiseTailProbability = noise_threshold > 0 ? 0.5 * std::erfc(noise_threshold / (TpcEnc * M_SQRT2)) : 1;
+  if (Verbosity() > 0 && SparseNoise)
+    cout << "PHG4TpcDigitizer::InitRun - sparse noise, probability for a noise bin to pass threshold: " << NoiseTailProbability << endl;
+
   //-------------
   // Add Hit Node
   //-------------
@@ -265,113 +274,139 @@ void PHG4TpcDigitizer::DigitizeCylinderCells(PHCompositeNode *topNode)
       if (!layergeom)
 	exit(1);
 
-      // for this hitset, make a vector of a vector of cells for each phibin
-      phi_sorted_hits.clear();
-      
-      // start with an empty vector of cells for each phibin      
-      int nphibins = layergeom->get_phibins();
-      for (int iphi = 0; iphi < nphibins; iphi++)
-	{
-	  phi_sorted_hits.push_back(std::vector<TrkrHitSet::ConstIterator>());
-	}      
-      
-      // get all of the hits from this hitset      
+      // hitkeys store the pad in their upper bits, so that hits are ordered by phibin then z bin in the hitset
+      // each phibin is then a contiguous range of hits, which is copied to dense z buffers
+      int nzbins = layergeom->get_zbins();
       TrkrHitSet *hitset = hitset_iter->second;
       TrkrHitSet::ConstRange hit_range = hitset->getHits();
-      for(TrkrHitSet::ConstIterator hit_iter = hit_range.first;
-	  hit_iter != hit_range.second;
-	  ++hit_iter)
+      for(TrkrHitSet::ConstIterator row_begin = hit_range.first; row_begin != hit_range.second;)
 	{
-	  // Fill the vector of hits for each phibin
-	  unsigned int phibin = TpcDefs::getPad(hit_iter->first);
-	  phi_sorted_hits[phibin].push_back(hit_iter);
-	}
-	  	  
-      // For this hitset we have the hits sorted into vectors for each phi
-      // process these vectors one phi bin at a time
-      for (unsigned int iphi = 0; iphi < phi_sorted_hits.size(); iphi++)
-	{
-	  if (phi_sorted_hits[iphi].size() == 0)
-	    continue;
-	  
-	  // Populate a vector of hits ordered by Z for each phibin
-	  int nzbins = layergeom->get_zbins();
-	  is_populated.clear();
+	  const unsigned int iphi = TpcDefs::getPad(row_begin->first);
+	  TrkrHitSet::ConstIterator row_end = row_begin;
+	  while(row_end != hit_range.second && TpcDefs::getPad(row_end->first) == iphi) ++row_end;
+
+	  // populate the z buffers for this phibin
 	  is_populated.assign(nzbins, 2);  // mark all as noise only for now
-	  z_sorted_hits.clear();
-	      
-	  // add an empty vector for each z bin
-	  for (int iz = 0; iz < nzbins; iz++)
-	    z_sorted_hits.push_back(std::vector<TrkrHitSet::ConstIterator>());
+	  row_energy.assign(nzbins, 0);
+	  row_hits.assign(nzbins, nullptr);
 
 	  if(Verbosity() > 2)
 	    if(layer == print_layer) cout << endl;	  
 
-	  // add a hit for each z bin that has one
-	  for (unsigned int iz = 0; iz < phi_sorted_hits[iphi].size(); iz++)
+	  for(TrkrHitSet::ConstIterator hit_iter = row_begin; hit_iter != row_end; ++hit_iter)
 	    {
-	      int zbin = TpcDefs::getTBin(phi_sorted_hits[iphi][iz]->first);
+	      int zbin = TpcDefs::getTBin(hit_iter->first);
 	      is_populated[zbin] = 1;  // this bin is a associated with a hit
-	      z_sorted_hits[zbin].push_back(phi_sorted_hits[iphi][iz]);
+	      row_energy[zbin] = (hit_iter->second)->getEnergy();
+	      row_hits[zbin] = hit_iter->second;
 
 	      if(Verbosity() > 2)
 		if(layer == print_layer)  
 		  {
-		    TrkrDefs::hitkey hitkey =  phi_sorted_hits[iphi][iz]->first ;
+		    TrkrDefs::hitkey hitkey =  hit_iter->first ;
 		    cout << "iphi " << iphi << " adding existing hit to z vector for layer " << layer << " zbin " << zbin << "  hitkey " << hitkey << " pad " << TpcDefs::getPad(hitkey) 
-			 << " z bin " << TpcDefs::getTBin(hitkey)   << "  energy " <<( phi_sorted_hits[iphi][iz]->second)->getEnergy() 
+			 << " z bin " << TpcDefs::getTBin(hitkey)   << "  energy " << row_energy[zbin]
 			 << endl;
 		  }
 	    }
-	      
-	  adc_input.clear();
-	  adc_hitid.clear();
+	  row_begin = row_end;
+
 	  // Now for this phibin we process all bins ordered by Z into hits with noise
 	  //======================================================
 	  // For this step we take the edep value and convert it to mV at the ADC input
 	  // See comments above for how to do this for signal and noise
-	      
-	  for (int iz = 0; iz < nzbins; iz++)
+	  if(SparseNoise && NoiseTailProbability < 1)
 	    {
-	      if (is_populated[iz] == 1)
+	      /*
+	       * only noise bins that cross the threshold are sampled upfront.
+	       * Their positions are obtained from geometric gaps between successive crossings,
+	       * and their value from the gaussian tail above threshold.
+	       * Other noise bins are left as NaN, which never pass the threshold, and are sampled
+	       * below threshold only if they get digitized after a neighboring bin
+	       */
+	      adc_input.assign(nzbins, numeric_limits<float>::quiet_NaN());
+	      if(NoiseTailProbability > 0)
 		{
-		  // This zbin has a hit, add noise
-		  float noise = added_noise();                                                                                       // in electrons
-		  float noise_voltage = (Pedestal + noise) * ADCNoiseConversionGain;                      // mV - from definition of noise charge and pedestal charge
-		  float adc_input_voltage = (z_sorted_hits[iz][0]->second)->getEnergy() * ADCSignalConversionGain;  // mV, see comments above
-		  
-		  adc_input.push_back(adc_input_voltage + noise_voltage);
-		  adc_hitid.push_back(z_sorted_hits[iz][0]->first);
-
-		  if(Verbosity() > 2)
-		  if(layer == print_layer) 
-		    cout << "existing hit: layer " << layer << " iphi " << iphi  << " iz " << iz << " edep " <<  (z_sorted_hits[iz][0]->second)->getEnergy() 
-			   << " adc gain " << ADCSignalConversionGain << " adc_input_voltage " << adc_input_voltage << " noise voltage " << noise_voltage 
-			   <<  " adc_input " << adc_input[iz] << endl;
+		  for(unsigned long iz = gsl_ran_geometric(RandomGenerator, NoiseTailProbability) - 1; iz < (unsigned long) nzbins; iz += gsl_ran_geometric(RandomGenerator, NoiseTailProbability))
+		    {
+		      if(is_populated[iz] == 1) continue;
+		      adc_input[iz] = (Pedestal + added_noise_above_threshold()) * ADCNoiseConversionGain;
+		    }
 		}
-	      else if (is_populated[iz] == 2)
+
+	      for (int iz = 0; iz < nzbins; iz++)
 		{
-		  // This z bin does not have a filled cell, add noise
-		  float noise = added_noise();                                        // returns "electrons"
-		  float noise_voltage = (Pedestal + noise) * ADCNoiseConversionGain;  // mV - noise "electrons" x conversion gain
-		  
-		  adc_input.push_back(noise_voltage);  // mV
-		  adc_hitid.push_back(0);             // there is no hit, just add a placeholder in the vector for now, replace it later
-
-		  if(Verbosity() > 2)
-		  if(layer == print_layer) 
-		    cout << "noise hit: layer " << layer << " iphi " << iphi  << " iz " << iz
-			   << " adc gain " << ADCSignalConversionGain << " noise voltage " << noise_voltage 
-			   <<  " adc_input " << adc_input[iz] << endl;
+		  if(is_populated[iz] != 1) continue;
+		  float noise = added_noise();
+		  adc_input[iz] = row_energy[iz] * ADCSignalConversionGain + (Pedestal + noise) * ADCNoiseConversionGain;
 		}
-	      else
+	    }
+	  else
+	    {
+	      adc_input.resize(nzbins);
+	      for (int iz = 0; iz < nzbins; iz++)
 		{
-		  // Cannot happen
-		  cout << "Impossible value of is_populated, iz = " << iz << " is_populated = " << is_populated[iz] << endl;
-		  exit(-1);
+		  float noise = added_noise();                                        // in electrons
+		  float noise_voltage = (Pedestal + noise) * ADCNoiseConversionGain;  // mV - from definition of noise charge and pedestal charge
+		  if (is_populated[iz] == 1)
+		    {
+		      // This zbin has a hit, add noise
+		      float adc_input_voltage = row_energy[iz] * ADCSignalConversionGain;  // mV, see comments above
+		      adc_input[iz] = adc_input_voltage + noise_voltage;
+
+		      if(Verbosity() > 2)
+			if(layer == print_layer) 
+			  cout << "existing hit: layer " << layer << " iphi " << iphi  << " iz " << iz << " edep " <<  row_energy[iz]
+			       << " adc gain " << ADCSignalConversionGain << " adc_input_voltage " << adc_input_voltage << " noise voltage " << noise_voltage 
+			       <<  " adc_input " << adc_input[iz] << endl;
+		    }
+		  else
+		    {
+		      // This z bin does not have a filled cell, only noise
+		      adc_input[iz] = noise_voltage;  // mV
+
+		      if(Verbosity() > 2)
+			if(layer == print_layer) 
+			  cout << "noise hit: layer " << layer << " iphi " << iphi  << " iz " << iz
+			       << " adc gain " << ADCSignalConversionGain << " noise voltage " << noise_voltage 
+			       <<  " adc_input " << adc_input[iz] << endl;
+		    }
 		}
 	    }
-	  
+
+	  // digitize a given z bin, creating a hit for noise bins
+	  auto digitize_bin = [&](int iz)
+	    {
+	      // noise bin that was not sampled yet. It is below threshold by construction
+	      if(std::isnan(adc_input[iz])) adc_input[iz] = (Pedestal + added_noise_below_threshold()) * ADCNoiseConversionGain;
+
+	      unsigned int adc_output = (unsigned int) (adc_input[iz] * 1024.0 / 2200.0);  // input voltage x 1024 channels over 2200 mV max range
+	      if (adc_input[iz] < 0) adc_output = 0;
+	      if (adc_output > 1023) adc_output = 1023;
+
+	      if (Verbosity() > 2)
+		if (layer == print_layer) cout << "new:  iphi " << iphi << "  iz " << iz << " populated " << is_populated[iz]
+					       << "  adc_input " << adc_input[iz] << " ADCThreshold " << ADCThreshold * ADCNoiseConversionGain
+					       << " adc_output " << adc_output << endl;
+
+	      // noise bins do not have TrkrHits associated with them, have to make one
+	      TrkrHit *hit = row_hits[iz];
+	      if(!hit)
+		{
+		  TrkrDefs::hitkey hitkey = TpcDefs::genHitKey(iphi, iz);
+		  hit = new TrkrHitv2();
+		  hitset->addHitSpecificKey(hitkey, hit);
+		  row_hits[iz] = hit;
+
+		  if (Verbosity() > 2)
+		    if (layer == print_layer) cout << "new:  adding noise hit for iphi " << iphi << " zbin " << iz
+						   << " created new hit with hitkey " << hitkey
+						   << " energy " << adc_input[iz] << " adc " << adc_output << endl;
+		}
+
+	      hit->setAdc(adc_output);
+	    };
+
 	  // Now we can digitize the entire stream of z bins for this phi bin
 	      
 	  // start with negative z, the first to arrive is bin 0
@@ -393,37 +428,7 @@ void PHG4TpcDigitizer::DigitizeCylinderCells(PHCompositeNode *topNode)
 		  for (int izup = 0; izup < 5; izup++)
 		    {
 		      if (iz + izup < nzbins / 2 && iz + izup >= 0)   // stay within the bin limits for negative z
-			{
-			  unsigned int adc_output = (unsigned int) (adc_input[iz + izup] * 1024.0 / 2200.0);  // input voltage x 1024 channels over 2200 mV max range
-			  if (adc_input[iz + izup] < 0) adc_output = 0;
-			  if (adc_output > 1023) adc_output = 1023;
-			  
-			  if (Verbosity() > 2)
-			  if (layer == print_layer) cout << "new:  iphi " << iphi << "  (neg z) iz+izup " << iz + izup << " adc_hitid " << adc_hitid[iz + izup]
-							   << "  adc_input " << adc_input[iz + izup] << " ADCThreshold " << ADCThreshold * ADCNoiseConversionGain
-							   << " adc_output " << adc_output << endl;
-			  
-			  // Get the hitkey
-			  TrkrDefs::hitkey hitkey = TpcDefs::genHitKey(iphi, iz+izup);
-			  TrkrHit *hit = nullptr;
-			  hit = hitset_iter->second->getHit(hitkey);
-			  
-			  // noise bins do not have TrkrHits associated with them, have to make one
-			  if(!hit)
-			    {
-			      hit = new TrkrHitv2();
-			      hitset_iter->second->addHitSpecificKey(hitkey, hit);
-			      //hit->addEnergy(adc_input[iz+izup]);
-			      
-			      if (Verbosity() > 2)
-				if (layer == print_layer) cout << "new:  adding noise hit for iphi " << iphi << " zbin " << iz + izup
-							       << " created new hit with hitkey " << hitkey
-							       << " energy " << adc_input[iz + izup] << " adc " << adc_output << endl;
-			    }
-
-			  hit->setAdc(adc_output);
-			  
-			}  // end boundary check
+			{ digitize_bin(iz + izup); }
 		      binpointer++;   // skip this bin in future
 		    }    // end izup loop
 		  
@@ -431,14 +436,8 @@ void PHG4TpcDigitizer::DigitizeCylinderCells(PHCompositeNode *topNode)
 	      else
 		{
 		  // set adc value to zero if there is a hit
-		  // Get the hitkey
-		  TrkrDefs::hitkey hitkey = TpcDefs::genHitKey(iphi, iz);
-		  TrkrHit *hit = nullptr;
-		  hit = hitset_iter->second->getHit(hitkey);
-		  if(hit)
-		    {
-		      hit->setAdc(0);
-		    }
+		  if(row_hits[iz]) row_hits[iz]->setAdc(0);
+
 		  // below threshold, move on
 		  binpointer++;
 		}  // end adc threshold if/else
@@ -464,36 +463,7 @@ void PHG4TpcDigitizer::DigitizeCylinderCells(PHCompositeNode *topNode)
 		  for (int izup = 0; izup < 5; izup++)
 		    {
 		      if (iz - izup < nzbins && iz - izup >= nzbins / 2)
-			{
-			  unsigned int adc_output = (unsigned int) (adc_input[iz - izup] * 1024.0 / 2200.0);  // input voltage x 1024 channels over 2200 mV max range
-			  if (adc_input[iz - izup] < 0) adc_output = 0;
-			  if (adc_output > 1023) adc_output = 1023;
-			  
-			  if (Verbosity() > 2)
-			  if (layer == print_layer) cout << "new:  iphi " << iphi << "  (pos z) iz-izup " << iz - izup << " adc_hitid " << adc_hitid[iz - izup]
-							   << "  adc_input " << adc_input[iz - izup] << " ADCThreshold " << ADCThreshold * ADCNoiseConversionGain
-							   << " adc_output " << adc_output << endl;
-
-			  // Get the hitkey
-			  TrkrDefs::hitkey hitkey = TpcDefs::genHitKey(iphi, iz-izup);
-			  TrkrHit *hit = nullptr;
-			  hit = hitset_iter->second->getHit(hitkey);
-			  
-			  // noise bins do not have TrkrHits associated with them, have to make one
-			  if(!hit)
-			    {
-			      hit = new TrkrHitv2();
-			      hitset_iter->second->addHitSpecificKey(hitkey, hit);
-			      //hit->addEnergy(adc_input[iz-izup]);
-			      
-			      if (Verbosity() > 2)
-				if (layer == print_layer) cout << "new:  adding noise hit for iphi " << iphi << " zbin " << iz - izup
-							       << " created new hit with hitkey " << hitkey
-							       << " energy " << adc_input[iz - izup] << " adc " << adc_output << endl;
-			    }
-
-			  hit->setAdc(adc_output);
-			} // end boundary check
+			{ digitize_bin(iz - izup); }
 		      binpointer--;
 		    } // end izup loop
 		  
@@ -501,14 +471,8 @@ void PHG4TpcDigitizer::DigitizeCylinderCells(PHCompositeNode *topNode)
 	      else
 		{
 		  // set adc value to zero if there is a hit
-		  // Get the hitkey
-		  TrkrDefs::hitkey hitkey = TpcDefs::genHitKey(iphi, iz);
-		  TrkrHit *hit = nullptr;
-		  hit = hitset_iter->second->getHit(hitkey);
-		  if(hit)
-		    {
-		      hit->setAdc(0);
-		    }
+		  if(row_hits[iz]) row_hits[iz]->setAdc(0);
+
 		  // below threshold, move on
 		  binpointer--;
 		}  // end adc threshold if/else
@@ -628,3 +592,23 @@ float PHG4TpcDigitizer::added_noise()
 
   return noise;
 }
+
+float PHG4TpcDigitizer::added_noise_above_threshold()
+{
+  // gaussian tail above the threshold
+  float noise = gsl_ran_gaussian_tail(RandomGenerator, ADCThreshold - Pedestal, TpcEnc);
+
+  return noise;
+}
+
+float PHG4TpcDigitizer::added_noise_below_threshold()
+{
+  // gaussian truncated at the threshold. Rejection is rare as long as the threshold is well above the noise
+  float noise = 0;
+  do
+  {
+    noise = gsl_ran_gaussian(RandomGenerator, TpcEnc);
+  } while (noise > ADCThreshold - Pedestal);
+
+  return noise;
+}
@@ -16,6 +16,7 @@
 #include <gsl/gsl_rng.h>
 
 class PHCompositeNode;
+class TrkrHit;
 
 class PHG4TpcDigitizer : public SubsysReco
 {
@@ -45,10 +46,20 @@ class PHG4TpcDigitizer : public SubsysReco
   void SetADCThreshold(const float thresh) { ADCThreshold = thresh; };
   void SetENC(const float enc) { TpcEnc = enc; };
 
+  //! only sample noise for bins that can pass the ADC threshold (default false)
+  /*!
+   * noise only bins above threshold are drawn from the gaussian tail, at positions given by geometric gaps.
+   * Remaining noise bins are sampled below threshold only when digitized next to a bin above threshold.
+   * The noise distribution is unchanged, but the random sequence differs from the default mode
+   */
+  void SetSparseNoise(const bool value) { SparseNoise = value; };
+
  private:
   void CalculateCylinderCellADCScale(PHCompositeNode *topNode);
   void DigitizeCylinderCells(PHCompositeNode *topNode);
   float added_noise();
+  float added_noise_above_threshold();
+  float added_noise_below_threshold();
 
   unsigned int TpcMinLayer;
   float ADCThreshold;
@@ -59,12 +70,17 @@ class PHG4TpcDigitizer : public SubsysReco
   float ADCSignalConversionGain;
   float ADCNoiseConversionGain;
 
-  std::vector<std::vector<TrkrHitSet::ConstIterator> > phi_sorted_hits;
-  std::vector<std::vector<TrkrHitSet::ConstIterator> > z_sorted_hits;
+  //! probability for a noise only bin to pass the threshold
+  double NoiseTailProbability;
+  bool SparseNoise = false;
 
+  //!@name dense buffers for the z bins of a given phibin
+  //@{
   std::vector<float> adc_input;
-  std::vector<TrkrDefs::hitkey> adc_hitid;
+  std::vector<float> row_energy;
+  std::vector<TrkrHit *> row_hits;
   std::vector<int> is_populated;
+  //@}
 
   // settings
   std::map<int, unsigned int> _max_adc;
@@ -26,6 +26,12 @@ namespace
     return x * x;
   }
 
+  // interpolate a distortion histogram, used when the histograms could not be converted to a TpcDistortionMap
+  inline double interpolate(TH3* h, double phi, double r, double z)
+  {
+    return h ? h->Interpolate(phi, r, z) : 0;
+  }
+
 }  // namespace
 
 //__________________________________________________________________________________________________________
@@ -48,6 +54,12 @@ void PHG4TpcDistortion::Init()
 
     // if z = -50 is in the underflow bin, map is only one-sided.
     m_static_map_onesided = (hDXint->GetZaxis()->FindBin(-50) == 0);
+
+    // convert to flat interpolation grid
+    if (!m_static_map.load({hDXint, hDYint, hDZint}))
+    {
+      std::cout << "Static distortion histograms could not be converted to interpolation grid, using TH3::Interpolate" << std::endl;
+    }
   }
 
   if (m_do_time_ordered_distortions)
@@ -87,6 +99,12 @@ void PHG4TpcDistortion::load_event(int event_num)
 
     // if z = -50 is in the underflow bin, map is only one-sided.
     m_time_ordered_map_onesided = (TimehDX->GetZaxis()->FindBin(-50) == 0);
+
+    // convert to flat interpolation grid
+    if (!m_time_ordered_map.load({TimehDX, TimehDY, TimehDZ}))
+    {
+      std::cout << "TimeOrdered distortion histograms could not be converted to interpolation grid, using TH3::Interpolate" << std::endl;
+    }
   }
 
   return;
@@ -95,40 +113,97 @@ void PHG4TpcDistortion::load_event(int event_num)
 //__________________________________________________________________________________________________________
 double PHG4TpcDistortion::get_x_distortion(double x, double y, double z) const
 {
-  return get_distortion(hDXint, TimehDX, x, y, z);
+  return get_distortion(0, x, y, z);
 }
 
 //__________________________________________________________________________________________________________
 double PHG4TpcDistortion::get_y_distortion(double x, double y, double z) const
 {
-  return get_distortion(hDYint, TimehDY, x, y, z);
+  return get_distortion(1, x, y, z);
 }
 
 //__________________________________________________________________________________________________________
 double PHG4TpcDistortion::get_z_distortion(double x, double y, double z) const
 {
-  return get_distortion(hDZint, TimehDZ, x, y, z);
+  return get_distortion(2, x, y, z);
+}
+
+//__________________________________________________________________________________________________________
+void PHG4TpcDistortion::get_distortions(double x, double y, double z, double& x_distortion, double& y_distortion, double& z_distortion) const
+{
+  double phi = std::atan2(y, x);
+  if (phi < 0) phi += 2 * M_PI;
+  const double r = std::sqrt(square(x) + square(y));
+
+  x_distortion = 0;
+  y_distortion = 0;
+  z_distortion = 0;
+
+  float distortions[3];
+  if (!m_static_map.empty())
+  {
+    const auto zmap = m_static_map_onesided ? std::abs(z) : z;
+    m_static_map.interpolate(phi, r, zmap, distortions);
+    x_distortion += distortions[0];
+    y_distortion += distortions[1];
+    z_distortion += distortions[2];
+  }
+  else if (m_do_static_distortions)
+  {
+    const auto zmap = m_static_map_onesided ? std::abs(z) : z;
+    x_distortion += interpolate(hDXint, phi, r, zmap);
+    y_distortion += interpolate(hDYint, phi, r, zmap);
+    z_distortion += interpolate(hDZint, phi, r, zmap);
+  }
+
+  if (!m_time_ordered_map.empty())
+  {
+    const auto zmap = m_time_ordered_map_onesided ? std::abs(z) : z;
+    m_time_ordered_map.interpolate(phi, r, zmap, distortions);
+    x_distortion += distortions[0];
+    y_distortion += distortions[1];
+    z_distortion += distortions[2];
+  }
+  else if (TimeTree)
+  {
+    const auto zmap = m_time_ordered_map_onesided ? std::abs(z) : z;
+    x_distortion += interpolate(TimehDX, phi, r, zmap);
+    y_distortion += interpolate(TimehDY, phi, r, zmap);
+    z_distortion += interpolate(TimehDZ, phi, r, zmap);
+  }
 }
 
 //__________________________________________________________________________________
-double PHG4TpcDistortion::get_distortion(TH3* hstatic, TH3* htimeOrdered, double x, double y, double z) const
+double PHG4TpcDistortion::get_distortion(unsigned int component, double x, double y, double z) const
 {
   double phi = std::atan2(y, x);
   if (phi < 0) phi += 2 * M_PI;
   const double r = std::sqrt(square(x) + square(y));
 
-  double x_distortion = 0;
-  if (hstatic)
+  double distortion = 0;
+  if (!m_static_map.empty())
   {
     const auto zmap = m_static_map_onesided ? std::abs(z) : z;
-    x_distortion += hstatic->Interpolate(phi, r, zmap);
+    distortion += m_static_map.interpolate(component, phi, r, zmap);
+  }
+  else if (m_do_static_distortions)
+  {
+    const auto zmap = m_static_map_onesided ? std::abs(z) : z;
+    TH3* const histograms[3] = {hDXint, hDYint, hDZint};
+    distortion += interpolate(histograms[component], phi, r, zmap);
   }
 
-  if (htimeOrdered)
+  if (!m_time_ordered_map.empty())
+  {
+    const auto zmap = m_time_ordered_map_onesided ? std::abs(z) : z;
+    distortion += m_time_ordered_map.interpolate(component, phi, r, zmap);
+  }
+  else if (TimeTree)
   {
     const auto zmap = m_time_ordered_map_onesided ? std::abs(z) : z;
-    x_distortion += htimeOrdered->Interpolate(phi, r, zmap);
+    TH3* const histograms[3] = {TimehDX, TimehDY, TimehDZ};
+    distortion += interpolate(histograms[component], phi, r, zmap);
   }
 
-  return x_distortion;
+  return distortion;
 }
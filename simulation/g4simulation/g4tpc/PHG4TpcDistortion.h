@@ -11,6 +11,8 @@
 #ifndef G4TPC_PHG4TPCDISTORTION_H
 #define G4TPC_PHG4TPCDISTORTION_H
 
+#include <tpc/TpcDistortionMap.h>
+
 #include <memory>
 #include <string>
 
@@ -37,6 +39,10 @@ class PHG4TpcDistortion
   //! z distortion for a given truth location of the primary ionization
   double get_z_distortion(double x, double y, double z) const;
 
+  //! x, y and z distortions for a given truth location of the primary ionization
+  /*! this is faster than calling the three accessors above separately, since the grid index is calculated only once */
+  void get_distortions(double x, double y, double z, double &x_distortion, double &y_distortion, double &z_distortion) const;
+
   //! Gets the verbosity of this module.
   int Verbosity() const
   {
@@ -87,8 +93,8 @@ class PHG4TpcDistortion
   //@}
 
  private:
-  //! get distortion for a set of histogram and an input momentum distribution
-  double get_distortion(TH3 *hstatic, TH3 *htimeOrdered, double x, double y, double z) const;
+  //! get distortion for a given component (0, 1, 2 for x, y, z) at a given location
+  double get_distortion(unsigned int component, double x, double y, double z) const;
 
   //! The verbosity level. 0 means not verbose at all.
   int verbosity = 0;
@@ -102,6 +108,7 @@ class PHG4TpcDistortion
   TH3 *hDXint = nullptr;
   TH3 *hDYint = nullptr;
   TH3 *hDZint = nullptr;
+  TpcDistortionMap m_static_map;
   //@}
 
   //!@name time ordered histograms
@@ -114,6 +121,7 @@ class PHG4TpcDistortion
   TH3 *TimehDX = nullptr;
   TH3 *TimehDY = nullptr;
   TH3 *TimehDZ = nullptr;
+  TpcDistortionMap m_time_ordered_map;
   //@}
 };
 
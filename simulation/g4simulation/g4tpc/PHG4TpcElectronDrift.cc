@@ -372,9 +372,10 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
 
       if (m_distortionMap)
       {
-        const double x_distortion = m_distortionMap->get_x_distortion(x_start, y_start, z_start);
-        const double y_distortion = m_distortionMap->get_y_distortion(x_start, y_start, z_start);
-        const double z_distortion = m_distortionMap->get_z_distortion(x_start, y_start, z_start);
+        double x_distortion = 0;
+        double y_distortion = 0;
+        double z_distortion = 0;
+        m_distortionMap->get_distortions(x_start, y_start, z_start, x_distortion, y_distortion, z_distortion);
 
         x_final += x_distortion;
         y_final += y_distortion;